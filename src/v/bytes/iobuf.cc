@@ -75,6 +75,29 @@ ss::future<iobuf> read_iobuf_exactly(ss::input_stream<char>& in, size_t n) {
     });
 }
 
+ss::future<iobuf>
+read_iobuf_exactly_shared(ss::input_stream<char>& in, size_t n) {
+    return ss::do_with(iobuf{}, n, [&in](iobuf& b, size_t& n) {
+        return ss::do_until(
+                 [&n] { return n == 0; },
+                 [&n, &in, &b] {
+                     return in.read_up_to(n).then(
+                       [&n, &b](ss::temporary_buffer<char> buf) {
+                           if (buf.empty()) {
+                               n = 0;
+                               return;
+                           }
+                           n -= buf.size();
+                           // iobuf::append copies buffers that fit in the
+                           // last fragment, take the shared buffer as is
+                           b.append_take_ownership(new iobuf::fragment(
+                             std::move(buf), iobuf::fragment::full{}));
+                       });
+                 })
+          .then([&b] { return std::move(b); });
+    });
+}
+
 ss::output_stream<char> make_iobuf_ref_output_stream(iobuf& io) {
     struct iobuf_output_stream final : ss::data_sink_impl {
         explicit iobuf_output_stream(iobuf& i)
@@ -22,4 +22,12 @@ ss::output_stream<char> make_iobuf_ref_output_stream(iobuf& io);
 /// \brief exactly like input_stream<char>::read_exactly but returns iobuf
 ss::future<iobuf> read_iobuf_exactly(ss::input_stream<char>& in, size_t n);
 
+/// \brief like read_iobuf_exactly but the fragments of the returned iobuf
+/// share the buffers of the input stream instead of copying small reads.
+/// Holding on to the result keeps the stream buffers it was sliced from alive,
+/// so it's meant for streams with large buffers that are consumed shortly
+/// after, e.g. segment reads.
+ss::future<iobuf>
+read_iobuf_exactly_shared(ss::input_stream<char>& in, size_t n);
+
 ss::future<> write_iobuf_to_output_stream(iobuf, ss::output_stream<char>&);
@@ -39,6 +39,32 @@ SEASTAR_THREAD_TEST_CASE(test_reading_some_bytes) {
     BOOST_REQUIRE_EQUAL(read_buf.size_bytes(), 16);
 };
 
+SEASTAR_THREAD_TEST_CASE(test_reading_shared_bytes) {
+    auto buf = iobuf();
+    append_sequence(buf, 5);
+    BOOST_REQUIRE_EQUAL(std::distance(buf.begin(), buf.end()), 1);
+    auto expected = buf.copy();
+    const char* src = buf.begin()->get();
+    const size_t src_size = buf.begin()->size();
+    auto is = make_iobuf_input_stream(std::move(buf));
+
+    // small reads are slices of the stream buffer rather than copies packed
+    // into a new fragment
+    iobuf read_buf;
+    for (size_t i = 0; i < src_size; i += 7) {
+        auto part = read_iobuf_exactly_shared(
+                      is, std::min<size_t>(7, src_size - i))
+                      .get0();
+        for (auto& f : part) {
+            BOOST_REQUIRE(f.get() >= src);
+            BOOST_REQUIRE(f.get() + f.size() <= src + src_size);
+        }
+        read_buf.append_fragments(std::move(part));
+    }
+    BOOST_REQUIRE_EQUAL(read_buf, expected);
+    BOOST_REQUIRE(read_iobuf_exactly_shared(is, 16).get0().empty());
+};
+
 SEASTAR_THREAD_TEST_CASE(test_bytes_conversion) {
     static constexpr std::string_view key = "magic_key";
     iobuf buf;
@@ -670,7 +670,8 @@ std::vector<ntp_report> collect_shard_local_reports(
                   .leader_id = p.second->get_leader_id(),
                   .revision_id = p.second->get_revision_id(),
                 },
-                .size_bytes = p.second->size_bytes() + p.second->non_log_disk_size_bytes(),
+                .size_bytes = p.second->log_disk_usage().total()
+                              + p.second->non_log_disk_size_bytes(),
               };
           });
     } else {
@@ -683,7 +684,8 @@ std::vector<ntp_report> collect_shard_local_reports(
                   .leader_id = partition->get_leader_id(),
                   .revision_id = partition->get_revision_id(),
                 },
-                .size_bytes = partition->size_bytes(),
+                .size_bytes = partition->log_disk_usage().total()
+                              + partition->non_log_disk_size_bytes(),
                 });
             }
         }
@@ -112,6 +112,15 @@ metadata_cache::get_node_metadata(model::node_id nid) const {
     return _members_table.local().get_node_metadata(nid);
 }
 
+std::optional<model::rack_id>
+metadata_cache::get_node_rack_id(model::node_id nid) const {
+    auto node = _members_table.local().get_node_metadata_ref(nid);
+    if (!node) {
+        return std::nullopt;
+    }
+    return node->get().broker.rack();
+}
+
 const members_table::cache_t& metadata_cache::nodes() const {
     return _members_table.local().nodes();
 }
@@ -121,6 +121,9 @@ public:
     /// broker can change
     std::optional<node_metadata> get_node_metadata(model::node_id) const;
 
+    /// Returns rack of the broker, if the broker exists and has its rack set
+    std::optional<model::rack_id> get_node_rack_id(model::node_id) const;
+
     bool should_reject_writes() const;
 
     bool contains(model::topic_namespace_view, model::partition_id) const;
@@ -127,6 +127,54 @@ public:
         return model::next_offset(_raft->last_visible_index());
     }
 
+    /**
+     * Resolves when the high watermark moves past the given offset, i.e. when
+     * a batch with offset greater or equal to `hwm` becomes visible.
+     */
+    ss::future<> wait_for_high_watermark_past(
+      model::offset hwm,
+      model::timeout_clock::time_point deadline,
+      std::optional<std::reference_wrapper<ss::abort_source>> as) {
+        return _raft->visible_offset_monitor().wait(hwm, deadline, as);
+    }
+
+    /**
+     * High watermark of the partition replica when it is a follower. Only the
+     * batches known to be committed are visible, i.e. the high watermark
+     * trails the one of the leader by at most the time it takes to propagate
+     * the commit index with append entries or heartbeats.
+     */
+    model::offset follower_high_watermark() const {
+        return model::next_offset(_raft->last_committed_visible_index());
+    }
+
+    /**
+     * Last stable offset of the partition replica when it is a follower, never
+     * greater than the follower high watermark.
+     */
+    model::offset follower_last_stable_offset() const {
+        auto hwm = follower_high_watermark();
+        if (_rm_stm) {
+            auto lso = _rm_stm->follower_last_stable_offset();
+            if (lso == model::invalid_lso) {
+                return lso;
+            }
+            return std::min(lso, hwm);
+        }
+        return hwm;
+    }
+
+    /**
+     * Resolves when the follower high watermark moves past the given offset.
+     */
+    ss::future<> wait_for_follower_high_watermark_past(
+      model::offset hwm,
+      model::timeout_clock::time_point deadline,
+      std::optional<std::reference_wrapper<ss::abort_source>> as) {
+        return _raft->committed_visible_offset_monitor().wait(
+          hwm, deadline, as);
+    }
+
     model::term_id term() { return _raft->term(); }
 
     model::offset dirty_offset() const {
@@ -188,6 +236,11 @@ public:
         return _raft->get_leader_id();
     }
 
+    result<raft::follower_metrics>
+    get_follower_metrics(model::node_id id) const {
+        return _raft->get_follower_metrics(id);
+    }
+
     model::offset get_latest_configuration_offset() const {
         return _raft->get_latest_configuration_offset();
     }
@@ -204,6 +257,10 @@ public:
     ss::shared_ptr<cluster::rm_stm> rm_stm();
 
     size_t size_bytes() const { return _raft->log().size_bytes(); }
+    /// bytes on disk of the log including its index files
+    storage::disk_usage log_disk_usage() const {
+        return _raft->log().get_disk_usage();
+    }
 
     uint64_t non_log_disk_size_bytes() const;
 
@@ -165,7 +165,14 @@ ss::future<consensus_ptr> partition_manager::manage(
               ntp_cfg, manifest, max_kafka_offset);
         }
     }
-    storage::log log = co_await _storage.log_mgr().manage(std::move(ntp_cfg));
+    // partitions this node was leading before the restart are recovered
+    // first so that their leadership moves back sooner
+    const auto priority = raft::consensus::last_voted_for_self(
+                            _storage.kvs(), group, _raft_manager.local().self())
+                            ? storage::recovery_priority::high
+                            : storage::recovery_priority::normal;
+    storage::log log = co_await _storage.log_mgr().manage(
+      std::move(ntp_cfg), priority);
     vlog(
       clusterlog.debug,
       "Log created manage completed, ntp: {}, rev: {}, {} "
@@ -1834,6 +1834,14 @@ model::offset rm_stm::last_stable_offset() {
     return model::next_offset(last_visible_index);
 }
 
+model::offset rm_stm::follower_last_stable_offset() {
+    auto lso = last_stable_offset();
+    if (lso == model::invalid_lso) {
+        return lso;
+    }
+    return std::min(lso, model::next_offset(last_applied_offset()));
+}
+
 static void filter_intersecting(
   std::vector<rm_stm::tx_range>& target,
   const std::vector<rm_stm::tx_range>& source,
@@ -187,6 +187,10 @@ public:
       model::producer_identity, model::tx_seq, model::timeout_clock::duration);
 
     model::offset last_stable_offset();
+    /// Last stable offset of a follower replica. Followers only learn about
+    /// transactions from the applied batches, the offset never passes the
+    /// next offset to apply.
+    model::offset follower_last_stable_offset();
     ss::future<std::vector<rm_stm::tx_range>>
       aborted_transactions(model::offset, model::offset);
 
@@ -75,7 +75,9 @@ public:
       std::vector<config::seed_server> seeds,
       configure_node_id use_node_id = configure_node_id::yes,
       empty_seed_starts_cluster empty_seed_starts_cluster_val
-      = empty_seed_starts_cluster::yes) {
+      = empty_seed_starts_cluster::yes,
+      model::rack_id rack = model::rack_id(
+        redpanda_thread_fixture::rack_name)) {
         _instances.emplace(
           node_id,
           std::make_unique<redpanda_thread_fixture>(
@@ -93,7 +95,8 @@ public:
             std::nullopt,
             std::nullopt,
             use_node_id,
-            empty_seed_starts_cluster_val));
+            empty_seed_starts_cluster_val,
+            std::move(rack)));
     }
 
     application* get_node_application(model::node_id id) {
@@ -239,6 +239,39 @@ configuration::configuration()
       "connection.  Set to 0 to disable force disconnection.",
       {.visibility = visibility::tunable},
       3)
+  , raft_delta_heartbeats(
+      *this,
+      "raft_delta_heartbeats",
+      "Only send heartbeats of raft groups whose state changed since the last "
+      "heartbeat acknowledged by the follower, heartbeats of the other groups "
+      "are implied.",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      true)
+  , raft_append_entries_batch_max_bytes(
+      *this,
+      "raft_append_entries_batch_max_bytes",
+      "Append entries requests to the same node smaller than this size are "
+      "sent together in a single message of up to this size. 0 disables "
+      "batching.",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      128_KiB)
+  , raft_leader_lease(
+      *this,
+      "raft_leader_lease",
+      "Let raft leaders serve linearizable reads without a round of "
+      "heartbeats while a majority of the group acknowledged one of their "
+      "requests within an election timeout. Nodes then wait an election "
+      "timeout after starting before they vote, which delays elections "
+      "after restarts.",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      false)
+  , raft_leader_lease_max_clock_drift(
+      *this,
+      "raft_leader_lease_max_clock_drift",
+      "Bound of the relative drift between the clocks of the nodes, the "
+      "leader lease is shortened by this ratio of the election timeout.",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      0.05)
 
   , min_version(*this, "min_version")
   , max_version(*this, "max_version")
@@ -550,6 +583,17 @@ configuration::configuration()
       "How often do we trigger background compaction",
       {.needs_restart = needs_restart::no, .visibility = visibility::user},
       10s)
+  , log_compaction_max_concurrency(
+      *this,
+      "log_compaction_max_concurrency",
+      "Maximum number of logs compacted concurrently on each shard, logs are "
+      "compacted in order of how much compaction and retention have to do on "
+      "them",
+      {.needs_restart = needs_restart::no,
+       .example = "2",
+       .visibility = visibility::tunable},
+      2,
+      {.min = 1, .max = 64})
   , retention_bytes(
       *this,
       "retention_bytes",
@@ -680,6 +724,34 @@ configuration::configuration()
       "one follower",
       {.visibility = visibility::tunable},
       16)
+  , raft_max_adaptive_append_requests_per_follower(
+      *this,
+      "raft_max_adaptive_append_requests_per_follower",
+      "Maximum number of concurrent append entries requests sent by leader to "
+      "one follower that replies within "
+      "raft_append_requests_target_latency_ms. The number of requests adapts "
+      "to the latency of the follower between "
+      "raft_max_concurrent_append_requests_per_follower and this limit. A "
+      "limit not larger than raft_max_concurrent_append_requests_per_follower "
+      "disables adaptation",
+      {.visibility = visibility::tunable},
+      64)
+  , raft_append_requests_target_latency_ms(
+      *this,
+      "raft_append_requests_target_latency_ms",
+      "Round trip latency of append entries requests, including the flush on "
+      "the follower, up to which more concurrent requests are sent to the "
+      "follower",
+      {.visibility = visibility::tunable},
+      50ms)
+  , raft_max_adaptive_append_requests_per_shard(
+      *this,
+      "raft_max_adaptive_append_requests_per_shard",
+      "Maximum number of append entries requests over "
+      "raft_max_concurrent_append_requests_per_follower that all raft groups "
+      "of a shard may have in flight to one node",
+      {.visibility = visibility::tunable},
+      256)
   , reclaim_min_size(
       *this,
       "reclaim_min_size",
@@ -783,6 +855,16 @@ configuration::configuration()
       "Maximum delay until buffered data is written",
       {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
       std::chrono::milliseconds(1s))
+  , segment_appender_write_coalesce_ms(
+      *this,
+      "segment_appender_write_coalesce_ms",
+      "Maximum time a flush of a segment may wait for more appends so that "
+      "they are written to disk together. Only used while appends to the "
+      "segment arrive more often than this, 0 disables coalescing",
+      {.needs_restart = needs_restart::no,
+       .example = "1",
+       .visibility = visibility::tunable},
+      0ms)
   , fetch_session_eviction_timeout_ms(
       *this,
       "fetch_session_eviction_timeout_ms",
@@ -850,6 +932,94 @@ configuration::configuration()
        .visibility = visibility::tunable},
       128_MiB,
       {.min = 16_MiB, .max = 100_GiB})
+  , storage_segment_index_memory(
+      *this,
+      "storage_segment_index_memory",
+      "Maximum number of bytes that may be used on each shard by the indexes "
+      "of closed segments. Indexes over the limit are paged out and loaded "
+      "again on demand",
+      {.needs_restart = needs_restart::no,
+       .example = "67108864",
+       .visibility = visibility::tunable},
+      64_MiB,
+      {.min = 1_MiB})
+  , log_compaction_use_sliding_window(
+      *this,
+      "log_compaction_use_sliding_window",
+      "Remove records superseded by later records of the same key across all "
+      "compacted segments of a partition, in addition to compaction within "
+      "a segment and between adjacent segments",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      true)
+  , storage_flush_coalesce_window_ms(
+      *this,
+      "storage_flush_coalesce_window_ms",
+      "Time for which flushes of segments are collected on each shard before "
+      "they are issued together. With 0 only flushes requested at the same "
+      "time are coalesced",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      0ms)
+  , storage_compaction_key_map_memory(
+      *this,
+      "storage_compaction_key_map_memory",
+      "Maximum number of bytes that may be used on each shard by the map of "
+      "the latest offset of every key built by sliding window compaction. "
+      "Each of the logs compacted concurrently gets an equal share of it",
+      {.needs_restart = needs_restart::no,
+       .example = "134217728",
+       .visibility = visibility::tunable},
+      128_MiB,
+      {.min = 16_MiB, .max = 100_GiB})
+  , storage_reader_fd_budget(
+      *this,
+      "storage_reader_fd_budget",
+      "Number of file descriptors each shard may keep open for reading "
+      "segments. Descriptors of segments that are not being read are kept "
+      "open up to this limit, least recently used ones are closed first",
+      {.needs_restart = needs_restart::no,
+       .example = "1024",
+       .visibility = visibility::tunable},
+      1024)
+  , storage_adaptive_read_ahead(
+      *this,
+      "storage_adaptive_read_ahead",
+      "Start log reads with a single read ahead and grow the read ahead and "
+      "read buffers of readers which keep reading sequentially, up to "
+      "storage_read_ahead_memory per shard. When disabled every read uses "
+      "storage_read_buffer_size and storage_read_readahead_count",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      true)
+  , storage_read_ahead_memory(
+      *this,
+      "storage_read_ahead_memory",
+      "Maximum number of bytes that may be used on each shard by the read "
+      "buffers of sequential readers beyond their initial ones",
+      {.needs_restart = needs_restart::no,
+       .example = "67108864",
+       .visibility = visibility::tunable},
+      64_MiB,
+      {.max = 10_GiB})
+  , storage_timequery_index(
+      *this,
+      "storage_timequery_index",
+      "Seek timequeries within a segment using the index of maximum batch "
+      "timestamps, which holds up with out of order timestamps. When "
+      "disabled timequeries read the segment from its beginning",
+      {.needs_restart = needs_restart::no, .visibility = visibility::tunable},
+      true)
+  , storage_tail_stream_bytes(
+      *this,
+      "storage_tail_stream_bytes",
+      "Maximum number of bytes of the most recently appended batches that "
+      "the partitions of each shard keep for their readers at the tail of the "
+      "log, which share them instead of each going through a log reader and "
+      "the batch cache. A partition only keeps batches while it has more than "
+      "one reader at the tail. 0 disables it",
+      {.needs_restart = needs_restart::no,
+       .example = "16777216",
+       .visibility = visibility::tunable},
+      16_MiB,
+      {.max = 1_GiB})
   , max_compacted_log_segment_size(
       *this,
       "max_compacted_log_segment_size",
@@ -1603,7 +1773,8 @@ configuration::configuration()
   , enable_rack_awareness(
       *this,
       "enable_rack_awareness",
-      "Enables rack-aware replica assignment",
+      "Enables rack-aware replica assignment and redirects consumers that "
+      "report their rack to the partition replica in the same rack",
       {.needs_restart = needs_restart::no, .visibility = visibility::user},
       false)
   , node_status_interval(
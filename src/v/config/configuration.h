@@ -77,6 +77,10 @@ struct configuration final : public config_store {
     bounded_property<std::chrono::milliseconds> raft_heartbeat_interval_ms;
     bounded_property<std::chrono::milliseconds> raft_heartbeat_timeout_ms;
     property<size_t> raft_heartbeat_disconnect_failures;
+    property<bool> raft_delta_heartbeats;
+    property<size_t> raft_append_entries_batch_max_bytes;
+    property<bool> raft_leader_lease;
+    property<double> raft_leader_lease_max_clock_drift;
     deprecated_property min_version;
     deprecated_property max_version;
     bounded_property<std::optional<size_t>> raft_max_recovery_memory;
@@ -128,6 +132,7 @@ struct configuration final : public config_store {
     // same as log.retention.ms in kafka
     retention_duration_property delete_retention_ms;
     property<std::chrono::milliseconds> log_compaction_interval_ms;
+    bounded_property<uint16_t> log_compaction_max_concurrency;
     // same as retention.size in kafka - TODO: size not implemented
     property<std::optional<size_t>> retention_bytes;
     property<int32_t> group_topic_partitions;
@@ -154,6 +159,9 @@ struct configuration final : public config_store {
     property<size_t> raft_learner_recovery_rate;
     property<std::optional<uint32_t>> raft_smp_max_non_local_requests;
     property<uint32_t> raft_max_concurrent_append_requests_per_follower;
+    property<uint32_t> raft_max_adaptive_append_requests_per_follower;
+    property<std::chrono::milliseconds> raft_append_requests_target_latency_ms;
+    property<uint32_t> raft_max_adaptive_append_requests_per_shard;
 
     property<size_t> reclaim_min_size;
     property<size_t> reclaim_max_size;
@@ -173,6 +181,7 @@ struct configuration final : public config_store {
       raft_transfer_leader_recovery_timeout_ms;
     property<bool> release_cache_on_segment_roll;
     property<std::chrono::milliseconds> segment_appender_flush_timeout_ms;
+    property<std::chrono::milliseconds> segment_appender_write_coalesce_ms;
     property<std::chrono::milliseconds> fetch_session_eviction_timeout_ms;
     bounded_property<size_t> append_chunk_size;
     property<size_t> storage_read_buffer_size;
@@ -181,6 +190,15 @@ struct configuration final : public config_store {
     bounded_property<uint64_t> storage_target_replay_bytes;
     bounded_property<uint64_t> storage_max_concurrent_replay;
     bounded_property<uint64_t> storage_compaction_index_memory;
+    bounded_property<size_t> storage_segment_index_memory;
+    property<bool> log_compaction_use_sliding_window;
+    property<std::chrono::milliseconds> storage_flush_coalesce_window_ms;
+    bounded_property<size_t> storage_compaction_key_map_memory;
+    property<size_t> storage_reader_fd_budget;
+    property<bool> storage_adaptive_read_ahead;
+    bounded_property<size_t> storage_read_ahead_memory;
+    property<bool> storage_timequery_index;
+    bounded_property<size_t> storage_tail_stream_bytes;
     property<size_t> max_compacted_log_segment_size;
     property<int16_t> id_allocator_log_capacity;
     property<int16_t> id_allocator_batch_size;
@@ -332,7 +350,7 @@ struct configuration final : public config_store {
 
     property<bool> features_auto_enable;
 
-    // enables rack aware replica assignment
+    // enables rack aware replica assignment and follower fetching
     property<bool> enable_rack_awareness;
 
     property<std::chrono::milliseconds> node_status_interval;
@@ -57,6 +57,10 @@ std::string_view to_string_view(feature f) {
         return "tm_stm_cache";
     case feature::kafka_gssapi:
         return "kafka_gssapi";
+    case feature::raft_append_entries_batching:
+        return "raft_append_entries_batching";
+    case feature::follower_fetching:
+        return "follower_fetching";
     case feature::test_alpha:
         return "__test_alpha";
     case feature::test_bravo:
@@ -98,7 +102,7 @@ std::string_view to_string_view(feature_state::state s) {
 // bumps, this is _not_ the intended usage, as stable branches are
 // meant to be safely downgradable within the branch, and new features
 // imply that new data formats may be written.
-static constexpr cluster_version latest_version = cluster_version{9};
+static constexpr cluster_version latest_version = cluster_version{10};
 
 feature_table::feature_table() {
     // Intentionally undocumented environment variable, only for use
@@ -49,6 +49,8 @@ enum class feature : std::uint64_t {
     seeds_driven_bootstrap_capable = 1ULL << 15U,
     tm_stm_cache = 1ULL << 16U,
     kafka_gssapi = 1ULL << 17U,
+    raft_append_entries_batching = 1ULL << 18U,
+    follower_fetching = 1ULL << 19U,
 
     // Dummy features for testing only
     test_alpha = 1ULL << 62U,
@@ -210,6 +212,18 @@ constexpr static std::array feature_schema{
     feature::kafka_gssapi,
     feature_spec::available_policy::explicit_only,
     feature_spec::prepare_policy::always},
+  feature_spec{
+    cluster::cluster_version{10},
+    "raft_append_entries_batching",
+    feature::raft_append_entries_batching,
+    feature_spec::available_policy::always,
+    feature_spec::prepare_policy::always},
+  feature_spec{
+    cluster::cluster_version{10},
+    "follower_fetching",
+    feature::follower_fetching,
+    feature_spec::available_policy::always,
+    feature_spec::prepare_policy::always},
 
   // For testing, a feature that does not auto-activate
   feature_spec{
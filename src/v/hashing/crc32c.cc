@@ -0,0 +1,73 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "hashing/crc32c.h"
+
+#include <array>
+
+// adapted from crc32_combine of zlib, operating on the reflected castagnoli
+// polynomial
+
+namespace crc {
+
+namespace {
+
+constexpr uint32_t castagnoli_reflected = 0x82f63b78;
+
+/// a * b modulo the polynomial, bit 31 of both being the x^0 coefficient
+constexpr uint32_t multmodp(uint32_t a, uint32_t b) {
+    uint32_t m = uint32_t(1) << 31;
+    uint32_t p = 0;
+    while (true) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) {
+                break;
+            }
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ castagnoli_reflected : b >> 1;
+    }
+    return p;
+}
+
+/// x^(2^n) modulo the polynomial
+constexpr std::array<uint32_t, 32> x2n_table = [] {
+    std::array<uint32_t, 32> t{};
+    uint32_t p = uint32_t(1) << 30; // x^1
+    t[0] = p;
+    for (size_t n = 1; n < t.size(); ++n) {
+        p = multmodp(p, p);
+        t[n] = p;
+    }
+    return t;
+}();
+
+/// x^(8 * len) modulo the polynomial, i.e. the operator appending len zero
+/// bytes to a message
+uint32_t x8nmodp(size_t len) {
+    uint32_t p = uint32_t(1) << 31; // x^0
+    size_t k = 3;
+    while (len) {
+        if (len & 1) {
+            p = multmodp(x2n_table[k & 31], p);
+        }
+        len >>= 1;
+        ++k;
+    }
+    return p;
+}
+
+} // namespace
+
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2) {
+    return multmodp(x8nmodp(len2), crc1) ^ crc2;
+}
+
+} // namespace crc
@@ -41,6 +41,10 @@ private:
     uint32_t _crc = 0;
 };
 
+/// \brief crc32c of the concatenation of two buffers given the crc32c of each
+/// of them and the length of the second one, without looking at the data.
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2);
+
 } // namespace crc
 
 inline void crc_extend_iobuf(crc::crc32c& crc, const iobuf& buf) {
@@ -0,0 +1,46 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#define BOOST_TEST_MODULE crc32c
+#include "hashing/crc32c.h"
+
+#include <boost/test/unit_test.hpp>
+
+#include <string_view>
+
+namespace {
+uint32_t crc_of(std::string_view s) {
+    crc::crc32c c;
+    c.extend(s.data(), s.size());
+    return c.value();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(combine_same_as_concatenation) {
+    const std::string_view data
+      = "the quick brown fox jumps over the lazy dog, over and over again";
+    for (size_t split = 0; split <= data.size(); ++split) {
+        const auto a = data.substr(0, split);
+        const auto b = data.substr(split);
+        BOOST_REQUIRE_EQUAL(
+          crc::crc32c_combine(crc_of(a), crc_of(b), b.size()), crc_of(data));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(combine_replaces_prefix) {
+    // the crc of a message with a different prefix of the same length can be
+    // derived from the crcs of both prefixes and the length of the suffix
+    const std::string_view suffix = "records payload which is not rehashed";
+    const std::string old_msg = std::string("prefix-1") + std::string(suffix);
+    const std::string new_msg = std::string("prefix-2") + std::string(suffix);
+    BOOST_REQUIRE_EQUAL(
+      crc::crc32c_combine(
+        crc_of("prefix-1") ^ crc_of("prefix-2"), crc_of(old_msg), suffix.size()),
+      crc_of(new_msg));
+}
@@ -46,6 +46,27 @@ public:
              labels,
              [this] { return _produce_latency.seastar_histogram_logform(); })
              .aggregate(aggregate_labels)});
+
+        _metrics.add_group(
+          prometheus_sanitize::metrics_name("kafka:fetch"),
+          {sm::make_counter(
+             "empty_read_passes",
+             [this] { return _fetch_empty_read_passes; },
+             sm::description(
+               "Number of repeated fetch read passes that returned no data"))
+             .aggregate(aggregate_labels),
+           sm::make_counter(
+             "waits",
+             [this] { return _fetch_waits; },
+             sm::description("Number of times a fetch waited for partition "
+                             "high watermark changes"))
+             .aggregate(aggregate_labels),
+           sm::make_counter(
+             "wait_timeouts",
+             [this] { return _fetch_wait_timeouts; },
+             sm::description("Number of fetch waits that ended without any "
+                             "partition high watermark change"))
+             .aggregate(aggregate_labels)});
     }
 
     void setup_public_metrics() {
@@ -84,7 +105,14 @@ public:
         return _fetch_latency.auto_measure();
     }
 
+    void fetch_empty_read_pass() { ++_fetch_empty_read_passes; }
+    void fetch_wait() { ++_fetch_waits; }
+    void fetch_wait_timeout() { ++_fetch_wait_timeouts; }
+
 private:
+    uint64_t _fetch_empty_read_passes{0};
+    uint64_t _fetch_waits{0};
+    uint64_t _fetch_wait_timeouts{0};
     hdr_hist _produce_latency;
     hdr_hist _fetch_latency;
     ss::metrics::metric_groups _metrics;
@@ -13,6 +13,7 @@
 #include "cluster/partition_manager.h"
 #include "cluster/shard_table.h"
 #include "config/configuration.h"
+#include "features/feature_table.h"
 #include "kafka/protocol/batch_consumer.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/protocol/fetch.h"
@@ -20,6 +21,7 @@
 #include "kafka/server/handlers/details/leader_epoch.h"
 #include "kafka/server/handlers/fetch/fetch_plan_executor.h"
 #include "kafka/server/handlers/fetch/fetch_planner.h"
+#include "kafka/server/logger.h"
 #include "kafka/server/materialized_partition.h"
 #include "kafka/server/partition_proxy.h"
 #include "kafka/server/replicated_partition.h"
@@ -33,6 +35,7 @@
 #include "storage/parser_utils.h"
 #include "utils/to_string.h"
 
+#include <seastar/core/abort_source.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/sleep.hh>
@@ -43,6 +46,7 @@
 #include <fmt/ostream.h>
 
 #include <chrono>
+#include <exception>
 #include <string_view>
 
 namespace kafka {
@@ -158,7 +162,15 @@ static ss::future<read_result> do_read_from_ntp(
         co_return read_result(error_code::unknown_topic_or_partition);
     }
     if (unlikely(!kafka_partition->is_leader())) {
-        co_return read_result(error_code::not_leader_for_partition);
+        /**
+         * followers serve the committed part of the log to consumers aware of
+         * preferred read replicas. for more details see KIP-392
+         */
+        if (
+          !ntp_config.cfg.read_from_follower
+          || !kafka_partition->may_serve_follower_reads()) {
+            co_return read_result(error_code::not_leader_for_partition);
+        }
     }
 
     /**
@@ -169,6 +181,26 @@ static ss::future<read_result> do_read_from_ntp(
     if (leader_epoch_err != error_code::none) {
         co_return read_result(leader_epoch_err);
     }
+
+    /**
+     * redirect the consumer to the replica in its rack if the replica is
+     * caught up, the leader only reports the partition offsets
+     */
+    if (
+      ntp_config.cfg.preferred_read_replica && kafka_partition->is_leader()
+      && kafka_partition->is_replica_in_sync(
+        *ntp_config.cfg.preferred_read_replica)) {
+        auto lso = kafka_partition->last_stable_offset();
+        if (unlikely(!lso)) {
+            co_return read_result(lso.error());
+        }
+        read_result res(
+          kafka_partition->start_offset(),
+          kafka_partition->high_watermark(),
+          lso.value());
+        res.preferred_read_replica = ntp_config.cfg.preferred_read_replica;
+        co_return res;
+    }
     auto offset_ec = co_await kafka_partition->validate_fetch_offset(
       ntp_config.cfg.start_offset,
       default_fetch_timeout + model::timeout_clock::now());
@@ -223,6 +255,7 @@ ss::future<read_result> read_from_ntp(
 }
 
 static void fill_fetch_responses(
+  ss::shard_id shard,
   op_context& octx,
   std::vector<read_result> results,
   std::vector<op_context::response_placeholder_ptr> responses,
@@ -243,14 +276,38 @@ static void fill_fetch_responses(
 
         model::ntp ntp(
           model::kafka_namespace, resp_it->topic(), resp_it->partition_id());
+
+        if (res.preferred_read_replica) {
+            // consumer is redirected, it will not wait for the partition
+            fetch_response::partition_response resp;
+            resp.partition_index = res.partition;
+            resp.error_code = error_code::none;
+            resp.log_start_offset = res.start_offset;
+            resp.high_watermark = res.high_watermark;
+            resp.last_stable_offset = res.last_stable_offset;
+            resp.preferred_read_replica = *res.preferred_read_replica;
+            resp.records = batch_reader();
+            resp_it->set(std::move(resp));
+            metric = nullptr;
+            continue;
+        }
+
         /**
          * Cache fetch metadata
          */
         octx.rctx.get_fetch_metadata_cache().insert_or_assign(
-          std::move(ntp),
+          ntp,
           res.start_offset,
           res.high_watermark,
           res.last_stable_offset);
+        /**
+         * If the fetch has to be retried it waits until the high watermark of
+         * any of the successfully read partitions changes.
+         */
+        octx.wait_targets[shard].push_back(fetch_wait_target{
+          .ntp = ntp,
+          .high_watermark = res.high_watermark,
+          .last_stable_offset = res.last_stable_offset});
         /**
          * Over response budget, we will just waste this read, it will cause
          * data to be stored in the cache so next read is fast
@@ -386,11 +443,16 @@ handle_shard_fetch(ss::shard_id shard, op_context& octx, shard_fetch fetch) {
               foreign_read,
               deadline);
         })
-      .then([responses = std::move(fetch.responses),
+      .then([shard,
+             responses = std::move(fetch.responses),
              metrics = std::move(fetch.metrics),
              &octx](std::vector<read_result> results) mutable {
           fill_fetch_responses(
-            octx, std::move(results), std::move(responses), std::move(metrics));
+            shard,
+            octx,
+            std::move(results),
+            std::move(responses),
+            std::move(metrics));
       });
 }
 
@@ -414,6 +476,36 @@ class parallel_fetch_plan_executor final : public fetch_plan_executor::impl {
     }
 };
 
+/**
+ * Returns the replica in the consumer rack if the partition leader is not in
+ * the consumer rack itself. Whether this node still leads the partition and
+ * the replica is caught up is verified on the partition shard when the fetch
+ * is executed.
+ */
+static std::optional<model::node_id>
+select_preferred_read_replica(const op_context& octx, const model::ntp& ntp) {
+    if (!octx.consumer_rack) {
+        return std::nullopt;
+    }
+    const auto& md_cache = octx.rctx.metadata_cache();
+    auto leader = md_cache.get_leader_id(ntp);
+    if (!leader || md_cache.get_node_rack_id(*leader) == octx.consumer_rack) {
+        return std::nullopt;
+    }
+    auto assignment = md_cache.get_partition_assignment(ntp);
+    if (!assignment) {
+        return std::nullopt;
+    }
+    for (const auto& bs : assignment->replicas) {
+        if (
+          bs.node_id != *leader
+          && md_cache.get_node_rack_id(bs.node_id) == octx.consumer_rack) {
+            return bs.node_id;
+        }
+    }
+    return std::nullopt;
+}
+
 class simple_fetch_planner final : public fetch_planner::impl {
     fetch_plan create_plan(op_context& octx) final {
         fetch_plan plan(ss::smp::count);
@@ -492,6 +584,9 @@ class simple_fetch_planner final : public fetch_planner::impl {
                 .strict_max_bytes = octx.response_size > 0,
                 .skip_read = bytes_left_in_plan == 0 && max_bytes == 0,
                 .current_leader_epoch = fp.current_leader_epoch,
+                .read_from_follower = octx.follower_fetching,
+                .preferred_read_replica = select_preferred_read_replica(
+                  octx, ntp),
               };
 
               plan.fetches_per_shard[*shard].push_back(
@@ -529,24 +624,178 @@ class simple_fetch_planner final : public fetch_planner::impl {
  * order as the partitions in the request.
  */
 
+
+/**
+ * Waits for any of the partitions from a single shard to change its high
+ * watermark. Executed on the partitions home shard. The abort source is shared
+ * by all the partition waits so that the first one to finish releases the
+ * others and is also used by the fetch home shard to cancel the wait when
+ * other shard observed a change first.
+ */
+static ss::future<> wait_for_shard_updates(
+  cluster::partition_manager& cluster_pm,
+  coproc::partition_manager& coproc_pm,
+  std::vector<fetch_wait_target> targets,
+  bool read_from_follower,
+  model::timeout_clock::time_point deadline,
+  ss::abort_source& as) {
+    std::vector<partition_proxy> partitions;
+    partitions.reserve(targets.size());
+    for (const auto& t : targets) {
+        auto p = make_partition_proxy(t.ntp, cluster_pm, coproc_pm);
+        if (
+          !p
+          || !(
+            p->is_leader()
+            || (read_from_follower && p->may_serve_follower_reads()))) {
+            // partition state changed, let the next read pass report it
+            co_return;
+        }
+        partitions.push_back(std::move(*p));
+    }
+
+    const auto debounce_deadline
+      = model::timeout_clock::now()
+        + config::shard_local_cfg().fetch_reads_debounce_timeout();
+
+    std::vector<ss::future<>> waits;
+    waits.reserve(partitions.size());
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        auto& t = targets[i];
+        auto p_deadline = deadline;
+        /**
+         * Last stable offset is not announced, when it lags behind the high
+         * watermark it may advance without the high watermark being changed.
+         * Fall back to the debounce timeout in this case.
+         */
+        if (t.last_stable_offset < t.high_watermark) {
+            p_deadline = std::min(p_deadline, debounce_deadline);
+        }
+        waits.push_back(
+          partitions[i]
+            .wait_for_high_watermark_change(t.high_watermark, p_deadline, as)
+            .handle_exception([](const std::exception_ptr&) {
+                // timeouts and aborts are expected
+            })
+            .finally([&as] {
+                if (!as.abort_requested()) {
+                    as.request_abort();
+                }
+            }));
+    }
+    co_await ss::when_all(waits.begin(), waits.end());
+}
+
+/**
+ * Parks the fetch until one of the partitions read in the last pass has its
+ * high watermark changed or the fetch deadline is
+ * reached. Waiters are registered on the partitions home shards, the first
+ * shard to observe a change cancels the waits on all the other shards.
+ */
+static ss::future<> wait_for_partition_updates(op_context& octx) {
+    auto targets = std::exchange(
+      octx.wait_targets,
+      std::vector<std::vector<fetch_wait_target>>(ss::smp::count));
+    std::vector<ss::shard_id> shards;
+    for (ss::shard_id s = 0; s < targets.size(); ++s) {
+        if (!targets[s].empty()) {
+            shards.push_back(s);
+        }
+    }
+
+    if (shards.empty()) {
+        // nothing to wait on, debounce next read retry
+        co_await ss::sleep(std::min(
+          config::shard_local_cfg().fetch_reads_debounce_timeout(),
+          octx.request.data.max_wait_ms));
+        co_return;
+    }
+
+    const auto deadline = octx.deadline.value_or(
+      model::timeout_clock::now() + octx.request.data.max_wait_ms);
+    octx.rctx.probe().fetch_wait();
+
+    using abort_source_ptr = ss::foreign_ptr<std::unique_ptr<ss::abort_source>>;
+    std::vector<abort_source_ptr> abort_sources;
+    abort_sources.reserve(shards.size());
+    for (auto s : shards) {
+        abort_sources.push_back(co_await ss::smp::submit_to(s, [] {
+            return ss::make_foreign(std::make_unique<ss::abort_source>());
+        }));
+    }
+
+    ss::promise<> woken;
+    bool notified = false;
+    std::vector<ss::future<>> waits;
+    waits.reserve(shards.size());
+    for (size_t i = 0; i < shards.size(); ++i) {
+        waits.push_back(
+          octx.rctx.partition_manager()
+            .invoke_on(
+              shards[i],
+              octx.ssg,
+              [&octx,
+               deadline,
+               as = abort_sources[i].get(),
+               t = std::move(targets[shards[i]])](
+                cluster::partition_manager& mgr) mutable {
+                  return wait_for_shard_updates(
+                    mgr,
+                    octx.rctx.coproc_partition_manager().local(),
+                    std::move(t),
+                    octx.follower_fetching,
+                    deadline,
+                    *as);
+              })
+            .handle_exception([](const std::exception_ptr& e) {
+                vlog(klog.debug, "error waiting for fetch updates - {}", e);
+            })
+            .finally([&woken, &notified] {
+                if (!notified) {
+                    notified = true;
+                    woken.set_value();
+                }
+            }));
+    }
+
+    co_await woken.get_future();
+    if (model::timeout_clock::now() >= deadline) {
+        octx.rctx.probe().fetch_wait_timeout();
+    }
+
+    co_await ss::parallel_for_each(
+      boost::irange<size_t>(0, shards.size()),
+      [&shards, &abort_sources](size_t i) {
+          return ss::smp::submit_to(
+            shards[i], [as = abort_sources[i].get()] {
+                if (!as->abort_requested()) {
+                    as->request_abort();
+                }
+            });
+      });
+    co_await ss::when_all(waits.begin(), waits.end());
+}
+
 static ss::future<> fetch_topic_partitions(op_context& octx) {
     auto planner = make_fetch_planner<simple_fetch_planner>();
 
     auto fetch_plan = planner.create_plan(octx);
 
+    const auto response_size_before = octx.response_size;
     fetch_plan_executor executor
       = make_fetch_plan_executor<parallel_fetch_plan_executor>();
     co_await executor.execute_plan(octx, std::move(fetch_plan));
 
+    if (!octx.initial_fetch && octx.response_size == response_size_before) {
+        octx.rctx.probe().fetch_empty_read_pass();
+    }
+
     if (octx.should_stop_fetch()) {
         co_return;
     }
 
     octx.reset_context();
-    // debounce next read retry
-    co_await ss::sleep(std::min(
-      config::shard_local_cfg().fetch_reads_debounce_timeout(),
-      octx.request.data.max_wait_ms));
+    co_await wait_for_partition_updates(octx);
 }
 
 template<>
@@ -603,6 +852,18 @@ op_context::op_context(request_context&& ctx, ss::smp_service_group ssg)
       config::shard_local_cfg().fetch_max_bytes(),
       size_t(request.data.max_bytes));
     session_ctx = rctx.fetch_sessions().maybe_get_session(request);
+    wait_targets.resize(ss::smp::count);
+
+    if (
+      rctx.header().version >= api_version(11)
+      && config::shard_local_cfg().enable_rack_awareness()
+      && rctx.feature_table().local().is_active(
+        features::feature::follower_fetching)) {
+        follower_fetching = true;
+        if (!request.data.rack_id.empty()) {
+            consumer_rack = model::rack_id(request.data.rack_id);
+        }
+    }
     create_response_placeholders();
 }
 
@@ -677,6 +938,10 @@ bool update_fetch_partition(
         include = true;
         partition.last_stable_offset = model::offset(resp.last_stable_offset);
     }
+    if (resp.preferred_read_replica != model::unassigned_node_id) {
+        // Redirected partitions are always included in the response.
+        include = true;
+    }
     if (include) {
         return include;
     }
@@ -722,6 +987,8 @@ ss::future<response_ptr> op_context::send_response() && {
           .last_stable_offset = it->partition_response->last_stable_offset,
           .log_start_offset = it->partition_response->log_start_offset,
           .aborted = std::move(it->partition_response->aborted),
+          .preferred_read_replica
+          = it->partition_response->preferred_read_replica,
           .records = std::move(it->partition_response->records)};
 
         final_response.data.topics.back().partitions.push_back(std::move(r));
@@ -747,6 +1014,9 @@ void op_context::response_placeholder::set(
     if (response.error_code != error_code::none) {
         _ctx->response_error = true;
     }
+    if (response.preferred_read_replica != model::unassigned_node_id) {
+        _ctx->has_preferred_read_replica = true;
+    }
     auto& current_resp_data = _it->partition_response->records;
     if (current_resp_data) {
         auto sz = current_resp_data->size_bytes();
@@ -13,12 +13,25 @@
 #include "kafka/protocol/fetch.h"
 #include "kafka/server/handlers/handler.h"
 #include "kafka/types.h"
+#include "model/metadata.h"
 #include "utils/intrusive_list_helpers.h"
+#include "utils/to_string.h"
 
 namespace kafka {
 
 using fetch_handler = single_stage_handler<fetch_api, 4, 11>;
 
+/**
+ * Partition read in the last read pass together with the offsets observed by
+ * that read. A fetch that has to wait for more data is parked until the high
+ * watermark of any of those partitions changes.
+ */
+struct fetch_wait_target {
+    model::ntp ntp;
+    model::offset high_watermark;
+    model::offset last_stable_offset;
+};
+
 /*
  * Fetch operation context
  */
@@ -97,6 +110,7 @@ struct op_context {
     bool should_stop_fetch() const {
         return !request.debounce_delay() || over_min_bytes()
                || is_empty_request() || response_error
+               || has_preferred_read_replica
                || deadline <= model::timeout_clock::now();
     }
 
@@ -154,10 +168,22 @@ struct op_context {
     size_t response_size;
     // does the response contain an error
     bool response_error;
+    // does the response redirect the consumer to other replica
+    bool has_preferred_read_replica{false};
+
+    /**
+     * Consumers aware of preferred read replicas (KIP-392) may fetch from
+     * followers and, when they report their rack, are redirected to the
+     * replica in the same rack.
+     */
+    bool follower_fetching{false};
+    std::optional<model::rack_id> consumer_rack;
 
     bool initial_fetch = true;
     fetch_session_ctx session_ctx;
     iteration_order_t iteration_order;
+    // partitions to wait on before the next read pass, indexed by shard
+    std::vector<std::vector<fetch_wait_target>> wait_targets;
 };
 
 struct fetch_config {
@@ -169,17 +195,23 @@ struct fetch_config {
     bool strict_max_bytes{false};
     bool skip_read{false};
     kafka::leader_epoch current_leader_epoch;
+    // allows the fetch to be served by a follower
+    bool read_from_follower{false};
+    // replica the leader redirects the consumer to, if it is in sync
+    std::optional<model::node_id> preferred_read_replica;
 
     friend std::ostream& operator<<(std::ostream& o, const fetch_config& cfg) {
         fmt::print(
           o,
-          R"({{"start_offset": {}, "max_offset": {}, "isolation_lvl": {}, "max_bytes": {}, "strict_max_bytes": {}, "current_leader_epoch:" {}}})",
+          R"({{"start_offset": {}, "max_offset": {}, "isolation_lvl": {}, "max_bytes": {}, "strict_max_bytes": {}, "current_leader_epoch:" {}, "read_from_follower": {}, "preferred_read_replica": {}}})",
           cfg.start_offset,
           cfg.max_offset,
           cfg.isolation_level,
           cfg.max_bytes,
           cfg.strict_max_bytes,
-          cfg.current_leader_epoch);
+          cfg.current_leader_epoch,
+          cfg.read_from_follower,
+          cfg.preferred_read_replica);
         return o;
     }
 };
@@ -271,6 +303,7 @@ struct read_result {
     error_code error;
     model::partition_id partition;
     std::vector<cluster::rm_stm::tx_range> aborted_transactions;
+    std::optional<model::node_id> preferred_read_replica;
 };
 // struct aggregating fetch requests and corresponding response iterators for
 // the same shard
@@ -10,6 +10,7 @@
  */
 #pragma once
 #include "cluster/partition_probe.h"
+#include "config/configuration.h"
 #include "coproc/partition.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/server/partition_proxy.h"
@@ -18,6 +19,8 @@
 #include "raft/errc.h"
 #include "storage/log.h"
 
+#include <seastar/core/sleep.hh>
+
 #include <system_error>
 
 namespace kafka {
@@ -48,6 +51,11 @@ public:
 
     bool is_leader() const final { return _partition->is_leader(); }
 
+    // materialized logs are not replicated
+    bool may_serve_follower_reads() const final { return false; }
+
+    bool is_replica_in_sync(model::node_id) const final { return false; }
+
     kafka::leader_epoch leader_epoch() const final {
         return leader_epoch_from_term(_partition->term());
     }
@@ -96,6 +104,18 @@ public:
           : error_code::offset_out_of_range;
     }
 
+    ss::future<> wait_for_high_watermark_change(
+      model::offset observed,
+      model::timeout_clock::time_point,
+      ss::abort_source& as) final {
+        if (high_watermark() != observed) {
+            return ss::now();
+        }
+        // materialized logs do not publish offset notifications, poll
+        return ss::sleep_abortable(
+          config::shard_local_cfg().fetch_reads_debounce_timeout(), as);
+    }
+
 private:
     static model::offset offset_or_zero(model::offset o) {
         return o > model::offset(0) ? o : model::offset(0);
@@ -41,6 +41,8 @@ public:
           get_leader_epoch_last_offset(kafka::leader_epoch) const = 0;
         virtual bool is_elected_leader() const = 0;
         virtual bool is_leader() const = 0;
+        virtual bool may_serve_follower_reads() const = 0;
+        virtual bool is_replica_in_sync(model::node_id) const = 0;
         virtual ss::future<std::error_code> linearizable_barrier() = 0;
         virtual ss::future<storage::translating_reader> make_reader(
           storage::log_reader_config,
@@ -57,6 +59,9 @@ public:
         virtual ss::future<error_code>
           validate_fetch_offset(model::offset, model::timeout_clock::time_point)
           = 0;
+        virtual ss::future<> wait_for_high_watermark_change(
+          model::offset, model::timeout_clock::time_point, ss::abort_source&)
+          = 0;
         virtual cluster::partition_probe& probe() = 0;
         virtual ~impl() noexcept = default;
     };
@@ -80,6 +85,23 @@ public:
 
     bool is_leader() const { return _impl->is_leader(); }
 
+    /**
+     * Returns true if the replica is a follower that can serve consumer
+     * fetches. Followers expose only the batches known to be committed, the
+     * offsets reported and read by the proxy are limited accordingly.
+     */
+    bool may_serve_follower_reads() const {
+        return _impl->may_serve_follower_reads();
+    }
+
+    /**
+     * Returns true if the replica on the given node is live and caught up with
+     * the leader. Always false when the partition is not a leader.
+     */
+    bool is_replica_in_sync(model::node_id id) const {
+        return _impl->is_replica_in_sync(id);
+    }
+
     const model::ntp& ntp() const { return _impl->ntp(); }
 
     ss::future<std::vector<cluster::rm_stm::tx_range>> aborted_transactions(
@@ -114,6 +136,18 @@ public:
         return _impl->validate_fetch_offset(o, deadline);
     }
 
+    /**
+     * Resolves when the high watermark differs from the `observed` one, when
+     * the deadline is reached or when the abort source fires. Timeouts and
+     * aborts are reported as exceptional futures.
+     */
+    ss::future<> wait_for_high_watermark_change(
+      model::offset observed,
+      model::timeout_clock::time_point deadline,
+      ss::abort_source& as) {
+        return _impl->wait_for_high_watermark_change(observed, deadline, as);
+    }
+
 private:
     std::unique_ptr<impl> _impl;
 };
@@ -12,6 +12,7 @@
 
 #include "cloud_storage/types.h"
 #include "cluster/errc.h"
+#include "config/configuration.h"
 #include "kafka/protocol/errors.h"
 #include "kafka/server/logger.h"
 #include "kafka/types.h"
@@ -24,6 +25,7 @@
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
+#include <seastar/core/sleep.hh>
 
 #include <optional>
 
@@ -49,6 +51,13 @@ ss::future<storage::translating_reader> replicated_partition::make_reader(
         co_return co_await _partition->make_cloud_reader(cfg);
     }
 
+    if (!_partition->is_leader()) {
+        // the raft reader is limited by the last visible offset, followers
+        // only expose the batches known to be committed
+        cfg.max_offset = std::min(
+          cfg.max_offset, model::prev_offset(high_watermark()));
+    }
+
     if (
       may_read_from_cloud(model::offset_cast(cfg.start_offset))
       && cfg.start_offset >= _partition->start_cloud_offset()) {
@@ -318,6 +327,19 @@ ss::future<error_code> replicated_partition::validate_fetch_offset(
     const auto log_end = model::next_offset(
       _translator->from_log_offset(_partition->dirty_offset()));
 
+    if (!_partition->is_leader()) {
+        /**
+         * Follower may lag behind the leader the consumer was redirected from,
+         * an offset past its log end is not out of range, the consumer has to
+         * retry until the follower catches up.
+         */
+        if (fetch_offset < start_offset()) {
+            co_return error_code::offset_out_of_range;
+        }
+        co_return fetch_offset > log_end ? error_code::offset_not_available
+                                         : error_code::none;
+    }
+
     while (fetch_offset > high_watermark() && fetch_offset <= log_end) {
         if (model::timeout_clock::now() > deadline) {
             break;
@@ -357,4 +379,30 @@ ss::future<error_code> replicated_partition::validate_fetch_offset(
       : error_code::offset_out_of_range;
 }
 
+ss::future<> replicated_partition::wait_for_high_watermark_change(
+  model::offset observed,
+  model::timeout_clock::time_point deadline,
+  ss::abort_source& as) {
+    if (high_watermark() != observed) {
+        return ss::now();
+    }
+    if (_partition->is_read_replica_mode_enabled()) {
+        // read replica high watermark follows the cloud manifest, there is no
+        // notification to wait on
+        return ss::sleep_abortable(
+          config::shard_local_cfg().fetch_reads_debounce_timeout(), as);
+    }
+    /**
+     * High watermark is expressed in kafka offsets while the monitor operates
+     * on raft offsets. Waiting for any change of the raft high watermark is
+     * enough, the caller re-validates the kafka offsets on wakeup.
+     */
+    if (!_partition->is_leader()) {
+        return _partition->wait_for_follower_high_watermark_past(
+          _partition->follower_high_watermark(), deadline, as);
+    }
+    return _partition->wait_for_high_watermark_past(
+      _partition->high_watermark(), deadline, as);
+}
+
 } // namespace kafka
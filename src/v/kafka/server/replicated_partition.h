@@ -63,6 +63,10 @@ public:
                 return model::offset(0);
             }
         }
+        if (!_partition->is_leader()) {
+            return _translator->from_log_offset(
+              _partition->follower_high_watermark());
+        }
         return _translator->from_log_offset(_partition->high_watermark());
     }
 
@@ -75,7 +79,9 @@ public:
                 return model::offset(0);
             }
         }
-        auto maybe_lso = _partition->last_stable_offset();
+        auto maybe_lso = _partition->is_leader()
+                           ? _partition->last_stable_offset()
+                           : _partition->follower_last_stable_offset();
         if (maybe_lso == model::invalid_lso) {
             return error_code::offset_not_available;
         }
@@ -88,6 +94,23 @@ public:
 
     bool is_leader() const final { return _partition->is_leader(); }
 
+    bool may_serve_follower_reads() const final {
+        if (_partition->is_read_replica_mode_enabled()) {
+            return false;
+        }
+        // stop serving reads once the follower lost track of the leader, e.g.
+        // when it is partitioned away and its commit index stops advancing
+        auto leader = _partition->get_leader_id();
+        return leader && *leader != _partition->raft()->self().id();
+    }
+
+    bool is_replica_in_sync(model::node_id id) const final {
+        auto metrics = _partition->get_follower_metrics(id);
+        return metrics && metrics.value().is_live
+               && !metrics.value().is_learner
+               && !metrics.value().under_replicated;
+    }
+
     ss::future<std::error_code> linearizable_barrier() final {
         auto r = co_await _partition->linearizable_barrier();
         if (r) {
@@ -128,6 +151,9 @@ public:
     ss::future<error_code> validate_fetch_offset(
       model::offset, model::timeout_clock::time_point) final;
 
+    ss::future<> wait_for_high_watermark_change(
+      model::offset, model::timeout_clock::time_point, ss::abort_source&) final;
+
 private:
     ss::future<std::vector<cluster::rm_stm::tx_range>>
       aborted_transactions_local(
@@ -7,6 +7,7 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "config/configuration.h"
 #include "kafka/protocol/batch_consumer.h"
 #include "kafka/server/handlers/fetch.h"
 #include "kafka/types.h"
@@ -15,7 +16,9 @@
 #include "resource_mgmt/io_priority.h"
 #include "test_utils/async.h"
 
+#include <seastar/core/sleep.hh>
 #include <seastar/core/smp.hh>
+#include <seastar/util/defer.hh>
 
 #include <fmt/ostream.h>
 
@@ -501,6 +504,76 @@ FIXTURE_TEST(fetch_one_debounce, redpanda_thread_fixture) {
     BOOST_REQUIRE(resp.data.topics[0].partitions[0].records->size_bytes() > 0);
 }
 
+FIXTURE_TEST(fetch_wakes_up_on_high_watermark_change, redpanda_thread_fixture) {
+    model::topic topic("foo");
+    model::partition_id pid(0);
+    model::offset offset(0);
+    auto ntp = make_default_ntp(topic, pid);
+
+    wait_for_controller_leadership().get0();
+
+    add_topic(model::topic_namespace_view(ntp)).get();
+    wait_for_partition_offset(ntp, model::offset(0)).get0();
+
+    // with a large debounce a polling fetch would not return before deadline
+    ss::smp::invoke_on_all([] {
+        config::shard_local_cfg().fetch_reads_debounce_timeout.set_value(
+          std::chrono::milliseconds(30000));
+    }).get();
+    auto reset_debounce = ss::defer([] {
+        ss::smp::invoke_on_all([] {
+            config::shard_local_cfg().fetch_reads_debounce_timeout.reset();
+        }).get();
+    });
+
+    kafka::fetch_request req;
+    req.data.max_bytes = std::numeric_limits<int32_t>::max();
+    req.data.min_bytes = 1;
+    req.data.max_wait_ms = std::chrono::milliseconds(30000);
+    req.data.session_id = kafka::invalid_fetch_session_id;
+    req.data.topics = {{
+      .name = topic,
+      .fetch_partitions = {{
+        .partition_index = pid,
+        .fetch_offset = offset,
+      }},
+    }};
+
+    auto client = make_kafka_client().get0();
+    client.connect().get();
+    auto start = ss::lowres_clock::now();
+    auto fresp = client.dispatch(req, kafka::api_version(4));
+    ss::sleep(100ms).get();
+    auto shard = app.shard_table.local().shard_for(ntp);
+    app.partition_manager
+      .invoke_on(
+        *shard,
+        [ntp](cluster::partition_manager& mgr) {
+            auto partition = mgr.get(ntp);
+            auto batches = model::test::make_random_batches(
+              model::offset(0), 5);
+            auto rdr = model::make_memory_record_batch_reader(
+              std::move(batches));
+            return partition->raft()->replicate(
+              std::move(rdr),
+              raft::replicate_options(raft::consistency_level::quorum_ack));
+        })
+      .discard_result()
+      .get0();
+
+    auto resp = fresp.get0();
+    auto elapsed = ss::lowres_clock::now() - start;
+    client.stop().then([&client] { client.shutdown(); }).get();
+
+    BOOST_REQUIRE_LT(elapsed, 10s);
+    BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+    BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+    BOOST_REQUIRE_EQUAL(
+      resp.data.topics[0].partitions[0].error_code, kafka::error_code::none);
+    BOOST_REQUIRE(resp.data.topics[0].partitions[0].records);
+    BOOST_REQUIRE_GT(resp.data.topics[0].partitions[0].records->size_bytes(), 0);
+}
+
 FIXTURE_TEST(fetch_multi_topics, redpanda_thread_fixture) {
     // create a topic partition with some data
     model::topic topic_1("foo");
@@ -0,0 +1,374 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#include "cluster/partition.h"
+#include "cluster/partition_manager.h"
+#include "cluster/shard_table.h"
+#include "cluster/tests/cluster_test_fixture.h"
+#include "cluster/tests/utils.h"
+#include "cluster/topics_frontend.h"
+#include "config/configuration.h"
+#include "features/feature_table.h"
+#include "kafka/client/transport.h"
+#include "kafka/protocol/fetch.h"
+#include "kafka/server/replicated_partition.h"
+#include "model/fundamental.h"
+#include "model/metadata.h"
+#include "model/tests/random_batch.h"
+#include "test_utils/async.h"
+#include "test_utils/fixture.h"
+
+#include <seastar/core/sleep.hh>
+#include <seastar/util/defer.hh>
+
+#include <chrono>
+#include <limits>
+
+using namespace std::chrono_literals;
+
+/**
+ * Three node cluster with every node in its own rack and a replica of the
+ * test partition on each node.
+ */
+class follower_fetch_fixture : public cluster_test_fixture {
+public:
+    static constexpr int node_count = 3;
+
+    follower_fetch_fixture() {
+        for (int i = 0; i < node_count; ++i) {
+            add_node_in_rack(model::node_id(i));
+        }
+        wait_for_all_members(10s).get();
+        set_configuration("enable_rack_awareness", true);
+        tests::cooperative_spin_wait_with_timeout(10s, [this] {
+            for (int i = 0; i < node_count; ++i) {
+                auto app = get_node_application(model::node_id(i));
+                if (!app->feature_table.local().is_active(
+                      features::feature::follower_fetching)) {
+                    return false;
+                }
+            }
+            return true;
+        }).get();
+
+        wait_for_controller_leadership(model::node_id(0)).get();
+        auto& topics = get_node_application(model::node_id(0))
+                         ->controller->get_topics_frontend();
+        auto res = topics.local()
+                     .autocreate_topics(
+                       {cluster::topic_configuration(
+                         ntp.ns, ntp.tp.topic, 1, node_count)},
+                       5s)
+                     .get0();
+        wait_for_metadata(
+          get_node_application(model::node_id(0))
+            ->controller->get_topics_state()
+            .local(),
+          res);
+
+        // the leader has to know that it leads the partition for the fetch
+        // planner to redirect consumers
+        tests::cooperative_spin_wait_with_timeout(10s, [this] {
+            return partition_leader().then(
+              [this](std::optional<model::node_id> leader) {
+                  return leader
+                         && get_local_cache(*leader).get_leader_id(ntp)
+                              == leader;
+              });
+        }).get();
+    }
+
+    ~follower_fetch_fixture() override {
+        ss::smp::invoke_on_all([] {
+            config::shard_local_cfg().enable_rack_awareness.reset();
+        }).get();
+    }
+
+    static model::rack_id rack_of(model::node_id id) {
+        return model::rack_id(ssx::sformat("rack-{}", id()));
+    }
+
+    void add_node_in_rack(model::node_id id) {
+        std::vector<config::seed_server> seeds;
+        if (id != model::node_id(0)) {
+            seeds.push_back(
+              {.addr = net::unresolved_address("127.0.0.1", 11000)});
+        }
+        add_node(
+          id,
+          9092 + id(),
+          11000 + id(),
+          8082 + id(),
+          8081 + id(),
+          43189 + id(),
+          std::move(seeds),
+          configure_node_id::yes,
+          empty_seed_starts_cluster::yes,
+          rack_of(id));
+    }
+
+    template<typename Func>
+    auto invoke_on_partition(model::node_id id, Func f) {
+        auto shard = get_shard_table(id).shard_for(ntp);
+        return get_partition_manager(id).invoke_on(
+          *shard,
+          [ntp = ntp, f = std::move(f)](cluster::partition_manager& pm) {
+              return f(pm.get(ntp));
+          });
+    }
+
+    ss::future<std::optional<model::node_id>> partition_leader() {
+        for (int i = 0; i < node_count; ++i) {
+            model::node_id id(i);
+            if (!get_shard_table(id).shard_for(ntp)) {
+                continue;
+            }
+            auto is_leader = co_await invoke_on_partition(
+              id, [](ss::lw_shared_ptr<cluster::partition> p) {
+                  return p && p->is_leader();
+              });
+            if (is_leader) {
+                co_return id;
+            }
+        }
+        co_return std::nullopt;
+    }
+
+    model::node_id follower_of(model::node_id leader) {
+        return model::node_id((leader() + 1) % node_count);
+    }
+
+    /// Kafka high watermark of the partition replica on the node, the
+    /// follower high watermark on followers.
+    ss::future<model::offset> high_watermark(model::node_id id) {
+        return invoke_on_partition(
+          id, [](ss::lw_shared_ptr<cluster::partition> p) {
+              return kafka::replicated_partition(std::move(p)).high_watermark();
+          });
+    }
+
+    void produce(model::node_id leader, int count) {
+        auto replicate = [count](ss::lw_shared_ptr<cluster::partition> p) {
+            auto rdr = model::make_memory_record_batch_reader(
+              model::test::make_random_batches(model::offset(0), count));
+            return p->raft()
+              ->replicate(
+                std::move(rdr),
+                raft::replicate_options(raft::consistency_level::quorum_ack))
+              .then([](result<raft::replicate_result> r) {
+                  return r.has_value();
+              });
+        };
+        BOOST_REQUIRE(invoke_on_partition(leader, replicate).get0());
+    }
+
+    ss::future<bool>
+    is_in_sync(model::node_id leader, model::node_id follower) {
+        return invoke_on_partition(
+          leader, [follower](ss::lw_shared_ptr<cluster::partition> p) {
+              auto m = p->get_follower_metrics(follower);
+              return m && m.value().is_live && !m.value().under_replicated;
+          });
+    }
+
+    kafka::fetch_request make_fetch_request(
+      model::offset offset,
+      std::optional<model::rack_id> rack,
+      std::chrono::milliseconds max_wait = 0ms) {
+        kafka::fetch_request req;
+        req.data.max_bytes = std::numeric_limits<int32_t>::max();
+        req.data.min_bytes = 1;
+        req.data.max_wait_ms = max_wait;
+        req.data.session_id = kafka::invalid_fetch_session_id;
+        req.data.session_epoch = kafka::final_fetch_session_epoch;
+        if (rack) {
+            req.data.rack_id = (*rack)();
+        }
+        req.data.topics = {{
+          .name = ntp.tp.topic,
+          .fetch_partitions = {{
+            .partition_index = ntp.tp.partition,
+            .fetch_offset = offset,
+          }},
+        }};
+        return req;
+    }
+
+    kafka::client::transport make_kafka_client(model::node_id id) {
+        return kafka::client::transport(
+          net::base_transport::configuration{
+            .server_addr = net::unresolved_address("127.0.0.1", 9092 + id()),
+          },
+          "test_client");
+    }
+
+    kafka::fetch_response::partition_response fetch(
+      model::node_id id,
+      model::offset offset,
+      std::optional<model::rack_id> rack,
+      kafka::api_version version = kafka::api_version(11)) {
+        auto client = make_kafka_client(id);
+        client.connect().get();
+        auto resp = client.dispatch(make_fetch_request(offset, rack), version)
+                      .get0();
+        client.stop().then([&client] { client.shutdown(); }).get();
+
+        BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+        BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+        return std::move(resp.data.topics[0].partitions[0]);
+    }
+
+    model::ntp ntp{
+      model::kafka_namespace,
+      model::topic("follower-fetch"),
+      model::partition_id(0)};
+};
+
+FIXTURE_TEST(
+  fetch_redirects_consumer_to_replica_in_its_rack, follower_fetch_fixture) {
+    auto leader = *partition_leader().get0();
+    auto follower = follower_of(leader);
+    produce(leader, 5);
+    tests::cooperative_spin_wait_with_timeout(10s, [this, leader, follower] {
+        return is_in_sync(leader, follower);
+    }).get();
+
+    auto p = fetch(leader, model::offset(0), rack_of(follower));
+    BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::none);
+    BOOST_REQUIRE_EQUAL(p.preferred_read_replica, follower);
+    BOOST_REQUIRE_EQUAL(p.high_watermark, high_watermark(leader).get0());
+    BOOST_REQUIRE(!p.records || p.records->empty());
+
+    // consumers not aware of preferred read replicas are served by the leader
+    p = fetch(
+      leader, model::offset(0), rack_of(follower), kafka::api_version(10));
+    BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::none);
+    BOOST_REQUIRE_EQUAL(p.preferred_read_replica, model::unassigned_node_id);
+    BOOST_REQUIRE(p.records && !p.records->empty());
+}
+
+FIXTURE_TEST(fetch_does_not_redirect_to_unknown_rack, follower_fetch_fixture) {
+    auto leader = *partition_leader().get0();
+    produce(leader, 5);
+
+    for (auto rack :
+         {model::rack_id("unknown-rack"), rack_of(leader), model::rack_id()}) {
+        auto p = fetch(leader, model::offset(0), rack);
+        BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::none);
+        BOOST_REQUIRE_EQUAL(
+          p.preferred_read_replica, model::unassigned_node_id);
+        BOOST_REQUIRE(p.records && !p.records->empty());
+    }
+}
+
+FIXTURE_TEST(
+  fetch_does_not_redirect_to_out_of_sync_replica, follower_fetch_fixture) {
+    auto leader = *partition_leader().get0();
+    auto follower = follower_of(leader);
+    produce(leader, 5);
+
+    remove_node_application(follower);
+    tests::cooperative_spin_wait_with_timeout(10s, [this, leader, follower] {
+        return is_in_sync(leader, follower).then([](bool s) { return !s; });
+    }).get();
+
+    auto p = fetch(leader, model::offset(0), rack_of(follower));
+    BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::none);
+    BOOST_REQUIRE_EQUAL(p.preferred_read_replica, model::unassigned_node_id);
+    BOOST_REQUIRE(p.records && !p.records->empty());
+}
+
+FIXTURE_TEST(
+  follower_fetch_is_capped_at_high_watermark, follower_fetch_fixture) {
+    auto leader = *partition_leader().get0();
+    auto follower = follower_of(leader);
+    produce(leader, 5);
+    tests::cooperative_spin_wait_with_timeout(10s, [this, follower] {
+        return high_watermark(follower).then(
+          [](model::offset hwm) { return hwm > model::offset(0); });
+    }).get();
+
+    for (int i = 0; i < 5; ++i) {
+        // the follower learns the commit index of the batches replicated
+        // last with the following requests of the leader
+        produce(leader, 5);
+        auto hwm_before = high_watermark(follower).get0();
+        auto p = fetch(follower, model::offset(0), std::nullopt);
+        auto hwm_after = high_watermark(follower).get0();
+
+        BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::none);
+        BOOST_REQUIRE_GE(p.high_watermark, hwm_before);
+        BOOST_REQUIRE_LE(p.high_watermark, hwm_after);
+        BOOST_REQUIRE(p.records && !p.records->empty());
+        BOOST_REQUIRE_LT(p.records->last_offset(), p.high_watermark);
+    }
+}
+
+FIXTURE_TEST(
+  follower_fetch_past_log_end_is_not_available, follower_fetch_fixture) {
+    auto leader = *partition_leader().get0();
+    auto follower = follower_of(leader);
+    produce(leader, 5);
+
+    // the consumer may be redirected to a follower that is behind the offset
+    // it already read from the leader
+    auto offset = high_watermark(leader).get0() + model::offset(1000);
+    auto p = fetch(follower, offset, std::nullopt);
+    BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::offset_not_available);
+
+    p = fetch(leader, offset, std::nullopt);
+    BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::offset_out_of_range);
+}
+
+FIXTURE_TEST(follower_fetch_wakes_up_on_commit_index, follower_fetch_fixture) {
+    auto leader = *partition_leader().get0();
+    auto follower = follower_of(leader);
+    produce(leader, 5);
+    tests::cooperative_spin_wait_with_timeout(10s, [this, leader, follower] {
+        return ss::when_all_succeed(
+                 high_watermark(leader), high_watermark(follower))
+          .then_unpack([](model::offset leader_hwm, model::offset hwm) {
+              return leader_hwm == hwm;
+          });
+    }).get();
+
+    // with a large debounce a polling fetch would not return before deadline
+    set_configuration(
+      "fetch_reads_debounce_timeout", std::chrono::milliseconds(30000));
+    auto reset_debounce = ss::defer([] {
+        ss::smp::invoke_on_all([] {
+            config::shard_local_cfg().fetch_reads_debounce_timeout.reset();
+        }).get();
+    });
+
+    auto client = make_kafka_client(follower);
+    client.connect().get();
+    auto start = ss::lowres_clock::now();
+    auto fresp = client.dispatch(
+      make_fetch_request(
+        high_watermark(follower).get0(), std::nullopt, 30000ms),
+      kafka::api_version(11));
+    ss::sleep(100ms).get();
+    BOOST_REQUIRE(!fresp.available());
+
+    produce(leader, 5);
+
+    auto resp = fresp.get0();
+    auto elapsed = ss::lowres_clock::now() - start;
+    client.stop().then([&client] { client.shutdown(); }).get();
+
+    BOOST_REQUIRE_LT(elapsed, 10s);
+    BOOST_REQUIRE_EQUAL(resp.data.topics.size(), 1);
+    BOOST_REQUIRE_EQUAL(resp.data.topics[0].partitions.size(), 1);
+    auto& p = resp.data.topics[0].partitions[0];
+    BOOST_REQUIRE_EQUAL(p.error_code, kafka::error_code::none);
+    BOOST_REQUIRE(p.records && !p.records->empty());
+}
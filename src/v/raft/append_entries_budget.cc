@@ -0,0 +1,52 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#include "raft/append_entries_budget.h"
+
+#include "raft/logger.h"
+#include "vlog.h"
+
+namespace raft {
+
+append_entries_budget::append_entries_budget(
+  config::binding<uint32_t> capacity)
+  : _capacity(std::move(capacity)) {
+    _capacity.watch([this] { on_capacity_changed(); });
+}
+
+append_entries_budget::semaphore_ptr
+append_entries_budget::for_node(model::node_id node) {
+    drop_unused();
+    auto [it, _] = _nodes.try_emplace(node);
+    if (!it->second) {
+        it->second = ss::make_lw_shared<adjustable_semaphore>(
+          _capacity(), "raft/shard-append");
+    }
+    return it->second;
+}
+
+void append_entries_budget::on_capacity_changed() {
+    vlog(
+      raftlog.info,
+      "append entries budget per node changed to {} requests",
+      _capacity());
+    drop_unused();
+    for (auto& [_, sem] : _nodes) {
+        sem->set_capacity(_capacity());
+    }
+}
+
+void append_entries_budget::drop_unused() {
+    // the only reference left is ours, no follower queue is using it
+    absl::erase_if(
+      _nodes, [](const auto& n) { return n.second.use_count() == 1; });
+}
+
+} // namespace raft
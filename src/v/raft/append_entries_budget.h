@@ -0,0 +1,49 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+#pragma once
+#include "config/property.h"
+#include "model/metadata.h"
+#include "seastarx.h"
+#include "utils/adjustable_semaphore.h"
+
+#include <seastar/core/shared_ptr.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace raft {
+/**
+ * Thread local budget of append entries requests sent over the configured per
+ * follower limit, shared by the followers of all raft groups of the shard
+ * that are on the same node.
+ *
+ * Follower queues hold the semaphore of their node. Semaphores of nodes no
+ * follower queue refers to anymore, e.g. of decommissioned nodes, are dropped.
+ */
+class append_entries_budget {
+public:
+    using semaphore_ptr = ss::lw_shared_ptr<adjustable_semaphore>;
+
+    explicit append_entries_budget(config::binding<uint32_t>);
+
+    /// \brief semaphore of the budget for requests to the given node
+    semaphore_ptr for_node(model::node_id);
+
+    size_t nodes() const { return _nodes.size(); }
+
+private:
+    void on_capacity_changed();
+    void drop_unused();
+
+    config::binding<uint32_t> _capacity;
+    absl::flat_hash_map<model::node_id, semaphore_ptr> _nodes;
+};
+
+} // namespace raft
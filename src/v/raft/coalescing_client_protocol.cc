@@ -0,0 +1,205 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/coalescing_client_protocol.h"
+
+#include "config/configuration.h"
+#include "features/feature_table.h"
+#include "raft/errc.h"
+#include "ssx/future-util.h"
+#include "ssx/semaphore.h"
+
+#include <seastar/core/future-util.hh>
+#include <seastar/core/later.hh>
+
+namespace raft {
+
+coalescing_client_protocol::coalescing_client_protocol(
+  consensus_client_protocol client, features::feature_table& feature_table)
+  : _client(std::move(client))
+  , _feature_table(feature_table)
+  , _max_batch_bytes(
+      config::shard_local_cfg().raft_append_entries_batch_max_bytes.bind()) {}
+
+ss::future<result<vote_reply>> coalescing_client_protocol::vote(
+  model::node_id n, vote_request&& r, rpc::client_opts opts) {
+    return _client.vote(n, std::move(r), std::move(opts));
+}
+
+ss::future<result<append_entries_reply>>
+coalescing_client_protocol::append_entries(
+  model::node_id n, append_entries_request&& r, rpc::client_opts opts) {
+    if (!batching_enabled()) {
+        dispatch(n);
+        return _client.append_entries(n, std::move(r), std::move(opts));
+    }
+    auto reader = std::move(r.batches());
+    return model::consume_reader_to_memory(std::move(reader), model::no_timeout)
+      .then([self = shared_from_this(),
+             n,
+             r = std::move(r),
+             opts = std::move(opts)](
+              ss::circular_buffer<model::record_batch> batches) mutable {
+          size_t size_bytes = 0;
+          for (const auto& b : batches) {
+              size_bytes += b.size_bytes();
+          }
+          append_entries_request req(
+            r.node_id,
+            r.target_node_id,
+            r.meta,
+            model::make_memory_record_batch_reader(std::move(batches)),
+            r.flush);
+          if (size_bytes >= self->_max_batch_bytes()) {
+              // keep the order of the requests sent to the node
+              self->dispatch(n);
+              return self->_client.append_entries(
+                n, std::move(req), std::move(opts));
+          }
+          return self->enqueue(n, std::move(req), size_bytes, std::move(opts));
+      });
+}
+
+ss::future<result<heartbeat_reply>> coalescing_client_protocol::heartbeat(
+  model::node_id n, heartbeat_request&& r, rpc::client_opts opts) {
+    return _client.heartbeat(n, std::move(r), std::move(opts));
+}
+
+ss::future<result<install_snapshot_reply>>
+coalescing_client_protocol::install_snapshot(
+  model::node_id n, install_snapshot_request&& r, rpc::client_opts opts) {
+    return _client.install_snapshot(n, std::move(r), std::move(opts));
+}
+
+ss::future<result<timeout_now_reply>> coalescing_client_protocol::timeout_now(
+  model::node_id n, timeout_now_request&& r, rpc::client_opts opts) {
+    return _client.timeout_now(n, std::move(r), std::move(opts));
+}
+
+ss::future<bool>
+coalescing_client_protocol::ensure_disconnect(model::node_id n) {
+    return _client.ensure_disconnect(n);
+}
+
+ss::future<result<transfer_leadership_reply>>
+coalescing_client_protocol::transfer_leadership(
+  model::node_id n, transfer_leadership_request&& r, rpc::client_opts opts) {
+    return _client.transfer_leadership(n, std::move(r), std::move(opts));
+}
+
+ss::future<> coalescing_client_protocol::reset_backoff(model::node_id n) {
+    return _client.reset_backoff(n);
+}
+
+ss::future<result<append_entries_batch_reply>>
+coalescing_client_protocol::append_entries_batch(
+  model::node_id n, append_entries_batch_request&& r, rpc::client_opts opts) {
+    return _client.append_entries_batch(n, std::move(r), std::move(opts));
+}
+
+bool coalescing_client_protocol::batching_enabled() const {
+    return _max_batch_bytes() > 0
+           && _feature_table.is_active(
+             features::feature::raft_append_entries_batching);
+}
+
+ss::future<result<append_entries_reply>> coalescing_client_protocol::enqueue(
+  model::node_id n,
+  append_entries_request r,
+  size_t size_bytes,
+  rpc::client_opts opts) {
+    auto& batch = _pending[n];
+    if (batch.requests.empty()) {
+        // send the requests buffered until the shard yields
+        ssx::background = ss::yield().then(
+          [self = shared_from_this(), n] { self->dispatch(n); });
+    }
+    batch.requests.push_back(std::move(r));
+    batch.replies.emplace_back();
+    auto f = batch.replies.back().get_future();
+    if (opts.resource_units) {
+        batch.units.push_back(std::move(opts.resource_units));
+    }
+    // never wait for a reply longer than any of the requests would
+    batch.timeout = std::min(batch.timeout, opts.timeout.timeout_at());
+    batch.size_bytes += size_bytes;
+
+    if (batch.size_bytes >= _max_batch_bytes()) {
+        dispatch(n);
+    }
+    return f;
+}
+
+void coalescing_client_protocol::dispatch(model::node_id n) {
+    auto it = _pending.find(n);
+    if (it == _pending.end()) {
+        return;
+    }
+    auto batch = std::move(it->second);
+    _pending.erase(it);
+
+    if (batch.requests.size() == 1) {
+        // nothing to coalesce with, send the request as it is
+        rpc::client_opts opts(rpc::timeout_spec::from_point(batch.timeout));
+        if (!batch.units.empty()) {
+            opts.resource_units = std::move(batch.units.front());
+        }
+        _client
+          .append_entries(
+            n, std::move(batch.requests.front()), std::move(opts))
+          .forward_to(std::move(batch.replies.front()));
+        return;
+    }
+
+    // the units of the batch are released once it is queued for sending, and
+    // with them the units of its requests
+    auto sent = ss::make_lw_shared<ssx::semaphore>(
+      1, "raft/append-entries-batch");
+    std::vector<ssx::semaphore_units> units;
+    units.push_back(ss::consume_units(*sent, 1));
+    ssx::background = sent->wait(1).then_wrapped(
+      [sent, held = std::move(batch.units)](ss::future<> f) {
+          f.ignore_ready_future();
+      });
+
+    rpc::client_opts opts(rpc::timeout_spec::from_point(batch.timeout));
+    opts.resource_units = ss::make_foreign(
+      ss::make_lw_shared<std::vector<ssx::semaphore_units>>(std::move(units)));
+
+    ssx::background
+      = _client
+          .append_entries_batch(
+            n,
+            append_entries_batch_request(std::move(batch.requests)),
+            std::move(opts))
+          .then_wrapped([replies = std::move(batch.replies)](
+                          ss::future<result<append_entries_batch_reply>>
+                            f) mutable {
+              if (f.failed()) {
+                  auto e = f.get_exception();
+                  for (auto& p : replies) {
+                      p.set_exception(e);
+                  }
+                  return;
+              }
+              auto r = f.get();
+              if (r && r.value().replies.size() != replies.size()) {
+                  r = make_error_code(errc::append_entries_dispatch_error);
+              }
+              for (size_t i = 0; i < replies.size(); ++i) {
+                  if (r) {
+                      replies[i].set_value(std::move(r.value().replies[i]));
+                  } else {
+                      replies[i].set_value(r.error());
+                  }
+              }
+          });
+}
+
+} // namespace raft
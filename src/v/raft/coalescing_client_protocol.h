@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/property.h"
+#include "features/fwd.h"
+#include "model/metadata.h"
+#include "raft/consensus_client_protocol.h"
+#include "raft/types.h"
+#include "rpc/types.h"
+
+#include <seastar/core/shared_ptr.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <vector>
+
+namespace raft {
+
+/**
+ * Raft client protocol sending the small append entries requests of many
+ * groups replicated to the same node together, in a single
+ * append_entries_batch message.
+ *
+ * With many partitions each receiving little data most of the cost of
+ * replication is per message rather than per byte. Requests smaller than the
+ * batch limit are buffered per node and sent together when the shard yields
+ * or the buffered requests reach the limit. Other requests, and all requests
+ * until every node of the cluster supports batches, are sent as they are.
+ *
+ * The resource units of a request, e.g. the op lock of its group, keep the
+ * requests of a group in order: the transport releases them once the request
+ * is queued for sending. The units of buffered requests are released with the
+ * units of the batch they are sent in.
+ */
+class coalescing_client_protocol final
+  : public consensus_client_protocol::impl
+  , public ss::enable_shared_from_this<coalescing_client_protocol> {
+public:
+    coalescing_client_protocol(
+      consensus_client_protocol, features::feature_table&);
+
+    ss::future<result<vote_reply>>
+    vote(model::node_id, vote_request&&, rpc::client_opts) final;
+
+    ss::future<result<append_entries_reply>> append_entries(
+      model::node_id, append_entries_request&&, rpc::client_opts) final;
+
+    ss::future<result<heartbeat_reply>>
+    heartbeat(model::node_id, heartbeat_request&&, rpc::client_opts) final;
+
+    ss::future<result<install_snapshot_reply>> install_snapshot(
+      model::node_id, install_snapshot_request&&, rpc::client_opts) final;
+
+    ss::future<result<timeout_now_reply>>
+    timeout_now(model::node_id, timeout_now_request&&, rpc::client_opts) final;
+
+    ss::future<bool> ensure_disconnect(model::node_id) final;
+
+    ss::future<result<transfer_leadership_reply>> transfer_leadership(
+      model::node_id, transfer_leadership_request&&, rpc::client_opts) final;
+
+    ss::future<> reset_backoff(model::node_id) final;
+
+    ss::future<result<append_entries_batch_reply>> append_entries_batch(
+      model::node_id, append_entries_batch_request&&, rpc::client_opts) final;
+
+private:
+    struct pending_batch {
+        std::vector<append_entries_request> requests;
+        std::vector<ss::promise<result<append_entries_reply>>> replies;
+        // units of the buffered requests, held until the batch is sent
+        std::vector<rpc::client_opts::resource_units_t> units;
+        rpc::clock_type::time_point timeout
+          = rpc::clock_type::time_point::max();
+        size_t size_bytes{0};
+    };
+
+    bool batching_enabled() const;
+
+    ss::future<result<append_entries_reply>> enqueue(
+      model::node_id,
+      append_entries_request,
+      size_t size_bytes,
+      rpc::client_opts);
+
+    /// \brief sends the requests buffered for the node, if any
+    void dispatch(model::node_id);
+
+    consensus_client_protocol _client;
+    features::feature_table& _feature_table;
+    config::binding<size_t> _max_batch_bytes;
+    absl::flat_hash_map<model::node_id, pending_batch> _pending;
+};
+
+inline consensus_client_protocol make_coalescing_client_protocol(
+  consensus_client_protocol client, features::feature_table& feature_table) {
+    return raft::make_consensus_client_protocol<
+      raft::coalescing_client_protocol>(std::move(client), feature_table);
+}
+
+} // namespace raft
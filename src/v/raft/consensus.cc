@@ -96,6 +96,7 @@ consensus::consensus(
   storage::api& storage,
   std::optional<std::reference_wrapper<recovery_throttle>> recovery_throttle,
   recovery_memory_quota& recovery_mem_quota,
+  append_entries_budget& append_budget,
   features::feature_table& ft,
   std::optional<voter_priority> voter_priority_override)
   : _self(nid, initial_cfg.revision_id())
@@ -114,7 +115,8 @@ consensus::consensus(
   , _fstats(
       _self,
       config::shard_local_cfg()
-        .raft_max_concurrent_append_requests_per_follower())
+        .raft_max_concurrent_append_requests_per_follower(),
+      append_budget)
   , _batcher(this, config::shard_local_cfg().raft_replicate_batch_window_size())
   , _event_manager(this)
   , _ctxlog(group, _log.config().ntp())
@@ -134,10 +136,21 @@ consensus::consensus(
       _scheduling.default_iopc)
   , _configuration_manager(std::move(initial_cfg), _group, _storage, _ctxlog)
   , _node_priority_override(voter_priority_override)
-  , _append_requests_buffer(*this, 256) {
+  , _append_requests_buffer(*this, 256)
+  , _leader_lease_enabled(config::shard_local_cfg().raft_leader_lease.bind()) {
     setup_metrics();
     setup_public_metrics();
     update_follower_stats(_configuration_manager.get_latest());
+    _leader_lease_enabled.watch([this] {
+        if (_leader_lease_enabled()) {
+            return;
+        }
+        // the lease is acquired again from requests sent once re-enabled
+        for (auto& [_, idx] : _fstats) {
+            idx.requests_sent_at.clear();
+            idx.last_processed_request_sent_at = clock_type::time_point::min();
+        }
+    });
     _vote_timeout.set_callback([this] {
         maybe_step_down();
         dispatch_vote(false);
@@ -236,6 +249,52 @@ clock_type::time_point consensus::majority_heartbeat() const {
     });
 }
 
+clock_type::time_point consensus::leader_lease_expiry() const {
+    auto acked_at = config().quorum_match([this](vnode rni) {
+        if (rni == _self) {
+            return clock_type::now();
+        }
+
+        if (auto it = _fstats.find(rni); it != _fstats.end()) {
+            return it->second.last_processed_request_sent_at;
+        }
+        return clock_type::time_point::min();
+    });
+    // requests sent in a previous term or before a leadership transfer do not
+    // count, a follower processing them may vote for another candidate
+    if (acked_at <= std::max(_became_leader_at, _leader_lease_not_before)) {
+        return clock_type::time_point::min();
+    }
+    // the leader and followers clocks may drift apart, and the low resolution
+    // clock may lag behind by a tick on both of them
+    static constexpr auto clock_error = 2 * std::chrono::milliseconds(10);
+    const auto drift
+      = config::shard_local_cfg().raft_leader_lease_max_clock_drift();
+    auto duration = std::chrono::duration_cast<clock_type::duration>(
+      _jit.base_duration() / (1.0 + std::max(drift, 0.0)));
+    return acked_at + duration - clock_error;
+}
+
+bool consensus::has_leader_lease() const {
+    if (!_leader_lease_enabled() || !is_leader() || _transferring_leadership) {
+        return false;
+    }
+    return clock_type::now() < leader_lease_expiry();
+}
+
+void consensus::update_leader_lease(
+  follower_index_metadata& idx, follower_req_seq seq) {
+    auto& sent = idx.requests_sent_at;
+    while (!sent.empty() && sent.front().first < seq) {
+        sent.pop_front();
+    }
+    if (!sent.empty() && sent.front().first == seq) {
+        idx.last_processed_request_sent_at = std::max(
+          idx.last_processed_request_sent_at, sent.front().second);
+        sent.pop_front();
+    }
+}
+
 void consensus::shutdown_input() {
     if (likely(!_as.abort_requested())) {
         _vote_timeout.cancel();
@@ -379,6 +438,13 @@ consensus::success_reply consensus::update_follower_index(
         });
         return success_reply::no;
     }
+    if (
+      reply.term == _term
+      && reply.result == append_entries_reply::status::success) {
+        // the follower log has the entries of the current term, so it
+        // respects the lease even if it restarts
+        update_leader_lease(idx, seq);
+    }
 
     // If recovery is in progress the recovery STM will handle follower index
     // updates
@@ -572,6 +638,15 @@ ss::future<result<model::offset>> consensus::linearizable_barrier() {
     if (_vstate != vote_state::leader) {
         co_return result<model::offset>(make_error_code(errc::not_leader));
     }
+    if (_leader_lease_enabled()) {
+        if (has_leader_lease()) {
+            _probe.leader_lease_read();
+            vlog(
+              _ctxlog.trace, "Linearizable offset (lease): {}", _commit_index);
+            co_return ret_t(_commit_index);
+        }
+        _probe.leader_lease_fallback();
+    }
     // store current commit index
     auto cfg = config();
     auto dirty_offset = _log.offsets().dirty_offset;
@@ -1379,6 +1454,24 @@ model::offset consensus::read_last_applied() const {
     return model::offset{};
 }
 
+bool consensus::last_voted_for_self(
+  storage::kvstore& kvs, group_id group, model::node_id self) {
+    auto value = kvs.get(
+      storage::kvstore::key_space::consensus,
+      raft::details::serialize_group_key(group, metadata_key::voted_for));
+    if (!value) {
+        return false;
+    }
+    try {
+        auto config = reflection::adl<voted_for_configuration>{}.from(
+          std::move(*value));
+        return config.voted_for.id() == self;
+    } catch (...) {
+        // votes in the old format are not worth a fallback for a hint
+        return false;
+    }
+}
+
 void consensus::read_voted_for() {
     /*
      * Initial values
@@ -1531,9 +1624,19 @@ ss::future<vote_reply> consensus::do_vote(vote_request&& r) {
     // timeout duration When the vote was requested because of leadership
     // transfer grant the vote immediately.
     auto prev_election = clock_type::now() - _jit.base_duration();
-    if (
-      _hbeat > prev_election && !r.leadership_transfer
-      && r.node_id != _voted_for) {
+    bool heard_from_leader = _hbeat > prev_election;
+    bool exempt = r.node_id == _voted_for;
+    if (_leader_lease_enabled()) {
+        // With leader leases a node must not vote for another candidate for
+        // an election timeout after processing a request of the leader, even
+        // if it restarted since. A node with an empty log never acknowledged
+        // a leader holding a lease. Only a candidate retrying its election in
+        // the term the node voted for it is exempt.
+        heard_from_leader |= _instantiated_at > prev_election
+                             && lstats.dirty_offset >= model::offset(0);
+        exempt &= r.term == _term;
+    }
+    if (heard_from_leader && !r.leadership_transfer && !exempt) {
         vlog(
           _ctxlog.trace,
           "Already heard from the leader, not granting vote to node {}",
@@ -2413,8 +2516,18 @@ void consensus::update_node_reply_timestamp(vnode id) {
 }
 
 follower_req_seq consensus::next_follower_sequence(vnode id) {
+    // replies are usually received in order, older requests are dropped
+    static constexpr size_t max_tracked_requests = 64;
     if (auto it = _fstats.find(id); it != _fstats.end()) {
-        return it->second.last_sent_seq++;
+        auto& idx = it->second;
+        if (_leader_lease_enabled()) {
+            if (idx.requests_sent_at.size() >= max_tracked_requests) {
+                idx.requests_sent_at.pop_front();
+            }
+            idx.requests_sent_at.emplace_back(
+              idx.last_sent_seq, clock_type::now());
+        }
+        return idx.last_sent_seq++;
     }
 
     return follower_req_seq{};
@@ -2611,6 +2724,8 @@ consensus::maybe_update_follower_commit_idx(model::offset request_commit_idx) {
               _ctxlog.trace, "Follower commit index updated {}", _commit_index);
             _commit_index_updated.broadcast();
             _event_manager.notify_commit_index();
+            _committed_visible_offset_monitor.notify(
+              last_committed_visible_index());
         }
     }
     return ss::make_ready_future<>();
@@ -3091,7 +3206,12 @@ consensus::do_transfer_leadership(std::optional<model::node_id> target) {
           });
     });
 
-    return f.finally([this] { _transferring_leadership = false; });
+    return f.finally([this] {
+        _transferring_leadership = false;
+        // the transfer target may still be elected, votes requested for a
+        // transfer are granted regardless of the leader lease
+        _leader_lease_not_before = clock_type::now() + _jit.base_duration();
+    });
 }
 
 ss::future<> consensus::remove_persistent_state() {
@@ -3118,6 +3238,7 @@ void consensus::maybe_update_last_visible_index(model::offset offset) {
       _visibility_upper_bound_index, offset);
     _majority_replicated_index = std::max(_majority_replicated_index, offset);
     _consumable_offset_monitor.notify(last_visible_index());
+    _committed_visible_offset_monitor.notify(last_committed_visible_index());
 }
 
 void consensus::maybe_update_majority_replicated_index() {
@@ -3134,6 +3255,7 @@ void consensus::maybe_update_majority_replicated_index() {
     _majority_replicated_index = std::max(
       _majority_replicated_index, majority_match);
     _consumable_offset_monitor.notify(last_visible_index());
+    _committed_visible_offset_monitor.notify(last_committed_visible_index());
 }
 
 heartbeats_suppressed consensus::are_heartbeats_suppressed(vnode id) const {
@@ -3249,7 +3371,8 @@ follower_metrics build_follower_metrics(
   model::node_id id,
   const storage::offset_stats& lstats,
   std::chrono::milliseconds liveness_timeout,
-  const follower_index_metadata& meta) {
+  const follower_index_metadata& meta,
+  size_t append_entries_depth) {
     const auto is_live = meta.last_received_reply_timestamp + liveness_timeout
                          > clock_type::now();
     return follower_metrics{
@@ -3261,7 +3384,8 @@ follower_metrics build_follower_metrics(
       .last_heartbeat = meta.last_received_reply_timestamp,
       .is_live = is_live,
       .under_replicated = (meta.is_recovering || !is_live)
-                          && meta.match_index < lstats.dirty_offset};
+                          && meta.match_index < lstats.dirty_offset,
+      .append_entries_depth = append_entries_depth};
 }
 
 std::vector<follower_metrics> consensus::get_follower_metrics() const {
@@ -3278,7 +3402,8 @@ std::vector<follower_metrics> consensus::get_follower_metrics() const {
           offsets,
           std::chrono::duration_cast<std::chrono::milliseconds>(
             _jit.base_duration()),
-          f.second));
+          f.second,
+          _fstats.append_entries_depth(f.first)));
     }
 
     return ret;
@@ -3301,7 +3426,8 @@ consensus::get_follower_metrics(model::node_id id) const {
       _log.offsets(),
       std::chrono::duration_cast<std::chrono::milliseconds>(
         _jit.base_duration()),
-      it->second);
+      it->second,
+      _fstats.append_entries_depth(it->first));
 }
 
 size_t consensus::get_follower_count() const {
@@ -11,10 +11,12 @@
 
 #pragma once
 
+#include "config/property.h"
 #include "features/feature_table.h"
 #include "hashing/crc32c.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
+#include "raft/append_entries_budget.h"
 #include "raft/append_entries_buffer.h"
 #include "raft/configuration_manager.h"
 #include "raft/consensus_client_protocol.h"
@@ -82,6 +84,14 @@ public:
         }
     };
     enum class vote_state { follower, candidate, leader };
+
+    /// \brief true if the last vote persisted by the group is for the node
+    /// itself, i.e. the node ran for leadership in the latest term it knows
+    /// of. Readable before the group is created, used as a hint of recent
+    /// leadership.
+    static bool
+    last_voted_for_self(storage::kvstore&, group_id, model::node_id self);
+
     using leader_cb_t = ss::noncopyable_function<void(leadership_status)>;
 
     consensus(
@@ -97,6 +107,7 @@ public:
       storage::api&,
       std::optional<std::reference_wrapper<recovery_throttle>>,
       recovery_memory_quota&,
+      append_entries_budget&,
       features::feature_table&,
       std::optional<voter_priority> = std::nullopt);
 
@@ -154,6 +165,15 @@ public:
      * details see paragraph 6.4 of Raft protocol dissertation.
      */
     ss::future<result<model::offset>> linearizable_barrier();
+    /**
+     * True if the leader holds a lease: followers don't vote for another
+     * candidate while the lease holds, so no other leader may have been
+     * elected and the commit index is linearizable without a round of
+     * heartbeats. The lease holds for an election timeout, shortened by the
+     * clock drift bound, from the time the leader sent the latest request
+     * acknowledged by a majority. Only used when raft_leader_lease is enabled.
+     */
+    bool has_leader_lease() const;
 
     vnode self() const { return _self; }
     protocol_metadata meta() const;
@@ -250,6 +270,18 @@ public:
           _majority_replicated_index, _visibility_upper_bound_index);
     };
 
+    /**
+     * Last visible offset that is also known to be committed. On a follower
+     * the commit index is the one propagated by the leader with append
+     * entries and heartbeats, entries up to it are never truncated and can be
+     * served to consumers reading from the follower. Entries that are only
+     * visible, e.g. replicated with relaxed consistency, may still be
+     * truncated when the follower's log diverges.
+     */
+    model::offset last_committed_visible_index() const {
+        return std::min(last_visible_index(), _commit_index);
+    }
+
     ss::future<offset_configuration>
     wait_for_config_change(model::offset last_seen, ss::abort_source& as) {
         return _configuration_manager.wait_for_change(last_seen, as);
@@ -358,6 +390,10 @@ public:
         return _consumable_offset_monitor;
     }
 
+    offset_monitor& committed_visible_offset_monitor() {
+        return _committed_visible_offset_monitor;
+    }
+
     ss::future<> refresh_commit_index();
 
     model::term_id get_term(model::offset) const;
@@ -449,6 +485,8 @@ private:
     ss::future<> do_maybe_update_leader_commit_idx(ssx::semaphore_units);
 
     clock_type::time_point majority_heartbeat() const;
+    clock_type::time_point leader_lease_expiry() const;
+    void update_leader_lease(follower_index_metadata&, follower_req_seq);
     /*
      * Start an election. When leadership transfer is requested, the election is
      * started immediately, and the vote request will contain a flag that
@@ -621,6 +659,9 @@ private:
     clock_type::time_point _hbeat = clock_type::now();
     clock_type::time_point _became_leader_at = clock_type::now();
     clock_type::time_point _instantiated_at = clock_type::now();
+    // requests sent before are not acknowledged towards the leader lease
+    clock_type::time_point _leader_lease_not_before
+      = clock_type::time_point::min();
 
     /// used to keep track if we are a leader, or transitioning
     vote_state _vstate = vote_state::follower;
@@ -674,8 +715,12 @@ private:
     model::offset _last_quorum_replicated_index;
     consistency_level _last_write_consistency_level;
     offset_monitor _consumable_offset_monitor;
+    // notified with last_committed_visible_index()
+    offset_monitor _committed_visible_offset_monitor;
     ss::condition_variable _follower_reply;
     append_entries_buffer _append_requests_buffer;
+    // send times of requests to followers are only recorded when enabled
+    config::binding<bool> _leader_lease_enabled;
     friend std::ostream& operator<<(std::ostream&, const consensus&);
 };
 
@@ -54,6 +54,11 @@ public:
 
         virtual ss::future<> reset_backoff(model::node_id) = 0;
 
+        virtual ss::future<result<append_entries_batch_reply>>
+        append_entries_batch(
+          model::node_id, append_entries_batch_request&&, rpc::client_opts)
+          = 0;
+
         virtual ~impl() noexcept = default;
     };
 
@@ -111,6 +116,14 @@ public:
         return _impl->reset_backoff(target_node);
     }
 
+    ss::future<result<append_entries_batch_reply>> append_entries_batch(
+      model::node_id target_node,
+      append_entries_batch_request&& r,
+      rpc::client_opts opts) {
+        return _impl->append_entries_batch(
+          target_node, std::move(r), std::move(opts));
+    }
+
 private:
     ss::shared_ptr<impl> _impl;
 };
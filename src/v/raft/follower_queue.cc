@@ -11,19 +11,81 @@
 
 #include "raft/follower_queue.h"
 
+#include "config/configuration.h"
+#include "raft/logger.h"
 #include "ssx/semaphore.h"
+#include "vlog.h"
 
 #include <seastar/core/coroutine.hh>
 
+#include <algorithm>
+
 namespace raft {
 
-follower_queue::follower_queue(uint32_t max_concurrent_append_entries)
-  : _max_concurrent_append_entries(max_concurrent_append_entries)
-  , _sem(std::make_unique<ssx::semaphore>(
-      _max_concurrent_append_entries, "raft/follow")) {}
+namespace {
+// weight of a new sample in the latency average and in the depth update
+constexpr double latency_alpha = 0.2;
+constexpr double depth_alpha = 0.2;
+constexpr auto depth_update_interval = std::chrono::milliseconds(100);
+} // namespace
+
+follower_queue::follower_queue(
+  vnode target,
+  uint32_t max_concurrent_append_entries,
+  append_entries_budget::semaphore_ptr shard_budget)
+  : _target(target)
+  , _max_concurrent_append_entries(max_concurrent_append_entries)
+  , _shard_budget(std::move(shard_budget))
+  , _target_latency(
+      config::shard_local_cfg().raft_append_requests_target_latency_ms()) {
+    const size_t max_depth = std::max(
+      _max_concurrent_append_entries,
+      config::shard_local_cfg()
+        .raft_max_adaptive_append_requests_per_follower());
+    // adaptation only adds requests on top of the configured limit
+    _qdc = std::make_unique<queue_depth_control>(
+      _target_latency,
+      depth_alpha,
+      _max_concurrent_append_entries,
+      _max_concurrent_append_entries,
+      max_depth);
+}
+
+ss::future<follower_queue::units> follower_queue::get_append_entries_unit() {
+    units u{.depth = co_await _qdc->get_unit()};
+    const auto in_flight = static_cast<ssize_t>(_qdc->depth())
+                           - _qdc->available_units();
+    if (in_flight > static_cast<ssize_t>(_max_concurrent_append_entries)) {
+        u.shard = co_await _shard_budget->get_units(1);
+    }
+    co_return u;
+}
+
+void follower_queue::record_latency(std::chrono::steady_clock::duration d) {
+    // a sample of 0 means idle to queue depth control
+    const auto sample = std::max(
+      std::chrono::duration<double, std::milli>(d).count(), 0.01);
+    _latency = _latency == 0
+                 ? sample
+                 : latency_alpha * sample + (1 - latency_alpha) * _latency;
 
-ss::future<ssx::semaphore_units> follower_queue::get_append_entries_unit() {
-    co_return co_await ss::get_units(*_sem, 1);
+    const auto now = std::chrono::steady_clock::now();
+    if (now - _last_depth_update < depth_update_interval) {
+        return;
+    }
+    _last_depth_update = now;
+    const auto prev = _qdc->depth();
+    _qdc->update(_latency);
+    if (_qdc->depth() != prev) {
+        vlog(
+          raftlog.trace,
+          "append entries depth for {} changed from {} to {}, latency {:.2f} "
+          "ms",
+          _target,
+          prev,
+          _qdc->depth(),
+          _latency);
+    }
 }
 
 } // namespace raft
@@ -9,14 +9,39 @@
  * by the Apache License, Version 2.0
  */
 #pragma once
+#include "raft/append_entries_budget.h"
 #include "raft/group_configuration.h"
 #include "ssx/semaphore.h"
+#include "utils/queue_depth_control.h"
+
+#include <chrono>
+#include <optional>
 
 namespace raft {
 
+/**
+ * Limits the number of append entries requests in flight from a leader to one
+ * follower.
+ *
+ * The limit starts at raft_max_concurrent_append_requests_per_follower and is
+ * adjusted by queue depth control from the round trip latency of the requests,
+ * which includes the flush on the follower: it grows while the follower
+ * replies within raft_append_requests_target_latency_ms, so that a few
+ * partitions can fill a link with a large bandwidth delay product, and shrinks
+ * back towards the configured limit when the follower falls behind. Requests
+ * over the configured limit also take a unit of the append_entries_budget of
+ * the follower's node, so that many groups growing together can't
+ * oversubscribe the link.
+ */
 class follower_queue {
 public:
-    explicit follower_queue(uint32_t);
+    struct units {
+        ssx::semaphore_units depth;
+        // only taken by requests over the configured limit
+        std::optional<ssx::semaphore_units> shard;
+    };
+
+    follower_queue(vnode, uint32_t, append_entries_budget::semaphore_ptr);
 
     follower_queue(follower_queue&&) noexcept = default;
     follower_queue(const follower_queue&) = delete;
@@ -26,30 +51,28 @@ public:
         vassert(is_idle(), "can not remove not idle follower queue");
     }
 
-    ss::future<ssx::semaphore_units> get_append_entries_unit();
+    ss::future<units> get_append_entries_unit();
+
+    /// \brief records the round trip latency of a request
+    void record_latency(std::chrono::steady_clock::duration);
 
-    ss::future<> stop();
+    size_t depth() const { return _qdc->depth(); }
 
     bool is_idle() const {
-        return _sem->waiters() == 0
-               && _sem->available_units() == _max_concurrent_append_entries;
+        return _qdc->waiters() == 0
+               && _qdc->available_units()
+                    == static_cast<ssize_t>(_qdc->depth());
     }
 
 private:
-    /**
-     * TODO: consider using queue depth control to automatically adjust number
-     * of concurrent requests per follower. In general it should be fine to make
-     * this static since scaling throughput is usually achieved by increasing
-     * partition count. We may need to increase number of concurrent requests
-     * per partition to increase throughput when partition number is low and we
-     * are fine with increasing latency.
-     *
-     * Things to consider:
-     * - per shard concurrency controll
-     * - token-bucket based throughput limitter
-     */
+    vnode _target;
     uint32_t _max_concurrent_append_entries;
-    std::unique_ptr<ssx::semaphore> _sem;
+    append_entries_budget::semaphore_ptr _shard_budget;
+    std::unique_ptr<queue_depth_control> _qdc;
+    std::chrono::milliseconds _target_latency;
+    // moving average of the round trip latency in milliseconds
+    double _latency{0};
+    std::chrono::steady_clock::time_point _last_depth_update;
 };
 
 } // namespace raft
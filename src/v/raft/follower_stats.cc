@@ -45,25 +45,49 @@ void follower_stats::update_with_configuration(const group_configuration& cfg) {
         }
         ++it;
     }
+    // queues of removed followers that are still in use are removed when
+    // their last request returns
+    absl::erase_if(_queues, [this](const auto& q) {
+        return !_followers.contains(q.first) && q.second.is_idle();
+    });
 }
 
-ss::future<ssx::semaphore_units>
+ss::future<follower_queue::units>
 follower_stats::get_append_entries_unit(vnode id) {
-    if (auto it = _queues.find(id); it != _queues.end()) {
-        return it->second.get_append_entries_unit();
+    // queues are kept for as long as the follower is a member so that the
+    // depth learned from its latency is kept between requests
+    auto it = _queues.find(id);
+    if (it == _queues.end()) {
+        it = _queues
+               .try_emplace(
+                 id,
+                 id,
+                 _max_concurrent_append_entries,
+                 _append_entries_budget.for_node(id.id()))
+               .first;
     }
-    auto [it, _] = _queues.emplace(id, _max_concurrent_append_entries);
-
     return it->second.get_append_entries_unit();
 }
 
-void follower_stats::return_append_entries_units(vnode id) {
-    if (auto it = _queues.find(id);
-        it != _queues.end() && it->second.is_idle()) {
+void follower_stats::return_append_entries_units(
+  vnode id, std::chrono::steady_clock::duration latency) {
+    auto it = _queues.find(id);
+    if (it == _queues.end()) {
+        return;
+    }
+    it->second.record_latency(latency);
+    if (!_followers.contains(id) && it->second.is_idle()) {
         _queues.erase(it);
     }
 }
 
+size_t follower_stats::append_entries_depth(vnode id) const {
+    if (auto it = _queues.find(id); it != _queues.end()) {
+        return it->second.depth();
+    }
+    return _max_concurrent_append_entries;
+}
+
 std::ostream& operator<<(std::ostream& o, const follower_stats& s) {
     o << "{followers:" << s._followers.size() << ", [";
     for (auto& f : s) {
@@ -12,12 +12,15 @@
 #pragma once
 
 #include "model/metadata.h"
+#include "raft/append_entries_budget.h"
 #include "raft/follower_queue.h"
 #include "raft/types.h"
 #include "vassert.h"
 
 #include <absl/container/node_hash_map.h>
 
+#include <chrono>
+
 namespace raft {
 
 class follower_stats {
@@ -26,9 +29,13 @@ public:
     using iterator = container_t::iterator;
     using const_iterator = container_t::const_iterator;
 
-    explicit follower_stats(vnode self, uint32_t max_concurrent_append_entries)
+    follower_stats(
+      vnode self,
+      uint32_t max_concurrent_append_entries,
+      append_entries_budget& budget)
       : _self(self)
-      , _max_concurrent_append_entries(max_concurrent_append_entries) {}
+      , _max_concurrent_append_entries(max_concurrent_append_entries)
+      , _append_entries_budget(budget) {}
 
     const follower_index_metadata& get(vnode n) const {
         auto it = _followers.find(n);
@@ -70,9 +77,16 @@ public:
 
     size_t size() const { return _followers.size(); }
 
-    ss::future<ssx::semaphore_units> get_append_entries_unit(vnode);
+    ss::future<follower_queue::units> get_append_entries_unit(vnode);
+
+    /// \brief called when a request dispatched with the units of the
+    /// follower completed after the given round trip latency
+    void
+    return_append_entries_units(vnode, std::chrono::steady_clock::duration);
 
-    void return_append_entries_units(vnode);
+    /// \brief current number of concurrent append entries requests allowed to
+    /// the follower
+    size_t append_entries_depth(vnode) const;
 
     void update_with_configuration(const group_configuration&);
 
@@ -80,6 +94,7 @@ private:
     friend std::ostream& operator<<(std::ostream&, const follower_stats&);
     vnode _self;
     uint32_t _max_concurrent_append_entries;
+    append_entries_budget& _append_entries_budget;
     container_t _followers;
     absl::node_hash_map<vnode, follower_queue> _queues;
 };
@@ -13,6 +13,7 @@
 #include "likely.h"
 #include "model/metadata.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "raft/coalescing_client_protocol.h"
 #include "raft/rpc_client_protocol.h"
 #include "resource_mgmt/io_priority.h"
 
@@ -33,7 +34,8 @@ group_manager::group_manager(
   ss::sharded<features::feature_table>& feature_table)
   : _self(self)
   , _raft_sg(raft_sg)
-  , _client(make_rpc_client_protocol(self, clients))
+  , _client(make_coalescing_client_protocol(
+      make_rpc_client_protocol(self, clients), feature_table.local()))
   , _configuration(cfg())
   , _heartbeats(
       _configuration.heartbeat_interval,
@@ -43,6 +45,8 @@ group_manager::group_manager(
   , _storage(storage.local())
   , _recovery_throttle(recovery_throttle.local())
   , _recovery_mem_quota(std::move(recovery_mem_cfg))
+  , _append_entries_budget(
+      _configuration.max_adaptive_append_requests_per_shard)
   , _feature_table(feature_table.local())
   , _is_ready(false) {
     setup_metrics();
@@ -101,6 +105,7 @@ ss::future<ss::lw_shared_ptr<raft::consensus>> group_manager::create_group(
       _storage,
       _recovery_throttle,
       _recovery_mem_quota,
+      _append_entries_budget,
       _feature_table,
       _is_ready ? std::nullopt : std::make_optional(min_voter_priority));
 
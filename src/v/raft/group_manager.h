@@ -12,6 +12,7 @@
 #pragma once
 #include "cluster/types.h"
 #include "model/metadata.h"
+#include "raft/append_entries_budget.h"
 #include "raft/consensus_client_protocol.h"
 #include "raft/heartbeat_manager.h"
 #include "raft/recovery_memory_quota.h"
@@ -41,6 +42,7 @@ public:
         config::binding<std::chrono::milliseconds> heartbeat_interval;
         config::binding<std::chrono::milliseconds> heartbeat_timeout;
         std::chrono::milliseconds raft_io_timeout_ms;
+        config::binding<uint32_t> max_adaptive_append_requests_per_shard;
     };
     using config_provider_fn = ss::noncopyable_function<configuration()>;
 
@@ -81,6 +83,8 @@ public:
 
     consensus_client_protocol raft_client() const { return _client; }
 
+    model::node_id self() const { return _self; }
+
 private:
     void trigger_leadership_notification(raft::leadership_status);
     void setup_metrics();
@@ -98,6 +102,7 @@ private:
     storage::api& _storage;
     recovery_throttle& _recovery_throttle;
     recovery_memory_quota _recovery_mem_quota;
+    append_entries_budget _append_entries_budget;
     features::feature_table& _feature_table;
     bool _is_ready;
 };
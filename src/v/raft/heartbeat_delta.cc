@@ -0,0 +1,230 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/heartbeat_delta.h"
+
+#include "random/generators.h"
+
+#include <absl/container/flat_hash_set.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace raft {
+
+heartbeat_delta_sender::heartbeat_delta_sender(
+  model::node_id self, model::node_id target)
+  : _self(self)
+  , _target(target)
+  , _session(random_generators::get_int<uint64_t>(
+      1, std::numeric_limits<uint64_t>::max())) {}
+
+heartbeat_request
+heartbeat_delta_sender::make_request(std::vector<heartbeat_metadata> hbs) {
+    heartbeat_delta delta{
+      .node_id = _self,
+      .target_node_id = _target,
+      .session = _session,
+      .generation = _next_generation++,
+    };
+
+    if (_acked_generation == 0 || _in_flight) {
+        // the follower may have applied the request in flight, its state is
+        // unknown
+        _groups.clear();
+        _acked_generation = 0;
+        _in_flight = in_flight_request{
+          .generation = delta.generation, .is_delta = false, .heartbeats = hbs};
+        return {std::move(hbs), std::move(delta)};
+    }
+
+    delta.base_generation = _acked_generation;
+    std::vector<heartbeat_metadata> changed;
+    size_t acked = 0;
+    for (auto& hb : hbs) {
+        auto it = _groups.find(hb.meta.group);
+        if (it != _groups.end()) {
+            ++acked;
+            if (it->second.heartbeat == hb) {
+                continue;
+            }
+        }
+        changed.push_back(hb);
+    }
+    // groups of the acknowledged request not heartbeated in this tick, e.g.
+    // because an append entries request was sent to the follower recently
+    if (acked < _groups.size()) {
+        absl::flat_hash_set<group_id> tick;
+        tick.reserve(hbs.size());
+        for (const auto& hb : hbs) {
+            tick.insert(hb.meta.group);
+        }
+        for (const auto& [group, _] : _groups) {
+            if (!tick.contains(group)) {
+                delta.removed.push_back(group);
+            }
+        }
+    }
+
+    _in_flight = in_flight_request{
+      .generation = delta.generation,
+      .is_delta = true,
+      .heartbeats = changed,
+      .removed = delta.removed};
+    return {std::move(changed), std::move(delta)};
+}
+
+void heartbeat_delta_sender::process_reply(
+  uint64_t generation, heartbeat_reply& reply) {
+    if (!_in_flight || _in_flight->generation != generation) {
+        // reply to a request superseded by a request starting over
+        return;
+    }
+    auto request = std::move(*_in_flight);
+    _in_flight.reset();
+    if (reply.acked_generation != generation) {
+        reset();
+        return;
+    }
+
+    if (!request.is_delta) {
+        _groups.clear();
+        _groups.reserve(request.heartbeats.size());
+    }
+    for (const auto& group : request.removed) {
+        _groups.erase(group);
+    }
+    for (auto& hb : request.heartbeats) {
+        _groups[hb.meta.group].heartbeat = std::move(hb);
+    }
+    _acked_generation = generation;
+
+    for (const auto& r : reply.meta) {
+        auto it = _groups.find(r.group);
+        if (it == _groups.end()) {
+            continue;
+        }
+        it->second.replied_generation = generation;
+        if (r.result == append_entries_reply::status::success) {
+            it->second.reply = r;
+        } else {
+            it->second.reply.reset();
+        }
+    }
+    if (!request.is_delta) {
+        return;
+    }
+    for (const auto& [_, state] : _groups) {
+        if (state.replied_generation != generation && state.reply) {
+            reply.meta.push_back(*state.reply);
+        }
+    }
+}
+
+void heartbeat_delta_sender::reset() {
+    _groups.clear();
+    _acked_generation = 0;
+    _in_flight.reset();
+}
+
+heartbeat_delta_receiver::heartbeat_delta_receiver(
+  clock_type::duration session_timeout)
+  : _session_timeout(session_timeout) {}
+
+std::optional<heartbeat_delta_receiver::applied_request>
+heartbeat_delta_receiver::apply(heartbeat_request& r) {
+    const auto& delta = r.delta;
+    if (delta.session == 0) {
+        return std::nullopt;
+    }
+    const auto now = clock_type::now();
+    const applied_request applied{
+      .session = delta.session,
+      .generation = delta.generation,
+      .is_delta = delta.is_delta()};
+
+    if (!applied.is_delta) {
+        expire_sessions(now);
+        auto& s = _sessions[delta.session];
+        s.node_id = delta.node_id;
+        s.generation = delta.generation;
+        s.last_request = now;
+        s.groups.clear();
+        s.groups.reserve(r.heartbeats.size());
+        for (const auto& hb : r.heartbeats) {
+            s.groups[hb.meta.group] = group_state{
+              .heartbeat = hb, .updated_generation = delta.generation};
+        }
+        return applied;
+    }
+
+    auto it = _sessions.find(delta.session);
+    if (
+      it == _sessions.end() || it->second.node_id != delta.node_id
+      || it->second.generation != delta.base_generation) {
+        if (it != _sessions.end()) {
+            _sessions.erase(it);
+        }
+        return std::nullopt;
+    }
+
+    auto& s = it->second;
+    for (const auto& group : delta.removed) {
+        s.groups.erase(group);
+    }
+    for (const auto& hb : r.heartbeats) {
+        auto& state = s.groups[hb.meta.group];
+        state.heartbeat = hb;
+        state.updated_generation = delta.generation;
+    }
+    r.heartbeats.reserve(s.groups.size());
+    for (auto& [_, state] : s.groups) {
+        if (state.updated_generation != delta.generation) {
+            r.heartbeats.push_back(state.heartbeat);
+        }
+    }
+    s.generation = delta.generation;
+    s.last_request = now;
+    return applied;
+}
+
+void heartbeat_delta_receiver::compact_reply(
+  const applied_request& applied, heartbeat_reply& reply) {
+    auto it = _sessions.find(applied.session);
+    if (it == _sessions.end() || it->second.generation != applied.generation) {
+        // the session started over while the request was processed
+        return;
+    }
+    reply.acked_generation = applied.generation;
+    auto& groups = it->second.groups;
+    std::erase_if(
+      reply.meta, [&groups, &applied](const append_entries_reply& r) {
+          auto g_it = groups.find(r.group);
+          if (g_it == groups.end()) {
+              return false;
+          }
+          if (r.result != append_entries_reply::status::success) {
+              g_it->second.reply.reset();
+              return false;
+          }
+          if (applied.is_delta && g_it->second.reply == r) {
+              return true;
+          }
+          g_it->second.reply = r;
+          return false;
+      });
+}
+
+void heartbeat_delta_receiver::expire_sessions(clock_type::time_point now) {
+    absl::erase_if(_sessions, [this, now](const auto& p) {
+        return p.second.last_request + _session_timeout < now;
+    });
+}
+
+} // namespace raft
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/metadata.h"
+#include "raft/types.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/node_hash_map.h>
+
+#include <optional>
+#include <vector>
+
+namespace raft {
+
+/**
+ * Leader side of a delta heartbeat session with one follower node, see
+ * `heartbeat_delta`.
+ *
+ * Requests are relative to the last request the follower acknowledged. A
+ * request is only relative to an acknowledged generation when no other request
+ * is in flight, as the follower may have applied a request whose reply never
+ * arrived. Otherwise the request carries all the groups and starts the session
+ * over.
+ */
+class heartbeat_delta_sender {
+public:
+    heartbeat_delta_sender(model::node_id self, model::node_id target);
+
+    /// \brief makes the request heartbeating the groups of one tick
+    heartbeat_request make_request(std::vector<heartbeat_metadata>);
+
+    /// \brief acknowledges the request of `generation` with its reply
+    ///
+    /// Adds the replies the follower omitted because the leader already has
+    /// them.
+    void process_reply(uint64_t generation, heartbeat_reply&);
+
+    /// \brief starts the session over with the next request, e.g. after the
+    /// connection to the follower was reset
+    void reset();
+
+    uint64_t acked_generation() const { return _acked_generation; }
+
+private:
+    struct group_state {
+        heartbeat_metadata heartbeat;
+        // last successful reply of the follower, it omits equal replies
+        std::optional<append_entries_reply> reply;
+        uint64_t replied_generation{0};
+    };
+
+    struct in_flight_request {
+        uint64_t generation;
+        bool is_delta;
+        // groups heartbeated with a new metadata
+        std::vector<heartbeat_metadata> heartbeats;
+        std::vector<group_id> removed;
+    };
+
+    model::node_id _self;
+    model::node_id _target;
+    uint64_t _session;
+    uint64_t _next_generation{1};
+    uint64_t _acked_generation{0};
+    // groups of the last acknowledged request
+    absl::flat_hash_map<group_id, group_state> _groups;
+    std::optional<in_flight_request> _in_flight;
+};
+
+/**
+ * Follower side of the delta heartbeat sessions of one shard.
+ *
+ * A session lives on the shard that received its requests. If the connection
+ * of a sender moves to another shard the base generation of its next request
+ * is unknown there, the request is not acknowledged and the sender starts the
+ * session over. Sessions that received no request for a while are dropped.
+ */
+class heartbeat_delta_receiver {
+public:
+    struct applied_request {
+        uint64_t session;
+        uint64_t generation;
+        bool is_delta;
+    };
+
+    explicit heartbeat_delta_receiver(clock_type::duration session_timeout);
+
+    /// \brief applies the request to its session
+    ///
+    /// Adds the heartbeats of the unchanged groups of a delta request to the
+    /// request. Returns nothing if the request has no session or isn't
+    /// relative to the current generation of its session, in which case it is
+    /// processed as is and is not acknowledged.
+    std::optional<applied_request> apply(heartbeat_request&);
+
+    /// \brief acknowledges an applied request
+    ///
+    /// Omits the successful replies equal to the ones the sender has already
+    /// received.
+    void compact_reply(const applied_request&, heartbeat_reply&);
+
+    size_t sessions() const { return _sessions.size(); }
+
+private:
+    struct group_state {
+        heartbeat_metadata heartbeat;
+        // last successful reply sent to the leader
+        std::optional<append_entries_reply> reply;
+        uint64_t updated_generation{0};
+    };
+
+    struct session {
+        model::node_id node_id;
+        uint64_t generation{0};
+        clock_type::time_point last_request;
+        absl::flat_hash_map<group_id, group_state> groups;
+    };
+
+    void expire_sessions(clock_type::time_point now);
+
+    clock_type::duration _session_timeout;
+    absl::node_hash_map<uint64_t, session> _sessions;
+};
+
+} // namespace raft
@@ -204,6 +204,10 @@ ss::future<> heartbeat_manager::do_dispatch_heartbeats() {
     auto reqs = requests_for_range(_consensus_groups, _heartbeat_interval());
 
     for (const auto& node_id : reqs.reconnect_nodes) {
+        if (auto it = _delta_senders.find(node_id);
+            it != _delta_senders.end()) {
+            it->second.reset();
+        }
         if (co_await _client_protocol.ensure_disconnect(node_id)) {
             vlog(
               hbeatlog.info, "Closed unresponsive connection to {}", node_id);
@@ -231,13 +235,47 @@ ss::future<> heartbeat_manager::do_self_heartbeat(node_heartbeat&& r) {
     return ss::now();
 }
 
+uint64_t heartbeat_manager::make_delta_request(node_heartbeat& r) {
+    if (!config::shard_local_cfg().raft_delta_heartbeats()) {
+        _delta_senders.clear();
+        return 0;
+    }
+    auto it = _delta_senders.find(r.target);
+    if (it == _delta_senders.end()) {
+        it = _delta_senders
+               .emplace(r.target, heartbeat_delta_sender(_self, r.target))
+               .first;
+    }
+    r.request = it->second.make_request(std::move(r.request.heartbeats));
+    return r.request.delta.generation;
+}
+
+void heartbeat_manager::process_delta_reply(
+  model::node_id n, uint64_t generation, result<heartbeat_reply>& r) {
+    auto it = _delta_senders.find(n);
+    if (generation == 0 || it == _delta_senders.end()) {
+        return;
+    }
+    if (!r) {
+        it->second.reset();
+        return;
+    }
+    it->second.process_reply(generation, r.value());
+}
+
 ss::future<> heartbeat_manager::do_heartbeat(node_heartbeat&& r) {
     auto gate = _bghbeats.hold();
+    const auto groups = r.meta_map.size();
+    const auto generation = make_delta_request(r);
     vlog(
       hbeatlog.trace,
-      "Dispatching hearbeats for {} groups to node: {}",
-      r.meta_map.size(),
-      r.target);
+      "Dispatching hearbeats for {} groups ({} changed) to node: {}, "
+      "generation: {}, base generation: {}",
+      groups,
+      r.request.heartbeats.size(),
+      r.target,
+      generation,
+      r.request.delta.base_generation);
 
     auto f = _client_protocol
                .heartbeat(
@@ -250,7 +288,10 @@ ss::future<> heartbeat_manager::do_heartbeat(node_heartbeat&& r) {
                .then([node = r.target,
                       groups = std::move(r.meta_map),
                       gate = std::move(gate),
+                      generation,
                       this](result<heartbeat_reply> ret) mutable {
+                   // adds replies of the groups the follower omitted
+                   process_delta_reply(node, generation, ret);
                    // this will happen after RPC client will return and resume
                    // sending heartbeats to follower
                    process_reply(node, std::move(groups), std::move(ret));
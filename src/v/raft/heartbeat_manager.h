@@ -16,6 +16,7 @@
 #include "raft/consensus.h"
 #include "raft/consensus_client_protocol.h"
 #include "raft/group_configuration.h"
+#include "raft/heartbeat_delta.h"
 #include "raft/types.h"
 #include "utils/mutex.h"
 
@@ -23,6 +24,7 @@
 #include <seastar/util/log.hh>
 
 #include <absl/container/btree_map.h>
+#include <absl/container/flat_hash_map.h>
 #include <boost/container/flat_set.hpp>
 
 namespace raft::details {
@@ -146,6 +148,12 @@ private:
 
     /// \brief sends a batch to one node
     ss::future<> do_heartbeat(node_heartbeat&&);
+    /// \brief turns the request into a delta of the session with its target,
+    /// returns the generation of the request or 0 if it isn't part of a
+    /// session
+    uint64_t make_delta_request(node_heartbeat&);
+    void
+    process_delta_reply(model::node_id, uint64_t, result<heartbeat_reply>&);
     /// \brief handle heartbeat at local node
     ss::future<> do_self_heartbeat(node_heartbeat&&);
 
@@ -172,5 +180,7 @@ private:
     consensus_set _consensus_groups;
     consensus_client_protocol _client_protocol;
     model::node_id _self;
+    /// delta heartbeat sessions with the followers
+    absl::flat_hash_map<model::node_id, heartbeat_delta_sender> _delta_senders;
 };
 } // namespace raft
@@ -146,6 +146,20 @@ void probe::setup_metrics(const model::ntp& ntp) {
          [this] { return _recovery_request_error; },
          sm::description("Number of failed recovery requests"),
          labels)
+         .aggregate(aggregate_labels),
+       sm::make_counter(
+         "leader_lease_reads",
+         [this] { return _leader_lease_reads; },
+         sm::description(
+           "Number of linearizable barriers served under the leader lease"),
+         labels)
+         .aggregate(aggregate_labels),
+       sm::make_counter(
+         "leader_lease_fallbacks",
+         [this] { return _leader_lease_fallbacks; },
+         sm::description("Number of linearizable barriers which required a "
+                         "round of heartbeats as the leader lease expired"),
+         labels)
          .aggregate(aggregate_labels)});
 }
 
@@ -49,6 +49,9 @@ public:
     void replicate_request_error() { ++_replicate_request_error; };
     void recovery_request_error() { ++_recovery_request_error; };
 
+    void leader_lease_read() { ++_leader_lease_reads; }
+    void leader_lease_fallback() { ++_leader_lease_fallbacks; }
+
 private:
     uint64_t _vote_requests = 0;
     uint64_t _append_requests = 0;
@@ -66,6 +69,8 @@ private:
     uint64_t _heartbeat_request_error = 0;
     uint64_t _replicate_request_error = 0;
     uint64_t _recovery_request_error = 0;
+    uint64_t _leader_lease_reads = 0;
+    uint64_t _leader_lease_fallbacks = 0;
 
     ss::metrics::metric_groups _metrics;
     ss::metrics::metric_groups _public_metrics{
@@ -102,7 +102,7 @@ replicate_entries_stm::send_append_entries_request(
 
     auto f = _ptr->_fstats.get_append_entries_unit(n).then_wrapped(
       [this, req = std::move(req), opts = std::move(opts), n](
-        ss::future<ssx::semaphore_units> f) mutable {
+        ss::future<follower_queue::units> f) mutable {
           // we want to signal dispatch semaphore after calling append entries.
           // When dispatch semaphore is released the append_entries_stm releases
           // op_lock so next append entries request can be dispatched to the
@@ -115,6 +115,7 @@ replicate_entries_stm::send_append_entries_request(
                 make_error_code(errc::append_entries_dispatch_error));
           }
           auto u = f.get();
+          const auto start = std::chrono::steady_clock::now();
 
           return _ptr->_client_protocol
             .append_entries(n.id(), std::move(req), std::move(opts))
@@ -122,8 +123,12 @@ replicate_entries_stm::send_append_entries_request(
                 return _ptr->validate_reply_target_node(
                   "append_entries_replicate", std::move(reply));
             })
-            .finally([this, n, u = std::move(u)] {
-                _ptr->_fstats.return_append_entries_units(n);
+            .finally([this, n, start, u = std::move(u)]() mutable {
+                // release the units before the follower queue may be removed
+                u.depth.return_all();
+                u.shard.reset();
+                _ptr->_fstats.return_append_entries_units(
+                  n, std::chrono::steady_clock::now() - start);
             });
       });
 
@@ -139,4 +139,19 @@ rpc_client_protocol::transfer_leadership(
       });
 }
 
+ss::future<result<append_entries_batch_reply>>
+rpc_client_protocol::append_entries_batch(
+  model::node_id n, append_entries_batch_request&& r, rpc::client_opts opts) {
+    return _connection_cache.local().with_node_client<raftgen_client_protocol>(
+      _self,
+      ss::this_shard_id(),
+      n,
+      opts.timeout,
+      [r = std::move(r),
+       opts = std::move(opts)](raftgen_client_protocol client) mutable {
+          return client.append_entries_batch(std::move(r), std::move(opts))
+            .then(&rpc::get_ctx_data<append_entries_batch_reply>);
+      });
+}
+
 } // namespace raft
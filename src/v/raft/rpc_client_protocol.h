@@ -53,6 +53,9 @@ public:
 
     ss::future<> reset_backoff(model::node_id n);
 
+    ss::future<result<append_entries_batch_reply>> append_entries_batch(
+      model::node_id, append_entries_batch_request&&, rpc::client_opts) final;
+
 private:
     model::node_id _self;
     ss::sharded<rpc::connection_cache>& _connection_cache;
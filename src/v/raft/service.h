@@ -13,10 +13,13 @@
 
 #include "likely.h"
 #include "raft/consensus.h"
+#include "raft/heartbeat_delta.h"
+#include "raft/logger.h"
 #include "raft/raftgen_service.h"
 #include "raft/types.h"
 #include "seastarx.h"
 #include "utils/copy_range.h"
+#include "vlog.h"
 
 #include <seastar/core/sharded.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -54,7 +57,8 @@ public:
       : raftgen_service(sc, ssg)
       , _group_manager(mngr)
       , _shard_table(tbl)
-      , _heartbeat_interval(heartbeat_interval) {
+      , _heartbeat_interval(heartbeat_interval)
+      , _heartbeat_sessions(heartbeat_session_timeout * heartbeat_interval) {
         finjector::shard_local_badger().register_probe(
           failure_probes::name(), &_probe);
     }
@@ -66,6 +70,8 @@ public:
     [[gnu::always_inline]] ss::future<heartbeat_reply>
     heartbeat(heartbeat_request&& r, rpc::streaming_context&) final {
         using ret_t = std::vector<append_entries_reply>;
+        // adds heartbeats of the groups a delta request keeps alive
+        auto applied = _heartbeat_sessions.apply(r);
         std::vector<append_entries_request> reqs;
         reqs.reserve(r.heartbeats.size());
         for (auto& m : r.heartbeats) {
@@ -102,7 +108,10 @@ public:
           });
 
         return ss::when_all_succeed(futures.begin(), futures.end())
-          .then([req_size, missing = std::move(group_missing_replies)](
+          .then([this,
+                 req_size,
+                 applied,
+                 missing = std::move(group_missing_replies)](
                   std::vector<ret_t> replies) mutable {
               ret_t ret;
               ret.reserve(req_size);
@@ -112,7 +121,11 @@ public:
               }
               std::move(
                 missing.begin(), missing.end(), std::back_inserter(ret));
-              return heartbeat_reply{std::move(ret)};
+              heartbeat_reply reply{std::move(ret)};
+              if (applied) {
+                  _heartbeat_sessions.compact_reply(*applied, reply);
+              }
+              return reply;
           });
     }
 
@@ -181,6 +194,15 @@ public:
           });
     }
 
+    [[gnu::always_inline]] ss::future<append_entries_batch_reply>
+    append_entries_batch(
+      append_entries_batch_request&& r, rpc::streaming_context&) final {
+        return _probe.append_entries_batch().then(
+          [this, r = std::move(r)]() mutable {
+              return dispatch_append_entries_batch(std::move(r.requests));
+          });
+    }
+
 private:
     using consensus_ptr = seastar::lw_shared_ptr<consensus>;
     using hbeats_t = std::vector<append_entries_request>;
@@ -189,6 +211,12 @@ private:
         absl::flat_hash_map<ss::shard_id, hbeats_ptr> shard_requests;
         std::vector<append_entries_request> group_missing_requests;
     };
+    // requests of an append entries batch targeting the groups of one shard
+    // and the positions of their replies in the batch reply
+    struct shard_batch_requests {
+        hbeats_ptr requests;
+        std::vector<size_t> positions;
+    };
 
     static ss::future<vote_reply> make_failed_vote_reply() {
         return ss::make_ready_future<vote_reply>(vote_reply{
@@ -209,6 +237,14 @@ private:
           .result = append_entries_reply::status::group_unavailable});
     }
 
+    /// Reply to a request of an append entries batch that failed on this
+    /// node. The leader ignores it, as it ignores a single request which
+    /// failed, and sends the request again.
+    static append_entries_reply make_failed_batch_reply(raft::group_id group) {
+        return append_entries_reply{
+          .group = group, .result = append_entries_reply::status::timeout};
+    }
+
     static ss::future<timeout_now_reply> make_failed_timeout_now_reply() {
         return ss::make_ready_future<timeout_now_reply>(timeout_now_reply{});
     }
@@ -310,6 +346,104 @@ private:
         return ret;
     }
 
+    /// Requests of a batch are enqueued in the append entries buffers of
+    /// their groups as if they were received one by one, each group flushes
+    /// its log once for all the requests it buffered. Unlike heartbeats the
+    /// requests carry data, so they are not subject to a timeout.
+    ss::future<append_entries_batch_reply>
+    dispatch_append_entries_batch(std::vector<append_entries_request> reqs) {
+        std::vector<append_entries_reply> replies;
+        replies.reserve(reqs.size());
+        absl::flat_hash_map<ss::shard_id, shard_batch_requests> shards;
+        for (size_t i = 0; i < reqs.size(); ++i) {
+            auto group = reqs[i].target_group();
+            if (unlikely(!_shard_table.contains(group))) {
+                replies.push_back(append_entries_reply{
+                  .group = group,
+                  .result = append_entries_reply::status::group_unavailable});
+                continue;
+            }
+            // replaced by the reply of the group unless its shard fails
+            replies.push_back(make_failed_batch_reply(group));
+            auto& batch = shards[_shard_table.shard_for(group)];
+            if (!batch.requests) {
+                batch.requests = ss::make_foreign(
+                  std::make_unique<std::vector<append_entries_request>>());
+            }
+            batch.requests->push_back(
+              append_entries_request::make_foreign(std::move(reqs[i])));
+            batch.positions.push_back(i);
+        }
+
+        return ss::do_with(
+          std::move(replies),
+          std::move(shards),
+          [this](
+            std::vector<append_entries_reply>& replies,
+            absl::flat_hash_map<ss::shard_id, shard_batch_requests>& shards) {
+              std::vector<ss::future<>> futures;
+              futures.reserve(shards.size());
+              for (auto& [shard, batch] : shards) {
+                  futures.push_back(
+                    dispatch_batch_to_core(shard, std::move(batch.requests))
+                      .then([&replies, &positions = batch.positions](
+                              std::vector<append_entries_reply> r) {
+                          for (size_t i = 0; i < r.size(); ++i) {
+                              replies[positions[i]] = std::move(r[i]);
+                          }
+                      })
+                      .handle_exception([shard](const std::exception_ptr& e) {
+                          vlog(
+                            raftlog.warn,
+                            "append entries batch requests to shard {} "
+                            "failed: {}",
+                            shard,
+                            e);
+                      }));
+              }
+              return ss::when_all_succeed(futures.begin(), futures.end())
+                .then([&replies] {
+                    return append_entries_batch_reply(std::move(replies));
+                });
+          });
+    }
+
+    ss::future<std::vector<append_entries_reply>>
+    dispatch_batch_to_core(ss::shard_id shard, hbeats_ptr requests) {
+        return with_scheduling_group(
+          get_scheduling_group(),
+          [this, shard, r = std::move(requests)]() mutable {
+              return _group_manager.invoke_on(
+                shard,
+                get_smp_service_group(),
+                [this, r = std::move(r)](ConsensusManager& m) mutable {
+                    std::vector<ss::future<append_entries_reply>> futures;
+                    futures.reserve(r->size());
+                    // enqueue all the requests before waiting for any of
+                    // them, the requests of a group are processed in order
+                    for (auto& req : *r) {
+                        auto group = req.target_group();
+                        futures.push_back(
+                          ss::futurize_invoke([this, &m, &req] {
+                              return dispatch_append_entries(
+                                m, std::move(req));
+                          }).handle_exception([group](
+                                                const std::exception_ptr& e) {
+                              vlog(
+                                raftlog.warn,
+                                "append entries batch request of group {} "
+                                "failed: {}",
+                                group,
+                                e);
+                              return make_failed_batch_reply(group);
+                          }));
+                    }
+                    return ss::when_all_succeed(
+                      futures.begin(), futures.end());
+                });
+          });
+    }
+
     ss::future<append_entries_reply>
     dispatch_append_entries(ConsensusManager& m, append_entries_request&& r) {
         auto group = group_id(r.meta.group);
@@ -320,9 +454,14 @@ private:
         return c->append_entries(std::move(r));
     }
 
+    // delta heartbeat sessions idle for this many heartbeat intervals are
+    // dropped
+    static constexpr int heartbeat_session_timeout = 20;
+
     failure_probes _probe;
     ss::sharded<ConsensusManager>& _group_manager;
     ShardLookup& _shard_table;
     clock_type::duration _heartbeat_interval;
+    heartbeat_delta_receiver _heartbeat_sessions;
 };
 } // namespace raft
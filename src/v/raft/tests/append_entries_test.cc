@@ -8,6 +8,7 @@
 // by the Apache License, Version 2.0
 
 #include "bytes/bytes.h"
+#include "config/configuration.h"
 #include "finjector/hbadger.h"
 #include "model/fundamental.h"
 #include "model/metadata.h"
@@ -25,6 +26,8 @@
 #include "storage/tests/utils/disk_log_builder.h"
 #include "test_utils/async.h"
 
+#include <seastar/util/defer.hh>
+
 #include <system_error>
 
 FIXTURE_TEST(test_entries_are_replicated_to_all_nodes, raft_test_fixture) {
@@ -787,6 +790,235 @@ FIXTURE_TEST(test_linarizable_barrier_single_node, raft_test_fixture) {
     }
 };
 
+FIXTURE_TEST(test_linarizable_barrier_with_leader_lease, raft_test_fixture) {
+    config::shard_local_cfg().raft_leader_lease.set_value(true);
+    auto reset_lease = ss::defer(
+      [] { config::shard_local_cfg().raft_leader_lease.reset(); });
+
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    leader_id = wait_for_group_leader(gr);
+    auto leader_raft = gr.get_member(leader_id).consensus;
+    // heartbeats acknowledged by the followers keep the lease of the leader
+    wait_for(
+      10s,
+      [leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader holds a lease");
+    for (auto& [id, member] : gr.get_members()) {
+        if (id != leader_id) {
+            BOOST_REQUIRE(!member.consensus->has_leader_lease());
+        }
+    }
+
+    auto r = leader_raft->linearizable_barrier().get();
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(r.value(), leader_raft->committed_offset());
+};
+
+FIXTURE_TEST(test_leader_lease_expires_without_followers, raft_test_fixture) {
+    config::shard_local_cfg().raft_leader_lease.set_value(true);
+    auto reset_lease = ss::defer(
+      [] { config::shard_local_cfg().raft_leader_lease.reset(); });
+
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    leader_id = wait_for_group_leader(gr);
+    auto leader_raft = gr.get_member(leader_id).consensus;
+    wait_for(
+      10s,
+      [leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader holds a lease");
+
+    std::vector<model::node_id> followers;
+    for (auto& [id, _] : gr.get_members()) {
+        if (id != leader_id) {
+            followers.push_back(id);
+        }
+    }
+    for (auto id : followers) {
+        gr.disable_node(id);
+    }
+    // without acknowledged heartbeats the lease runs out
+    wait_for(
+      10s,
+      [leader_raft] { return !leader_raft->has_leader_lease(); },
+      "leader lease expired");
+    BOOST_REQUIRE(leader_raft->is_elected_leader());
+
+    // the barrier falls back to a round of heartbeats, it can not complete
+    // until a majority acknowledges them
+    auto barrier = leader_raft->linearizable_barrier();
+    ss::sleep(heartbeat_interval * 5).get();
+    BOOST_REQUIRE(!barrier.available());
+
+    gr.enable_node(followers.front());
+    auto r = barrier.get();
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(r.value(), leader_raft->committed_offset());
+};
+
+FIXTURE_TEST(test_leader_lease_toggled_at_runtime, raft_test_fixture) {
+    auto reset_lease = ss::defer(
+      [] { config::shard_local_cfg().raft_leader_lease.reset(); });
+
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+    leader_id = wait_for_group_leader(gr);
+    auto leader_raft = gr.get_member(leader_id).consensus;
+    BOOST_REQUIRE(!leader_raft->has_leader_lease());
+
+    // send times are recorded from the moment the lease is enabled
+    config::shard_local_cfg().raft_leader_lease.set_value(true);
+    wait_for(
+      10s,
+      [leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader holds a lease");
+
+    // disabling it drops the recorded send times, the lease is acquired
+    // again from the requests sent once it is re-enabled
+    config::shard_local_cfg().raft_leader_lease.set_value(false);
+    BOOST_REQUIRE(!leader_raft->has_leader_lease());
+    config::shard_local_cfg().raft_leader_lease.set_value(true);
+    BOOST_REQUIRE(!leader_raft->has_leader_lease());
+    wait_for(
+      10s,
+      [leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader holds a lease again");
+};
+
+FIXTURE_TEST(test_no_leader_lease_after_transfer, raft_test_fixture) {
+    config::shard_local_cfg().raft_leader_lease.set_value(true);
+    auto reset_lease = ss::defer(
+      [] { config::shard_local_cfg().raft_leader_lease.reset(); });
+
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    leader_id = wait_for_group_leader(gr);
+    auto leader_raft = gr.get_member(leader_id).consensus;
+    wait_for(
+      10s,
+      [leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader holds a lease");
+
+    model::node_id target;
+    for (auto& [id, _] : gr.get_members()) {
+        if (id != leader_id) {
+            target = id;
+            break;
+        }
+    }
+    // the target is down, the transfer fails and the leader stays in place
+    gr.disable_node(target);
+
+    auto started = raft::clock_type::now();
+    auto transfer = leader_raft->do_transfer_leadership(target);
+    BOOST_REQUIRE(!leader_raft->has_leader_lease());
+    auto ec = transfer.get();
+    BOOST_REQUIRE(ec);
+    BOOST_REQUIRE(leader_raft->is_elected_leader());
+
+    // the target may still hold the timeout now request and start an
+    // election, the lease is not regained for an election timeout
+    BOOST_REQUIRE(!leader_raft->has_leader_lease());
+    wait_for(
+      10s,
+      [leader_raft] { return leader_raft->has_leader_lease(); },
+      "leader regained the lease");
+    BOOST_REQUIRE(
+      raft::clock_type::now() - started >= heartbeat_interval * 10);
+};
+
+FIXTURE_TEST(test_restarted_node_refuses_votes, raft_test_fixture) {
+    config::shard_local_cfg().raft_leader_lease.set_value(true);
+    auto reset_lease = ss::defer(
+      [] { config::shard_local_cfg().raft_leader_lease.reset(); });
+
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    wait_for_group_leader(gr);
+
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    // the first node of the configuration campaigns immediately after a
+    // restart, restart the last one
+    model::node_id restarted_id(2);
+    auto candidate = gr.get_member(model::node_id(1)).consensus->self();
+    for (auto id : {0, 1, 2}) {
+        gr.disable_node(model::node_id(id));
+    }
+    // no leader is around, the node only knows it restarted with a non
+    // empty log
+    gr.enable_node(restarted_id);
+    auto node = gr.get_member(restarted_id).consensus;
+    BOOST_REQUIRE_GE(node->dirty_offset(), model::offset(0));
+
+    auto make_vote_request = [&] {
+        return raft::vote_request{
+          .node_id = candidate,
+          .target_node_id = node->self(),
+          .group = node->group(),
+          .term = node->term() + model::term_id(1),
+          .prev_log_index = node->dirty_offset(),
+          .prev_log_term = node->get_term(node->dirty_offset()),
+          .leadership_transfer = false};
+    };
+
+    auto reply = node->vote(make_vote_request()).get();
+    BOOST_REQUIRE(!reply.granted);
+
+    // an election timeout after the restart the node votes again, its own
+    // prevotes fail without other nodes and do not bump the term
+    ss::sleep(heartbeat_interval * 11).get();
+    reply = node->vote(make_vote_request()).get();
+    BOOST_REQUIRE(reply.granted);
+};
+
+FIXTURE_TEST(test_follower_committed_visible_index, raft_test_fixture) {
+    raft_group gr = raft_group(raft::group_id(0), 3);
+    gr.enable_all();
+    auto leader_id = wait_for_group_leader(gr);
+
+    bool success = replicate_random_batches(gr, 5).get0();
+    BOOST_REQUIRE(success);
+
+    leader_id = wait_for_group_leader(gr);
+    auto leader_raft = gr.get_member(leader_id).consensus;
+    const auto committed = leader_raft->committed_offset();
+    // followers learn the commit index with the next heartbeat
+    for (auto& [id, member] : gr.get_members()) {
+        if (id == leader_id) {
+            continue;
+        }
+        auto follower = member.consensus;
+        follower->committed_visible_offset_monitor()
+          .wait(committed, model::timeout_clock::now() + 10s, std::nullopt)
+          .get();
+        BOOST_REQUIRE_GE(follower->last_committed_visible_index(), committed);
+        BOOST_REQUIRE_LE(
+          follower->last_committed_visible_index(),
+          follower->committed_offset());
+    }
+};
+
 FIXTURE_TEST(test_big_batches_replication, raft_test_fixture) {
     raft_group gr = raft_group(raft::group_id(0), 1);
     gr.enable_all();
@@ -0,0 +1,392 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "features/feature_table.h"
+#include "model/record_batch_reader.h"
+#include "model/tests/random_batch.h"
+#include "raft/coalescing_client_protocol.h"
+#include "raft/errc.h"
+#include "raft/service.h"
+#include "raft/types.h"
+#include "seastarx.h"
+#include "ssx/semaphore.h"
+#include "test_utils/async.h"
+#include "units.h"
+
+#include <seastar/core/sharded.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+const model::node_id follower(1);
+constexpr size_t max_batch_bytes = 16_KiB;
+constexpr size_t small_request = 100;
+constexpr size_t large_request = 32_KiB;
+
+struct batching_config {
+    batching_config() {
+        config::shard_local_cfg().raft_append_entries_batch_max_bytes.set_value(
+          max_batch_bytes);
+    }
+    ~batching_config() {
+        config::shard_local_cfg().raft_append_entries_batch_max_bytes.reset();
+    }
+};
+
+/// A request sent by the coalescing client to the transport
+struct sent_request {
+    bool batch{false};
+    std::vector<raft::group_id> groups;
+    // held as the transport does until the request is queued for sending
+    rpc::client_opts::resource_units_t units;
+};
+
+/// Transport recording the requests sent through it. Append entries requests
+/// are replied right away with their group and their prev_log_index as the
+/// last dirty offset, so that a reply can be matched with its request.
+struct recording_protocol final : raft::consensus_client_protocol::impl {
+    template<typename T>
+    static ss::future<result<T>> unexpected() {
+        return ss::make_exception_future<result<T>>(
+          std::logic_error("unexpected request"));
+    }
+
+    static raft::append_entries_reply
+    reply_to(const raft::append_entries_request& r) {
+        return raft::append_entries_reply{
+          .group = r.target_group(),
+          .last_dirty_log_index = r.meta.prev_log_index,
+          .result = raft::append_entries_reply::status::success};
+    }
+
+    ss::future<result<raft::vote_reply>>
+    vote(model::node_id, raft::vote_request&&, rpc::client_opts) final {
+        return unexpected<raft::vote_reply>();
+    }
+
+    ss::future<result<raft::append_entries_reply>> append_entries(
+      model::node_id,
+      raft::append_entries_request&& r,
+      rpc::client_opts opts) final {
+        sent.push_back(sent_request{
+          .groups = {r.target_group()},
+          .units = std::move(opts.resource_units)});
+        return ss::make_ready_future<result<raft::append_entries_reply>>(
+          reply_to(r));
+    }
+
+    ss::future<result<raft::heartbeat_reply>> heartbeat(
+      model::node_id, raft::heartbeat_request&&, rpc::client_opts) final {
+        return unexpected<raft::heartbeat_reply>();
+    }
+
+    ss::future<result<raft::install_snapshot_reply>> install_snapshot(
+      model::node_id, raft::install_snapshot_request&&, rpc::client_opts) final {
+        return unexpected<raft::install_snapshot_reply>();
+    }
+
+    ss::future<result<raft::timeout_now_reply>> timeout_now(
+      model::node_id, raft::timeout_now_request&&, rpc::client_opts) final {
+        return unexpected<raft::timeout_now_reply>();
+    }
+
+    ss::future<bool> ensure_disconnect(model::node_id) final {
+        return ss::make_ready_future<bool>(false);
+    }
+
+    ss::future<result<raft::transfer_leadership_reply>> transfer_leadership(
+      model::node_id,
+      raft::transfer_leadership_request&&,
+      rpc::client_opts) final {
+        return unexpected<raft::transfer_leadership_reply>();
+    }
+
+    ss::future<> reset_backoff(model::node_id) final {
+        return ss::now();
+    }
+
+    ss::future<result<raft::append_entries_batch_reply>> append_entries_batch(
+      model::node_id,
+      raft::append_entries_batch_request&& r,
+      rpc::client_opts opts) final {
+        sent_request s{.batch = true, .units = std::move(opts.resource_units)};
+        std::vector<raft::append_entries_reply> replies;
+        for (const auto& req : r.requests) {
+            s.groups.push_back(req.target_group());
+            replies.push_back(reply_to(req));
+        }
+        sent.push_back(std::move(s));
+        if (batch_reply_size) {
+            replies.resize(*batch_reply_size);
+        }
+        return ss::make_ready_future<result<raft::append_entries_batch_reply>>(
+          raft::append_entries_batch_reply(std::move(replies)));
+    }
+
+    std::vector<sent_request> sent;
+    // number of replies to a batch, one per request when not set
+    std::optional<size_t> batch_reply_size;
+};
+
+struct coalescing_fixture {
+    coalescing_fixture()
+      : transport(ss::make_shared<recording_protocol>())
+      , client(raft::make_coalescing_client_protocol(
+          raft::consensus_client_protocol(transport), features)) {
+        features.testing_activate_all();
+    }
+
+    ss::future<result<raft::append_entries_reply>> send(
+      raft::group_id group,
+      model::offset prev_log_index,
+      size_t record_size,
+      rpc::client_opts::resource_units_t units = nullptr) {
+        ss::circular_buffer<model::record_batch> batches;
+        batches.push_back(
+          model::test::make_random_batch(model::test::record_batch_spec{
+            .offset = prev_log_index + model::offset(1),
+            .allow_compression = false,
+            .count = 1,
+            .record_sizes = std::vector<size_t>{record_size}}));
+        raft::protocol_metadata meta{
+          .group = group, .prev_log_index = prev_log_index};
+        rpc::client_opts opts(rpc::clock_type::now() + 10s);
+        opts.resource_units = std::move(units);
+        return client.append_entries(
+          follower,
+          raft::append_entries_request(
+            raft::vnode(model::node_id(0), model::revision_id(0)),
+            raft::vnode(follower, model::revision_id(0)),
+            meta,
+            model::make_memory_record_batch_reader(std::move(batches))),
+          std::move(opts));
+    }
+
+    batching_config cfg;
+    features::feature_table features;
+    ss::shared_ptr<recording_protocol> transport;
+    raft::consensus_client_protocol client;
+};
+
+rpc::client_opts::resource_units_t take_unit(ssx::semaphore& sem) {
+    auto units = ss::make_lw_shared<std::vector<ssx::semaphore_units>>();
+    units->push_back(ss::get_units(sem, 1).get0());
+    return ss::make_foreign(std::move(units));
+}
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(coalescing_keeps_group_order_with_large_requests) {
+    coalescing_fixture f;
+    const raft::group_id g1(1);
+    const raft::group_id g2(2);
+
+    auto r1 = f.send(g1, model::offset(10), small_request);
+    auto r2 = f.send(g2, model::offset(20), small_request);
+    // a large request is sent on its own, after the small request of its
+    // group buffered before it
+    auto r3 = f.send(g1, model::offset(11), large_request);
+    r1.get();
+    r2.get();
+    r3.get();
+
+    BOOST_REQUIRE_EQUAL(f.transport->sent.size(), 2);
+    BOOST_REQUIRE(f.transport->sent[0].batch);
+    BOOST_REQUIRE(
+      f.transport->sent[0].groups == std::vector<raft::group_id>({g1, g2}));
+    BOOST_REQUIRE(!f.transport->sent[1].batch);
+    BOOST_REQUIRE(
+      f.transport->sent[1].groups == std::vector<raft::group_id>({g1}));
+}
+
+SEASTAR_THREAD_TEST_CASE(coalescing_releases_units_once_batch_is_queued) {
+    coalescing_fixture f;
+    ssx::semaphore sem(2, "test/coalescing");
+
+    auto r1 = f.send(
+      raft::group_id(1), model::offset(10), small_request, take_unit(sem));
+    auto r2 = f.send(
+      raft::group_id(2), model::offset(20), small_request, take_unit(sem));
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 0);
+
+    // the batch is replied, but the transport didn't queue it yet
+    r1.get();
+    r2.get();
+    BOOST_REQUIRE_EQUAL(f.transport->sent.size(), 1);
+    BOOST_REQUIRE(f.transport->sent[0].units);
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 0);
+
+    // queueing the batch releases the units of all of its requests
+    f.transport->sent[0].units = nullptr;
+    tests::cooperative_spin_wait_with_timeout(
+      1s, [&sem] { return sem.available_units() == 2; })
+      .get();
+}
+
+SEASTAR_THREAD_TEST_CASE(coalescing_maps_replies_to_requests) {
+    coalescing_fixture f;
+    std::vector<ss::future<result<raft::append_entries_reply>>> replies;
+    for (int i = 0; i < 4; ++i) {
+        replies.push_back(
+          f.send(raft::group_id(i), model::offset(100 + i), small_request));
+    }
+    for (int i = 0; i < 4; ++i) {
+        auto r = replies[i].get0();
+        BOOST_REQUIRE(r);
+        BOOST_REQUIRE_EQUAL(r.value().group, raft::group_id(i));
+        BOOST_REQUIRE_EQUAL(
+          r.value().last_dirty_log_index, model::offset(100 + i));
+    }
+    BOOST_REQUIRE_EQUAL(f.transport->sent.size(), 1);
+    BOOST_REQUIRE(f.transport->sent[0].batch);
+}
+
+SEASTAR_THREAD_TEST_CASE(coalescing_fails_requests_of_mismatched_reply) {
+    coalescing_fixture f;
+    f.transport->batch_reply_size = 1;
+    auto r1 = f.send(raft::group_id(1), model::offset(10), small_request);
+    auto r2 = f.send(raft::group_id(2), model::offset(20), small_request);
+    for (auto* fut : {&r1, &r2}) {
+        auto r = fut->get0();
+        BOOST_REQUIRE(!r);
+        BOOST_REQUIRE_EQUAL(
+          r.error(),
+          raft::make_error_code(raft::errc::append_entries_dispatch_error));
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(coalescing_sends_single_request_as_it_is) {
+    coalescing_fixture f;
+    ssx::semaphore sem(1, "test/coalescing");
+    auto r = f.send(
+              raft::group_id(1),
+              model::offset(10),
+              small_request,
+              take_unit(sem))
+               .get0();
+    BOOST_REQUIRE(r);
+    BOOST_REQUIRE_EQUAL(r.value().group, raft::group_id(1));
+    BOOST_REQUIRE_EQUAL(f.transport->sent.size(), 1);
+    BOOST_REQUIRE(!f.transport->sent[0].batch);
+    // the units of the request are passed on to the transport
+    BOOST_REQUIRE(f.transport->sent[0].units);
+    f.transport->sent.clear();
+    BOOST_REQUIRE_EQUAL(sem.available_units(), 1);
+}
+
+namespace {
+const raft::group_id missing_group(1000);
+const raft::group_id failing_group(7);
+
+/// Groups of the shard a batch was dispatched to. It has no consensus
+/// instances, requests are replied as for groups not yet created, except the
+/// requests of failing_group which throw.
+struct recording_group_manager {
+    ss::lw_shared_ptr<raft::consensus> consensus_for(raft::group_id g) {
+        groups.push_back(g);
+        if (g == failing_group) {
+            throw std::runtime_error("test failure");
+        }
+        return nullptr;
+    }
+
+    ss::future<> stop() { return ss::now(); }
+
+    std::vector<raft::group_id> groups;
+};
+
+struct modulo_shard_table {
+    ss::shard_id shard_for(raft::group_id g) {
+        return static_cast<ss::shard_id>(g() % ss::smp::count);
+    }
+    bool contains(raft::group_id g) { return g != missing_group; }
+};
+
+struct test_streaming_context final : public rpc::streaming_context {
+    ss::future<ssx::semaphore_units> reserve_memory(size_t) final {
+        return ss::get_units(sem, 1);
+    }
+    const rpc::header& get_header() const final { return hdr; }
+    void signal_body_parse() final {}
+    void body_parse_exception(std::exception_ptr) final {}
+
+    rpc::header hdr;
+    ssx::semaphore sem{1, "test/streaming-context"};
+};
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(append_entries_batch_dispatched_per_shard) {
+    ss::sharded<recording_group_manager> managers;
+    managers.start().get();
+    modulo_shard_table shards;
+    raft::service<recording_group_manager, modulo_shard_table> service(
+      ss::default_scheduling_group(),
+      ss::default_smp_service_group(),
+      managers,
+      shards,
+      100ms);
+
+    std::vector<raft::group_id> groups;
+    std::vector<raft::append_entries_request> requests;
+    for (int i = 0; i < 16; ++i) {
+        groups.emplace_back(i);
+    }
+    groups.push_back(missing_group);
+    for (auto g : groups) {
+        requests.emplace_back(
+          raft::vnode(model::node_id(0), model::revision_id(0)),
+          raft::vnode(follower, model::revision_id(0)),
+          raft::protocol_metadata{.group = g},
+          model::make_memory_record_batch_reader(
+            ss::circular_buffer<model::record_batch>{}));
+    }
+
+    test_streaming_context ctx;
+    auto reply = service
+                   .append_entries_batch(
+                     raft::append_entries_batch_request(std::move(requests)),
+                     ctx)
+                   .get0();
+
+    // replies are in the order of the requests, a group that failed only
+    // fails its own request
+    BOOST_REQUIRE_EQUAL(reply.replies.size(), groups.size());
+    for (size_t i = 0; i < groups.size(); ++i) {
+        BOOST_REQUIRE_EQUAL(reply.replies[i].group, groups[i]);
+        auto expected = raft::append_entries_reply::status::group_unavailable;
+        if (groups[i] == failing_group) {
+            expected = raft::append_entries_reply::status::timeout;
+        }
+        BOOST_REQUIRE_EQUAL(reply.replies[i].result, expected);
+    }
+
+    // every shard only saw the requests of its own groups, in order
+    for (ss::shard_id s = 0; s < ss::smp::count; ++s) {
+        auto seen = managers
+                      .invoke_on(
+                        s,
+                        [](recording_group_manager& m) { return m.groups; })
+                      .get0();
+        std::vector<raft::group_id> expected;
+        for (auto g : groups) {
+            if (g != missing_group && shards.shard_for(g) == s) {
+                expected.push_back(g);
+            }
+        }
+        BOOST_REQUIRE(seen == expected);
+    }
+    managers.stop().get();
+}
@@ -0,0 +1,116 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "raft/follower_queue.h"
+#include "seastarx.h"
+
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+struct adaptive_config {
+    explicit adaptive_config(uint32_t max_depth) {
+        auto& cfg = config::shard_local_cfg();
+        cfg.raft_max_adaptive_append_requests_per_follower.set_value(max_depth);
+        cfg.raft_append_requests_target_latency_ms.set_value(
+          std::chrono::milliseconds(50));
+    }
+    ~adaptive_config() {
+        auto& cfg = config::shard_local_cfg();
+        cfg.raft_max_adaptive_append_requests_per_follower.reset();
+        cfg.raft_append_requests_target_latency_ms.reset();
+    }
+};
+
+const raft::vnode follower(model::node_id(1), model::revision_id(0));
+const raft::vnode other_follower(model::node_id(2), model::revision_id(0));
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(follower_queue_adapts_depth_to_latency) {
+    adaptive_config cfg(32);
+    raft::append_entries_budget budget(config::mock_binding<uint32_t>(256));
+    raft::follower_queue q(follower, 4, budget.for_node(follower.id()));
+    BOOST_REQUIRE_EQUAL(q.depth(), 4);
+
+    // a follower replying well within the target latency gets more requests
+    q.record_latency(1ms);
+    const auto grown = q.depth();
+    BOOST_REQUIRE_GT(grown, 4);
+    BOOST_REQUIRE_LE(grown, 32);
+
+    // only the requests over the configured limit take the shard budget
+    std::vector<raft::follower_queue::units> units;
+    for (size_t i = 0; i < grown; ++i) {
+        units.push_back(q.get_append_entries_unit().get0());
+    }
+    BOOST_REQUIRE(!units.front().shard.has_value());
+    BOOST_REQUIRE(units.back().shard.has_value());
+    BOOST_REQUIRE(!q.is_idle());
+    units.clear();
+    BOOST_REQUIRE(q.is_idle());
+
+    // a follower that falls behind gets fewer, but never less than the
+    // configured limit
+    for (int i = 0; i < 12; ++i) {
+        ss::sleep(110ms).get();
+        q.record_latency(1s);
+    }
+    BOOST_REQUIRE_LT(q.depth(), grown);
+    BOOST_REQUIRE_EQUAL(q.depth(), 4);
+}
+
+SEASTAR_THREAD_TEST_CASE(follower_queue_without_adaptation) {
+    adaptive_config cfg(4);
+    raft::append_entries_budget budget(config::mock_binding<uint32_t>(256));
+    raft::follower_queue q(follower, 4, budget.for_node(follower.id()));
+    q.record_latency(1ms);
+    BOOST_REQUIRE_EQUAL(q.depth(), 4);
+    ss::sleep(110ms).get();
+    q.record_latency(1s);
+    BOOST_REQUIRE_EQUAL(q.depth(), 4);
+}
+
+SEASTAR_THREAD_TEST_CASE(append_entries_budget_per_node) {
+    auto& capacity
+      = config::shard_local_cfg().raft_max_adaptive_append_requests_per_shard;
+    capacity.set_value(uint32_t(2));
+    raft::append_entries_budget budget(capacity.bind());
+
+    // followers on the same node share the budget of the node
+    auto a = budget.for_node(follower.id());
+    auto b = budget.for_node(follower.id());
+    BOOST_REQUIRE_EQUAL(a.get(), b.get());
+    BOOST_REQUIRE_EQUAL(a->available_units(), 2);
+    BOOST_REQUIRE_EQUAL(budget.nodes(), 1);
+
+    // and follows changes of the configured budget
+    capacity.set_value(uint32_t(8));
+    BOOST_REQUIRE_EQUAL(a->available_units(), 8);
+    {
+        auto units = a->get_units(8).get0();
+        capacity.set_value(uint32_t(4));
+        BOOST_REQUIRE_EQUAL(a->available_units(), -4);
+    }
+    BOOST_REQUIRE_EQUAL(a->available_units(), 4);
+
+    // the budget of a node is dropped once no follower queue uses it, e.g.
+    // the node was decommissioned
+    a = nullptr;
+    b = nullptr;
+    auto c = budget.for_node(other_follower.id());
+    BOOST_REQUIRE_EQUAL(budget.nodes(), 1);
+    BOOST_REQUIRE_EQUAL(c->available_units(), 4);
+    capacity.reset();
+}
@@ -0,0 +1,124 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/heartbeat_delta.h"
+#include "raft/types.h"
+#include "serde/serde.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+/**
+ * Heartbeats of one tick between a pair of nodes sharing `Groups` raft groups,
+ * of which 1% committed since the previous tick. Every tick serializes the
+ * request and the reply and deserializes them on the other side, either with
+ * the heartbeats of all groups or as a delta of a heartbeat session. Every
+ * tick counts one operation per group, so the time perf_tests reports is the
+ * time per group heartbeat. The bytes on the wire of both are compared by
+ * heartbeat_delta_test.
+ */
+template<size_t Groups>
+struct heartbeat_bench {
+    static constexpr size_t changed_per_tick = Groups / 100;
+    static inline const model::node_id leader{0};
+    static inline const model::node_id follower{1};
+
+    heartbeat_bench()
+      : sender(leader, follower)
+      , receiver(1h) {
+        heartbeats.reserve(Groups);
+        for (size_t i = 0; i < Groups; ++i) {
+            heartbeats.push_back(raft::heartbeat_metadata{
+              .meta = {
+                .group = raft::group_id(i),
+                .commit_index = model::offset(1000),
+                .term = model::term_id(3),
+                .prev_log_index = model::offset(1000),
+                .prev_log_term = model::term_id(3),
+                .last_visible_index = model::offset(1000)},
+              .node_id = raft::vnode(leader, model::revision_id(10)),
+              .target_node_id = raft::vnode(follower, model::revision_id(10)),
+            });
+        }
+    }
+
+    void next_tick() {
+        for (size_t i = 0; i < changed_per_tick; ++i) {
+            auto& m = heartbeats[(cursor + i) % Groups].meta;
+            m.commit_index++;
+            m.prev_log_index++;
+            m.last_visible_index++;
+        }
+        cursor += changed_per_tick;
+    }
+
+    template<typename T>
+    T send(T t) {
+        iobuf buf;
+        serde::write_async(buf, std::move(t)).get();
+        iobuf_parser parser(std::move(buf));
+        return serde::read<T>(parser);
+    }
+
+    static raft::heartbeat_reply
+    make_reply(const raft::heartbeat_request& request) {
+        raft::heartbeat_reply reply;
+        reply.meta.reserve(request.heartbeats.size());
+        for (const auto& hb : request.heartbeats) {
+            reply.meta.push_back(raft::append_entries_reply{
+              .target_node_id = hb.node_id,
+              .node_id = hb.target_node_id,
+              .group = hb.meta.group,
+              .term = hb.meta.term,
+              .last_flushed_log_index = hb.meta.prev_log_index,
+              .last_dirty_log_index = hb.meta.prev_log_index,
+              .result = raft::append_entries_reply::status::success});
+        }
+        return reply;
+    }
+
+    size_t full_tick() {
+        next_tick();
+        auto request = send(raft::heartbeat_request(heartbeats));
+        send(make_reply(request));
+        return Groups;
+    }
+
+    size_t delta_tick() {
+        next_tick();
+        auto request = sender.make_request(heartbeats);
+        const auto generation = request.delta.generation;
+        request = send(std::move(request));
+        auto applied = receiver.apply(request);
+        auto reply = make_reply(request);
+        if (applied) {
+            receiver.compact_reply(*applied, reply);
+        }
+        reply = send(std::move(reply));
+        sender.process_reply(generation, reply);
+        return Groups;
+    }
+
+    std::vector<raft::heartbeat_metadata> heartbeats;
+    size_t cursor{0};
+    raft::heartbeat_delta_sender sender;
+    raft::heartbeat_delta_receiver receiver;
+};
+
+using heartbeat_bench_10k = heartbeat_bench<10'000>;
+using heartbeat_bench_100k = heartbeat_bench<100'000>;
+
+PERF_TEST_F(heartbeat_bench_10k, full) { return full_tick(); }
+PERF_TEST_F(heartbeat_bench_10k, delta) { return delta_tick(); }
+PERF_TEST_F(heartbeat_bench_100k, full) { return full_tick(); }
+PERF_TEST_F(heartbeat_bench_100k, delta) { return delta_tick(); }
@@ -0,0 +1,280 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "raft/heartbeat_delta.h"
+#include "raft/types.h"
+#include "serde/serde.h"
+
+#include <seastar/testing/thread_test_case.hh>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+const model::node_id leader(0);
+const model::node_id follower(1);
+
+std::vector<raft::heartbeat_metadata> make_heartbeats(size_t groups) {
+    std::vector<raft::heartbeat_metadata> hbs;
+    hbs.reserve(groups);
+    for (size_t i = 0; i < groups; ++i) {
+        hbs.push_back(raft::heartbeat_metadata{
+          .meta = {
+            .group = raft::group_id(i),
+            .commit_index = model::offset(10),
+            .term = model::term_id(1),
+            .prev_log_index = model::offset(10),
+            .prev_log_term = model::term_id(1),
+            .last_visible_index = model::offset(10)},
+          .node_id = raft::vnode(leader, model::revision_id(0)),
+          .target_node_id = raft::vnode(follower, model::revision_id(0)),
+        });
+    }
+    return hbs;
+}
+
+raft::append_entries_reply reply_to(const raft::heartbeat_metadata& hb) {
+    return raft::append_entries_reply{
+      .target_node_id = hb.node_id,
+      .node_id = hb.target_node_id,
+      .group = hb.meta.group,
+      .term = hb.meta.term,
+      .last_flushed_log_index = hb.meta.prev_log_index,
+      .last_dirty_log_index = hb.meta.prev_log_index,
+      .result = raft::append_entries_reply::status::success};
+}
+
+/// Sends the heartbeats of one tick through the sender, the wire and the
+/// receiver, returns the request as sent and the reply as seen by the leader.
+struct tick_result {
+    raft::heartbeat_request sent;
+    raft::heartbeat_reply reply;
+    size_t applied_heartbeats{0};
+};
+
+template<typename T>
+T roundtrip(T t) {
+    iobuf buf;
+    serde::write_async(buf, std::move(t)).get();
+    iobuf_parser parser(std::move(buf));
+    return serde::read<T>(parser);
+}
+
+template<typename T>
+size_t wire_bytes(T t) {
+    iobuf buf;
+    serde::write_async(buf, std::move(t)).get();
+    return buf.size_bytes();
+}
+
+tick_result tick(
+  raft::heartbeat_delta_sender& sender,
+  raft::heartbeat_delta_receiver& receiver,
+  std::vector<raft::heartbeat_metadata> hbs) {
+    auto request = sender.make_request(std::move(hbs));
+    tick_result ret{.sent = request};
+    auto received = roundtrip(std::move(request));
+    auto applied = receiver.apply(received);
+    ret.applied_heartbeats = received.heartbeats.size();
+
+    raft::heartbeat_reply reply;
+    for (const auto& hb : received.heartbeats) {
+        reply.meta.push_back(reply_to(hb));
+    }
+    if (applied) {
+        receiver.compact_reply(*applied, reply);
+    }
+    ret.reply = roundtrip(std::move(reply));
+    sender.process_reply(ret.sent.delta.generation, ret.reply);
+    return ret;
+}
+
+std::vector<raft::group_id> replied_groups(const raft::heartbeat_reply& r) {
+    std::vector<raft::group_id> groups;
+    groups.reserve(r.meta.size());
+    for (const auto& m : r.meta) {
+        groups.push_back(m.group);
+    }
+    std::sort(groups.begin(), groups.end());
+    return groups;
+}
+
+std::vector<raft::group_id> all_groups(size_t n) {
+    std::vector<raft::group_id> groups;
+    for (size_t i = 0; i < n; ++i) {
+        groups.emplace_back(i);
+    }
+    return groups;
+}
+} // namespace
+
+SEASTAR_THREAD_TEST_CASE(heartbeat_delta_roundtrip) {
+    raft::heartbeat_request req(
+      make_heartbeats(3),
+      raft::heartbeat_delta{
+        .node_id = leader,
+        .target_node_id = follower,
+        .session = 42,
+        .generation = 5,
+        .base_generation = 4,
+        .removed = {raft::group_id(7), raft::group_id(9)}});
+    auto res = roundtrip(req);
+    BOOST_REQUIRE_EQUAL(res.delta, req.delta);
+    BOOST_REQUIRE_EQUAL(res.heartbeats.size(), 3);
+
+    // keepalive of all the groups of a session
+    raft::heartbeat_request keepalive({}, req.delta);
+    res = roundtrip(keepalive);
+    BOOST_REQUIRE(res.heartbeats.empty());
+    BOOST_REQUIRE_EQUAL(res.delta, req.delta);
+
+    raft::heartbeat_reply reply;
+    reply.acked_generation = 5;
+    BOOST_REQUIRE_EQUAL(roundtrip(reply).acked_generation, 5);
+}
+
+SEASTAR_THREAD_TEST_CASE(heartbeat_delta_sends_changed_groups) {
+    constexpr size_t groups = 100;
+    raft::heartbeat_delta_sender sender(leader, follower);
+    raft::heartbeat_delta_receiver receiver(10s);
+
+    // first request starts the session with all groups
+    auto r = tick(sender, receiver, make_heartbeats(groups));
+    BOOST_REQUIRE_EQUAL(r.sent.delta.base_generation, 0);
+    BOOST_REQUIRE_EQUAL(r.sent.heartbeats.size(), groups);
+    BOOST_REQUIRE_EQUAL(r.reply.acked_generation, r.sent.delta.generation);
+    BOOST_REQUIRE_EQUAL(sender.acked_generation(), r.sent.delta.generation);
+
+    // nothing changed, a keepalive heartbeats all groups on the follower and
+    // the leader gets all replies back
+    r = tick(sender, receiver, make_heartbeats(groups));
+    BOOST_REQUIRE(r.sent.delta.is_delta());
+    BOOST_REQUIRE(r.sent.heartbeats.empty());
+    BOOST_REQUIRE_EQUAL(r.applied_heartbeats, groups);
+    BOOST_REQUIRE(replied_groups(r.reply) == all_groups(groups));
+
+    // one group committed
+    auto hbs = make_heartbeats(groups);
+    hbs[17].meta.commit_index = model::offset(11);
+    hbs[17].meta.prev_log_index = model::offset(11);
+    r = tick(sender, receiver, hbs);
+    BOOST_REQUIRE_EQUAL(r.sent.heartbeats.size(), 1);
+    BOOST_REQUIRE(r.sent.heartbeats[0] == hbs[17]);
+    BOOST_REQUIRE_EQUAL(r.applied_heartbeats, groups);
+    BOOST_REQUIRE(replied_groups(r.reply) == all_groups(groups));
+    auto it = std::find_if(
+      r.reply.meta.begin(), r.reply.meta.end(), [](const auto& m) {
+          return m.group == raft::group_id(17);
+      });
+    BOOST_REQUIRE_EQUAL(it->last_dirty_log_index, model::offset(11));
+
+    // a group not heartbeated in a tick isn't kept alive by the follower
+    hbs.erase(hbs.begin() + 3);
+    r = tick(sender, receiver, hbs);
+    BOOST_REQUIRE(r.sent.heartbeats.empty());
+    BOOST_REQUIRE_EQUAL(r.sent.delta.removed.size(), 1);
+    BOOST_REQUIRE_EQUAL(r.applied_heartbeats, groups - 1);
+    BOOST_REQUIRE_EQUAL(r.reply.meta.size(), groups - 1);
+
+    // and heartbeated again with its full metadata
+    r = tick(sender, receiver, make_heartbeats(groups));
+    BOOST_REQUIRE_EQUAL(r.sent.heartbeats.size(), 2);
+    BOOST_REQUIRE_EQUAL(r.applied_heartbeats, groups);
+    BOOST_REQUIRE(replied_groups(r.reply) == all_groups(groups));
+}
+
+SEASTAR_THREAD_TEST_CASE(heartbeat_delta_starts_over) {
+    constexpr size_t groups = 10;
+    raft::heartbeat_delta_sender sender(leader, follower);
+    raft::heartbeat_delta_receiver receiver(10s);
+    tick(sender, receiver, make_heartbeats(groups));
+
+    // a request still in flight may have been applied by the follower, the
+    // next request carries all groups
+    auto lost = sender.make_request(make_heartbeats(groups));
+    BOOST_REQUIRE(lost.delta.is_delta());
+    auto r = tick(sender, receiver, make_heartbeats(groups));
+    BOOST_REQUIRE(!r.sent.delta.is_delta());
+    BOOST_REQUIRE_EQUAL(r.sent.heartbeats.size(), groups);
+    // the late reply to the lost request is ignored
+    raft::heartbeat_reply late;
+    late.acked_generation = lost.delta.generation;
+    sender.process_reply(lost.delta.generation, late);
+    BOOST_REQUIRE_EQUAL(sender.acked_generation(), r.sent.delta.generation);
+
+    // a follower which lost its session, e.g. the connection moved to another
+    // shard, doesn't acknowledge the delta
+    raft::heartbeat_delta_receiver other_shard(10s);
+    r = tick(sender, other_shard, make_heartbeats(groups));
+    BOOST_REQUIRE(r.sent.delta.is_delta());
+    BOOST_REQUIRE_EQUAL(r.reply.acked_generation, 0);
+    BOOST_REQUIRE_EQUAL(sender.acked_generation(), 0);
+    r = tick(sender, other_shard, make_heartbeats(groups));
+    BOOST_REQUIRE(!r.sent.delta.is_delta());
+    BOOST_REQUIRE_EQUAL(r.applied_heartbeats, groups);
+    BOOST_REQUIRE_EQUAL(r.reply.acked_generation, r.sent.delta.generation);
+}
+
+SEASTAR_THREAD_TEST_CASE(heartbeat_delta_failed_replies_are_always_sent) {
+    constexpr size_t groups = 4;
+    raft::heartbeat_delta_sender sender(leader, follower);
+    raft::heartbeat_delta_receiver receiver(10s);
+    tick(sender, receiver, make_heartbeats(groups));
+
+    auto request = sender.make_request(make_heartbeats(groups));
+    auto applied = receiver.apply(request);
+    BOOST_REQUIRE(applied);
+    raft::heartbeat_reply reply;
+    for (const auto& hb : request.heartbeats) {
+        reply.meta.push_back(reply_to(hb));
+    }
+    reply.meta[0].result = raft::append_entries_reply::status::timeout;
+    auto failed_group = reply.meta[0].group;
+    receiver.compact_reply(*applied, reply);
+    BOOST_REQUIRE_EQUAL(reply.meta.size(), 1);
+    BOOST_REQUIRE_EQUAL(reply.meta[0].group, failed_group);
+
+    sender.process_reply(request.delta.generation, reply);
+    BOOST_REQUIRE(replied_groups(reply) == all_groups(groups));
+}
+
+SEASTAR_THREAD_TEST_CASE(heartbeat_delta_is_smaller_on_the_wire) {
+    constexpr size_t groups = 1000;
+    raft::heartbeat_delta_sender sender(leader, follower);
+    raft::heartbeat_delta_receiver receiver(10s);
+    auto hbs = make_heartbeats(groups);
+    tick(sender, receiver, hbs);
+
+    // 1% of the groups committed since the previous tick
+    for (size_t i = 0; i < groups / 100; ++i) {
+        hbs[i * 100].meta.commit_index++;
+        hbs[i * 100].meta.prev_log_index++;
+    }
+    raft::heartbeat_request full(hbs);
+    raft::heartbeat_reply full_reply;
+    for (const auto& hb : hbs) {
+        full_reply.meta.push_back(reply_to(hb));
+    }
+    const auto full_bytes = wire_bytes(full) + wire_bytes(full_reply);
+
+    auto request = sender.make_request(hbs);
+    auto applied = receiver.apply(request);
+    BOOST_REQUIRE(applied);
+    raft::heartbeat_reply reply;
+    for (const auto& hb : request.heartbeats) {
+        reply.meta.push_back(reply_to(hb));
+    }
+    receiver.compact_reply(*applied, reply);
+    const auto delta_bytes = wire_bytes(request) + wire_bytes(reply);
+
+    BOOST_REQUIRE_LT(delta_bytes * 10, full_bytes);
+}
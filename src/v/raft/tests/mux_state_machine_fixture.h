@@ -81,6 +81,8 @@ struct mux_state_machine_fixture {
                   .heartbeat_timeout
                   = config::mock_binding<std::chrono::milliseconds>(2000ms),
                   .raft_io_timeout_ms = 30s,
+                  .max_adaptive_append_requests_per_shard
+                  = config::mock_binding<uint32_t>(256),
                 };
             },
             [] {
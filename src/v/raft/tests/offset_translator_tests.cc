@@ -14,6 +14,7 @@
 #include "storage/fwd.h"
 #include "storage/kvstore.h"
 #include "storage/log_manager.h"
+#include "storage/offset_translator_state.h"
 #include "storage/record_batch_builder.h"
 #include "test_utils/fixture.h"
 
@@ -672,3 +673,95 @@ FIXTURE_TEST(test_moving_persistent_state, base_fixture) {
     BOOST_REQUIRE_EQUAL(map.has_value(), false);
     BOOST_REQUIRE_EQUAL(highest_known_offset.has_value(), false);
 }
+
+SEASTAR_THREAD_TEST_CASE(frozen_offset_translator_state) {
+    // a single offset gap at every odd offset: data batch @ 2k -> kafka k
+    const int gaps = 5000;
+    auto ntp = model::ntp(
+      model::ns("test"), model::topic("tp"), model::partition_id(0));
+    storage::offset_translator_state state(ntp, model::offset(-1), 0);
+    for (int i = 0; i < gaps; ++i) {
+        state.add_gap(model::offset(2 * i + 1), model::offset(2 * i + 1));
+    }
+    BOOST_REQUIRE_EQUAL(state.size(), gaps + 1);
+
+    auto validate = [](
+                      const storage::offset_translator_state& st,
+                      int64_t start,
+                      int64_t end) {
+        for (int64_t o = start; o < end; o += 2) {
+            BOOST_REQUIRE_EQUAL(
+              st.from_log_offset(model::offset(o)), model::offset(o / 2));
+            BOOST_REQUIRE_EQUAL(
+              st.to_log_offset(model::offset(o / 2)), model::offset(o));
+            // within a gap the kafka offset stops at the next data offset
+            BOOST_REQUIRE_EQUAL(
+              st.from_log_offset(model::offset(o + 1)),
+              model::offset(o / 2 + 1));
+        }
+    };
+    validate(state, 0, 2 * gaps);
+
+    // truncate within the frozen gaps
+    BOOST_REQUIRE(state.truncate(model::offset(2 * 3000 + 1)));
+    BOOST_REQUIRE_EQUAL(state.last_gap_offset(), model::offset(2 * 2999 + 1));
+    BOOST_REQUIRE_EQUAL(state.last_delta(), 3000);
+    validate(state, 0, 2 * 3000);
+    for (int i = 3000; i < gaps; ++i) {
+        state.add_gap(model::offset(2 * i + 1), model::offset(2 * i + 1));
+    }
+    validate(state, 0, 2 * gaps);
+
+    // prefix truncate within the frozen gaps
+    BOOST_REQUIRE(state.prefix_truncate(model::offset(2 * 1000)));
+    BOOST_REQUIRE_EQUAL(state.size(), gaps - 1000 + 1);
+    validate(state, 2 * 1000 + 2, 2 * gaps);
+    BOOST_REQUIRE_THROW(
+      state.from_log_offset(model::offset(2 * 1000)), std::runtime_error);
+
+    // past the middle of the frozen gaps, they are compacted
+    BOOST_REQUIRE(state.prefix_truncate(model::offset(2 * 4000)));
+    BOOST_REQUIRE_EQUAL(state.size(), gaps - 4000 + 1);
+    validate(state, 2 * 4000 + 2, 2 * gaps);
+
+    // the persisted map loads into an equivalent state
+    auto reloaded = storage::offset_translator_state::from_serialized_map(
+      ntp, state.serialize_map());
+    BOOST_REQUIRE_EQUAL(reloaded.size(), state.size());
+    BOOST_REQUIRE_EQUAL(reloaded.last_delta(), state.last_delta());
+    validate(reloaded, 2 * 4000 + 2, 2 * gaps);
+}
+
+SEASTAR_THREAD_TEST_CASE(frozen_offset_translator_state_sparse_gaps) {
+    // gaps further apart than the packed offsets reach start new frozen runs
+    const int64_t gaps = 1000;
+    const int64_t step = int64_t(1) << 31;
+    auto ntp = model::ntp(
+      model::ns("test"), model::topic("tp"), model::partition_id(0));
+    storage::offset_translator_state state(ntp, model::offset(-1), 0);
+    for (int64_t i = 0; i < gaps; ++i) {
+        state.add_gap(model::offset(i * step + 1), model::offset(i * step + 1));
+    }
+    BOOST_REQUIRE_EQUAL(state.size(), gaps + 1);
+
+    auto validate = [step](
+                      const storage::offset_translator_state& st,
+                      int64_t start,
+                      int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+            // i gaps before the data batch at i * step
+            const auto o = model::offset(i * step);
+            BOOST_REQUIRE_EQUAL(st.from_log_offset(o), model::offset(o - i));
+            BOOST_REQUIRE_EQUAL(st.to_log_offset(model::offset(o - i)), o);
+        }
+    };
+    validate(state, 1, gaps);
+
+    BOOST_REQUIRE(state.truncate(model::offset(500 * step + 1)));
+    BOOST_REQUIRE_EQUAL(state.last_delta(), 500);
+    validate(state, 1, 500);
+
+    BOOST_REQUIRE(state.prefix_truncate(model::offset(300 * step)));
+    BOOST_REQUIRE_EQUAL(state.size(), 500 - 300 + 1);
+    validate(state, 301, 500);
+}
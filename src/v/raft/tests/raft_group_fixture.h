@@ -104,7 +104,8 @@ struct raft_node {
               std::nullopt),
             .default_read_buffer_size = config::mock_binding(512_KiB),
           };
-      }) {
+      })
+      , append_entries_budget(config::mock_binding<uint32_t>(256)) {
         feature_table.start().get();
         feature_table
           .invoke_on_all(
@@ -170,6 +171,7 @@ struct raft_node {
           storage.local(),
           recovery_throttle.local(),
           recovery_mem_quota,
+          append_entries_budget,
           feature_table.local(),
           std::nullopt);
 
@@ -352,6 +354,7 @@ struct raft_node {
     ss::sharded<test_raft_manager> raft_manager;
     leader_clb_t leader_callback;
     raft::recovery_memory_quota recovery_mem_quota;
+    raft::append_entries_budget append_entries_budget;
     std::unique_ptr<raft::heartbeat_manager> hbeats;
     consensus_ptr consensus;
     std::unique_ptr<raft::log_eviction_stm> _nop_stm;
@@ -19,6 +19,7 @@
 #include "raft/types.h"
 #include "random/generators.h"
 #include "reflection/adl.h"
+#include "serde/serde.h"
 #include "storage/record_batch_builder.h"
 #include "test_utils/randoms.h"
 #include "test_utils/rpc.h"
@@ -105,6 +106,82 @@ SEASTAR_THREAD_TEST_CASE(append_entries_requests) {
       .get0();
 }
 
+SEASTAR_THREAD_TEST_CASE(append_entries_batch_roundtrip) {
+    using flush_after_append = raft::append_entries_request::flush_after_append;
+    std::vector<raft::append_entries_request> requests;
+    std::vector<ss::circular_buffer<model::record_batch>> expected;
+    for (int i = 0; i < 3; ++i) {
+        // the last request carries no batches, e.g. an empty request of an
+        // idle group
+        auto batches = model::test::make_random_batches(
+          model::offset(1), i < 2 ? 3 : 0, false);
+        auto readers = raft::details::share_n(
+                         model::make_memory_record_batch_reader(
+                           std::move(batches)),
+                         2)
+                         .get0();
+        expected.push_back(model::consume_reader_to_memory(
+                             std::move(readers.back()), model::no_timeout)
+                             .get0());
+        requests.emplace_back(
+          raft::vnode(model::node_id(1), model::revision_id(10)),
+          raft::vnode(model::node_id(2), model::revision_id(10)),
+          raft::protocol_metadata{
+            .group = raft::group_id(i),
+            .commit_index = model::offset(100 + i),
+            .term = model::term_id(10),
+            .prev_log_index = model::offset(99 + i),
+            .prev_log_term = model::term_id(9),
+            .last_visible_index = model::offset(100 + i)},
+          std::move(readers.front()),
+          i % 2 == 0 ? flush_after_append::yes : flush_after_append::no);
+    }
+
+    iobuf buf;
+    serde::write_async(
+      buf, raft::append_entries_batch_request(std::move(requests)))
+      .get();
+    iobuf_parser parser(std::move(buf));
+    auto d = serde::read_async<raft::append_entries_batch_request>(parser)
+               .get0();
+
+    BOOST_REQUIRE_EQUAL(d.requests.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        auto& r = d.requests[i];
+        BOOST_REQUIRE_EQUAL(r.meta.group, raft::group_id(i));
+        BOOST_REQUIRE_EQUAL(r.meta.commit_index, model::offset(100 + i));
+        BOOST_REQUIRE_EQUAL(r.meta.prev_log_index, model::offset(99 + i));
+        BOOST_REQUIRE_EQUAL(
+          r.target_node_id,
+          raft::vnode(model::node_id(2), model::revision_id(10)));
+        BOOST_REQUIRE_EQUAL(
+          r.flush,
+          i % 2 == 0 ? flush_after_append::yes : flush_after_append::no);
+        r.batches()
+          .consume(checking_consumer(std::move(expected[i])), model::no_timeout)
+          .get0();
+    }
+
+    using status = raft::append_entries_reply::status;
+    raft::append_entries_batch_reply reply;
+    for (int i = 0; i < 3; ++i) {
+        reply.replies.push_back(raft::append_entries_reply{
+          .target_node_id = d.requests[i].node_id,
+          .node_id = d.requests[i].target_node_id,
+          .group = raft::group_id(i),
+          .term = model::term_id(10),
+          .last_flushed_log_index = model::offset(100 + i),
+          .last_dirty_log_index = model::offset(100 + i),
+          .result = i == 1 ? status::group_unavailable : status::success});
+    }
+    iobuf reply_buf;
+    serde::write_async(reply_buf, reply).get();
+    iobuf_parser reply_parser(std::move(reply_buf));
+    BOOST_REQUIRE(
+      serde::read_async<raft::append_entries_batch_reply>(reply_parser).get0()
+      == reply);
+}
+
 model::broker create_test_broker() {
     return model::broker(
       model::node_id(random_generators::get_int(1000)), // id
@@ -161,8 +161,22 @@ std::ostream& operator<<(std::ostream& o, const follower_index_metadata& i) {
              << ", is_recovering: " << i.is_recovering << "}";
 }
 
+std::ostream& operator<<(std::ostream& o, const heartbeat_delta& d) {
+    fmt::print(
+      o,
+      "{{node_id: {}, target_node_id: {}, session: {}, generation: {}, "
+      "base_generation: {}, removed: {}}}",
+      d.node_id,
+      d.target_node_id,
+      d.session,
+      d.generation,
+      d.base_generation,
+      d.removed.size());
+    return o;
+}
+
 std::ostream& operator<<(std::ostream& o, const heartbeat_request& r) {
-    o << "{meta:(" << r.heartbeats.size() << ") [";
+    o << "{delta: " << r.delta << ", meta:(" << r.heartbeats.size() << ") [";
     for (auto& m : r.heartbeats) {
         o << "meta: " << m.meta << ","
           << "node_id: " << m.node_id << ","
@@ -171,13 +185,31 @@ std::ostream& operator<<(std::ostream& o, const heartbeat_request& r) {
     return o << "]}";
 }
 std::ostream& operator<<(std::ostream& o, const heartbeat_reply& r) {
-    o << "{meta:[";
+    o << "{acked_generation: " << r.acked_generation << ", meta:[";
     for (auto& m : r.meta) {
         o << m << ",";
     }
     return o << "]}";
 }
 
+std::ostream&
+operator<<(std::ostream& o, const append_entries_batch_request& r) {
+    o << "{requests:[";
+    for (auto& req : r.requests) {
+        o << "{" << req << "},";
+    }
+    return o << "]}";
+}
+
+std::ostream&
+operator<<(std::ostream& o, const append_entries_batch_reply& r) {
+    o << "{replies:[";
+    for (auto& m : r.replies) {
+        o << m << ",";
+    }
+    return o << "]}";
+}
+
 std::ostream& operator<<(std::ostream& o, const consistency_level& l) {
     switch (l) {
     case consistency_level::quorum_ack:
@@ -253,7 +285,20 @@ std::ostream& operator<<(std::ostream& o, const install_snapshot_reply& r) {
 }
 
 ss::future<> heartbeat_request::serde_async_write(iobuf& dst) {
-    vassert(!heartbeats.empty(), "cannot serialize empty heartbeats request");
+    using serde::write;
+
+    if (heartbeats.empty()) {
+        // delta heartbeat keeping all the groups of the session alive
+        vassert(
+          delta.is_delta(), "cannot serialize empty heartbeats request");
+        iobuf out;
+        write(out, delta.node_id);
+        write(out, delta.target_node_id);
+        write(out, uint32_t(0));
+        write(dst, std::move(out));
+        write(dst, std::move(delta));
+        co_return;
+    }
 
     struct sorter_fn {
         constexpr bool operator()(
@@ -300,8 +345,6 @@ ss::future<> heartbeat_request::serde_async_write(iobuf& dst) {
     // important to release this memory after this function
     // request.meta = {}; // release memory
 
-    using serde::write;
-
     // physical node ids are the same for all requests
     write(out, request.heartbeats.front().node_id.id());
     write(out, request.heartbeats.front().target_node_id.id());
@@ -323,12 +366,16 @@ ss::future<> heartbeat_request::serde_async_write(iobuf& dst) {
       out, encodee.target_revisions);
 
     write(dst, std::move(out));
+    write(dst, std::move(delta));
 }
 
 void heartbeat_request::serde_read(
   iobuf_parser& src, const serde::header& hdr) {
     using serde::read_nested;
     auto tmp = read_nested<iobuf>(src, hdr._bytes_left_limit);
+    if (hdr._version >= 1) {
+        delta = read_nested<heartbeat_delta>(src, hdr._bytes_left_limit);
+    }
     iobuf_parser in(std::move(tmp));
 
     auto& req = *this;
@@ -425,6 +472,8 @@ void heartbeat_reply::serde_write(iobuf& dst) {
     write(out, static_cast<uint32_t>(reply.meta.size()));
     // no requests
     if (reply.meta.empty()) {
+        write(dst, std::move(out));
+        write(dst, reply.acked_generation);
         return;
     }
 
@@ -468,11 +517,15 @@ void heartbeat_reply::serde_write(iobuf& dst) {
     }
 
     write(dst, std::move(out));
+    write(dst, reply.acked_generation);
 }
 
 void heartbeat_reply::serde_read(iobuf_parser& src, const serde::header& hdr) {
     using serde::read_nested;
     auto tmp = read_nested<iobuf>(src, hdr._bytes_left_limit);
+    if (hdr._version >= 1) {
+        acked_generation = read_nested<uint64_t>(src, hdr._bytes_left_limit);
+    }
     iobuf_parser in(std::move(tmp));
 
     auto& reply = *this;
@@ -599,6 +652,25 @@ ss::future<> append_entries_request::serde_async_read(
       in, 0U);
 }
 
+ss::future<> append_entries_batch_request::serde_async_write(iobuf& dst) {
+    serde::write(dst, static_cast<uint32_t>(requests.size()));
+    for (auto& r : requests) {
+        co_await serde::write_async(dst, std::move(r));
+    }
+    requests.clear();
+}
+
+ss::future<> append_entries_batch_request::serde_async_read(
+  iobuf_parser& src, const serde::header hdr) {
+    auto count = serde::read_nested<uint32_t>(src, hdr._bytes_left_limit);
+    requests.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        requests.push_back(
+          co_await serde::read_async_nested<append_entries_request>(
+            src, hdr._bytes_left_limit));
+    }
+}
+
 } // namespace raft
 
 namespace reflection {
@@ -674,8 +746,17 @@ raft::protocol_metadata adl<raft::protocol_metadata>::from(iobuf_parser& in) {
 
 ss::future<> async_adl<raft::heartbeat_request>::to(
   iobuf& out, raft::heartbeat_request&& request) {
-    vassert(
-      !request.heartbeats.empty(), "cannot serialize empty heartbeats request");
+    if (request.heartbeats.empty()) {
+        // the delta of a keepalive can't be encoded with adl, the follower
+        // won't acknowledge it and the next request will carry all groups
+        vassert(
+          request.delta.is_delta(),
+          "cannot serialize empty heartbeats request");
+        adl<model::node_id>{}.to(out, request.delta.node_id);
+        adl<model::node_id>{}.to(out, request.delta.target_node_id);
+        adl<uint32_t>{}.to(out, 0);
+        return ss::now();
+    }
     struct sorter_fn {
         constexpr bool operator()(
           const raft::heartbeat_metadata& lhs,
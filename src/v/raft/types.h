@@ -24,6 +24,7 @@
 #include "reflection/async_adl.h"
 #include "utils/named_type.h"
 
+#include <seastar/core/circular_buffer.hh>
 #include <seastar/core/condition-variable.hh>
 #include <seastar/core/io_priority_class.hh>
 #include <seastar/core/scheduling.hh>
@@ -152,6 +153,15 @@ struct follower_index_metadata {
     follower_req_seq last_received_seq{0};
     // sequence number of last received successfull append entries request
     follower_req_seq last_successful_received_seq{0};
+    // send times of the requests not replied yet, bounded to the most recent
+    // requests
+    ss::circular_buffer<std::pair<follower_req_seq, clock_type::time_point>>
+      requests_sent_at;
+    // send time of the last request of the current term the follower
+    // processed. It doesn't vote for another candidate for an election
+    // timeout after that, this anchors the leader lease.
+    clock_type::time_point last_processed_request_sent_at
+      = clock_type::time_point::min();
     bool is_learner = true;
     bool is_recovering = false;
 
@@ -191,6 +201,8 @@ struct follower_metrics {
     clock_type::time_point last_heartbeat;
     bool is_live;
     bool under_replicated;
+    // number of concurrent append entries requests allowed to the follower
+    size_t append_entries_depth{0};
 };
 
 struct append_entries_request
@@ -352,6 +364,50 @@ struct heartbeat_metadata {
       = default;
 };
 
+/**
+ * Delta heartbeats.
+ *
+ * Heartbeats from one heartbeat manager to a node form a session. The follower
+ * acknowledges the generation of every request of the session it applied and
+ * further requests are relative to the last acknowledged generation: they only
+ * carry heartbeats of the groups whose metadata changed since, list the groups
+ * that are no longer heartbeated in `removed`, and every other group of the
+ * acknowledged generation is heartbeated again with its unchanged metadata.
+ * A request with no heartbeats is a keepalive of all the groups.
+ *
+ * Requests with a `base_generation` of 0 carry heartbeats of all the groups
+ * and start the session over. A `session` of 0 is a request of a sender not
+ * using delta heartbeats.
+ */
+struct heartbeat_delta
+  : serde::
+      envelope<heartbeat_delta, serde::version<0>, serde::compat_version<0>> {
+    // physical nodes of the request, even if it carries no heartbeats
+    model::node_id node_id;
+    model::node_id target_node_id;
+    uint64_t session{0};
+    uint64_t generation{0};
+    uint64_t base_generation{0};
+    std::vector<group_id> removed;
+
+    bool is_delta() const { return session != 0 && base_generation != 0; }
+
+    friend std::ostream& operator<<(std::ostream& o, const heartbeat_delta& d);
+
+    friend bool operator==(const heartbeat_delta&, const heartbeat_delta&)
+      = default;
+
+    auto serde_fields() {
+        return std::tie(
+          node_id,
+          target_node_id,
+          session,
+          generation,
+          base_generation,
+          removed);
+    }
+};
+
 /// \brief this is our _biggest_ modification to how raft works
 /// to accomodate for millions of raft groups in a cluster.
 /// internally, the receiving side will simply iterate and dispatch one
@@ -360,12 +416,18 @@ struct heartbeat_metadata {
 /// log at some offset
 struct heartbeat_request
   : serde::
-      envelope<heartbeat_request, serde::version<0>, serde::compat_version<0>> {
+      envelope<heartbeat_request, serde::version<1>, serde::compat_version<0>> {
     std::vector<heartbeat_metadata> heartbeats;
+    // only serialized with serde, requests encoded with adl are never deltas
+    heartbeat_delta delta;
 
     heartbeat_request() noexcept = default;
     explicit heartbeat_request(std::vector<heartbeat_metadata> heartbeats)
       : heartbeats(std::move(heartbeats)) {}
+    heartbeat_request(
+      std::vector<heartbeat_metadata> heartbeats, heartbeat_delta delta)
+      : heartbeats(std::move(heartbeats))
+      , delta(std::move(delta)) {}
 
     friend std::ostream&
     operator<<(std::ostream& o, const heartbeat_request& r);
@@ -379,8 +441,12 @@ struct heartbeat_request
 
 struct heartbeat_reply
   : serde::
-      envelope<heartbeat_reply, serde::version<0>, serde::compat_version<0>> {
+      envelope<heartbeat_reply, serde::version<1>, serde::compat_version<0>> {
     std::vector<append_entries_reply> meta;
+    /// generation of the heartbeat request the follower applied to its
+    /// session, 0 if it didn't. Replies to a delta request omit successful
+    /// replies equal to the ones sent for its base generation.
+    uint64_t acked_generation{0};
 
     heartbeat_reply() noexcept = default;
     explicit heartbeat_reply(std::vector<append_entries_reply> meta)
@@ -395,6 +461,59 @@ struct heartbeat_reply
     void serde_read(iobuf_parser&, const serde::header&);
 };
 
+/// \brief append entries requests of many groups replicated to the same node,
+/// sent in a single message. Each request is processed as if it was received
+/// on its own, in particular it is flushed according to its `flush` flag.
+/// Requests of the same group are in the order they were sent.
+struct append_entries_batch_request
+  : serde::envelope<
+      append_entries_batch_request,
+      serde::version<0>,
+      serde::compat_version<0>> {
+    // only sent once the whole cluster supports it, see
+    // feature::raft_append_entries_batching
+    using rpc_adl_exempt = std::true_type;
+
+    std::vector<append_entries_request> requests;
+
+    append_entries_batch_request() noexcept = default;
+    explicit append_entries_batch_request(
+      std::vector<append_entries_request> requests) noexcept
+      : requests(std::move(requests)) {}
+
+    friend std::ostream&
+    operator<<(std::ostream& o, const append_entries_batch_request& r);
+
+    ss::future<> serde_async_write(iobuf& out);
+    ss::future<> serde_async_read(iobuf_parser&, const serde::header);
+};
+
+/// \brief replies to the requests of an append_entries_batch_request, in the
+/// order of the requests
+struct append_entries_batch_reply
+  : serde::envelope<
+      append_entries_batch_reply,
+      serde::version<0>,
+      serde::compat_version<0>> {
+    using rpc_adl_exempt = std::true_type;
+
+    std::vector<append_entries_reply> replies;
+
+    append_entries_batch_reply() noexcept = default;
+    explicit append_entries_batch_reply(
+      std::vector<append_entries_reply> replies) noexcept
+      : replies(std::move(replies)) {}
+
+    friend std::ostream&
+    operator<<(std::ostream& o, const append_entries_batch_reply& r);
+
+    friend bool operator==(
+      const append_entries_batch_reply&, const append_entries_batch_reply&)
+      = default;
+
+    auto serde_fields() { return std::tie(replies); }
+};
+
 struct vote_request
   : serde::envelope<vote_request, serde::version<0>, serde::compat_version<0>> {
     vnode node_id;
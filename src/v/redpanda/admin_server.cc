@@ -3303,6 +3303,50 @@ void admin_server::register_debug_routes() {
 
           return ss::make_ready_future<ss::json::json_return_type>(ret);
       });
+
+    register_route<superuser>(
+      seastar::httpd::debug_json::get_key_lookup,
+      [this](std::unique_ptr<ss::httpd::request> req) {
+          return get_key_lookup_handler(std::move(req));
+      });
+}
+
+ss::future<ss::json::json_return_type>
+admin_server::get_key_lookup_handler(std::unique_ptr<ss::httpd::request> req) {
+    const model::ntp ntp = parse_ntp_from_request(req->param);
+    auto key = req->get_query_param("key");
+    if (key.empty()) {
+        throw ss::httpd::bad_param_exception("Missing key");
+    }
+
+    auto shard = _shard_table.local().shard_for(ntp);
+    if (!shard) {
+        throw ss::httpd::not_found_exception(
+          fmt::format("Partition {} not found on this node", ntp));
+    }
+
+    co_return co_await _partition_manager.invoke_on(
+      *shard,
+      [ntp, key = bytes(key.begin(), key.end())](
+        cluster::partition_manager& pm) mutable
+      -> ss::future<ss::json::json_return_type> {
+          auto partition = pm.get(ntp);
+          if (!partition) {
+              throw ss::httpd::not_found_exception(
+                fmt::format("Partition {} not found on this node", ntp));
+          }
+          auto result = co_await partition->log().lookup_key(std::move(key));
+
+          ss::httpd::debug_json::key_lookup_result ret;
+          ret.found = result.offset.has_value();
+          if (result.offset) {
+              ret.offset = partition->get_offset_translator_state()
+                             ->from_log_offset(*result.offset);
+          }
+          ret.segments_read = result.segments_read;
+          ret.segments_skipped = result.segments_skipped;
+          co_return ss::json::json_return_type(ret);
+      });
 }
 ss::future<ss::json::json_return_type>
 admin_server::get_partition_balancer_status_handler(
@@ -336,6 +336,10 @@ private:
     ss::future<ss::json::json_return_type>
       redpanda_services_restart_handler(std::unique_ptr<ss::httpd::request>);
 
+    /// Debug routes
+    ss::future<ss::json::json_return_type>
+      get_key_lookup_handler(std::unique_ptr<ss::httpd::request>);
+
     ss::future<> throw_on_error(
       ss::httpd::request& req,
       std::error_code ec,
@@ -80,7 +80,8 @@ public:
       std::optional<cloud_storage::configuration> cloud_cfg = std::nullopt,
       configure_node_id use_node_id = configure_node_id::yes,
       const empty_seed_starts_cluster empty_seed_starts_cluster_val
-      = empty_seed_starts_cluster::yes)
+      = empty_seed_starts_cluster::yes,
+      model::rack_id rack = model::rack_id(rack_name))
       : app(ssx::sformat("redpanda-{}", node_id()))
       , proxy_port(proxy_port)
       , schema_reg_port(schema_reg_port)
@@ -97,7 +98,8 @@ public:
           std::move(archival_cfg),
           std::move(cloud_cfg),
           use_node_id,
-          empty_seed_starts_cluster_val);
+          empty_seed_starts_cluster_val,
+          std::move(rack));
         app.initialize(
           proxy_config(proxy_port),
           proxy_client_config(kafka_port),
@@ -246,7 +248,8 @@ public:
       std::optional<cloud_storage::configuration> cloud_cfg = std::nullopt,
       configure_node_id use_node_id = configure_node_id::yes,
       const empty_seed_starts_cluster empty_seed_starts_cluster_val
-      = empty_seed_starts_cluster::yes) {
+      = empty_seed_starts_cluster::yes,
+      model::rack_id rack = model::rack_id(rack_name)) {
         auto base_path = std::filesystem::path(data_dir);
         ss::smp::invoke_on_all([node_id,
                                 kafka_port,
@@ -258,7 +261,8 @@ public:
                                 archival_cfg,
                                 cloud_cfg,
                                 use_node_id,
-                                empty_seed_starts_cluster_val]() mutable {
+                                empty_seed_starts_cluster_val,
+                                rack]() mutable {
             auto& config = config::shard_local_cfg();
 
             config.get("enable_pid_file").set_value(false);
@@ -276,8 +280,7 @@ public:
                           : std::optional<model::node_id>(std::nullopt));
             node_config.get("empty_seed_starts_cluster")
               .set_value(bool(empty_seed_starts_cluster_val));
-            node_config.get("rack").set_value(
-              std::make_optional(model::rack_id(rack_name)));
+            node_config.get("rack").set_value(std::make_optional(rack));
             node_config.get("seed_servers").set_value(seed_servers);
             node_config.get("rpc_server")
               .set_value(net::unresolved_address("127.0.0.1", rpc_port));
@@ -0,0 +1,91 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/adaptive_read_ahead.h"
+
+#include "config/configuration.h"
+#include "storage/logger.h"
+#include "storage/storage_resources.h"
+#include "vlog.h"
+
+#include <algorithm>
+
+namespace storage {
+
+namespace {
+unsigned configured_read_ahead() {
+    return static_cast<unsigned>(std::max<int16_t>(
+      config::shard_local_cfg().storage_read_readahead_count(), 0));
+}
+} // namespace
+
+adaptive_read_ahead::adaptive_read_ahead()
+  : _enabled(config::shard_local_cfg().storage_adaptive_read_ahead())
+  , _initial{
+      .buffer_size = config::shard_local_cfg().storage_read_buffer_size(),
+      .read_ahead = std::min(1u, configured_read_ahead())}
+  , _max{
+      .buffer_size = std::max(_initial.buffer_size, max_buffer_size),
+      .read_ahead = configured_read_ahead()}
+  , _current(_initial) {}
+
+std::optional<read_window> adaptive_read_ahead::window() const {
+    if (!_enabled) {
+        return std::nullopt;
+    }
+    return _current;
+}
+
+read_window adaptive_read_ahead::next_window() const {
+    auto w = _current;
+    if (w.read_ahead < _max.read_ahead) {
+        w.read_ahead = std::min(std::max(w.read_ahead * 2, 1u), _max.read_ahead);
+    } else if (w.buffer_size < _max.buffer_size) {
+        w.buffer_size = std::min(w.buffer_size * 2, _max.buffer_size);
+    }
+    return w;
+}
+
+bool adaptive_read_ahead::record_sequential_read(
+  size_t bytes, storage_resources& resources) {
+    if (!_enabled) {
+        return false;
+    }
+    _sequential_bytes += bytes;
+    if (_sequential_bytes < 2 * _current.memory()) {
+        return false;
+    }
+    auto next = next_window();
+    if (next == _current) {
+        return false;
+    }
+    auto units = resources.read_ahead_try_take_bytes(
+      next.memory() - _current.memory());
+    if (!units) {
+        // over the shard's budget, try again once more has been read
+        return false;
+    }
+    if (_units.count()) {
+        _units.adopt(std::move(*units));
+    } else {
+        _units = std::move(*units);
+    }
+    vlog(stlog.trace, "Growing read window from {} to {}", _current, next);
+    _current = next;
+    _sequential_bytes = 0;
+    return true;
+}
+
+void adaptive_read_ahead::reset() {
+    _current = _initial;
+    _sequential_bytes = 0;
+    _units.return_all();
+}
+
+} // namespace storage
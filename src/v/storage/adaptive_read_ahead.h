@@ -0,0 +1,66 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "ssx/semaphore.h"
+#include "storage/segment_reader.h"
+#include "units.h"
+
+#include <cstddef>
+#include <optional>
+
+namespace storage {
+
+class storage_resources;
+
+/**
+ * Sizes the reads of a log reader by how sequential its reads are.
+ *
+ * Readers start with the configured buffer size and a single read ahead, so
+ * point reads (fetching a few batches, timequeries) don't issue reads they
+ * won't consume. Every time a reader read twice the memory of its current
+ * window without seeking the window grows: first the read ahead doubles up to
+ * the configured read ahead count, then the buffer size doubles up to
+ * `max_buffer_size`. The memory of a window beyond the initial one is taken
+ * from the shard's read ahead budget, a reader which doesn't get it keeps its
+ * current window.
+ */
+class adaptive_read_ahead {
+public:
+    static constexpr size_t max_buffer_size = 1_MiB;
+
+    adaptive_read_ahead();
+
+    /// \brief window of the streams opened next, std::nullopt when adaptive
+    /// read ahead is disabled and streams use the defaults of the segment
+    std::optional<read_window> window() const;
+
+    /// \brief accounts bytes read from disk without seeking. Returns true
+    /// when the window grew, streams opened with the previous window should
+    /// be reopened to read with the new one.
+    bool record_sequential_read(size_t bytes, storage_resources&);
+
+    /// \brief the reader seeked, back to the initial window
+    void reset();
+
+private:
+    read_window next_window() const;
+
+    bool _enabled;
+    read_window _initial;
+    read_window _max;
+    read_window _current;
+    size_t _sequential_bytes{0};
+    ssx::semaphore_units _units;
+};
+
+} // namespace storage
@@ -73,6 +73,8 @@ public:
       , _log_conf_cb(std::move(log_conf_cb)) {}
 
     ss::future<> start() {
+        _resources.flushes().setup_metrics();
+        _resources.reader_handles().setup_metrics();
         _kvstore = std::make_unique<kvstore>(_kv_conf_cb(), _resources);
         return _kvstore->start().then([this] {
             _log_mgr = std::make_unique<log_manager>(
@@ -86,9 +88,10 @@ public:
             f = _log_mgr->stop();
         }
         if (_kvstore) {
-            return f.then([this] { return _kvstore->stop(); });
+            f = f.then([this] { return _kvstore->stop(); });
         }
-        return f;
+        return f.then([this] { return _resources.flushes().stop(); })
+          .then([this] { return _resources.reader_handles().stop(); });
     }
 
     void set_node_uuid(const model::node_uuid& node_uuid) {
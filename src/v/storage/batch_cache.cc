@@ -134,11 +134,14 @@ batch_cache::batch_cache(const reclaim_options& opts)
   , _background_reclaimer(
       *this, opts.min_free_memory, opts.background_reclaimer_sg)
   , _available_mem_deregister(register_memory_reporter(*this)) {
+    _probe.setup_metrics(*this);
     _background_reclaimer.start();
 }
 
-batch_cache::entry
-batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
+batch_cache::entry batch_cache::put(
+  batch_cache_index& index,
+  const model::record_batch& input,
+  is_historical historical) {
     // notify no matter what the exit path
     auto notify_guard = ss::defer([this] { _background_reclaimer.notify(); });
 
@@ -156,10 +159,25 @@ batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
     // shouldn't--`e` wouldn't be visible to the reclaimer since it
     // isn't on a lru/pool list.
 
+    // new ranges are always admitted to the probationary segment, historical
+    // ones at its head so that they are the first to be reclaimed
+    auto admit = [this, historical](range& r) {
+        if (historical) {
+            _probation_lru.push_front(r);
+        } else {
+            _probation_lru.push_back(r);
+        }
+        _size_bytes += r.memory_size();
+    };
+    if (historical) {
+        _probe.historical_admission();
+    } else {
+        _probe.admission();
+    }
+
     if (static_cast<size_t>(input.size_bytes()) > range::range_size) {
         auto r = new range(index, input);
-        _lru.push_back(*r);
-        _size_bytes += r->memory_size();
+        admit(*r);
         return entry(0, r->weak_from_this());
     }
 
@@ -167,8 +185,7 @@ batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
       !index._small_batches_range || !index._small_batches_range->valid()
       || !index._small_batches_range->fits(input)) {
         auto r = new range(index);
-        _lru.push_back(*r);
-        _size_bytes += r->memory_size();
+        admit(*r);
         index._small_batches_range = r->weak_from_this();
     }
 
@@ -178,13 +195,45 @@ batch_cache::put(batch_cache_index& index, const model::record_batch& input) {
     int64_t diff = (int64_t)index._small_batches_range->memory_size()
                    - initial_sz;
     _size_bytes += diff;
+    if (index._small_batches_range->_in_protected) {
+        _protected_size_bytes += diff;
+    }
     return entry(offset, index._small_batches_range->weak_from_this());
 }
 
+void batch_cache::promote(range& r) {
+    r._hook.unlink();
+    if (!r._in_protected) {
+        r._in_protected = true;
+        _protected_size_bytes += r.memory_size();
+        _probe.promotion();
+    }
+    _protected_lru.push_back(r);
+    maybe_demote();
+}
+
+void batch_cache::maybe_demote() {
+    const auto max_protected_size = static_cast<size_t>(
+      static_cast<double>(_size_bytes) * protected_ratio);
+    /*
+     * the range that was just promoted sits at the tail of the protected
+     * segment, it is demoted only if it alone exceeds the protected budget.
+     */
+    while (_protected_size_bytes > max_protected_size
+           && !_protected_lru.empty()) {
+        auto& r = _protected_lru.front();
+        r._hook.unlink();
+        r._in_protected = false;
+        _protected_size_bytes -= r.memory_size();
+        _probation_lru.push_back(r);
+        _probe.demotion();
+    }
+}
+
 batch_cache::~batch_cache() noexcept {
     clear();
     vassert(
-      _size_bytes == 0 && _lru.empty(),
+      _size_bytes == 0 && _protected_size_bytes == 0 && empty(),
       "Detected incorrect batch_cache accounting. {}",
       *this);
 }
@@ -196,8 +245,12 @@ void batch_cache::evict(range_ptr&& e) {
         // r-value reference `e` wouldn't do that.
         auto p = std::exchange(e, {});
         _size_bytes -= p->memory_size();
-        _lru.erase_and_dispose(
-          _lru.iterator_to(*p), [](range* e) { delete e; });
+        if (p->_in_protected) {
+            _protected_size_bytes -= p->memory_size();
+        }
+        auto& lru = lru_of(*p);
+        lru.erase_and_dispose(
+          lru.iterator_to(*p), [](range* e) { delete e; });
     }
 }
 
@@ -240,9 +293,45 @@ size_t batch_cache::reclaim(size_t size) {
      * index still exists even though the batch data was removed.
      */
     size_t reclaimed = 0;
-    intrusive_list<range, &range::_hook> reclaimed_ranges;
+    lru_type reclaimed_ranges;
+
+    // probationary segment is always drained first
+    reclaim_from(_probation_lru, reclaimed, reclaimed_ranges);
+    reclaim_from(_protected_lru, reclaimed, reclaimed_ranges);
+
+    /*
+     * final removal from the index is deferred because there is some chance
+     * that removal allocates, so waiting until the bulk of the reclaims have
+     * occurred reduces the probability of an allocation failure.
+     */
+
+    reclaimed_ranges.clear_and_dispose([](range* e) {
+        auto* index = &e->_index;
+        auto offsets = std::move(e->_offsets);
+        delete e; // NOLINT
 
-    for (auto it = _lru.begin(); it != _lru.end();) {
+        /*
+         * since reclaim may be invoked at any moment and removals may be
+         * deferred if an index is locked, one can imagine races in which a
+         * batch is removed by offset here which is not the same batch that was
+         * reclaimed in a prior pass. at worst this would raise the miss ratio,
+         * but is still generally safe since all batch cache users are prepared
+         * to handle a miss.
+         */
+        for (auto& o : offsets) {
+            index->remove(o);
+        }
+    });
+
+    _last_reclaim = ss::lowres_clock::now();
+    _size_bytes -= reclaimed;
+    _probe.add_reclaimed_bytes(reclaimed);
+    return reclaimed;
+}
+
+void batch_cache::reclaim_from(
+  lru_type& lru, size_t& reclaimed, lru_type& reclaimed_ranges) {
+    for (auto it = lru.begin(); it != lru.end();) {
         if (reclaimed >= _reclaim_size) {
             break;
         }
@@ -257,7 +346,11 @@ size_t batch_cache::reclaim(size_t size) {
             continue;
         }
         // reclaim the batch's record data
-        reclaimed += it->memory_size();
+        const auto range_size = it->memory_size();
+        reclaimed += range_size;
+        if (it->_in_protected) {
+            _protected_size_bytes -= range_size;
+        }
         it->_arena.clear();
 
         /*
@@ -272,38 +365,10 @@ size_t batch_cache::reclaim(size_t size) {
         }
 
         // collect the entries that will be fully removed
-        it = _lru.erase_and_dispose(it, [&reclaimed_ranges](range* e) {
+        it = lru.erase_and_dispose(it, [&reclaimed_ranges](range* e) {
             reclaimed_ranges.push_back(*e);
         });
     }
-
-    /*
-     * final removal from the index is deferred because there is some chance
-     * that removal allocates, so waiting until the bulk of the reclaims have
-     * occurred reduces the probability of an allocation failure.
-     */
-
-    reclaimed_ranges.clear_and_dispose([](range* e) {
-        auto* index = &e->_index;
-        auto offsets = std::move(e->_offsets);
-        delete e; // NOLINT
-
-        /*
-         * since reclaim may be invoked at any moment and removals may be
-         * deferred if an index is locked, one can imagine races in which a
-         * batch is removed by offset here which is not the same batch that was
-         * reclaimed in a prior pass. at worst this would raise the miss ratio,
-         * but is still generally safe since all batch cache users are prepared
-         * to handle a miss.
-         */
-        for (auto& o : offsets) {
-            index->remove(o);
-        }
-    });
-
-    _last_reclaim = ss::lowres_clock::now();
-    _size_bytes -= reclaimed;
-    return reclaimed;
 }
 
 std::optional<model::record_batch>
@@ -311,9 +376,11 @@ batch_cache_index::get(model::offset offset) {
     lock_guard lk(*this);
     if (auto it = find_first_contains(offset); it != _index.end()) {
         batch_cache::range::lock_guard g(*it->second.range());
+        _cache->probe().hit();
         _cache->touch(it->second.range());
         return it->second.batch();
     }
+    _cache->probe().miss();
     return std::nullopt;
 }
 
@@ -380,6 +447,11 @@ batch_cache_index::read_result batch_cache_index::read(
             break;
         }
     }
+    if (ret.batches.empty()) {
+        _cache->probe().miss();
+    } else {
+        _cache->probe().hit();
+    }
     ret.next_batch = offset;
     return ret;
 }
@@ -451,7 +523,9 @@ std::ostream& operator<<(std::ostream& o, const batch_cache& b) {
     // Do _not_ print size of _lru
     return o << "{is_reclaiming:" << b.is_memory_reclaiming()
              << ", size_bytes: " << b._size_bytes
-             << ", lru_empty:" << b._lru.empty() << "}";
+             << ", protected_size_bytes: " << b._protected_size_bytes
+             << ", probation_empty:" << b._probation_lru.empty()
+             << ", protected_empty:" << b._protected_lru.empty() << "}";
 }
 std::ostream&
 operator<<(std::ostream& o, const batch_cache_index::read_result& c) {
@@ -13,6 +13,7 @@
 #include "model/record.h"
 #include "resource_mgmt/available_memory.h"
 #include "ssx/semaphore.h"
+#include "storage/probe.h"
 #include "units.h"
 #include "utils/intrusive_list_helpers.h"
 #include "vassert.h"
@@ -24,6 +25,7 @@
 #include <seastar/core/memory.hh>
 #include <seastar/core/scheduling.hh>
 #include <seastar/core/weak_ptr.hh>
+#include <seastar/util/bool_class.hh>
 
 #include <absl/container/btree_map.h>
 #include <absl/container/flat_hash_map.h>
@@ -38,7 +40,7 @@ class batch_cache_index;
 
 /**
  * The batch cache system consists of two components. The `batch_cache` is a
- * global (per-shard) LRU cache of batches stored in memory. The second
+ * global (per-shard) segmented LRU cache of batches stored in memory. The second
  * component is the `batch_cache_index` which presents an offset-based index
  * into the global cache.
  *
@@ -57,6 +59,23 @@ class batch_cache_index;
  * example, a batch cache index is created for each log segment, all of which
  * share the same LRU cache.
  *
+ * Admission and eviction
+ * ======================
+ *
+ * The cache is a segmented LRU split into a probationary and a protected
+ * segment. Newly inserted ranges are admitted to the probationary segment and
+ * are promoted to the protected segment only when they are hit again. The
+ * protected segment is bounded to `protected_ratio` of the cache size, ranges
+ * falling out of it are demoted back to the tail of the probationary segment.
+ * Reclaim always drains the probationary segment first.
+ *
+ * This makes the cache resistant to scans: a catch-up consumer or a recovery
+ * reading an old backlog only ever churns the probationary segment and can not
+ * push out the hot tail data that is repeatedly read by real-time consumers.
+ * Historical reads are additionally admitted at the head of the probationary
+ * segment (i.e. they are the first to be reclaimed) and do not promote ranges
+ * they hit.
+ *
  * The LRU cache serves as an entry point for the Seastar memory reclaimer.
  * During a low-memory event Seastar may make an upcall to the LRU cache to free
  * memory. When memory is reclaimed cache entries are invalidated. Since this
@@ -93,9 +112,6 @@ class batch_cache_index;
  * guaranteed. so, good luck. if you find yourself with mysterious crashes in
  * the future, consider other solutions like blocking the reclaimer or only
  * allowing asynchronous reclaims while executing within the batch catch.
- *
- * TODO:
- *  - add probes to track statistics
  */
 
 class batch_cache {
@@ -107,6 +123,12 @@ class batch_cache {
     using reclaim_result = ss::memory::reclaiming_result;
 
 public:
+    /// Maximum fraction of the cache memory held by the protected segment.
+    static constexpr double protected_ratio = 0.8;
+
+    /// Marks insertions and lookups coming from reads of historical data.
+    using is_historical = ss::bool_class<struct is_historical_tag>;
+
     struct reclaim_options {
         ss::lowres_clock::duration growth_window;
         ss::lowres_clock::duration stable_window;
@@ -190,6 +212,8 @@ public:
         std::vector<model::offset> _offsets;
 
         bool _pinned{false};
+        // true if the range is linked into the protected segment
+        bool _in_protected{false};
         size_t _size = 0;
         intrusive_list_hook _hook;
         batch_cache_index& _index;
@@ -246,7 +270,9 @@ public:
     ss::future<> stop() { return _background_reclaimer.stop(); }
 
     /// Returns true if the cache is empty, and false otherwise.
-    bool empty() const { return _lru.empty(); }
+    bool empty() const {
+        return _probation_lru.empty() && _protected_lru.empty();
+    }
 
     /// Removes all entries from the cache.
     void clear() { reclaim(std::numeric_limits<size_t>::max()); }
@@ -255,10 +281,17 @@ public:
      * Copies a batch into the LRU cache.
      * Copying is needed to release memory references of underlying tempbufs.
      *
+     * New ranges are admitted to the probationary segment. Ranges created for
+     * historical batches are placed at its head so that they are reclaimed
+     * first.
+     *
      * The returned weak_ptr will be invalidated if its memory is reclaimed. To
      * evict the range, move it into batch_cache::evict().
      */
-    entry put(batch_cache_index&, const model::record_batch&);
+    entry put(
+      batch_cache_index&,
+      const model::record_batch&,
+      is_historical historical = is_historical::no);
 
     /**
      * \brief Remove a batch from the cache.
@@ -276,13 +309,12 @@ public:
     void evict(range_ptr&& e);
 
     /**
-     * Notify the cache that the specified range was recently used.
+     * Notify the cache that the specified range was recently used. The range
+     * is promoted to the tail of the protected segment.
      */
     void touch(range_ptr& e) {
         if (e) {
-            auto p = e.get();
-            p->_hook.unlink();
-            _lru.push_back(*p);
+            promote(*e.get());
         }
     }
 
@@ -312,6 +344,11 @@ public:
      */
     size_t size_bytes() const { return _size_bytes; }
 
+    /// The estimated size of the protected segment in bytes.
+    size_t protected_size_bytes() const { return _protected_size_bytes; }
+
+    batch_cache_probe& probe() { return _probe; }
+
 private:
     friend batch_cache_test_fixture;
     struct batch_reclaiming_lock {
@@ -374,10 +411,22 @@ private:
                               : reclaim_result::reclaimed_nothing;
     }
 
-    intrusive_list<range, &range::_hook> _lru;
+    using lru_type = intrusive_list<range, &range::_hook>;
+
+    void promote(range&);
+    void maybe_demote();
+    lru_type& lru_of(const range& r) {
+        return r._in_protected ? _protected_lru : _probation_lru;
+    }
+    void reclaim_from(lru_type&, size_t&, lru_type&);
+
+    lru_type _probation_lru;
+    lru_type _protected_lru;
     reclaimer _reclaimer;
     bool _is_reclaiming{false};
     size_t _size_bytes{0};
+    size_t _protected_size_bytes{0};
+    batch_cache_probe _probe;
 
     reclaim_options _reclaim_opts;
     ss::lowres_clock::time_point _last_reclaim;
@@ -418,7 +467,9 @@ public:
 
     bool empty() const { return _index.empty(); }
 
-    void put(const model::record_batch& batch) {
+    void put(
+      const model::record_batch& batch,
+      batch_cache::is_historical historical = batch_cache::is_historical::no) {
         lock_guard lk(*this);
         auto offset = batch.header().base_offset;
         if (likely(!_index.contains(offset))) {
@@ -428,7 +479,7 @@ public:
              * entries are initialized in the cache and index, clean-up happens
              * correctly on either side.
              */
-            auto p = _cache->put(*this, batch);
+            auto p = _cache->put(*this, batch, historical);
             _index.emplace(offset, std::move(p));
         }
     }
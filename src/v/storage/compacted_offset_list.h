@@ -34,6 +34,8 @@ public:
     ~compacted_offset_list() noexcept = default;
 
     bool contains(model::offset) const;
+    /// \brief number of offsets in the inclusive range [first, last]
+    uint64_t count(model::offset first, model::offset last) const;
     void add(model::offset);
 
 private:
@@ -61,4 +63,15 @@ inline bool compacted_offset_list::contains(model::offset o) const {
     return _to_keep.contains(x);
 }
 
+inline uint64_t
+compacted_offset_list::count(model::offset first, model::offset last) const {
+    const uint32_t hi = (last - _base)();
+    const auto upto_last = _to_keep.rank(hi);
+    if (first <= _base) {
+        return upto_last;
+    }
+    const uint32_t lo = (first - _base)();
+    return upto_last - _to_keep.rank(lo - 1);
+}
+
 } // namespace storage::internal
@@ -10,6 +10,7 @@
 #include "storage/compaction_reducers.h"
 
 #include "compression/compression.h"
+#include "hashing/crc32c.h"
 #include "model/record.h"
 #include "model/record_batch_types.h"
 #include "model/record_utils.h"
@@ -21,7 +22,9 @@
 #include "storage/segment_utils.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/future.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 
 #include <absl/algorithm/container.h>
 #include <absl/container/flat_hash_map.h>
@@ -83,6 +86,61 @@ roaring::Roaring compaction_key_reducer::end_of_stream() {
     return std::move(_inverted);
 }
 
+bool key_offset_map::put(bytes key, model::offset o) {
+    auto it = _map.find(key);
+    if (it != _map.end()) {
+        it->second = std::max(it->second, o);
+        return true;
+    }
+    if (mem_usage() + key.size() >= _max_mem) {
+        _full = true;
+        return false;
+    }
+    _keys_mem_usage += key.size();
+    _map.emplace(std::move(key), o);
+    return true;
+}
+
+ss::future<bool>
+key_offset_map::may_intersect(const key_bloom_filter& filter) const {
+    size_t checked = 0;
+    for (const auto& [key, offset] : _map) {
+        if (filter.may_contain(key)) {
+            co_return true;
+        }
+        // the map isn't modified while compaction uses it
+        if (++checked % 1024 == 0) {
+            co_await ss::coroutine::maybe_yield();
+        }
+    }
+    co_return false;
+}
+
+ss::future<ss::stop_iteration>
+key_offset_map_reducer::operator()(compacted_index::entry&& e) {
+    using stop_t = ss::stop_iteration;
+    const model::offset o = e.offset + model::offset(e.delta);
+    if (!_map->put(std::move(e.key), o)) {
+        return ss::make_ready_future<stop_t>(stop_t::yes);
+    }
+    return ss::make_ready_future<stop_t>(stop_t::no);
+}
+
+ss::future<ss::stop_iteration>
+key_offset_map_filter_reducer::operator()(compacted_index::entry&& e) {
+    using stop_t = ss::stop_iteration;
+    const model::offset o = e.offset + model::offset(e.delta);
+    auto latest = _map->get(e.key);
+    if (!latest || *latest <= o) {
+        _result.list.add(o);
+        _result.to_keep.add(_natural_index);
+    } else {
+        ++_result.removed;
+    }
+    ++_natural_index;
+    return ss::make_ready_future<stop_t>(stop_t::no);
+}
+
 ss::future<ss::stop_iteration>
 index_copy_reducer::operator()(compacted_index::entry&& e) {
     using stop_t = ss::stop_iteration;
@@ -113,6 +171,25 @@ compacted_offset_list_reducer::operator()(compacted_index::entry&& e) {
     return ss::make_ready_future<stop_t>(stop_t::no);
 }
 
+/// Clears the transactional bit of a data batch. The crc of the batch is
+/// updated from the crc of the header fields alone, the records aren't hashed
+/// again.
+static void unset_transactional_type(model::record_batch_header& hdr) {
+    if (!hdr.attrs.is_transactional() || hdr.attrs.is_control()) {
+        return;
+    }
+    crc::crc32c old_fields;
+    model::crc_record_batch_header(old_fields, hdr);
+    hdr.attrs.unset_transactional_type();
+    crc::crc32c new_fields;
+    model::crc_record_batch_header(new_fields, hdr);
+    hdr.crc = static_cast<int32_t>(crc::crc32c_combine(
+      old_fields.value() ^ new_fields.value(),
+      static_cast<uint32_t>(hdr.crc),
+      hdr.size_bytes - model::packed_record_batch_header_size));
+    hdr.header_crc = model::internal_header_only_crc(hdr);
+}
+
 std::optional<model::record_batch>
 copy_data_segment_reducer::filter(model::record_batch&& batch) {
     // do not compact raft configuration and archival metadata as they shift
@@ -131,15 +208,7 @@ copy_data_segment_reducer::filter(model::record_batch&& batch) {
     // aborted list of transactions. Marking these batches here as
     // non transactional means that clients skip that extra check.
     auto& hdr = batch.header();
-    bool hdr_changed = false;
-    if (hdr.attrs.is_transactional() && !hdr.attrs.is_control()) {
-        hdr.attrs.unset_transactional_type();
-        // We do not recompute crc here as the batch records may
-        // be filtered in step 4 in which case we need to recompute
-        // it anyway. It is expensive to loop through the batch and
-        // is wasteful to do it twice.
-        hdr_changed = true;
-    }
+    unset_transactional_type(hdr);
 
     // 1. compute which records to keep
     const auto base = batch.base_offset();
@@ -158,10 +227,6 @@ copy_data_segment_reducer::filter(model::record_batch&& batch) {
 
     // 3. keep all records
     if (offset_deltas.size() == static_cast<size_t>(batch.record_count())) {
-        if (hdr_changed) {
-            hdr.crc = model::crc_record_batch(batch);
-            hdr.header_crc = model::internal_header_only_crc(hdr);
-        }
         return std::move(batch);
     }
 
@@ -258,6 +323,11 @@ ss::future<ss::stop_iteration> copy_data_segment_reducer::do_compaction(
         co_return stop_t::no;
     }
     auto batch = co_await compress_batch(original, std::move(to_copy.value()));
+    co_await write_batch(std::move(batch));
+    co_return stop_t::no;
+}
+
+ss::future<> copy_data_segment_reducer::write_batch(model::record_batch batch) {
     auto const start_offset = _appender->file_byte_offset();
     auto const header_size = batch.header().size_bytes;
     _acc += header_size;
@@ -279,8 +349,6 @@ ss::future<ss::stop_iteration> copy_data_segment_reducer::do_compaction(
       "Size must be deterministic. Expected:{} == {}",
       _appender->file_byte_offset(),
       start_offset + header_size);
-
-    co_return stop_t::no;
 }
 
 ss::future<ss::stop_iteration>
@@ -289,6 +357,15 @@ copy_data_segment_reducer::operator()(model::record_batch b) {
     if (!b.compressed()) {
         co_return co_await do_compaction(comp, std::move(b));
     }
+    // compressed batches which keep all of their records are copied verbatim
+    // instead of being decompressed, filtered and compressed again
+    if (!is_compactible(b) || keeps_all_records(b.header())) {
+        if (is_compactible(b)) {
+            unset_transactional_type(b.header());
+        }
+        co_await write_batch(std::move(b));
+        co_return ss::stop_iteration::no;
+    }
     auto batch = co_await decompress_batch(std::move(b));
 
     co_return co_await do_compaction(comp, std::move(batch));
@@ -319,6 +396,27 @@ ss::future<> index_rebuilder_reducer::do_index(model::record_batch&& b) {
     });
 }
 
+ss::future<ss::stop_iteration>
+key_lookup_reducer::operator()(model::record_batch&& b) {
+    if (b.header().type != model::record_batch_type::raft_data) {
+        co_return ss::stop_iteration::no;
+    }
+    if (!b.compressed()) {
+        do_lookup(b);
+    } else {
+        do_lookup(co_await internal::decompress_batch(std::move(b)));
+    }
+    co_return ss::stop_iteration::no;
+}
+
+void key_lookup_reducer::do_lookup(const model::record_batch& b) {
+    b.for_each_record([this, &b](model::record r) {
+        if (r.key() == _key) {
+            _offset = b.base_offset() + model::offset(r.offset_delta());
+        }
+    });
+}
+
 void tx_reducer::consume_aborted_txs(model::offset upto) {
     while (!_aborted_txs.empty() && _aborted_txs.top().first <= upto) {
         const auto& top = _aborted_txs.top();
@@ -18,6 +18,7 @@
 #include "storage/compacted_index_writer.h"
 #include "storage/compacted_offset_list.h"
 #include "storage/index_state.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/logger.h"
 #include "storage/segment_appender.h"
 #include "units.h"
@@ -66,6 +67,100 @@ private:
     uint32_t _natural_index{0};
 };
 
+/**
+ * Map of the latest offset of every key over the compacted indices of a range
+ * of segments, used by sliding window compaction. The memory used by the map
+ * is bounded: once full only the offsets of keys that are already present are
+ * updated.
+ *
+ * Every offset in the map is the offset of a record carrying the key, and
+ * no larger than the latest offset of the key in the log. Dropping the
+ * records of a key with offsets lower than the one in the map is therefore
+ * always safe, even for a partially built map.
+ */
+class key_offset_map {
+public:
+    static constexpr const size_t default_max_memory_usage = 128_MiB;
+    using underlying_t = absl::node_hash_map<
+      bytes,
+      model::offset,
+      bytes_hasher<uint64_t, xxhash_64>,
+      bytes_type_eq>;
+
+    explicit key_offset_map(size_t max_mem = default_max_memory_usage)
+      : _max_mem(max_mem) {}
+
+    /// \brief records the offset of the key if it is larger than the one in
+    /// the map. Returns false if the key is new and the map is full.
+    bool put(bytes key, model::offset o);
+
+    std::optional<model::offset> get(const bytes& key) const {
+        auto it = _map.find(key);
+        if (it == _map.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    /// \brief true if the filter may contain any of the keys of the map
+    ss::future<bool> may_intersect(const key_bloom_filter&) const;
+
+    size_t size() const { return _map.size(); }
+    bool full() const { return _full; }
+    size_t mem_usage() const { return idx_mem_usage() + _keys_mem_usage; }
+
+private:
+    size_t idx_mem_usage() const {
+        using debug = absl::container_internal::hashtable_debug_internal::
+          HashtableDebugAccess<underlying_t>;
+        return debug::AllocatedByteSize(_map);
+    }
+
+    underlying_t _map;
+    size_t _keys_mem_usage{0};
+    size_t _max_mem;
+    bool _full{false};
+};
+
+/// Adds the entries of a compacted index to a key_offset_map. Stops when the
+/// map is full, returns true if all entries of the index were added.
+class key_offset_map_reducer : public compaction_reducer {
+public:
+    explicit key_offset_map_reducer(key_offset_map& m)
+      : _map(&m) {}
+
+    ss::future<ss::stop_iteration> operator()(compacted_index::entry&&);
+    bool end_of_stream() const { return !_map->full(); }
+
+private:
+    key_offset_map* _map;
+};
+
+/// Filters the entries of a compacted index with a key_offset_map, keeping
+/// the entries at or after the latest known offset of their key. Produces the
+/// list of offsets to keep in the segment and the natural indices of the
+/// entries to keep in the compacted index.
+class key_offset_map_filter_reducer : public compaction_reducer {
+public:
+    struct result {
+        compacted_offset_list list;
+        roaring::Roaring to_keep;
+        size_t removed{0};
+    };
+
+    key_offset_map_filter_reducer(const key_offset_map& m, model::offset base)
+      : _map(&m)
+      , _result{.list = compacted_offset_list(base, roaring::Roaring{})} {}
+
+    ss::future<ss::stop_iteration> operator()(compacted_index::entry&&);
+    result end_of_stream() { return std::move(_result); }
+
+private:
+    const key_offset_map* _map;
+    result _result;
+    uint32_t _natural_index{0};
+};
+
 /// This class copies the input reader into the writer consulting the bitmap of
 /// wether ot keep the entry or not
 class index_filtered_copy_reducer : public compaction_reducer {
@@ -121,11 +216,19 @@ public:
 private:
     ss::future<ss::stop_iteration>
       do_compaction(model::compression, model::record_batch);
+    ss::future<> write_batch(model::record_batch);
 
     bool should_keep(model::offset base, int32_t delta) const {
         const auto o = base + model::offset(delta);
         return _list.contains(o);
     }
+    /// true if the list keeps every record of the batch, tells without
+    /// decoding the records
+    bool keeps_all_records(const model::record_batch_header& hdr) const {
+        return hdr.record_count > 0
+               && _list.count(hdr.base_offset, hdr.last_offset())
+                    == static_cast<uint64_t>(hdr.record_count);
+    }
     std::optional<model::record_batch> filter(model::record_batch&&);
 
     compacted_offset_list _list;
@@ -151,6 +254,21 @@ private:
     compacted_index_writer* _w;
 };
 
+/// Finds the offset of the latest record with the key in data batches
+class key_lookup_reducer : public compaction_reducer {
+public:
+    explicit key_lookup_reducer(iobuf key) noexcept
+      : _key(std::move(key)) {}
+    ss::future<ss::stop_iteration> operator()(model::record_batch&&);
+    std::optional<model::offset> end_of_stream() { return _offset; }
+
+private:
+    void do_lookup(const model::record_batch&);
+
+    iobuf _key;
+    std::optional<model::offset> _offset;
+};
+
 /**
  * Filters out the following record batches from compaction.
  * - Aborted transaction raft data bathes
@@ -0,0 +1,289 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/compressed_index_state.h"
+
+#include "vassert.h"
+
+#include <seastar/core/temporary_buffer.hh>
+
+#include <algorithm>
+
+namespace storage {
+
+namespace {
+
+constexpr size_t row_width = details::FOR_buffer_depth;
+using offset_delta = details::delta_delta<uint64_t>;
+using time_delta = details::delta_xor;
+using position_delta = details::delta_delta<uint64_t>;
+
+/*
+ * A handful of recently decoded frames per shard. Lookups into the index of
+ * a closed segment are strongly clustered (consumers reading the same region
+ * of the log, retried timequeries) so a small cache avoids decoding the same
+ * frame over and over again.
+ */
+class decoded_frame_cache {
+public:
+    static constexpr size_t capacity = 32;
+
+    compressed_index_state::frame* get(uint64_t id, size_t frame_idx) {
+        for (auto& s : _slots) {
+            if (s.id == id && s.frame_idx == frame_idx) {
+                s.last_use = ++_clock;
+                return &s.data;
+            }
+        }
+        return nullptr;
+    }
+
+    /// returns the least recently used slot, reassigned to the given frame
+    compressed_index_state::frame& reserve(uint64_t id, size_t frame_idx) {
+        auto it = std::min_element(
+          _slots.begin(), _slots.end(), [](const slot& a, const slot& b) {
+              return a.last_use < b.last_use;
+          });
+        it->id = id;
+        it->frame_idx = frame_idx;
+        it->last_use = ++_clock;
+        return it->data;
+    }
+
+private:
+    struct slot {
+        // zero is never assigned to an index
+        uint64_t id{0};
+        size_t frame_idx{0};
+        uint64_t last_use{0};
+        compressed_index_state::frame data;
+    };
+
+    std::array<slot, capacity> _slots;
+    uint64_t _clock{0};
+};
+
+decoded_frame_cache& frame_cache() {
+    static thread_local decoded_frame_cache cache;
+    return cache;
+}
+
+thread_local uint64_t next_index_id{1};
+
+/// copies the buffer into a single fragment of the exact size to not hold on
+/// to the slack of the fragments used while encoding
+iobuf tighten(iobuf buf) {
+    iobuf ret;
+    if (buf.empty()) {
+        return ret;
+    }
+    ss::temporary_buffer<char> out(buf.size_bytes());
+    size_t pos = 0;
+    for (const auto& f : buf) {
+        std::copy_n(f.get(), f.size(), out.get_write() + pos);
+        pos += f.size();
+    }
+    ret.append(std::move(out));
+    return ret;
+}
+
+template<typename Delta, typename Column>
+void encode_column(
+  iobuf& out, const Column& column, size_t begin, size_t end, Delta delta) {
+    deltafor_encoder<uint64_t, Delta> enc(column[begin], delta);
+    typename deltafor_encoder<uint64_t, Delta>::row_t row;
+    // the last row of the last frame is padded by repeating the last value
+    for (size_t i = begin; i < end; i += row_width) {
+        for (size_t j = 0; j < row_width; ++j) {
+            row[j] = column[std::min(i + j, end - 1)];
+        }
+        enc.add(row);
+    }
+    for (const auto& f : enc.share()) {
+        out.append(f.get(), f.size());
+    }
+}
+
+template<typename Delta, typename T>
+void decode_column(
+  iobuf& column,
+  size_t begin,
+  size_t end,
+  uint64_t initial,
+  size_t rows,
+  Delta delta,
+  std::array<T, compressed_index_state::frame_size>& out) {
+    deltafor_decoder<uint64_t, Delta> dec(
+      initial, rows, column.share(begin, end - begin), delta);
+    typename deltafor_decoder<uint64_t, Delta>::row_t row;
+    for (size_t r = 0; r < rows; ++r) {
+        vassert(dec.read(row), "compressed index frame is truncated");
+        for (size_t j = 0; j < row_width; ++j) {
+            out[r * row_width + j] = static_cast<T>(row[j]);
+        }
+    }
+}
+
+} // namespace
+
+std::optional<compressed_index_state>
+compressed_index_state::compress(const index_state& st) {
+    const auto& offsets = st.relative_offset_index;
+    const auto& times = st.relative_time_index;
+    const auto& positions = st.position_index;
+    const auto n = offsets.size();
+
+    // delta-delta encoding requires non-decreasing sequences
+    for (size_t i = 1; i < n; ++i) {
+        if (offsets[i] < offsets[i - 1] || positions[i] < positions[i - 1]) {
+            return std::nullopt;
+        }
+    }
+
+    compressed_index_state c;
+    c._id = next_index_id++;
+    c._size = n;
+    c._frames.reserve((n + frame_size - 1) / frame_size);
+
+    iobuf offsets_buf;
+    iobuf times_buf;
+    iobuf positions_buf;
+    for (size_t begin = 0; begin < n; begin += frame_size) {
+        const auto end = std::min(begin + frame_size, n);
+        uint32_t max_time = times[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            max_time = std::max(max_time, times[i]);
+        }
+        c._frames.push_back(frame_hint{
+          .first_offset = offsets[begin],
+          .first_time = times[begin],
+          .max_time = max_time,
+          .first_position = positions[begin],
+          .offset_pos = static_cast<uint32_t>(offsets_buf.size_bytes()),
+          .time_pos = static_cast<uint32_t>(times_buf.size_bytes()),
+          .position_pos = static_cast<uint32_t>(positions_buf.size_bytes()),
+        });
+        encode_column(offsets_buf, offsets, begin, end, offset_delta(0));
+        encode_column(times_buf, times, begin, end, time_delta{});
+        encode_column(positions_buf, positions, begin, end, position_delta(0));
+    }
+
+    c._offsets = tighten(std::move(offsets_buf));
+    c._times = tighten(std::move(times_buf));
+    c._positions = tighten(std::move(positions_buf));
+    return c;
+}
+
+void compressed_index_state::decode_frame(size_t i, frame& out) {
+    const auto& h = _frames[i];
+    const bool last = i + 1 == _frames.size();
+    out.size = last ? _size - i * frame_size : frame_size;
+    const auto rows = (out.size + row_width - 1) / row_width;
+
+    decode_column(
+      _offsets,
+      h.offset_pos,
+      last ? _offsets.size_bytes() : _frames[i + 1].offset_pos,
+      h.first_offset,
+      rows,
+      offset_delta(0),
+      out.relative_offset);
+    decode_column(
+      _times,
+      h.time_pos,
+      last ? _times.size_bytes() : _frames[i + 1].time_pos,
+      h.first_time,
+      rows,
+      time_delta{},
+      out.relative_time);
+    decode_column(
+      _positions,
+      h.position_pos,
+      last ? _positions.size_bytes() : _frames[i + 1].position_pos,
+      h.first_position,
+      rows,
+      position_delta(0),
+      out.position);
+}
+
+const compressed_index_state::frame&
+compressed_index_state::get_frame(size_t i) {
+    auto& cache = frame_cache();
+    if (auto f = cache.get(_id, i); f) {
+        return *f;
+    }
+    auto& f = cache.reserve(_id, i);
+    decode_frame(i, f);
+    return f;
+}
+
+void compressed_index_state::decompress_into(index_state& st) {
+    frame f;
+    for (size_t i = 0; i < _frames.size(); ++i) {
+        decode_frame(i, f);
+        for (size_t j = 0; j < f.size; ++j) {
+            st.add_entry(
+              f.relative_offset[j], f.relative_time[j], f.position[j]);
+        }
+    }
+}
+
+std::optional<compressed_index_state::entry_t>
+compressed_index_state::find_nearest_offset(uint32_t needle) {
+    // last frame starting at or before the needle
+    auto it = std::upper_bound(
+      _frames.begin(),
+      _frames.end(),
+      needle,
+      [](uint32_t v, const frame_hint& h) { return v < h.first_offset; });
+    if (it == _frames.begin()) {
+        return std::nullopt;
+    }
+    const auto& f = get_frame(std::distance(_frames.begin(), it) - 1);
+    auto begin = f.relative_offset.begin();
+    // the first entry of the frame is <= needle so this is never begin
+    auto e = std::upper_bound(begin, begin + f.size, needle);
+    auto i = std::distance(begin, e) - 1;
+    return entry_t{f.relative_offset[i], f.relative_time[i], f.position[i]};
+}
+
+std::optional<compressed_index_state::entry_t>
+compressed_index_state::find_nearest_time(uint32_t needle) {
+    // first frame containing an entry at or after the needle
+    auto it = std::partition_point(
+      _frames.begin(), _frames.end(), [needle](const frame_hint& h) {
+          return h.max_time < needle;
+      });
+    if (it == _frames.end()) {
+        return std::nullopt;
+    }
+    const auto& f = get_frame(std::distance(_frames.begin(), it));
+    auto begin = f.relative_time.begin();
+    auto e = std::lower_bound(begin, begin + f.size, needle);
+    if (e == begin + f.size) {
+        return std::nullopt;
+    }
+    auto i = std::distance(begin, e);
+    return entry_t{f.relative_offset[i], f.relative_time[i], f.position[i]};
+}
+
+compressed_index_state::entry_t compressed_index_state::get_entry(size_t i) {
+    vassert(i < _size, "Index entry {} out of range {}", i, _size);
+    const auto& f = get_frame(i / frame_size);
+    const auto j = i % frame_size;
+    return entry_t{f.relative_offset[j], f.relative_time[j], f.position[j]};
+}
+
+size_t compressed_index_state::memory_usage() const {
+    return sizeof(*this) + _frames.capacity() * sizeof(frame_hint)
+           + _offsets.size_bytes() + _times.size_bytes()
+           + _positions.size_bytes();
+}
+
+} // namespace storage
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/iobuf.h"
+#include "storage/index_state.h"
+#include "utils/delta_for.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace storage {
+
+/**
+ * Read-only representation of the entries of an index_state, used for the
+ * index of segments that will not be appended to anymore.
+ *
+ * Entries are split into frames of `frame_size` entries and every column of a
+ * frame is delta-FOR encoded on its own, so a lookup only has to decode the
+ * single frame which contains the entry. The first relative offset and the
+ * max relative timestamp of every frame are kept uncompressed to pick the
+ * frame. Recently decoded frames are kept in a small per-shard cache.
+ *
+ * Only the entries are stored, the header fields (base offset, timestamps,
+ * etc) stay in the index_state owned by segment_index.
+ */
+class compressed_index_state {
+public:
+    static constexpr size_t rows_per_frame = 4;
+    static constexpr size_t frame_size = rows_per_frame
+                                         * details::FOR_buffer_depth;
+
+    using entry_t = std::tuple<uint32_t, uint32_t, uint64_t>;
+
+    /// A fully decoded frame
+    struct frame {
+        std::array<uint32_t, frame_size> relative_offset;
+        std::array<uint32_t, frame_size> relative_time;
+        std::array<uint64_t, frame_size> position;
+        size_t size{0};
+    };
+
+    compressed_index_state(compressed_index_state&&) noexcept = default;
+    compressed_index_state& operator=(compressed_index_state&&) noexcept
+      = default;
+    compressed_index_state(const compressed_index_state&) = delete;
+    compressed_index_state& operator=(const compressed_index_state&) = delete;
+    ~compressed_index_state() noexcept = default;
+
+    /// \brief compresses the entries of the index. Returns std::nullopt when
+    /// the relative offsets or file positions are not monotonic, these can't
+    /// be delta encoded and the index should stay uncompressed.
+    static std::optional<compressed_index_state> compress(const index_state&);
+
+    /// \brief appends all entries to the given index state
+    void decompress_into(index_state&);
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    /// \brief last entry with relative offset less or equal to the needle
+    std::optional<entry_t> find_nearest_offset(uint32_t relative_offset);
+
+    /// \brief first entry with relative time greater or equal to the needle
+    std::optional<entry_t> find_nearest_time(uint32_t relative_time);
+
+    /// \brief the i-th entry of the index
+    entry_t get_entry(size_t i);
+
+    /// \brief approximate number of bytes of memory held by this object
+    size_t memory_usage() const;
+
+private:
+    struct frame_hint {
+        uint32_t first_offset;
+        uint32_t first_time;
+        uint32_t max_time;
+        uint64_t first_position;
+        // byte positions of the frame in the columns
+        uint32_t offset_pos;
+        uint32_t time_pos;
+        uint32_t position_pos;
+    };
+
+    compressed_index_state() = default;
+
+    const frame& get_frame(size_t i);
+    void decode_frame(size_t i, frame&);
+
+    // unique on the shard, identifies frames of this index in the cache
+    uint64_t _id{0};
+    size_t _size{0};
+    std::vector<frame_hint> _frames;
+    iobuf _offsets;
+    iobuf _times;
+    iobuf _positions;
+};
+
+} // namespace storage
@@ -106,7 +106,7 @@ disk_log_appender::operator()(model::record_batch& batch) {
 }
 
 ss::future<ss::stop_iteration>
-disk_log_appender::append_batch_to_segment(const model::record_batch& batch) {
+disk_log_appender::append_batch_to_segment(model::record_batch& batch) {
     // ghost batch handling, it doesn't happen often so we can use unlikely
     if (unlikely(
           batch.header().type == model::record_batch_type::ghost_batch)) {
@@ -115,7 +115,8 @@ disk_log_appender::append_batch_to_segment(const model::record_batch& batch) {
         return ss::make_ready_future<ss::stop_iteration>(
           ss::stop_iteration::no);
     }
-    return _seg->append(batch).then([this](append_result r) {
+    return _seg->append(batch).then([this, &batch](append_result r) {
+        _log._tail_stream.append(batch);
         _idx = r.last_offset + model::offset(1); // next base offset
         _byte_size += r.byte_size;
         // do not track base_offset, only the last one
@@ -16,8 +16,11 @@
 #include "model/timeout_clock.h"
 #include "model/timestamp.h"
 #include "reflection/adl.h"
+#include "ssx/future-util.h"
+#include "storage/compaction_reducers.h"
 #include "storage/disk_log_appender.h"
 #include "storage/fwd.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/kvstore.h"
 #include "storage/log_manager.h"
 #include "storage/logger.h"
@@ -27,6 +30,7 @@
 #include "storage/segment.h"
 #include "storage/segment_set.h"
 #include "storage/segment_utils.h"
+#include "storage/spill_key_index.h"
 #include "storage/types.h"
 #include "storage/version.h"
 #include "utils/gate_guard.h"
@@ -66,12 +70,17 @@ disk_log_impl::disk_log_impl(
   , _max_segment_size(compute_max_segment_size())
   , _readers_cache(std::make_unique<readers_cache>(
       config().ntp(), _manager.config().readers_cache_eviction_timeout)) {
+    _tail_stream.set_tracker(&_manager.resources().tail_streams());
+    _probe.set_disk_usage_tracker(
+      &_manager.usage_tracker(),
+      model::topic_namespace(config().ntp().ns, config().ntp().tp.topic));
     const bool is_compacted = config().is_compacted();
     for (auto& s : _segs) {
         _probe.add_initial_segment(*s);
         if (is_compacted) {
             s->mark_as_compacted_segment();
         }
+        refresh_segment_artifacts_in_background(s);
     }
     _probe.initial_segments_count(_segs.size());
     _probe.setup_metrics(this->config().ntp());
@@ -88,8 +97,10 @@ size_t disk_log_impl::compute_max_segment_size() {
 ss::future<> disk_log_impl::remove() {
     vassert(!_closed, "Invalid double closing of log - {}", *this);
     _closed = true;
+    _tail_stream.clear();
     // wait for compaction to finish
     co_await _compaction_housekeeping_gate.close();
+    _probe.clear_disk_usage_tracker();
     // gets all the futures started in the background
     std::vector<ss::future<>> permanent_delete;
     permanent_delete.reserve(_segs.size());
@@ -125,6 +136,7 @@ ss::future<std::optional<ss::sstring>> disk_log_impl::close() {
     vassert(!_closed, "Invalid double closing of log - {}", *this);
     vlog(stlog.debug, "closing log {}", *this);
     _closed = true;
+    _tail_stream.clear();
     if (
       _eviction_monitor
       && !_eviction_monitor->promise.get_future().available()) {
@@ -133,6 +145,7 @@ ss::future<std::optional<ss::sstring>> disk_log_impl::close() {
     // wait for compaction to finish
     vlog(stlog.trace, "waiting for {} compaction to finish", config().ntp());
     co_await _compaction_housekeeping_gate.close();
+    _probe.clear_disk_usage_tracker();
     vlog(stlog.trace, "stopping {} readers cache", config().ntp());
 
     // close() on the segments is not expected to fail, but it might
@@ -390,6 +403,7 @@ ss::future<> disk_log_impl::do_compact(compaction_config cfg) {
           _probe,
           *_readers_cache,
           _manager.resources());
+        co_await refresh_segment_artifacts(segment);
 
         vlog(
           gclog.debug,
@@ -403,6 +417,18 @@ ss::future<> disk_log_impl::do_compact(compaction_config cfg) {
         }
     }
 
+    if (config::shard_local_cfg().log_compaction_use_sliding_window()) {
+        auto r = co_await sliding_window_compact(cfg);
+        vlog(
+          gclog.debug,
+          "[{}] sliding window compaction result: {}",
+          config().ntp(),
+          r);
+        if (r.did_compact()) {
+            _compaction_ratio.update(r.compaction_ratio());
+        }
+    }
+
     if (auto range = find_compaction_range(cfg); range) {
         auto r = co_await compact_adjacent_segments(std::move(*range), cfg);
         vlog(
@@ -416,6 +442,63 @@ ss::future<> disk_log_impl::do_compact(compaction_config cfg) {
     }
 }
 
+ss::future<compaction_result>
+disk_log_impl::sliding_window_compact(compaction_config cfg) {
+    /*
+     * sliding window compaction.
+     *
+     * self compaction only removes the records superseded within the same
+     * segment and adjacent compaction only looks at two segments at a time, so
+     * a key updated once per segment is never compacted away. here the whole
+     * prefix of self compacted, stable segments is compacted against a map of
+     * the latest offset of every key in that prefix.
+     */
+    std::vector<ss::lw_shared_ptr<segment>> segments;
+    if (!_segs.empty()) {
+        const auto end_it = std::prev(_segs.end());
+        for (auto it = _segs.begin(); it != end_it; ++it) {
+            auto& s = *it;
+            if (
+              s->has_appender() || !s->is_compacted_segment()
+              || !s->finished_self_compaction()
+              || !s->has_compactible_offsets(cfg)) {
+                break;
+            }
+            segments.push_back(s);
+        }
+    }
+    if (segments.size() < 2) {
+        co_return compaction_result(0);
+    }
+
+    // nothing was added to the range since the last pass
+    const auto window_end = segments.back()->offsets().dirty_offset;
+    if (window_end == _last_sliding_window_end) {
+        co_return compaction_result(0);
+    }
+
+    vlog(
+      gclog.debug,
+      "[{}] sliding window compaction of {} segments, offsets [{}, {}]",
+      config().ntp(),
+      segments.size(),
+      segments.front()->offsets().base_offset,
+      window_end);
+
+    auto r = co_await storage::internal::sliding_window_compact(
+      segments,
+      cfg,
+      _probe,
+      *_readers_cache,
+      _manager.resources(),
+      _segment_rewrite_lock);
+    _last_sliding_window_end = window_end;
+    for (auto& s : segments) {
+        co_await refresh_segment_artifacts(s);
+    }
+    co_return r;
+}
+
 std::optional<std::pair<segment_set::iterator, segment_set::iterator>>
 disk_log_impl::find_compaction_range(const compaction_config& cfg) {
     /*
@@ -551,6 +634,10 @@ ss::future<compaction_result> disk_log_impl::compact_adjacent_segments(
     if (co_await ss::file_exists(compact_index.string())) {
         co_await ss::remove_file(compact_index.string());
     }
+    auto key_filter = key_filter_path(compact_index);
+    if (co_await ss::file_exists(key_filter.string())) {
+        co_await ss::remove_file(key_filter.string());
+    }
 
     // lock the range. only metadata (e.g. open/rename/delete) i/o occurs with
     // these locks held so it is a relatively short duration. all of the data
@@ -580,10 +667,12 @@ ss::future<compaction_result> disk_log_impl::compact_adjacent_segments(
             // Clean up any staging files that will go unused.
             // TODO: generalize this cleanup for other compaction abort paths.
             std::vector<std::filesystem::path> rm;
-            rm.reserve(3);
+            rm.reserve(4);
             rm.emplace_back(replacement->reader().filename().c_str());
             rm.emplace_back(replacement->index().path().string());
             rm.emplace_back(replacement->reader().path().to_compacted_index());
+            rm.emplace_back(key_filter_path(
+              replacement->reader().path().to_compacted_index()));
             vlog(
               gclog.debug, "Cleaning up files from aborted compaction: {}", rm);
             for (const auto& f : rm) {
@@ -618,6 +707,7 @@ ss::future<compaction_result> disk_log_impl::compact_adjacent_segments(
         co_await remove_segment_permanently(
           segments.back(), "compact_adjacent_segments");
     }
+    co_await refresh_segment_artifacts(target);
 
     co_return ret;
 }
@@ -896,7 +986,15 @@ ss::future<> disk_log_impl::new_segment(
                 if (config().is_compacted()) {
                     h->mark_as_compacted_segment();
                 }
+                // the index files of the previous segment were written when
+                // its appender was released
+                if (!_segs.empty()) {
+                    refresh_segment_artifacts_in_background(_segs.back());
+                }
                 _segs.add(std::move(h));
+                // the stream only covers the active segment, closed segments
+                // may be compacted underneath it
+                _tail_stream.clear();
                 _probe.segment_created();
                 _stm_manager->make_snapshot_in_background();
                 _stm_dirty_bytes_units.return_all();
@@ -1120,32 +1218,64 @@ disk_log_impl::make_reader(log_reader_config config) {
         return ss::make_ready_future<model::record_batch_reader>(
           std::move(empty));
     }
+    /*
+     * reads starting before the active segment are catching up on a backlog,
+     * do not let them displace the tail data in the batch cache.
+     */
+    if (
+      !_segs.empty()
+      && config.start_offset < _segs.back()->offsets().base_offset) {
+        config.historical_read = true;
+    }
+    /*
+     * readers at the tail share the batches of the tail stream, readers
+     * which asked to read from disk still do.
+     */
+    if (!config.skip_batch_cache) {
+        auto rdr = _tail_stream.read(
+          config,
+          _segs.empty() ? model::offset{} : _segs.back()->offsets().base_offset,
+          offsets().dirty_offset,
+          _probe);
+        if (rdr) {
+            return ss::make_ready_future<model::record_batch_reader>(
+              std::move(*rdr));
+        }
+    }
     return make_cached_reader(config);
 }
 
 ss::future<model::record_batch_reader>
-disk_log_impl::make_reader(timequery_config config) {
+disk_log_impl::make_reader(timequery_config cfg) {
     vassert(!_closed, "make_reader on closed log - {}", *this);
-    return _lock_mngr.range_lock(config).then(
-      [this, cfg = config](std::unique_ptr<lock_manager::lease> lease) {
-          auto start_offset = _start_offset;
-          if (!lease->range.empty()) {
-              // adjust for partial visibility of segment prefix
-              start_offset = std::max(
-                start_offset, (*lease->range.begin())->offsets().base_offset);
-          }
-          log_reader_config config(
-            start_offset,
-            cfg.max_offset,
-            0,
-            2048, // We just need one record batch
-            cfg.prio,
-            cfg.type_filter,
-            cfg.time,
-            cfg.abort_source);
-          return model::make_record_batch_reader<log_reader>(
-            std::move(lease), config, _probe);
-      });
+    auto lease = co_await _lock_mngr.range_lock(cfg);
+    auto start_offset = _start_offset;
+    if (!lease->range.empty()) {
+        const auto& seg = *lease->range.begin();
+        // adjust for partial visibility of segment prefix
+        start_offset = std::max(start_offset, seg->offsets().base_offset);
+        if (config::shard_local_cfg().storage_timequery_index()) {
+            // skip the ranges of the segment with no batch at or after the
+            // queried time rather than reading it from its beginning
+            segment_index::pin_guard pin(seg->index());
+            co_await seg->index().page_in();
+            auto entry = seg->index().find_timequery_start(cfg.time);
+            if (entry) {
+                start_offset = std::max(start_offset, entry->offset);
+            }
+        }
+    }
+    log_reader_config reader_cfg(
+      start_offset,
+      cfg.max_offset,
+      0,
+      2048, // We just need one record batch
+      cfg.prio,
+      cfg.type_filter,
+      cfg.time,
+      cfg.abort_source);
+    co_return model::make_record_batch_reader<log_reader>(
+      std::move(lease), reader_cfg, _probe);
 }
 
 std::optional<model::term_id> disk_log_impl::get_term(model::offset o) const {
@@ -1198,11 +1328,115 @@ disk_log_impl::timequery(timequery_config cfg) {
     });
 }
 
+ss::future<key_lookup_result> disk_log_impl::lookup_key(bytes key) {
+    vassert(!_closed, "lookup_key on closed log - {}", *this);
+    // close() waits for the lookup, which stops at the first scheduling
+    // point after the log is closed
+    auto gate = _compaction_housekeeping_gate.hold();
+    auto throw_if_closed = [this] {
+        if (_closed) {
+            throw segment_closed_exception();
+        }
+    };
+    // compacted indices and their filters have the keys prefixed with the
+    // batch type and truncated
+    const auto indexed_key = prefix_with_batch_type(
+      model::record_batch_type::raft_data, key);
+    const auto filter_key = bytes_view(indexed_key)
+                              .substr(0, internal::spill_key_index::max_key_size);
+
+    key_lookup_result result;
+    std::vector<ss::lw_shared_ptr<segment>> segments(_segs.begin(), _segs.end());
+    for (auto it = segments.rbegin(); it != segments.rend(); ++it) {
+        auto& s = *it;
+        if (s->is_closed() || s->is_tombstone()) {
+            continue;
+        }
+        // the index of the active segment is still being written
+        if (s->is_compacted_segment() && !s->has_appender()) {
+            auto read_holder = co_await s->read_lock();
+            throw_if_closed();
+            if (s->is_closed()) {
+                continue;
+            }
+            auto filter = co_await s->key_filter(
+              ss::default_priority_class(), _manager.config().sanitize_fileops);
+            throw_if_closed();
+            if (filter && !filter->may_contain(filter_key)) {
+                ++result.segments_skipped;
+                continue;
+            }
+        }
+
+        const auto start = std::max(s->offsets().base_offset, _start_offset);
+        const auto end = s->offsets().dirty_offset;
+        if (start > end) {
+            continue;
+        }
+        ++result.segments_read;
+        auto reader = co_await make_reader(log_reader_config(
+          start,
+          end,
+          0,
+          std::numeric_limits<size_t>::max(),
+          ss::default_priority_class(),
+          model::record_batch_type::raft_data,
+          std::nullopt,
+          std::nullopt));
+        auto offset = co_await std::move(reader).consume(
+          internal::key_lookup_reducer(bytes_to_iobuf(key)), model::no_timeout);
+        throw_if_closed();
+        if (offset) {
+            result.offset = offset;
+            break;
+        }
+    }
+    vlog(
+      stlog.debug, "[{}] lookup of key {}: {}", config().ntp(), key, result);
+    co_return result;
+}
+
+ss::future<>
+disk_log_impl::refresh_segment_artifacts(ss::lw_shared_ptr<segment> s) {
+    auto file_size = [](ss::sstring path) -> ss::future<uint64_t> {
+        try {
+            co_return co_await ss::file_size(path);
+        } catch (const std::system_error&) {
+            // not written yet, or removed along with the segment
+            co_return 0;
+        }
+    };
+    const auto index = co_await file_size(s->path().to_index().string());
+    const auto compaction
+      = co_await file_size(s->path().to_compacted_index().string())
+        + co_await file_size(
+          key_filter_path(s->path().to_compacted_index()).string());
+    if (s->is_tombstone() || s->is_closed()) {
+        // removed while the files were looked up, already unaccounted
+        co_return;
+    }
+    _probe.set_segment_artifacts(*s, index, compaction);
+}
+
+void disk_log_impl::refresh_segment_artifacts_in_background(
+  ss::lw_shared_ptr<segment> s) {
+    ssx::spawn_with_gate(_compaction_housekeeping_gate, [this, s] {
+        // bounded per shard, every segment of every log is refreshed when
+        // the logs are opened
+        return _manager.resources().get_artifact_refresh_units().then(
+          [this, s](ssx::semaphore_units units) {
+              return refresh_segment_artifacts(s).finally(
+                [units = std::move(units)] {});
+          });
+    });
+}
+
 ss::future<> disk_log_impl::remove_segment_permanently(
   ss::lw_shared_ptr<segment> s, std::string_view ctx) {
     vlog(stlog.info, "Removing \"{}\" ({}, {})", s->filename(), ctx, s);
     // stats accounting must happen synchronously
     _probe.delete_segment(*s);
+    _probe.remove_segment_artifacts(*s);
     // background close
     s->tombstone();
     if (s->has_outstanding_locks()) {
@@ -1262,6 +1496,7 @@ ss::future<> disk_log_impl::do_truncate_prefix(truncate_prefix_config cfg) {
      * Persist the desired starting offset
      */
     co_await update_start_offset(cfg.start_offset);
+    _tail_stream.prefix_truncate(cfg.start_offset);
 
     /*
      * Then delete all segments (potentially including the active segment)
@@ -1326,6 +1561,7 @@ ss::future<> disk_log_impl::do_truncate(
   truncate_config cfg,
   std::optional<std::pair<ssx::semaphore_units, ssx::semaphore_units>>
     lock_guards) {
+    _tail_stream.truncate(cfg.base_offset);
     if (!lock_guards) {
         auto seg_rolling_units = co_await _segments_rolling_lock.get_units();
         ssx::semaphore_units seg_rewrite_units
@@ -1369,6 +1605,8 @@ ss::future<> disk_log_impl::do_truncate(
     // offset
     model::offset start = last->offsets().base_offset;
 
+    segment_index::pin_guard pin(last->index());
+    co_await last->index().page_in();
     auto pidx = last->index().find_nearest(
       std::max(start, model::prev_offset(cfg.base_offset)));
     size_t initial_size = 0;
@@ -1431,7 +1669,7 @@ ss::future<> disk_log_impl::do_truncate(
     auto cache_lock = co_await _readers_cache->evict_truncate(cfg.base_offset);
 
     try {
-        co_return co_await last_ptr->truncate(prev_last_offset, file_position);
+        co_await last_ptr->truncate(prev_last_offset, file_position);
     } catch (...) {
         vassert(
           false,
@@ -1443,6 +1681,7 @@ ss::future<> disk_log_impl::do_truncate(
           last,
           *this);
     }
+    co_await refresh_segment_artifacts(last_ptr);
 }
 
 model::offset disk_log_impl::read_start_offset() const {
@@ -1617,6 +1856,39 @@ int64_t disk_log_impl::compaction_backlog() const {
     return backlog;
 }
 
+housekeeping_stats
+disk_log_impl::housekeeping_stats(const compaction_config& defaults) const {
+    storage::housekeeping_stats stats{.size_bytes = size_bytes()};
+    if (_segs.empty()) {
+        return stats;
+    }
+    if (config().is_compacted()) {
+        size_t closed = 0;
+        size_t dirty = 0;
+        for (const auto& s : _segs) {
+            // the active segment is not compacted until it rolls
+            if (s->has_appender()) {
+                continue;
+            }
+            closed += s->size_bytes();
+            if (!s->finished_self_compaction()) {
+                dirty += s->size_bytes();
+            }
+        }
+        if (closed > 0) {
+            stats.dirty_ratio = static_cast<double>(dirty)
+                                / static_cast<double>(closed);
+        }
+    }
+    if (config().is_collectable()) {
+        auto cfg = apply_overrides(defaults);
+        if (cfg.max_bytes && stats.size_bytes > *cfg.max_bytes) {
+            stats.bytes_over_retention = stats.size_bytes - *cfg.max_bytes;
+        }
+    }
+    return stats;
+}
+
 /**
  * Record appended bytes & maybe trigger STM snapshots if they have
  * exceeded a threshold.
@@ -21,6 +21,7 @@
 #include "storage/readers_cache.h"
 #include "storage/segment_appender.h"
 #include "storage/segment_reader.h"
+#include "storage/tail_stream.h"
 #include "storage/types.h"
 #include "utils/moving_average.h"
 #include "utils/mutex.h"
@@ -78,6 +79,7 @@ public:
     /// timequery
     ss::future<std::optional<timequery_result>>
     timequery(timequery_config cfg) final;
+    ss::future<key_lookup_result> lookup_key(bytes) final;
     size_t segment_count() const final { return _segs.size(); }
     offset_stats offsets() const final;
     model::timestamp start_timestamp() const final;
@@ -94,15 +96,21 @@ public:
     ss::future<> force_roll(ss::io_priority_class);
 
     probe& get_probe() { return _probe; }
+    bool tail_stream_shared() const { return _tail_stream.is_shared(); }
     model::term_id term() const;
     segment_set& segments() { return _segs; }
     const segment_set& segments() const { return _segs; }
     size_t bytes_left_before_roll() const;
 
     size_t size_bytes() const override { return _probe.partition_size(); }
+    storage::disk_usage get_disk_usage() const override {
+        return _probe.get_disk_usage();
+    }
     ss::future<> update_configuration(ntp_config::default_overrides) final;
 
     int64_t compaction_backlog() const final;
+    storage::housekeeping_stats
+    housekeeping_stats(const compaction_config&) const final;
 
 private:
     friend class disk_log_appender; // for multi-term appends
@@ -122,6 +130,7 @@ private:
     ss::future<bool> update_start_offset(model::offset o);
 
     ss::future<> do_compact(compaction_config);
+    ss::future<compaction_result> sliding_window_compact(compaction_config);
     ss::future<compaction_result> compact_adjacent_segments(
       std::pair<segment_set::iterator, segment_set::iterator>,
       storage::compaction_config cfg);
@@ -170,6 +179,10 @@ private:
 
 private:
     size_t max_segment_size() const;
+    // accounts the current sizes of the index and compaction index files of
+    // the segment, after they were written or rewritten
+    ss::future<> refresh_segment_artifacts(ss::lw_shared_ptr<segment>);
+    void refresh_segment_artifacts_in_background(ss::lw_shared_ptr<segment>);
     // Computes the segment size based on the latest max_segment_size
     // configuration. This takes into consideration any segment size
     // overrides since the last time it was called.
@@ -195,8 +208,13 @@ private:
     model::offset _max_collectible_offset;
     size_t _max_segment_size;
     std::unique_ptr<readers_cache> _readers_cache;
+    // batches appended to the active segment, shared by readers at the tail
+    tail_stream _tail_stream;
     // average ratio of segment sizes after segment size before compaction
     moving_average<double, 5> _compaction_ratio{1.0};
+    // last offset of the range covered by the last sliding window compaction,
+    // the range is only compacted again once it grew
+    model::offset _last_sliding_window_end;
 
     // Mutually exclude operations that do non-appending modification
     // to segments: adjacent segment compaction and truncation.  Truncation
@@ -0,0 +1,94 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/disk_usage.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+
+#include <seastar/core/metrics.hh>
+
+#include <fmt/ostream.h>
+
+namespace storage {
+
+std::ostream& operator<<(std::ostream& o, const disk_usage& u) {
+    fmt::print(
+      o,
+      "{{data: {}, index: {}, compaction: {}}}",
+      u.data,
+      u.index,
+      u.compaction);
+    return o;
+}
+
+void disk_usage_tracker::add(
+  const model::topic_namespace& tn, const disk_usage& u) {
+    _shard += u;
+    _topics[tn] += u;
+}
+
+void disk_usage_tracker::subtract(
+  const model::topic_namespace& tn, const disk_usage& u) {
+    _shard -= u;
+    auto it = _topics.find(tn);
+    if (it == _topics.end()) {
+        return;
+    }
+    it->second -= u;
+    if (it->second.total() == 0) {
+        _topics.erase(it);
+    }
+}
+
+disk_usage
+disk_usage_tracker::topic_usage(const model::topic_namespace& tn) const {
+    if (auto it = _topics.find(tn); it != _topics.end()) {
+        return it->second;
+    }
+    return {};
+}
+
+void disk_usage_tracker::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+
+    namespace sm = ss::metrics;
+    auto aggregate_labels = config::shard_local_cfg().aggregate_metrics()
+                              ? std::vector<sm::label>{sm::shard_label}
+                              : std::vector<sm::label>{};
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:disk_usage"),
+      {
+        sm::make_gauge(
+          "data_bytes",
+          [this] { return _shard.data; },
+          sm::description("Bytes of the segment files of the logs"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "index_bytes",
+          [this] { return _shard.index; },
+          sm::description("Bytes of the index files of the log segments"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "compaction_index_bytes",
+          [this] { return _shard.compaction; },
+          sm::description(
+            "Bytes of the compaction index files of the log segments"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "topics",
+          [this] { return _topics.size(); },
+          sm::description("Number of topics with logs on disk"))
+          .aggregate(aggregate_labels),
+      });
+}
+
+} // namespace storage
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/metadata.h"
+
+#include <seastar/core/metrics_registration.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iosfwd>
+
+namespace storage {
+
+/// Bytes on disk of a log, by kind of file
+struct disk_usage {
+    // segment data files
+    uint64_t data{0};
+    // segment offset/time index files
+    uint64_t index{0};
+    // segment compaction index files
+    uint64_t compaction{0};
+
+    uint64_t total() const { return data + index + compaction; }
+
+    disk_usage& operator+=(const disk_usage& o) {
+        data += o.data;
+        index += o.index;
+        compaction += o.compaction;
+        return *this;
+    }
+    disk_usage& operator-=(const disk_usage& o) {
+        data -= std::min(data, o.data);
+        index -= std::min(index, o.index);
+        compaction -= std::min(compaction, o.compaction);
+        return *this;
+    }
+
+    bool operator==(const disk_usage&) const = default;
+    friend std::ostream& operator<<(std::ostream&, const disk_usage&);
+};
+
+/**
+ * Disk usage of the logs of a shard, in total and by topic.
+ *
+ * The per-NTP probes of the logs push every change of their disk usage here
+ * as it happens (appends, segment removals, truncations, index and compaction
+ * index rewrites), so the usage of a shard or topic is always at hand without
+ * walking segments or the data directory.
+ */
+class disk_usage_tracker {
+public:
+    void add(const model::topic_namespace&, const disk_usage&);
+    void subtract(const model::topic_namespace&, const disk_usage&);
+
+    const disk_usage& shard_usage() const { return _shard; }
+    disk_usage topic_usage(const model::topic_namespace&) const;
+    size_t topics() const { return _topics.size(); }
+
+    void setup_metrics();
+
+private:
+    disk_usage _shard;
+    absl::flat_hash_map<model::topic_namespace, disk_usage> _topics;
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
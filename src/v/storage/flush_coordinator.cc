@@ -0,0 +1,131 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/flush_coordinator.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "ssx/future-util.h"
+#include "storage/logger.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+
+namespace storage {
+
+flush_coordinator::flush_coordinator(
+  config::binding<std::chrono::milliseconds> window)
+  : _window(std::move(window)) {
+    _timer.set_callback([this] { dispatch(); });
+}
+
+ss::future<> flush_coordinator::flush(const void* owner, ss::file f) {
+    if (_gate.is_closed()) {
+        // shutting down, nothing left to coalesce with
+        co_return co_await f.flush();
+    }
+    ++_requests;
+    auto [it, inserted] = _pending.try_emplace(owner);
+    if (inserted) {
+        it->second.f = std::move(f);
+    }
+    auto& waiter = it->second.waiters.emplace_back();
+    auto fut = waiter.get_future();
+    if (!_timer.armed()) {
+        _timer.arm(_window());
+    }
+    co_return co_await std::move(fut);
+}
+
+void flush_coordinator::dispatch() {
+    if (_pending.empty()) {
+        return;
+    }
+    ++_batches;
+    auto pending = std::exchange(_pending, {});
+    vlog(stlog.trace, "Dispatching a batch of {} file syncs", pending.size());
+    for (auto& [_, p] : pending) {
+        ssx::spawn_with_gate(
+          _gate, [this, p = std::move(p)]() mutable {
+              return do_sync(std::move(p));
+          });
+    }
+}
+
+ss::future<> flush_coordinator::do_sync(pending_flush p) {
+    ++_syncs;
+    auto m = _sync_latency.auto_measure();
+    std::exception_ptr ex;
+    try {
+        co_await p.f.flush();
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    for (auto& w : p.waiters) {
+        if (ex) {
+            w.set_exception(ex);
+        } else {
+            w.set_value();
+        }
+    }
+}
+
+ss::future<> flush_coordinator::stop() {
+    _timer.cancel();
+    dispatch();
+    co_await _gate.close();
+}
+
+void flush_coordinator::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    _metrics.clear();
+
+    namespace sm = ss::metrics;
+    auto aggregate_labels = config::shard_local_cfg().aggregate_metrics()
+                              ? std::vector<sm::label>{sm::shard_label}
+                              : std::vector<sm::label>{};
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:flush"),
+      {
+        sm::make_counter(
+          "requests",
+          [this] { return _requests; },
+          sm::description("Number of flushes requested by segment appenders"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "syncs",
+          [this] { return _syncs; },
+          sm::description("Number of file syncs issued for requested flushes"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "batches",
+          [this] { return _batches; },
+          sm::description("Number of batches of file syncs dispatched"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "coalescing_ratio",
+          [this] {
+              return _syncs == 0 ? 1.0
+                                 : static_cast<double>(_requests)
+                                     / static_cast<double>(_syncs);
+          },
+          sm::description("Average number of flush requests per file sync"))
+          .aggregate(aggregate_labels),
+        sm::make_histogram(
+          "sync_latency",
+          [this] { return _sync_latency.seastar_histogram_logform(); },
+          sm::description("Latency of file syncs in microseconds"))
+          .aggregate(aggregate_labels),
+      });
+}
+
+} // namespace storage
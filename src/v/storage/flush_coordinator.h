@@ -0,0 +1,84 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/property.h"
+#include "seastarx.h"
+#include "utils/hdr_hist.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/timer.hh>
+
+#include <absl/container/flat_hash_map.h>
+
+#include <chrono>
+#include <vector>
+
+namespace storage {
+
+/**
+ * Group commit of the segment appenders on a shard.
+ *
+ * Flushes requested within the coalescing window are collected and issued
+ * together once the window closes: every file is synced once no matter how
+ * many flushes of it were requested, the syncs of all files are dispatched at
+ * the same time and all requesters of a file are completed together once its
+ * sync finished. A zero window still coalesces the requests made before the
+ * reactor polls timers again.
+ *
+ * Requesters only get completed after a sync which was issued after their
+ * request, so every caller keeps the durability guarantee of a plain flush.
+ */
+class flush_coordinator {
+public:
+    explicit flush_coordinator(config::binding<std::chrono::milliseconds>);
+    flush_coordinator(const flush_coordinator&) = delete;
+    flush_coordinator& operator=(const flush_coordinator&) = delete;
+    ~flush_coordinator() noexcept = default;
+
+    /// \brief syncs the file with the next batch of flushes. The owner
+    /// identifies requests for the same file.
+    ss::future<> flush(const void* owner, ss::file f);
+
+    /// \brief dispatches pending flushes and waits for all of them
+    ss::future<> stop();
+
+    void setup_metrics();
+
+    uint64_t requests() const { return _requests; }
+    uint64_t syncs() const { return _syncs; }
+    uint64_t batches() const { return _batches; }
+
+private:
+    struct pending_flush {
+        ss::file f;
+        std::vector<ss::promise<>> waiters;
+    };
+
+    void dispatch();
+    ss::future<> do_sync(pending_flush);
+
+    config::binding<std::chrono::milliseconds> _window;
+    ss::timer<> _timer;
+    ss::gate _gate;
+    absl::flat_hash_map<const void*, pending_flush> _pending;
+
+    uint64_t _requests{0};
+    uint64_t _syncs{0};
+    uint64_t _batches{0};
+    hdr_hist _sync_latency;
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
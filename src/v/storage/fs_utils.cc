@@ -102,6 +102,16 @@ segment_full_path segment_full_path::to_index() const {
     }
 }
 
+segment_full_path segment_full_path::to_segment() const {
+    if (extension == ".base_index") {
+        return with_extension(".log");
+    } else if (extension == ".log.compaction.base_index") {
+        return with_extension(".log.compaction.staging");
+    } else {
+        vassert(false, "Unexpected extension {}", extension);
+    }
+}
+
 segment_full_path segment_full_path::to_compacted_index() const {
     if (extension == ".log") {
         return with_extension(".compaction_index");
@@ -118,6 +118,8 @@ public:
     segment_full_path to_compacted_index() const;
     segment_full_path to_compaction_staging() const;
     segment_full_path to_staging() const;
+    /// Inverse of to_index(): the data file the index belongs to
+    segment_full_path to_segment() const;
 
     /**
      * Hydrate the metadata into a fully qualified filesystem path.
@@ -14,6 +14,7 @@
 namespace storage {
 
 class api;
+class batch_cache;
 class node_api;
 class kvstore;
 class log_manager;
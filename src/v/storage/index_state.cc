@@ -24,10 +24,18 @@
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <algorithm>
+#include <limits>
 #include <optional>
 
 namespace storage {
 
+static uint32_t
+relative_max_time(model::timestamp t, model::timestamp base_timestamp) {
+    return static_cast<uint32_t>(std::clamp<int64_t>(
+      t() - base_timestamp(), 0, std::numeric_limits<uint32_t>::max()));
+}
+
 bool index_state::maybe_index(
   size_t accumulator,
   size_t step,
@@ -46,6 +54,8 @@ bool index_state::maybe_index(
       *this);
 
     bool retval = false;
+    // indexes loaded from before version 5 keep going without it
+    const bool track_max_time = has_max_time_index();
 
     // The first non-config batch in the segment, use its timestamp
     // to override the timestamps of any config batch that was indexed
@@ -56,6 +66,9 @@ bool index_state::maybe_index(
         base_timestamp = first_timestamp;
         max_timestamp = first_timestamp;
         non_data_timestamps = false;
+        if (track_max_time) {
+            max_time_index[0] = 0;
+        }
     }
 
     // index_state
@@ -93,8 +106,16 @@ bool index_state::maybe_index(
           batch_base_offset() - base_offset(),
           std::max(last_timestamp() - base_timestamp(), int64_t{0}),
           starting_position_in_file);
+        if (track_max_time) {
+            max_time_index.push_back(
+              relative_max_time(max_timestamp, base_timestamp));
+        }
 
         retval = true;
+    } else if (user_data && track_max_time && !max_time_index.empty()) {
+        // the batch belongs to the range of the last entry
+        max_time_index[max_time_index.size() - 1] = relative_max_time(
+          max_timestamp, base_timestamp);
     }
     return retval;
 }
@@ -122,6 +143,7 @@ void index_state::serde_write(iobuf& out) const {
     write(tmp, relative_offset_index.copy());
     write(tmp, relative_time_index.copy());
     write(tmp, position_index.copy());
+    write(tmp, max_time_index.copy());
 
     crc::crc32c crc;
     crc_extend_iobuf(crc, tmp);
@@ -193,6 +215,53 @@ void read_nested(
     read_nested(p, st.relative_offset_index, 0U);
     read_nested(p, st.relative_time_index, 0U);
     read_nested(p, st.position_index, 0U);
+    if (hdr._version >= 5) {
+        read_nested(p, st.max_time_index, 0U);
+    }
+}
+
+size_t index_state::header_region_size() {
+    // envelope header, blob size and the fixed size header fields
+    return 2 * sizeof(serde::version_t) + 2 * sizeof(serde::serde_size_t)
+           + sizeof(uint32_t) + 4 * sizeof(int64_t);
+}
+
+std::optional<index_state>
+index_state::decode_header(iobuf_parser& in, size_t file_size) {
+    using serde::read_nested;
+
+    // the header fields are laid out the same since version 4
+    const auto version = serde::peek_version(in);
+    if (version < 4 || version > index_state::redpanda_serde_version) {
+        return std::nullopt;
+    }
+
+    // envelope header: version, compat version, size
+    read_nested<serde::version_t>(in, 0U);
+    read_nested<serde::version_t>(in, 0U);
+    const auto size = read_nested<serde::serde_size_t>(in, 0U);
+    const auto envelope_header_size = 2 * sizeof(serde::version_t)
+                                      + sizeof(serde::serde_size_t);
+    if (size + envelope_header_size != file_size) {
+        return std::nullopt;
+    }
+
+    // data blob + crc, the header fields lead the blob
+    const auto blob_size = read_nested<serde::serde_size_t>(in, 0U);
+    if (blob_size + sizeof(serde::serde_size_t) + sizeof(uint32_t) != size) {
+        return std::nullopt;
+    }
+
+    index_state st;
+    read_nested(in, st.bitflags, 0U);
+    read_nested(in, st.base_offset, 0U);
+    read_nested(in, st.max_offset, 0U);
+    read_nested(in, st.base_timestamp, 0U);
+    read_nested(in, st.max_timestamp, 0U);
+    if (st.max_offset < st.base_offset) {
+        return std::nullopt;
+    }
+    return st;
 }
 
 } // namespace storage
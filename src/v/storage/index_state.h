@@ -34,9 +34,10 @@ namespace storage {
    [] relative_offset_index
    [] relative_time_index
    [] position_index
+   [] max_time_index - since version 5
  */
 struct index_state
-  : serde::envelope<index_state, serde::version<4>, serde::compat_version<4>> {
+  : serde::envelope<index_state, serde::version<5>, serde::compat_version<4>> {
     index_state() = default;
     index_state(index_state&&) noexcept = default;
     index_state& operator=(index_state&&) noexcept = default;
@@ -60,8 +61,16 @@ struct index_state
     fragmented_vector<uint32_t> relative_offset_index;
     fragmented_vector<uint32_t> relative_time_index;
     fragmented_vector<uint64_t> position_index;
+    // the max timestamp of the user batches up to the next entry, relative to
+    // base_timestamp. Unlike relative_time_index it never decreases when
+    // producers assign timestamps out of order, so timequeries can binary
+    // search it. Indexes written before version 5 don't have it.
+    fragmented_vector<uint32_t> max_time_index;
 
     bool empty() const { return relative_offset_index.empty(); }
+    bool has_max_time_index() const {
+        return max_time_index.size() == relative_offset_index.size();
+    }
 
     void
     add_entry(uint32_t relative_offset, uint32_t relative_time, uint64_t pos) {
@@ -70,11 +79,16 @@ struct index_state
         position_index.push_back(pos);
     }
     void pop_back() {
+        if (has_max_time_index()) {
+            max_time_index.pop_back();
+        }
         relative_offset_index.pop_back();
         relative_time_index.pop_back();
         position_index.pop_back();
         if (empty()) {
             non_data_timestamps = false;
+            // an empty index starts over with a max time index
+            max_time_index = {};
         }
     }
     std::tuple<uint32_t, uint32_t, uint64_t> get_entry(size_t i) {
@@ -99,6 +113,17 @@ struct index_state
     void serde_write(iobuf&) const;
     friend void read_nested(iobuf_parser&, index_state&, const size_t);
 
+    /// \brief decodes the header fields from the first header_region_size()
+    /// bytes of a serialized index_state of `file_size` bytes. The checksum
+    /// covers the whole blob and is only verified once the entries are read.
+    /// Returns std::nullopt for formats whose header can't be decoded on its
+    /// own, or when the sizes recorded in the header don't match the file.
+    static std::optional<index_state>
+    decode_header(iobuf_parser&, size_t file_size);
+
+    /// \brief bytes at the start of the file that decode_header() reads
+    static size_t header_region_size();
+
 private:
     bool non_data_timestamps{false};
 
@@ -110,7 +135,8 @@ private:
       , max_timestamp(o.max_timestamp)
       , relative_offset_index(o.relative_offset_index.copy())
       , relative_time_index(o.relative_time_index.copy())
-      , position_index(o.position_index.copy()) {}
+      , position_index(o.position_index.copy())
+      , max_time_index(o.max_time_index.copy()) {}
 };
 
 } // namespace storage
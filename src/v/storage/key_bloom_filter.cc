@@ -0,0 +1,112 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/key_bloom_filter.h"
+
+#include "hashing/xx.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace storage {
+
+namespace {
+constexpr uint64_t bits_per_word = 64;
+// ~0.8% false positives for the first stage, each further stage has about a
+// third of the false positives of the previous one
+constexpr uint64_t initial_bits_per_key = 10;
+constexpr uint64_t bits_per_key_step = 2;
+constexpr uint8_t max_hashes = 16;
+
+/// double hashing, the i-th probe of a hash in a stage of `bits` bits
+uint64_t probe(uint64_t hash, uint8_t i, uint64_t bits) {
+    const uint64_t h1 = hash & 0xffffffff;
+    const uint64_t h2 = (hash >> 32U) | 1U;
+    return (h1 + i * h2) % bits;
+}
+} // namespace
+
+uint64_t key_bloom_filter::hash(bytes_view key) {
+    return xxhash_64(key.data(), key.size());
+}
+
+void key_bloom_filter::add_stage() {
+    const auto n = _stages.size();
+    const uint64_t capacity = n == 0 ? initial_capacity
+                                     : 2 * _stages.back().capacity;
+    const uint64_t bits_per_key = initial_bits_per_key
+                                  + n * bits_per_key_step;
+    // optimal number of hashes is bits per key * ln(2)
+    const auto hashes = static_cast<uint8_t>(
+      std::min<uint64_t>((bits_per_key * 693 + 500) / 1000, max_hashes));
+    const uint64_t words = (capacity * bits_per_key + bits_per_word - 1)
+                           / bits_per_word;
+    _stages.push_back(stage{
+      .capacity = capacity,
+      .first_word = _bits.size(),
+      .words = words,
+      .hashes = hashes});
+    for (uint64_t i = 0; i < words; ++i) {
+        _bits.push_back(0);
+    }
+}
+
+void key_bloom_filter::add(uint64_t hash) {
+    // duplicates would fill the stages without adding keys
+    if (may_contain(hash)) {
+        return;
+    }
+    if (_stages.empty() || _stages.back().keys >= _stages.back().capacity) {
+        add_stage();
+    }
+    auto& s = _stages.back();
+    const uint64_t bits = s.words * bits_per_word;
+    for (uint8_t i = 0; i < s.hashes; ++i) {
+        const auto bit = probe(hash, i, bits);
+        _bits[s.first_word + bit / bits_per_word] |= uint64_t(1)
+                                                     << (bit % bits_per_word);
+    }
+    ++s.keys;
+}
+
+bool key_bloom_filter::may_contain(uint64_t hash) const {
+    return std::any_of(
+      _stages.begin(), _stages.end(), [this, hash](const stage& s) {
+          const uint64_t bits = s.words * bits_per_word;
+          for (uint8_t i = 0; i < s.hashes; ++i) {
+              const auto bit = probe(hash, i, bits);
+              const auto word = _bits[s.first_word + bit / bits_per_word];
+              if ((word & (uint64_t(1) << (bit % bits_per_word))) == 0) {
+                  return false;
+              }
+          }
+          return true;
+      });
+}
+
+bool key_bloom_filter::is_valid() const {
+    uint64_t next_word = 0;
+    for (const auto& s : _stages) {
+        if (s.first_word != next_word || s.words == 0 || s.hashes == 0) {
+            return false;
+        }
+        next_word += s.words;
+    }
+    return next_word == _bits.size();
+}
+
+uint64_t key_bloom_filter::keys() const {
+    return std::accumulate(
+      _stages.begin(),
+      _stages.end(),
+      uint64_t(0),
+      [](uint64_t acc, const stage& s) { return acc + s.keys; });
+}
+
+} // namespace storage
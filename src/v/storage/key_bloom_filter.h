@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "bytes/bytes.h"
+#include "serde/envelope.h"
+#include "utils/fragmented_vector.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace storage {
+
+/**
+ * Bloom filter over the keys of a compacted index. Answers whether a segment
+ * may contain a key without reading its compacted index.
+ *
+ * The number of keys of a segment isn't known while its index is written, so
+ * the filter is a sequence of stages of doubling capacity: keys are added to
+ * the last stage until it is full, and a key may be contained if any stage
+ * may contain it. Later stages use more bits per key so that the false
+ * positive rate stays around 1% however many stages there are.
+ */
+class key_bloom_filter
+  : public serde::envelope<
+      key_bloom_filter,
+      serde::version<0>,
+      serde::compat_version<0>> {
+public:
+    static constexpr uint64_t initial_capacity = 1024;
+
+    static uint64_t hash(bytes_view key);
+
+    void add(uint64_t hash);
+    bool may_contain(uint64_t hash) const;
+    bool may_contain(bytes_view key) const { return may_contain(hash(key)); }
+
+    /// Number of distinct keys added, modulo false positives
+    uint64_t keys() const;
+    size_t memory_usage() const { return _bits.size() * sizeof(uint64_t); }
+
+    /// False if the stages don't match the bits, e.g. read from a corrupted
+    /// file
+    bool is_valid() const;
+
+    auto serde_fields() { return std::tie(_stages, _bits); }
+
+private:
+    struct stage
+      : serde::envelope<stage, serde::version<0>, serde::compat_version<0>> {
+        uint64_t capacity{0};
+        uint64_t keys{0};
+        // the bits of the stage are the words [first_word, first_word + words)
+        uint64_t first_word{0};
+        uint64_t words{0};
+        uint8_t hashes{0};
+    };
+
+    void add_stage();
+
+    std::vector<stage> _stages;
+    fragmented_vector<uint64_t> _bits;
+};
+
+/// The key filter of a compacted index is stored next to it
+inline constexpr std::string_view key_filter_suffix = ".key_filter";
+
+inline std::filesystem::path
+key_filter_path(const std::filesystem::path& compacted_index) {
+    auto p = compacted_index;
+    p += key_filter_suffix;
+    return p;
+}
+
+/**
+ * Contents of the key filter file of a compacted index. The index is rewritten
+ * by compaction, so the filter records the size and checksum of the index it
+ * was built for and is only used with that index.
+ */
+struct key_filter_file
+  : serde::envelope<
+      key_filter_file,
+      serde::version<0>,
+      serde::compat_version<0>> {
+    uint64_t index_size{0};
+    uint64_t index_keys{0};
+    uint32_t index_crc{0};
+    key_bloom_filter filter;
+};
+
+} // namespace storage
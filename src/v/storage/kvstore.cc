@@ -16,14 +16,17 @@
 #include "prometheus/prometheus_sanitize.h"
 #include "raft/types.h"
 #include "reflection/adl.h"
+#include "ssx/future-util.h"
 #include "storage/parser.h"
 #include "storage/record_batch_builder.h"
 #include "storage/segment_set.h"
 #include "storage/types.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/thread.hh>
+#include <seastar/coroutine/maybe_yield.hh>
 #include <seastar/util/defer.hh>
 #include <seastar/util/log.hh>
 
@@ -70,8 +73,23 @@ ss::future<> kvstore::start() {
               ss::metrics::description("Size of the database in memory")),
             ss::metrics::make_counter(
               "key_count",
-              [this] { return _db.size(); },
+              [this] {
+                  size_t keys = 0;
+                  for (const auto& p : _partitions) {
+                      keys += p.db.size();
+                  }
+                  return keys;
+              },
               ss::metrics::description("Number of keys in the database")),
+            ss::metrics::make_gauge(
+              "pending_ops",
+              [this] { return _pending_ops; },
+              ss::metrics::description(
+                "Number of operations waiting to be committed")),
+            ss::metrics::make_total_operations(
+              "snapshots_saved",
+              [this] { return _probe.snapshots_saved; },
+              ss::metrics::description("Number of snapshots saved")),
           });
     }
 
@@ -116,10 +134,13 @@ ss::future<> kvstore::stop() {
     // flusher only operates on a snapshot of the pending ops that it takes when
     // it starts these ops begin cancelled would be ops that arrived between the
     // start of a flush and this service being stopped.
-    for (auto& op : _ops) {
-        op.done.set_exception(ss::gate_closed_exception());
+    for (auto& p : _partitions) {
+        for (auto& op : p.ops) {
+            op.done.set_exception(ss::gate_closed_exception());
+        }
+        p.ops.clear();
     }
-    _ops.clear();
+    _pending_ops = 0;
 
     return f.then([this] {
         // wait until the flusher exists--it might create _segment
@@ -146,13 +167,34 @@ static inline bytes make_spaced_key(kvstore::key_space ks, bytes_view key) {
     return spaced_key;
 }
 
+/*
+ * Split a key prefixed by a key-space, std::nullopt if the key space is not
+ * known to this version
+ */
+static inline std::optional<std::pair<kvstore::key_space, bytes>>
+split_spaced_key(const bytes& spaced_key) {
+    using ks_type = std::underlying_type<kvstore::key_space>::type;
+    if (spaced_key.size() < sizeof(ks_type)) {
+        return std::nullopt;
+    }
+    ks_type ks_le;
+    std::copy_n(
+      spaced_key.begin(), sizeof(ks_le), reinterpret_cast<char*>(&ks_le));
+    auto ks = ss::le_to_cpu(ks_le);
+    if (ks < 0 || static_cast<size_t>(ks) >= kvstore::key_space_count) {
+        return std::nullopt;
+    }
+    return std::make_pair(
+      static_cast<kvstore::key_space>(ks),
+      bytes(spaced_key.begin() + sizeof(ks_le), spaced_key.end()));
+}
+
 std::optional<iobuf> kvstore::get(key_space ks, bytes_view key) {
     _probe.entry_fetched();
     vassert(_started, "kvstore has not been started");
 
-    // do not re-assign to string_view -> temporary
-    auto kkey = make_spaced_key(ks, key);
-    if (auto it = _db.find(kkey); it != _db.end()) {
+    auto& db = get_partition(ks).db;
+    if (auto it = db.find(key); it != db.end()) {
         return it->second.copy();
     }
     return std::nullopt;
@@ -171,10 +213,12 @@ ss::future<> kvstore::remove(key_space ks, bytes key) {
 ss::future<> kvstore::put(key_space ks, bytes key, std::optional<iobuf> value) {
     vassert(_started, "kvstore has not been started");
 
-    key = make_spaced_key(ks, key);
     return ss::with_gate(
-      _gate, [this, key = std::move(key), value = std::move(value)]() mutable {
-          auto& w = _ops.emplace_back(std::move(key), std::move(value));
+      _gate,
+      [this, ks, key = std::move(key), value = std::move(value)]() mutable {
+          auto& w = get_partition(ks).ops.emplace_back(
+            std::move(key), std::move(value));
+          ++_pending_ops;
           if (!_timer.armed()) {
               _timer.arm(_conf.commit_interval());
           }
@@ -182,14 +226,16 @@ ss::future<> kvstore::put(key_space ks, bytes key, std::optional<iobuf> value) {
       });
 }
 
-void kvstore::apply_op(bytes key, std::optional<iobuf> value) {
-    auto it = _db.find(key);
-    bool found = it != _db.end();
+void kvstore::apply_op(key_space ks, bytes key, std::optional<iobuf> value) {
+    auto& db = get_partition(ks).db;
+    auto it = db.find(key);
+    bool found = it != db.end();
     if (value) {
         vlog(
           lg.trace,
-          "Apply op: {}: key={} value={}",
+          "Apply op: {}: key_space={} key={} value={}",
           (found ? "update" : "insert"),
+          static_cast<int>(ks),
           key,
           value);
         if (found) {
@@ -198,7 +244,7 @@ void kvstore::apply_op(bytes key, std::optional<iobuf> value) {
             it->second = std::move(*value);
         } else {
             _probe.add_cached_bytes(key.size() + value->size_bytes());
-            _db.emplace(std::move(key), std::move(*value));
+            db.emplace(std::move(key), std::move(*value));
         }
     } else {
         if (!found) {
@@ -206,29 +252,56 @@ void kvstore::apply_op(bytes key, std::optional<iobuf> value) {
         } else {
             vlog(lg.trace, "Apply op: delete: key={}", key);
             _probe.dec_cached_bytes(it->first.size() + it->second.size_bytes());
-            _db.erase(it);
+            db.erase(it);
         }
     }
 }
 
+void kvstore::apply_spaced_op(bytes spaced_key, std::optional<iobuf> value) {
+    auto split = split_spaced_key(spaced_key);
+    if (!split) {
+        apply_unknown_op(std::move(spaced_key), std::move(value));
+        return;
+    }
+    apply_op(split->first, std::move(split->second), std::move(value));
+}
+
+void kvstore::apply_unknown_op(bytes spaced_key, std::optional<iobuf> value) {
+    // written by a newer version, kept as is so that it isn't lost when the
+    // snapshot is rewritten
+    vlog(lg.warn, "Keeping key {} of an unknown key space", spaced_key);
+    if (value) {
+        _unknown[std::move(spaced_key)] = std::move(*value);
+    } else {
+        _unknown.erase(spaced_key);
+    }
+}
+
 ss::future<> kvstore::flush_and_apply_ops() {
-    if (_ops.empty()) {
+    if (_pending_ops == 0) {
         return ss::now();
     }
 
-    // flush and apply whatever happens to be queued up
-    auto ops = std::exchange(_ops, {});
+    // flush and apply whatever happens to be queued up in every key space,
+    // all of them are committed by a single batch
+    std::array<std::vector<op>, key_space_count> ops;
+    _pending_ops = 0;
 
     // build the operation batch to be logged
     storage::record_batch_builder builder(
       model::record_batch_type::kvstore, _next_offset);
-    for (auto& op : ops) {
-        std::optional<iobuf> value;
-        if (op.value) {
-            value = op.value->share(0, op.value->size_bytes());
+    for (size_t i = 0; i < key_space_count; ++i) {
+        ops[i] = std::exchange(_partitions[i].ops, {});
+        auto ks = static_cast<key_space>(i);
+        for (auto& op : ops[i]) {
+            std::optional<iobuf> value;
+            if (op.value) {
+                value = op.value->share(0, op.value->size_bytes());
+            }
+            builder.add_raw_kv(
+              bytes_to_iobuf(make_spaced_key(ks, op.key)),
+              reflection::to_iobuf(std::move(value)));
         }
-        builder.add_raw_kv(
-          bytes_to_iobuf(op.key), reflection::to_iobuf(std::move(value)));
     }
     auto batch = std::move(builder).build();
     auto last_offset = batch.last_offset();
@@ -242,101 +315,135 @@ ss::future<> kvstore::flush_and_apply_ops() {
     return _segment->append(std::move(batch))
       .then([this](append_result) { return _segment->flush(); })
       .then([this, last_offset, ops = std::move(ops)]() mutable {
-          for (auto& op : ops) {
-              apply_op(std::move(op.key), std::move(op.value));
-              op.done.set_value();
+          for (size_t i = 0; i < key_space_count; ++i) {
+              auto ks = static_cast<key_space>(i);
+              for (auto& op : ops[i]) {
+                  apply_op(ks, std::move(op.key), std::move(op.value));
+                  op.done.set_value();
+              }
           }
           _next_offset = last_offset + model::offset(1);
       });
 }
 
+ss::future<> kvstore::make_active_segment() {
+    return make_segment(
+             _ntpc,
+             model::offset(_next_offset),
+             model::term_id(0),
+             ss::default_priority_class(),
+             record_version_type::v1,
+             config::shard_local_cfg().storage_read_buffer_size(),
+             config::shard_local_cfg().storage_read_readahead_count(),
+             _conf.sanitize_fileops,
+             std::nullopt,
+             _resources)
+      .then([this](ss::lw_shared_ptr<segment> seg) {
+          _segment = std::move(seg);
+      });
+}
+
 ss::future<> kvstore::roll() {
     if (!_segment) {
-        return make_segment(
-                 _ntpc,
-                 model::offset(_next_offset),
-                 model::term_id(0),
-                 ss::default_priority_class(),
-                 record_version_type::v1,
-                 config::shard_local_cfg().storage_read_buffer_size(),
-                 config::shard_local_cfg().storage_read_readahead_count(),
-                 _conf.sanitize_fileops,
-                 std::nullopt,
-                 _resources)
-          .then([this](ss::lw_shared_ptr<segment> seg) {
-              _segment = std::move(seg);
-          });
+        co_await make_active_segment();
+        co_return;
     }
 
-    if (_segment->appender().file_byte_offset() > _conf.max_segment_size) {
-        _probe.roll_segment();
+    if (_segment->appender().file_byte_offset() <= _conf.max_segment_size) {
+        co_return;
+    }
 
+    if (_snapshot_in_flight) {
+        // keep appending to the active segment until the previous snapshot is
+        // written rather than holding a second copy of the db in memory
         vlog(
-          lg.debug,
-          "Rolling segment with base offset {} size {}",
+          lg.trace,
+          "Deferring roll of segment with base offset {} size {}: snapshot in "
+          "flight",
           _segment->offsets().base_offset,
           _segment->appender().file_byte_offset());
-        // _segment being set is a signal to stop() to flush and close the
-        // segment. we clear _segment here before closing and finishing the roll
-        // process so that if an issue occurs and the flush fiber terminates
-        // that stop() doesn't try to flush and close a closed and partially
-        // cleaned-up segment.
-        auto seg = std::exchange(_segment, nullptr);
-        return seg->close()
-          .then([this] { return save_snapshot(); })
-          .then([seg] {
-              vlog(
-                lg.debug,
-                "Removing old segment with base offset {}",
-                seg->offsets().base_offset);
-              return ss::remove_file(seg->reader().path().string()).then([seg] {
-                  return ss::remove_file(seg->index().path().string());
-              });
-          })
-          .then([this] {
-              return make_segment(
-                       _ntpc,
-                       model::offset(_next_offset),
-                       model::term_id(0),
-                       ss::default_priority_class(),
-                       record_version_type::v1,
-                       config::shard_local_cfg().storage_read_buffer_size(),
-                       config::shard_local_cfg().storage_read_readahead_count(),
-                       _conf.sanitize_fileops,
-                       std::nullopt,
-                       _resources)
-                .then([this](ss::lw_shared_ptr<segment> seg) {
-                    _segment = std::move(seg);
-                });
-          });
+        co_return;
     }
 
-    return ss::now();
+    _probe.roll_segment();
+    vlog(
+      lg.debug,
+      "Rolling segment with base offset {} size {}",
+      _segment->offsets().base_offset,
+      _segment->appender().file_byte_offset());
+    // _segment being set is a signal to stop() to flush and close the
+    // segment. we clear _segment here before closing and finishing the roll
+    // process so that if an issue occurs and the flush fiber terminates
+    // that stop() doesn't try to flush and close a closed and partially
+    // cleaned-up segment.
+    auto seg = std::exchange(_segment, nullptr);
+    co_await seg->close();
+
+    // the snapshot captures the db as of the end of the closed segment, it is
+    // written while new operations are committed to the next segment
+    auto last_offset = _next_offset - model::offset(1);
+    auto data = co_await serialize_snapshot();
+    co_await make_active_segment();
+
+    if (_gate.is_closed()) {
+        // shutting down, recovery replays the closed segment
+        co_return;
+    }
+    _snapshot_in_flight = true;
+    ssx::spawn_with_gate(
+      _gate,
+      [this,
+       data = std::move(data),
+       last_offset,
+       seg = std::move(seg)]() mutable {
+          return save_snapshot_and_remove(
+            std::move(data), last_offset, std::move(seg));
+      });
 }
 
-ss::future<> kvstore::save_snapshot() {
-    vassert(
-      _next_offset >= model::offset(0),
-      "Unexpected next offset {}",
-      _next_offset);
-
-    // no operations have been applied to the db
-    if (_next_offset == model::offset(0)) {
-        return ss::now();
+ss::future<> kvstore::save_snapshot_and_remove(
+  iobuf data, model::offset last_offset, ss::lw_shared_ptr<segment> seg) {
+    auto clear_in_flight = ss::defer([this] { _snapshot_in_flight = false; });
+    try {
+        co_await save_snapshot(std::move(data), last_offset);
+    } catch (...) {
+        // the segment is removed by the recovery following a later snapshot
+        vlog(
+          lg.warn,
+          "Failed to save snapshot at offset {}, keeping segment with base "
+          "offset {}: {}",
+          last_offset,
+          seg->offsets().base_offset,
+          std::current_exception());
+        co_return;
     }
-
     vlog(
       lg.debug,
-      "Creating snapshot at offset {}",
-      _next_offset - model::offset(1));
+      "Removing old segment with base offset {}",
+      seg->offsets().base_offset);
+    co_await ss::remove_file(seg->reader().path().string());
+    co_await ss::remove_file(seg->index().path().string());
+}
 
-    // package up the db into a batch
+ss::future<iobuf> kvstore::serialize_snapshot() {
+    // package up the db into a batch. the db is only mutated by the flusher
+    // which waits for this to finish, so it is safe to yield between entries.
     storage::record_batch_builder builder(
       model::record_batch_type::kvstore, model::offset(0));
-    for (auto& entry : _db) {
+    for (size_t i = 0; i < key_space_count; ++i) {
+        auto ks = static_cast<key_space>(i);
+        for (auto& entry : _partitions[i].db) {
+            builder.add_raw_kv(
+              bytes_to_iobuf(make_spaced_key(ks, entry.first)),
+              entry.second.share(0, entry.second.size_bytes()));
+            co_await ss::coroutine::maybe_yield();
+        }
+    }
+    for (auto& entry : _unknown) {
         builder.add_raw_kv(
           bytes_to_iobuf(entry.first),
           entry.second.share(0, entry.second.size_bytes()));
+        co_await ss::coroutine::maybe_yield();
     }
     auto batch = std::move(builder).build();
 
@@ -346,30 +453,40 @@ ss::future<> kvstore::save_snapshot() {
     reflection::serialize(data, std::move(batch));
     auto size = ss::cpu_to_le(int32_t(data.size_bytes() - sizeof(int32_t)));
     ph.write((const char*)&size, sizeof(size));
+    co_return data;
+}
 
-    return _snap.start_snapshot().then(
-      [this, data = std::move(data)](snapshot_writer writer) mutable {
-          return ss::do_with(
-            std::move(writer),
-            [this, data = std::move(data)](snapshot_writer& wr) mutable {
-                // the last log offset represented in the snapshot
-                auto last_offset = _next_offset - model::offset(1);
-
-                iobuf meta;
-                reflection::serialize(meta, last_offset);
-
-                return wr.write_metadata(std::move(meta))
-                  .then([&wr, data = std::move(data)]() mutable {
-                      auto& os = wr.output(); // kept alive by do_with above
-                      return write_iobuf_to_output_stream(std::move(data), os);
-                  })
-                  .then([&wr] { return wr.close(); })
-                  .then([this, &wr]() {
-                      vlog(lg.debug, "Finishing snapshot creation");
-                      return _snap.finish_snapshot(wr);
-                  });
-            });
-      });
+ss::future<> kvstore::save_snapshot() {
+    vassert(
+      _next_offset >= model::offset(0),
+      "Unexpected next offset {}",
+      _next_offset);
+
+    // no operations have been applied to the db
+    if (_next_offset == model::offset(0)) {
+        co_return;
+    }
+
+    auto last_offset = _next_offset - model::offset(1);
+    co_await save_snapshot(co_await serialize_snapshot(), last_offset);
+}
+
+ss::future<> kvstore::save_snapshot(iobuf data, model::offset last_offset) {
+    // snapshots are taken in offset order, write them in that order too
+    auto units = co_await _snapshot_mutex.get_units();
+
+    vlog(lg.debug, "Creating snapshot at offset {}", last_offset);
+    auto writer = co_await _snap.start_snapshot();
+
+    // the last log offset represented in the snapshot
+    iobuf meta;
+    reflection::serialize(meta, last_offset);
+    co_await writer.write_metadata(std::move(meta));
+    co_await write_iobuf_to_output_stream(std::move(data), writer.output());
+    co_await writer.close();
+    vlog(lg.debug, "Finishing snapshot creation");
+    co_await _snap.finish_snapshot(writer);
+    _probe.snapshot_saved();
 }
 
 ss::future<> kvstore::recover() {
@@ -380,6 +497,7 @@ ss::future<> kvstore::recover() {
          */
         load_snapshot_in_thread();
 
+        segment_recovery_stats stats;
         auto segments
           = recover_segments(
               partition_path(_ntpc),
@@ -390,7 +508,8 @@ ss::future<> kvstore::recover() {
               config::shard_local_cfg().storage_read_buffer_size(),
               config::shard_local_cfg().storage_read_readahead_count(),
               std::nullopt,
-              _resources)
+              _resources,
+              stats)
               .get0();
 
         replay_segments_in_thread(std::move(segments));
@@ -454,9 +573,16 @@ void kvstore::load_snapshot_in_thread() {
     }
 
     batch.for_each_record([this](model::record r) {
-        auto key = iobuf_to_bytes(r.release_key());
+        auto spaced_key = iobuf_to_bytes(r.release_key());
+        auto split = split_spaced_key(spaced_key);
+        if (!split) {
+            apply_unknown_op(std::move(spaced_key), r.release_value());
+            return;
+        }
+        auto& [ks, key] = *split;
         _probe.add_cached_bytes(key.size() + r.value().size_bytes());
-        auto res = _db.emplace(std::move(key), r.release_value());
+        auto res = get_partition(ks).db.emplace(
+          std::move(key), r.release_value());
         vassert(
           res.second, "Snapshot contained duplicate key {}", res.first->first);
         vlog(
@@ -594,7 +720,7 @@ batch_consumer::stop_parser kvstore::replay_consumer::consume_batch_end() {
         auto key = iobuf_to_bytes(r.release_key());
         auto value = reflection::from_iobuf<std::optional<iobuf>>(
           r.release_value());
-        _store->apply_op(std::move(key), std::move(value));
+        _store->apply_spaced_op(std::move(key), std::move(value));
         _store->_next_offset += model::offset(1);
     });
 
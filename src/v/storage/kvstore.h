@@ -27,6 +27,9 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <array>
+
 namespace storage {
 
 /**
@@ -56,6 +59,26 @@ namespace storage {
  * means is that the key-value store provides no consistency guarantees for
  * concurrent reads and writes to the same key.
  *
+ * Each key space is a separate partition with its own map and queue of
+ * pending operations, so lookups don't build prefixed keys and the sub-systems
+ * don't share a single queue. The pending operations of all key spaces are
+ * committed together: a single batch is appended and flushed per commit
+ * interval.
+ *
+ * Compaction
+ * ==========
+ *
+ * When the active segment reaches its maximum size a new segment is started
+ * right away and the snapshot replacing the old segment is written in the
+ * background, so operations keep being committed while the snapshot is
+ * written. The db is serialized in chunks, yielding between entries, and at
+ * most one snapshot is in flight: while one is being written the active
+ * segment keeps growing past its maximum size instead of rolling, so there is
+ * never more than one serialized copy of the db in memory. The old segment is
+ * removed once the snapshot covering it is durable. A crash before that
+ * leaves the previous snapshot and both segments behind, which recovery
+ * replays as usual.
+ *
  * This is sufficient for the initial use cases of storing voted_for metadata
  * in which access to the underlying file storing the metadata was already
  * controlled.
@@ -98,6 +121,11 @@ public:
         offset_translator = 4,
         /* your sub-system here */
     };
+    // number of key spaces, must cover every key_space above
+    static constexpr size_t key_space_count = 5;
+    static_assert(
+      static_cast<size_t>(key_space::offset_translator) + 1
+      == key_space_count);
 
     explicit kvstore(kvstore_config kv_conf, storage_resources&);
 
@@ -110,7 +138,10 @@ public:
 
     bool empty() const {
         vassert(_started, "kvstore has not been started");
-        return _db.empty();
+        return std::all_of(
+          _partitions.begin(), _partitions.end(), [](const partition& p) {
+              return p.db.empty();
+          });
     }
 
 private:
@@ -135,24 +166,53 @@ private:
           , value(std::move(value)) {}
     };
 
+    using map_t
+      = absl::flat_hash_map<bytes, iobuf, bytes_type_hash, bytes_type_eq>;
+
+    /**
+     * State of a key space: its keys without the key space prefix and the
+     * operations waiting for the next commit.
+     */
+    struct partition {
+        map_t db;
+        std::vector<op> ops;
+    };
+
     /*
-     * database operations are cached in `ops` and periodically flushed to the
-     * current `segment` at position `next_offset` and then applied to `db`.
-     * when the segment reaches a threshold size a snapshot is saved a new
-     * segment is created.
+     * database operations are queued in the `ops` of their partition and
+     * periodically flushed together to the current `segment` at position
+     * `next_offset` and then applied to the `db` of their partition. when the
+     * segment reaches a threshold size a new segment is created and a snapshot
+     * replacing the old one is saved in the background.
      */
-    std::vector<op> _ops;
+    std::array<partition, key_space_count> _partitions;
+    // entries of key spaces unknown to this version, by their prefixed key
+    map_t _unknown;
+    size_t _pending_ops{0};
     ss::timer<> _timer;
     ssx::semaphore _sem{0, "s/kvstore"};
     ss::lw_shared_ptr<segment> _segment;
     model::offset _next_offset;
-    absl::flat_hash_map<bytes, iobuf, bytes_type_hash, bytes_type_eq> _db;
+    mutex _snapshot_mutex;
+    // a snapshot is being written in the background, rolling waits for it
+    bool _snapshot_in_flight{false};
+
+    partition& get_partition(key_space ks) {
+        return _partitions[static_cast<size_t>(ks)];
+    }
 
     ss::future<> put(key_space ks, bytes key, std::optional<iobuf> value);
-    void apply_op(bytes key, std::optional<iobuf> value);
+    void apply_op(key_space ks, bytes key, std::optional<iobuf> value);
+    void apply_spaced_op(bytes spaced_key, std::optional<iobuf> value);
+    void apply_unknown_op(bytes spaced_key, std::optional<iobuf> value);
     ss::future<> flush_and_apply_ops();
     ss::future<> roll();
+    ss::future<> make_active_segment();
+    ss::future<iobuf> serialize_snapshot();
     ss::future<> save_snapshot();
+    ss::future<> save_snapshot(iobuf data, model::offset last_offset);
+    ss::future<>
+      save_snapshot_and_remove(iobuf, model::offset, ss::lw_shared_ptr<segment>);
 
     /*
      * Recovery
@@ -196,6 +256,7 @@ private:
 
     struct probe {
         void roll_segment() { ++segments_rolled; }
+        void snapshot_saved() { ++snapshots_saved; }
         void entry_fetched() { ++entries_fetched; }
         void entry_written() { ++entries_written; }
         void entry_removed() { ++entries_removed; }
@@ -203,6 +264,7 @@ private:
         void dec_cached_bytes(size_t count) { cached_bytes -= count; }
 
         uint64_t segments_rolled{0};
+        uint64_t snapshots_saved{0};
         uint64_t entries_fetched{0};
         uint64_t entries_written{0};
         uint64_t entries_removed{0};
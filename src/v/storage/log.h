@@ -10,11 +10,13 @@
  */
 
 #pragma once
+#include "bytes/bytes.h"
 #include "model/fundamental.h"
 #include "model/record_batch_reader.h"
 #include "model/timeout_clock.h"
 #include "model/timestamp.h"
 #include "seastarx.h"
+#include "storage/disk_usage.h"
 #include "storage/log_appender.h"
 #include "storage/ntp_config.h"
 #include "storage/segment_reader.h"
@@ -70,6 +72,8 @@ public:
         virtual ss::future<std::optional<timequery_result>>
           timequery(timequery_config) = 0;
 
+        virtual ss::future<key_lookup_result> lookup_key(bytes) = 0;
+
         const ntp_config& config() const { return _config; }
 
         virtual size_t segment_count() const = 0;
@@ -88,10 +92,13 @@ public:
         }
 
         virtual size_t size_bytes() const = 0;
+        virtual storage::disk_usage get_disk_usage() const = 0;
         virtual ss::future<>
           update_configuration(ntp_config::default_overrides) = 0;
 
         virtual int64_t compaction_backlog() const = 0;
+        virtual storage::housekeeping_stats
+          housekeeping_stats(const compaction_config&) const = 0;
 
     private:
         ntp_config _config;
@@ -172,6 +179,17 @@ public:
         return _impl->timequery(cfg);
     }
 
+    /**
+     * \brief Offset of the latest record with the key in the data batches of
+     * the log, including records of aborted transactions. Segments whose key
+     * filter doesn't contain the key are not read.
+     *
+     * Meant for debugging compacted topics, all other segments are read.
+     */
+    ss::future<key_lookup_result> lookup_key(bytes key) {
+        return _impl->lookup_key(std::move(key));
+    }
+
     ss::future<> compact(compaction_config cfg) { return _impl->compact(cfg); }
 
     ss::future<> housekeeping() { return _impl->do_housekeeping(); }
@@ -204,10 +222,22 @@ public:
 
     int64_t compaction_backlog() const { return _impl->compaction_backlog(); }
 
+    /// \brief how much compaction and retention have to do on this log when
+    /// housekeeping runs with the given defaults
+    storage::housekeeping_stats
+    housekeeping_stats(const compaction_config& cfg) const {
+        return _impl->housekeeping_stats(cfg);
+    }
+
     std::ostream& print(std::ostream& o) const { return _impl->print(o); }
 
     size_t size_bytes() const { return _impl->size_bytes(); }
 
+    /// bytes of the data, index and compaction index files of the log
+    storage::disk_usage get_disk_usage() const {
+        return _impl->get_disk_usage();
+    }
+
     impl* get_impl() const { return _impl.get(); }
 
 private:
@@ -12,52 +12,60 @@
 #pragma once
 
 #include "storage/log.h"
+#include "storage/types.h"
 #include "utils/intrusive_list_helpers.h"
 
+#include <seastar/core/lowres_clock.hh>
+
+#include <algorithm>
+
 namespace storage {
+
+inline constexpr int max_staleness_intervals = 4;
+
+/**
+ * Priority of a log for compaction and retention, logs with higher scores are
+ * housekept first.
+ *
+ * The score adds up three terms, each in [0, 1]:
+ *  - the fraction of the log over its retention.bytes, weighted twice as
+ *    space held over retention is what fills disks
+ *  - the fraction of the closed bytes of a compacted log not compacted yet
+ *  - the time since the log was last housekept, saturating at
+ *    `max_staleness_intervals` compaction intervals so that logs with nothing
+ *    to do still get their turn
+ */
+inline double housekeeping_score(
+  const housekeeping_stats& stats,
+  ss::lowres_clock::duration since_last_compaction,
+  ss::lowres_clock::duration compaction_interval) {
+    double retention = 0;
+    if (stats.size_bytes > 0) {
+        retention = static_cast<double>(stats.bytes_over_retention)
+                    / static_cast<double>(stats.size_bytes);
+    }
+    double staleness = 1;
+    if (compaction_interval.count() > 0) {
+        staleness = std::min(
+                      static_cast<double>(since_last_compaction.count())
+                        / static_cast<double>(compaction_interval.count()),
+                      static_cast<double>(max_staleness_intervals))
+                    / max_staleness_intervals;
+    }
+    return 2 * retention + std::clamp(stats.dirty_ratio, 0.0, 1.0)
+           + std::max(staleness, 0.0);
+}
+
 struct log_housekeeping_meta {
-    enum class bitflags : uint32_t {
-        none = 0,
-        compacted = 1U,
-    };
     explicit log_housekeeping_meta(log l) noexcept
       : handle(std::move(l)) {}
 
     log handle;
-    bitflags flags{bitflags::none};
     ss::lowres_clock::time_point last_compaction;
+    // score of the log in the last housekeeping round
+    double score{0};
 
     intrusive_list_hook link;
 };
 
-inline log_housekeeping_meta::bitflags operator|(
-  log_housekeeping_meta::bitflags a, log_housekeeping_meta::bitflags b) {
-    return log_housekeeping_meta::bitflags(
-      std::underlying_type_t<log_housekeeping_meta::bitflags>(a)
-      | std::underlying_type_t<log_housekeeping_meta::bitflags>(b));
-}
-
-inline void operator|=(
-  log_housekeeping_meta::bitflags& a, log_housekeeping_meta::bitflags b) {
-    a = (a | b);
-}
-
-inline log_housekeeping_meta::bitflags
-operator~(log_housekeeping_meta::bitflags a) {
-    return log_housekeeping_meta::bitflags(
-      ~std::underlying_type_t<log_housekeeping_meta::bitflags>(a));
-}
-
-inline log_housekeeping_meta::bitflags operator&(
-  log_housekeeping_meta::bitflags a, log_housekeeping_meta::bitflags b) {
-    return log_housekeeping_meta::bitflags(
-      std::underlying_type_t<log_housekeeping_meta::bitflags>(a)
-      & std::underlying_type_t<log_housekeeping_meta::bitflags>(b));
-}
-
-inline void operator&=(
-  log_housekeeping_meta::bitflags& a, log_housekeeping_meta::bitflags b) {
-    a = (a & b);
-}
-
 } // namespace storage
@@ -19,6 +19,7 @@
 #include "storage/batch_cache.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/fs_utils.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/kvstore.h"
 #include "storage/log.h"
 #include "storage/logger.h"
@@ -39,6 +40,7 @@
 #include <seastar/core/future-util.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/gate.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/print.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/shared_ptr.hh>
@@ -50,10 +52,12 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <chrono>
 #include <exception>
 #include <filesystem>
 #include <optional>
+#include <vector>
 
 namespace storage {
 using logs_type = absl::flat_hash_map<model::ntp, log_housekeeping_meta>;
@@ -130,6 +134,9 @@ log_manager::log_manager(
   , _resources(resources)
   , _jitter(_config.compaction_interval())
   , _batch_cache(config.reclaim_opts) {
+    _recovery_probe.setup_metrics();
+    _housekeeping_probe.setup_metrics();
+    _disk_usage.setup_metrics();
     _housekeeping_timer.set_callback([this] { trigger_housekeeping(); });
     _housekeeping_timer.rearm(_jitter());
 
@@ -191,46 +198,96 @@ ss::future<> log_manager::stop() {
 }
 
 /**
- * `housekeeping_scan` scans over every current log in a single pass.
+ * `housekeeping_scan` scans over every current log in a single pass to apply
+ * segment.ms, then compacts and garbage collects the logs in order of their
+ * housekeeping_score, running up to `log_compaction_max_concurrency` of them
+ * at a time.
  */
 ss::future<>
 log_manager::housekeeping_scan(model::timestamp collection_threshold) {
-    using bflags = log_housekeeping_meta::bitflags;
-
     if (_logs_list.empty()) {
         co_return;
     }
 
-    // TODO handle this after compaction?
-    // handle segment.ms sequentially, since compaction is already sequential
-    // when this will be unified with compaction, the whole task could be made
-    // concurrent
+    // handle segment.ms sequentially, rolling a segment is cheap
     for (auto& log_meta : _logs_list) {
         co_await log_meta.handle.housekeeping();
     }
 
+    // scores only depend on retention bytes, the collectible offset of each
+    // log is taken when its compaction starts
+    auto defaults = compaction_config(
+      collection_threshold,
+      _config.retention_bytes(),
+      model::offset{},
+      _config.compaction_priority,
+      _abort_source);
+    auto now = ss::lowres_clock::now();
+    std::vector<housekeeping_candidate> candidates;
+    candidates.reserve(_logs.size());
+    double max_score = 0;
+    double total_score = 0;
     for (auto& log_meta : _logs_list) {
-        log_meta.flags &= ~bflags::compacted;
+        log_meta.score = housekeeping_score(
+          log_meta.handle.housekeeping_stats(defaults),
+          now - log_meta.last_compaction,
+          _config.compaction_interval());
+        max_score = std::max(max_score, log_meta.score);
+        total_score += log_meta.score;
+        candidates.push_back(housekeeping_candidate{
+          .ntp = log_meta.handle.config().ntp(),
+          .handle = log_meta.handle,
+          .score = log_meta.score,
+        });
     }
+    std::stable_sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const housekeeping_candidate& a, const housekeeping_candidate& b) {
+          return a.score > b.score;
+      });
+    _housekeeping_probe.round_started(
+      candidates.size(), max_score, total_score);
+
+    co_await ss::max_concurrent_for_each(
+      candidates,
+      config::shard_local_cfg().log_compaction_max_concurrency(),
+      [this, collection_threshold](housekeeping_candidate& c) {
+          return compact_log(c, collection_threshold);
+      });
+    _housekeeping_probe.round_finished();
+}
 
-    while ((_logs_list.front().flags & bflags::compacted) == bflags::none) {
-        auto& current_log = _logs_list.front();
-
-        _logs_list.pop_front();
-        _logs_list.push_back(current_log);
-
-        current_log.flags |= bflags::compacted;
-        current_log.last_compaction = ss::lowres_clock::now();
-        co_await current_log.handle.compact(compaction_config(
+ss::future<> log_manager::compact_log(
+  housekeeping_candidate& c, model::timestamp collection_threshold) {
+    if (_abort_source.abort_requested()) {
+        co_return;
+    }
+    vlog(stlog.trace, "Compacting {} with score {:.3f}", c.ntp, c.score);
+    _housekeeping_probe.compaction_started();
+    bool failed = false;
+    try {
+        co_await c.handle.compact(compaction_config(
           collection_threshold,
           _config.retention_bytes(),
-          current_log.handle.stm_manager()->max_collectible_offset(),
+          c.handle.stm_manager()->max_collectible_offset(),
           _config.compaction_priority,
           _abort_source));
-
-        if (_logs_list.empty()) {
-            co_return;
-        }
+    } catch (const ss::gate_closed_exception&) {
+        // the log was closed or removed since the round started
+    } catch (const ss::abort_requested_exception&) {
+        // shutting down
+    } catch (...) {
+        failed = true;
+        vlog(
+          stlog.warn,
+          "Error compacting {}: {}",
+          c.ntp,
+          std::current_exception());
+    }
+    _housekeeping_probe.compaction_finished(failed);
+    if (auto it = _logs.find(c.ntp); it != _logs.end()) {
+        it->second->last_compaction = ss::lowres_clock::now();
     }
 }
 
@@ -291,11 +348,43 @@ log_manager::create_cache(with_cache ntp_cache_enabled) {
     return batch_cache_index(_batch_cache);
 }
 
-ss::future<log> log_manager::manage(ntp_config cfg) {
+ss::future<log>
+log_manager::manage(ntp_config cfg, recovery_priority priority) {
+    using clock_type = segment_recovery_stats::clock_type;
     auto gate = _open_gate.hold();
 
-    auto units = co_await _resources.get_recovery_units();
-    co_return co_await do_manage(std::move(cfg));
+    const auto wait_start = clock_type::now();
+    auto units = co_await _resources.get_recovery_units(priority);
+    const auto start = clock_type::now();
+
+    segment_recovery_stats stats;
+    auto ntp = cfg.ntp();
+    auto l = co_await do_manage(std::move(cfg), stats);
+
+    const auto end = clock_type::now();
+    _recovery_probe.log_recovered(
+      priority, start - wait_start, end - start, stats);
+    vlog(
+      stlog.debug,
+      "Recovered log {} with {} priority in {}ms (waited {}ms), segments "
+      "opened: {} ({}ms), indexes loaded in {}ms, segments replayed: {} "
+      "({}ms), skipped clean: {}",
+      ntp,
+      priority,
+      std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+        .count(),
+      std::chrono::duration_cast<std::chrono::milliseconds>(start - wait_start)
+        .count(),
+      stats.segments_opened,
+      std::chrono::duration_cast<std::chrono::milliseconds>(stats.open_time)
+        .count(),
+      std::chrono::duration_cast<std::chrono::milliseconds>(stats.index_time)
+        .count(),
+      stats.segments_replayed,
+      std::chrono::duration_cast<std::chrono::milliseconds>(stats.replay_time)
+        .count(),
+      stats.segments_skipped_clean);
+    co_return l;
 }
 
 ss::future<> log_manager::recover_log_state(const ntp_config& cfg) {
@@ -317,7 +406,8 @@ ss::future<> log_manager::recover_log_state(const ntp_config& cfg) {
       });
 }
 
-ss::future<log> log_manager::do_manage(ntp_config cfg) {
+ss::future<log>
+log_manager::do_manage(ntp_config cfg, segment_recovery_stats& stats) {
     if (_config.base_dir.empty()) {
         throw std::runtime_error(
           "log_manager:: cannot have empty config.base_dir");
@@ -358,7 +448,8 @@ ss::future<log> log_manager::do_manage(ntp_config cfg) {
       config::shard_local_cfg().storage_read_buffer_size(),
       config::shard_local_cfg().storage_read_readahead_count(),
       last_clean_segment,
-      _resources);
+      _resources,
+      stats);
 
     auto l = storage::make_disk_backed_log(
       std::move(cfg), *this, std::move(segments), _kvstore);
@@ -409,7 +500,10 @@ ss::future<> log_manager::remove(model::ntp ntp) {
           //
           // TODO: we should more consistently clean up the staging operations
           // to clean up after themselves on failure.
-          if (boost::algorithm::ends_with(de.name, ".staging")) {
+          if (
+            boost::algorithm::ends_with(de.name, ".staging")
+            || boost::algorithm::ends_with(
+              de.name, fmt::format(".staging{}", key_filter_suffix))) {
               // It isn't necessarily problematic to get here since we can
               // proceed with removal, but it points to a missing cleanup which
               // can be problematic for users, as it needlessly consumes space.
@@ -16,10 +16,13 @@
 #include "random/simple_time_jitter.h"
 #include "seastarx.h"
 #include "storage/batch_cache.h"
+#include "storage/disk_usage.h"
 #include "storage/log.h"
 #include "storage/log_housekeeping_meta.h"
 #include "storage/ntp_config.h"
+#include "storage/probe.h"
 #include "storage/segment.h"
+#include "storage/segment_set.h"
 #include "storage/storage_resources.h"
 #include "storage/types.h"
 #include "storage/version.h"
@@ -156,7 +159,12 @@ public:
     explicit log_manager(
       log_config, kvstore& kvstore, storage_resources&) noexcept;
 
-    ss::future<log> manage(ntp_config);
+    /// \brief opens the log of the ntp, recovering it if needed. At most
+    /// storage_max_concurrent_replay logs (divided by the number of shards)
+    /// are recovered at the same time, waiting logs are admitted in priority
+    /// order.
+    ss::future<log>
+      manage(ntp_config, recovery_priority = recovery_priority::normal);
 
     ss::future<> shutdown(model::ntp);
 
@@ -202,13 +210,17 @@ public:
 
     storage_resources& resources() { return _resources; }
 
+    /// Disk usage of the logs of this shard, in total and by topic
+    disk_usage_tracker& usage_tracker() { return _disk_usage; }
+    const disk_usage_tracker& usage_tracker() const { return _disk_usage; }
+
 private:
     using logs_type
       = absl::flat_hash_map<model::ntp, std::unique_ptr<log_housekeeping_meta>>;
     using compaction_list_type
       = intrusive_list<log_housekeeping_meta, &log_housekeeping_meta::link>;
 
-    ss::future<log> do_manage(ntp_config);
+    ss::future<log> do_manage(ntp_config, segment_recovery_stats&);
     ss::future<> clean_close(storage::log&);
 
     /**
@@ -224,7 +236,15 @@ private:
     ss::future<> recover_log_state(const ntp_config&);
     ss::future<> async_clear_logs();
 
+    struct housekeeping_candidate {
+        model::ntp ntp;
+        log handle;
+        double score;
+    };
+
     ss::future<> housekeeping_scan(model::timestamp);
+    ss::future<>
+    compact_log(housekeeping_candidate&, model::timestamp collection_threshold);
 
     log_config _config;
     kvstore& _kvstore;
@@ -234,6 +254,9 @@ private:
     logs_type _logs;
     compaction_list_type _logs_list;
     batch_cache _batch_cache;
+    log_recovery_probe _recovery_probe;
+    housekeeping_probe _housekeeping_probe;
+    disk_usage_tracker _disk_usage;
     ss::gate _open_gate;
     ss::abort_source _abort_source;
 
@@ -124,9 +124,13 @@ void skipping_consumer::print(std::ostream& os) const {
 }
 
 log_segment_batch_reader::log_segment_batch_reader(
-  segment& seg, log_reader_config& config, probe& p) noexcept
+  segment& seg,
+  log_reader_config& config,
+  adaptive_read_ahead& read_ahead,
+  probe& p) noexcept
   : _seg(seg)
   , _config(config)
+  , _read_ahead(read_ahead)
   , _probe(p) {}
 
 ss::future<std::unique_ptr<continuous_batch_parser>>
@@ -134,7 +138,7 @@ log_segment_batch_reader::initialize(
   model::timeout_clock::time_point timeout,
   std::optional<model::offset> next_cached_batch) {
     auto input = co_await _seg.offset_data_stream(
-      _config.start_offset, _config.prio);
+      _config.start_offset, _config.prio, _read_ahead.window());
     co_return std::make_unique<continuous_batch_parser>(
       std::make_unique<skipping_consumer>(*this, timeout, next_cached_batch),
       std::move(input));
@@ -157,7 +161,8 @@ void log_segment_batch_reader::add_one(model::record_batch&& batch) {
     _state.buffer_size += size_bytes;
     _probe.add_bytes_read(size_bytes);
     if (!_config.skip_batch_cache) {
-        _seg.cache_put(b);
+        _seg.cache_put(
+          b, batch_cache::is_historical(_config.historical_read));
     }
 }
 ss::future<result<records_t>>
@@ -172,7 +177,7 @@ log_segment_batch_reader::read_some(model::timeout_clock::time_point timeout) {
       _config.type_filter,
       _config.first_timestamp,
       std::min(max_buffer_size, _config.max_bytes),
-      _config.skip_batch_cache);
+      _config.skip_batch_cache || _config.historical_read);
 
     // handles cases where the type filter skipped batches. see
     // batch_cache_index::read for more details.
@@ -202,11 +207,20 @@ log_segment_batch_reader::read_some(model::timeout_clock::time_point timeout) {
         _iterator = co_await initialize(timeout, cache_read.next_cached_batch);
     }
     auto ptr = _iterator.get();
-    co_return co_await ptr->consume()
-      .then([this](result<size_t> bytes_consumed) -> result<records_t> {
+    bool window_grew = false;
+    auto res = co_await ptr->consume()
+      .then([this, &window_grew](
+              result<size_t> bytes_consumed) -> result<records_t> {
           if (!bytes_consumed) {
               return bytes_consumed.error();
           }
+          // the parser reports the bytes consumed since the stream was opened
+          auto bytes = bytes_consumed.value() - _stream_bytes_consumed;
+          _stream_bytes_consumed = bytes_consumed.value();
+          if (!_config.first_timestamp) {
+              window_grew = _read_ahead.record_sequential_read(
+                bytes, _seg.resources());
+          }
           auto tmp = std::exchange(_state, {});
           return result<records_t>(std::move(tmp.buffer));
       })
@@ -219,6 +233,14 @@ log_segment_batch_reader::read_some(model::timeout_clock::time_point timeout) {
                   std::current_exception());
             }
         });
+    if (window_grew) {
+        // the next read reopens the stream with the larger window, starting
+        // at the index entry preceding the next batch
+        co_await _iterator->close();
+        _iterator.reset();
+        _stream_bytes_consumed = 0;
+    }
+    co_return res;
 }
 
 log_reader::log_reader(
@@ -243,7 +265,7 @@ log_reader::log_reader(
 
     if (_iterator.next_seg != _lease->range.end()) {
         _iterator.reader = std::make_unique<log_segment_batch_reader>(
-          **_iterator.next_seg, _config, _probe);
+          **_iterator.next_seg, _config, _read_ahead, _probe);
     }
 }
 
@@ -263,8 +285,16 @@ ss::future<> log_reader::find_next_valid_iterator() {
     }
     if (_iterator.next_seg != _lease->range.end()) {
         _iterator.reader = std::make_unique<log_segment_batch_reader>(
-          **_iterator.next_seg, _config, _probe);
+          **_iterator.next_seg, _config, _read_ahead, _probe);
         _iterator.current_reader_seg = _iterator.next_seg;
+        // the read moved on to the next segment, open the one after it while
+        // this one is being read
+        auto following = std::next(_iterator.next_seg);
+        if (
+          following != _lease->range.end()
+          && (*following)->offsets().base_offset <= _config.max_offset) {
+            (*following)->prewarm_reader();
+        }
     }
     if (tmp_reader) {
         auto raw = tmp_reader.get();
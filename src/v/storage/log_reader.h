@@ -14,6 +14,7 @@
 #include "bytes/iobuf.h"
 #include "model/limits.h"
 #include "model/record_batch_reader.h"
+#include "storage/adaptive_read_ahead.h"
 #include "storage/lock_manager.h"
 #include "storage/parser.h"
 #include "storage/probe.h"
@@ -91,7 +92,10 @@ public:
     static constexpr size_t max_buffer_size = 32 * 1024; // 32KB
 
     log_segment_batch_reader(
-      segment&, log_reader_config& config, probe& p) noexcept;
+      segment&,
+      log_reader_config& config,
+      adaptive_read_ahead& read_ahead,
+      probe& p) noexcept;
     log_segment_batch_reader(log_segment_batch_reader&&) noexcept = default;
     log_segment_batch_reader&
     operator=(log_segment_batch_reader&&) noexcept = delete;
@@ -121,9 +125,13 @@ private:
 
     segment& _seg;
     log_reader_config& _config;
+    adaptive_read_ahead& _read_ahead;
     probe& _probe;
 
     std::unique_ptr<continuous_batch_parser> _iterator;
+    // bytes the parser consumed from the current stream, reported to the
+    // read ahead as they are read
+    size_t _stream_bytes_consumed{0};
     tmp_state _state;
     friend class skipping_consumer;
 };
@@ -165,6 +173,9 @@ public:
      * 3. read next chunk of batches
      */
     void reset_config(log_reader_config cfg) {
+        if (cfg.start_offset != _config.start_offset) {
+            _read_ahead.reset();
+        }
         _config = cfg;
         _iterator.next_seg = _iterator.current_reader_seg;
     };
@@ -231,6 +242,7 @@ private:
     std::unique_ptr<lock_manager::lease> _lease;
     iterator_pair _iterator;
     log_reader_config _config;
+    adaptive_read_ahead _read_ahead;
     model::offset _last_base;
     probe& _probe;
     ss::abort_source::subscription _as_sub;
@@ -19,17 +19,21 @@
 #include "utils/vint.h"
 #include "vlog.h"
 
+#include <seastar/core/coroutine.hh>
+
 #include <limits>
 #include <type_traits>
 
 namespace storage {
 class checksumming_consumer final : public batch_consumer {
 public:
-    checksumming_consumer(segment* s, log_replayer::checkpoint& c)
-      : _seg(s)
+    checksumming_consumer(
+      segment_index& idx, ss::sstring name, log_replayer::checkpoint& c)
+      : _idx(idx)
+      , _name(std::move(name))
       , _cfg(c) {
         // we'll reconstruct the state manually
-        _seg->index().reset();
+        _idx.reset();
     }
     checksumming_consumer(const checksumming_consumer&) = delete;
     checksumming_consumer& operator=(const checksumming_consumer&) = delete;
@@ -64,7 +68,7 @@ public:
             _cfg.truncate_file_pos = _file_pos_to_end_of_batch;
             const auto physical_base_offset = _file_pos_to_end_of_batch
                                               - _header.size_bytes;
-            _seg->index().maybe_track(_header, physical_base_offset);
+            _idx.maybe_track(_header, physical_base_offset);
             _header = {};
             return stop_parser::no;
         }
@@ -78,37 +82,46 @@ public:
     }
 
     void print(std::ostream& os) const override {
-        fmt::print(os, "storage::checksumming_consumer segment {}", *_seg);
+        fmt::print(os, "storage::checksumming_consumer segment {}", _name);
     }
 
 private:
     model::record_batch_header _header;
-    segment* _seg;
+    segment_index& _idx;
+    ss::sstring _name;
     log_replayer::checkpoint& _cfg;
     crc::crc32c _crc;
     size_t _file_pos_to_end_of_batch{0};
 };
 
-// Called in the context of a ss::thread
-log_replayer::checkpoint
-log_replayer::recover_in_thread(const ss::io_priority_class& prio) {
-    vlog(stlog.debug, "Recovering segment {}", *_seg);
+ss::future<log_replayer::checkpoint> rebuild_index(
+  segment_index& idx, segment_reader& rdr, ss::io_priority_class prio) {
+    log_replayer::checkpoint ckpt;
     // explicitly not using the index to recover the full file
-    auto data_stream = _seg->reader().data_stream(0, prio).get();
-    auto consumer = std::make_unique<checksumming_consumer>(_seg, _ckpt);
+    auto data_stream = co_await rdr.data_stream(0, prio);
+    auto consumer = std::make_unique<checksumming_consumer>(
+      idx, rdr.filename(), ckpt);
     auto parser = continuous_batch_parser(
       std::move(consumer), std::move(data_stream), true);
     try {
-        parser.consume().get();
+        co_await parser.consume();
     } catch (...) {
         vlog(
           stlog.warn,
           "{} partial recovery to {}, with: {}",
-          _seg->reader().filename(),
-          _ckpt,
+          rdr.filename(),
+          ckpt,
           std::current_exception());
     }
-    parser.close().get();
+    co_await parser.close();
+    co_return ckpt;
+}
+
+// Called in the context of a ss::thread
+log_replayer::checkpoint
+log_replayer::recover_in_thread(const ss::io_priority_class& prio) {
+    vlog(stlog.debug, "Recovering segment {}", *_seg);
+    _ckpt = rebuild_index(_seg->index(), _seg->reader(), prio).get();
     return _ckpt;
 }
 
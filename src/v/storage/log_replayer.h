@@ -15,11 +15,16 @@
 #include "seastarx.h"
 #include "storage/fwd.h"
 
+#include <seastar/core/future.hh>
+
 #include <seastar/core/io_queue.hh>
 #include <seastar/util/bool_class.hh>
 
 namespace storage {
 
+class segment_index;
+class segment_reader;
+
 class log_replayer {
 public:
     explicit log_replayer(segment& seg) noexcept
@@ -45,4 +50,9 @@ private:
     friend std::ostream& operator<<(std::ostream&, const checkpoint&);
 };
 
+/// \brief resets \p idx and tracks the batches read from \p rdr, up to the
+/// first one whose checksum doesn't match
+ss::future<log_replayer::checkpoint>
+rebuild_index(segment_index& idx, segment_reader& rdr, ss::io_priority_class);
+
 } // namespace storage
@@ -14,6 +14,7 @@
 #include "model/timeout_clock.h"
 #include "model/timestamp.h"
 #include "seastarx.h"
+#include "storage/compaction_reducers.h"
 #include "storage/log.h"
 #include "storage/logger.h"
 #include "storage/types.h"
@@ -185,6 +186,22 @@ struct mem_log_impl final : log::impl {
         }
         return ss::make_ready_future<ret_t>();
     }
+    ss::future<key_lookup_result> lookup_key(bytes key) final {
+        // there are no key filters, all batches are read
+        auto o = offsets();
+        return make_reader(log_reader_config(
+                             o.start_offset,
+                             o.dirty_offset,
+                             ss::default_priority_class()))
+          .then([key = std::move(key)](model::record_batch_reader r) mutable {
+              return std::move(r).consume(
+                internal::key_lookup_reducer(bytes_to_iobuf(key)),
+                model::no_timeout);
+          })
+          .then([](std::optional<model::offset> offset) {
+              return key_lookup_result{.offset = offset};
+          });
+    }
     ss::future<> truncate_prefix(truncate_prefix_config cfg) final {
         stlog.debug("PREFIX Truncating {} log at {}", config().ntp(), cfg);
         if (cfg.start_offset <= _start_offset) {
@@ -317,6 +334,10 @@ struct mem_log_impl final : log::impl {
     }
 
     int64_t compaction_backlog() const final { return 0; }
+    storage::housekeeping_stats
+    housekeeping_stats(const compaction_config&) const final {
+        return {.size_bytes = size_bytes()};
+    }
 
     ss::future<model::record_batch_reader>
     make_reader(log_reader_config cfg) final {
@@ -432,6 +453,10 @@ struct mem_log_impl final : log::impl {
           });
     }
 
+    storage::disk_usage get_disk_usage() const override {
+        return {.data = size_bytes()};
+    }
+
     struct eviction_monitor {
         ss::promise<model::offset> promise;
         ss::abort_source::subscription subscription;
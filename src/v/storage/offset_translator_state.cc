@@ -13,30 +13,207 @@
 
 #include "vassert.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace storage {
 
+offset_translator_state::gap offset_translator_state::at(size_t i) const {
+    if (i == 0) {
+        return *_head;
+    }
+    --i;
+    if (i < frozen_size()) {
+        const auto idx = _frozen_begin + i;
+        const auto& f = _frozen[idx];
+        const auto last_offset = _frozen_runs[frozen_run_of(idx)].base
+                                 + model::offset(f.last_offset);
+        return gap{
+          .last_offset = last_offset,
+          .base_offset = last_offset - model::offset(f.length - 1),
+          .next_delta = f.next_delta};
+    }
+    return _tail[i - frozen_size()];
+}
+
+size_t offset_translator_state::find(model::offset o, bool upper) const {
+    auto before = [o, upper](model::offset last_offset) {
+        return upper ? last_offset <= o : last_offset < o;
+    };
+    if (!_head || !before(_head->last_offset)) {
+        return 0;
+    }
+    size_t pos = 1;
+    if (frozen_size() > 0) {
+        for (auto r = frozen_run_of(_frozen_begin); r < _frozen_runs.size();
+             ++r) {
+            const auto& run = _frozen_runs[r];
+            auto begin = std::next(
+              _frozen.begin(), std::max(run.begin, _frozen_begin));
+            auto end = r + 1 < _frozen_runs.size()
+                         ? std::next(_frozen.begin(), _frozen_runs[r + 1].begin)
+                         : _frozen.end();
+            auto it = std::partition_point(
+              begin, end, [&run, &before](const frozen_gap& f) {
+                  return before(run.base + model::offset(f.last_offset));
+              });
+            pos += std::distance(begin, it);
+            if (it != end) {
+                return pos;
+            }
+        }
+    }
+    auto it = std::partition_point(
+      _tail.begin(), _tail.end(), [&before](const gap& g) {
+          return before(g.last_offset);
+      });
+    return pos + std::distance(_tail.begin(), it);
+}
+
+void offset_translator_state::push_back(gap g) {
+    if (!_head) {
+        _head = g;
+        return;
+    }
+    _tail.push_back(g);
+    maybe_freeze();
+}
+
+size_t offset_translator_state::frozen_run_of(size_t idx) const {
+    auto it = std::upper_bound(
+      _frozen_runs.begin(),
+      _frozen_runs.end(),
+      idx,
+      [](size_t i, const frozen_run& r) { return i < r.begin; });
+    return std::distance(_frozen_runs.begin(), it) - 1;
+}
+
+bool offset_translator_state::try_freeze(const gap& g) {
+    static constexpr int64_t max_packed = std::numeric_limits<uint32_t>::max();
+    const int64_t length = g.last_offset - g.base_offset + 1;
+    if (length < 1 || length > max_packed) {
+        return false;
+    }
+    if (frozen_size() == 0) {
+        _frozen = {};
+        _frozen_begin = 0;
+        _frozen_runs = {frozen_run{.begin = 0, .base = g.base_offset}};
+    }
+    int64_t last_offset = g.last_offset - _frozen_runs.back().base;
+    if (last_offset > max_packed) {
+        // too far from the base of the run, start a new one at the gap
+        _frozen_runs.push_back(
+          frozen_run{.begin = _frozen.size(), .base = g.base_offset});
+        last_offset = length - 1;
+    }
+    _frozen.push_back(frozen_gap{
+      .last_offset = static_cast<uint32_t>(last_offset),
+      .length = static_cast<uint32_t>(length),
+      .next_delta = g.next_delta});
+    return true;
+}
+
+void offset_translator_state::maybe_freeze() {
+    if (_tail.size() < max_tail_size) {
+        return;
+    }
+    auto it = _tail.begin();
+    while (it != _tail.end() && try_freeze(*it)) {
+        ++it;
+    }
+    // only a gap spanning more than 4 billion offsets by itself can't be
+    // packed, it and the gaps after it stay in the tail
+    _tail.erase(_tail.begin(), it);
+}
+
+void offset_translator_state::maybe_compact_frozen() {
+    if (_frozen_begin == 0 || _frozen_begin < _frozen.size() / 2) {
+        return;
+    }
+    // rebase the remaining frozen gaps on the first of them
+    auto frozen = std::exchange(_frozen, {});
+    const auto begin = std::exchange(_frozen_begin, 0);
+    const auto runs = std::exchange(_frozen_runs, {});
+    size_t r = 0;
+    for (size_t i = begin; i < frozen.size(); ++i) {
+        while (r + 1 < runs.size() && runs[r + 1].begin <= i) {
+            ++r;
+        }
+        const auto& f = frozen[i];
+        const auto last_offset = runs[r].base + model::offset(f.last_offset);
+        try_freeze(gap{
+          .last_offset = last_offset,
+          .base_offset = last_offset - model::offset(f.length - 1),
+          .next_delta = f.next_delta});
+    }
+}
+
+void offset_translator_state::erase_from(size_t pos) {
+    if (pos == 0) {
+        _head.reset();
+        _frozen = {};
+        _frozen_begin = 0;
+        _tail.clear();
+        return;
+    }
+    const size_t frozen_pos = pos - 1;
+    if (frozen_pos >= frozen_size()) {
+        _tail.resize(frozen_pos - frozen_size());
+        return;
+    }
+    _tail.clear();
+    while (frozen_size() > frozen_pos) {
+        _frozen.pop_back();
+    }
+    while (!_frozen_runs.empty()
+           && _frozen_runs.back().begin >= _frozen.size()) {
+        _frozen_runs.pop_back();
+    }
+}
+
+void offset_translator_state::erase_until(size_t pos) {
+    if (pos == 0) {
+        return;
+    }
+    // the head is always replaced by the caller
+    const size_t dropped = pos - 1;
+    if (dropped < frozen_size()) {
+        _frozen_begin += dropped;
+        maybe_compact_frozen();
+        return;
+    }
+    const size_t dropped_tail = dropped - frozen_size();
+    _frozen = {};
+    _frozen_begin = 0;
+    _tail.erase(_tail.begin(), std::next(_tail.begin(), dropped_tail));
+}
+
 int64_t offset_translator_state::delta(model::offset o) const {
-    if (_last_offset2batch.empty()) {
+    if (empty()) {
         return 0;
     }
 
-    auto it = _last_offset2batch.lower_bound(o);
-    if (it == _last_offset2batch.begin()) {
+    auto pos = lower_bound(o);
+    if (pos == 0) {
         throw std::runtime_error{fmt::format(
           "ntp {}: log offset {} is outside the translation range (starting at "
           "{})",
           _ntp,
           o,
-          model::next_offset(_last_offset2batch.begin()->first))};
+          model::next_offset(_head->last_offset))};
     }
 
-    auto delta = std::prev(it)->second.next_delta;
-    if (it == _last_offset2batch.end() || o < it->second.base_offset) {
+    auto delta = at(pos - 1).next_delta;
+    if (pos == size()) {
+        return delta;
+    }
+    auto g = at(pos);
+    if (o < g.base_offset) {
         return delta;
     } else {
         // The offset is inside the non-data batch, so the data offset stops
         // increasing at the base offset.
-        return delta + (o - it->second.base_offset);
+        return delta + (o - g.base_offset);
     }
 }
 
@@ -47,7 +224,7 @@ model::offset offset_translator_state::from_log_offset(model::offset o) const {
 
 model::offset offset_translator_state::to_log_offset(
   model::offset data_offset, model::offset hint) const {
-    if (_last_offset2batch.empty()) {
+    if (empty()) {
         return data_offset;
     }
 
@@ -55,12 +232,10 @@ model::offset offset_translator_state::to_log_offset(
         return data_offset;
     }
 
-    model::offset min_log_offset = model::next_offset(
-      _last_offset2batch.begin()->first);
+    model::offset min_log_offset = model::next_offset(_head->last_offset);
 
-    model::offset min_data_offset
-      = min_log_offset
-        - model::offset(_last_offset2batch.begin()->second.next_delta);
+    model::offset min_data_offset = min_log_offset
+                                    - model::offset(_head->next_delta);
     if (data_offset < min_data_offset) {
         throw std::runtime_error{fmt::format(
           "ntp {}: data offset {} is outside the translation range (starting "
@@ -78,74 +253,66 @@ model::offset offset_translator_state::to_log_offset(
     // log offset equal to `data_offset` (because log offset is at least as
     // big as data offset) and stopping when we find the interval where
     // given data offset is achievable.
-    auto interval_end_it = _last_offset2batch.lower_bound(search_start);
+    auto interval_end = lower_bound(search_start);
     vassert(
-      interval_end_it != _last_offset2batch.begin(),
+      interval_end != 0,
       "ntp {}: log offset search start too small: {}",
+      _ntp,
       search_start);
-    auto delta = std::prev(interval_end_it)->second.next_delta;
+    auto delta = at(interval_end - 1).next_delta;
 
-    while (interval_end_it != _last_offset2batch.end()) {
+    for (const auto end = size(); interval_end != end; ++interval_end) {
+        auto g = at(interval_end);
         model::offset max_do_this_interval
-          = model::prev_offset(interval_end_it->second.base_offset)
-            - model::offset{delta};
+          = model::prev_offset(g.base_offset) - model::offset{delta};
         if (max_do_this_interval >= data_offset) {
             break;
         }
 
-        delta = interval_end_it->second.next_delta;
-        ++interval_end_it;
+        delta = g.next_delta;
     }
 
     return data_offset + model::offset(delta);
 }
 
 int64_t offset_translator_state::last_delta() const {
-    vassert(
-      !_last_offset2batch.empty(),
-      "ntp {}: offsets map shouldn't be empty",
-      _ntp);
+    vassert(!empty(), "ntp {}: offsets map shouldn't be empty", _ntp);
 
-    return _last_offset2batch.rbegin()->second.next_delta;
+    return back().next_delta;
 }
 
 model::offset offset_translator_state::last_gap_offset() const {
-    vassert(
-      !_last_offset2batch.empty(),
-      "ntp {}: offsets map shouldn't be empty",
-      _ntp);
+    vassert(!empty(), "ntp {}: offsets map shouldn't be empty", _ntp);
 
-    return _last_offset2batch.rbegin()->first;
+    return back().last_offset;
 }
 
 void offset_translator_state::add_gap(
   model::offset base_offset, model::offset last_offset) {
-    vassert(
-      !_last_offset2batch.empty(),
-      "ntp {}: offsets map shouldn't be empty",
-      _ntp);
+    vassert(!empty(), "ntp {}: offsets map shouldn't be empty", _ntp);
 
-    auto rbegin = _last_offset2batch.rbegin();
+    auto last = back();
     vassert(
-      base_offset > rbegin->first,
+      base_offset > last.last_offset,
       "ntp {}: trying to add batch to offset translator at offset {} that "
       "is not higher than the previous last offset {}",
       _ntp,
       base_offset,
-      rbegin->first);
+      last.last_offset);
 
     int64_t length = last_offset() - base_offset() + 1;
-    int64_t next_delta = rbegin->second.next_delta + length;
-    _last_offset2batch.emplace(
-      last_offset,
-      batch_info{.base_offset = base_offset, .next_delta = next_delta});
+    int64_t next_delta = last.next_delta + length;
+    push_back(gap{
+      .last_offset = last_offset,
+      .base_offset = base_offset,
+      .next_delta = next_delta});
 }
 
 bool offset_translator_state::add_absolute_delta(
   model::offset offset, int64_t delta) {
     auto prev = model::prev_offset(offset);
 
-    if (_last_offset2batch.empty()) {
+    if (empty()) {
         vassert(
           delta <= offset(),
           "ntp {}: inconsistent add_absolute_delta: delta {} can't be > offset "
@@ -155,29 +322,29 @@ bool offset_translator_state::add_absolute_delta(
           offset);
 
         model::offset base_offset = offset - model::offset{delta};
-        _last_offset2batch.emplace(
-          prev, batch_info{.base_offset = base_offset, .next_delta = delta});
+        push_back(gap{
+          .last_offset = prev, .base_offset = base_offset, .next_delta = delta});
         return true;
     } else {
-        int64_t last_delta = _last_offset2batch.rbegin()->second.next_delta;
-        int64_t gap_length = delta - last_delta;
+        auto last = back();
+        int64_t gap_length = delta - last.next_delta;
 
         if (gap_length != 0) {
-            model::offset last_offset = _last_offset2batch.rbegin()->first;
             auto base_offset = offset - model::offset{gap_length};
             vassert(
-              base_offset > last_offset && base_offset < offset,
+              base_offset > last.last_offset && base_offset < offset,
               "ntp {}: inconsistent add_absolute_delta (offset {}, delta {}), "
               "but last_offset: {}, last_delta: {}",
               _ntp,
               offset,
               delta,
-              last_offset,
-              last_delta);
+              last.last_offset,
+              last.next_delta);
 
-            _last_offset2batch.emplace(
-              prev,
-              batch_info{.base_offset = base_offset, .next_delta = delta});
+            push_back(gap{
+              .last_offset = prev,
+              .base_offset = base_offset,
+              .next_delta = delta});
             return true;
         } else {
             return false;
@@ -186,33 +353,31 @@ bool offset_translator_state::add_absolute_delta(
 }
 
 bool offset_translator_state::truncate(model::offset offset) {
-    vassert(
-      !_last_offset2batch.empty(),
-      "ntp {}: offsets map shouldn't be empty",
-      _ntp);
+    vassert(!empty(), "ntp {}: offsets map shouldn't be empty", _ntp);
 
-    auto it = _last_offset2batch.lower_bound(offset);
-    if (it == _last_offset2batch.begin()) {
+    auto pos = lower_bound(offset);
+    if (pos == 0) {
         throw std::runtime_error{fmt::format(
           "ntp {}: trying to truncate offset_translator at offset {} which is "
           "<= base translation offset {}",
           _ntp,
           offset,
-          _last_offset2batch.begin()->first)};
+          _head->last_offset)};
     }
 
-    if (it != _last_offset2batch.end()) {
-        if (offset > it->second.base_offset) {
+    if (pos != size()) {
+        auto g = at(pos);
+        if (offset > g.base_offset) {
             throw std::runtime_error{fmt::format(
               "ntp {}: trying to truncate offset_translator at offset {} which "
               "is in the middle of the batch [{},{}]",
               _ntp,
               offset,
-              it->second.base_offset,
-              it->first)};
+              g.base_offset,
+              g.last_offset)};
         }
 
-        _last_offset2batch.erase(it, _last_offset2batch.end());
+        erase_from(pos);
         return true;
     }
 
@@ -220,38 +385,37 @@ bool offset_translator_state::truncate(model::offset offset) {
 }
 
 bool offset_translator_state::prefix_truncate(model::offset offset) {
-    vassert(
-      !_last_offset2batch.empty(),
-      "ntp {}: offsets map shouldn't be empty",
-      _ntp);
+    vassert(!empty(), "ntp {}: offsets map shouldn't be empty", _ntp);
 
-    auto it = _last_offset2batch.upper_bound(offset);
-    if (it != _last_offset2batch.end() && offset >= it->second.base_offset) {
-        throw std::runtime_error{fmt::format(
-          "ntp {}: trying to prefix truncate offset translator at offset {} "
-          "which is in the middle of the batch {}-{}",
-          _ntp,
-          offset,
-          it->second.base_offset,
-          it->first)};
+    auto pos = upper_bound(offset);
+    if (pos != size()) {
+        auto g = at(pos);
+        if (offset >= g.base_offset) {
+            throw std::runtime_error{fmt::format(
+              "ntp {}: trying to prefix truncate offset translator at offset "
+              "{} which is in the middle of the batch {}-{}",
+              _ntp,
+              offset,
+              g.base_offset,
+              g.last_offset)};
+        }
     }
 
-    if (it == _last_offset2batch.begin()) {
+    if (pos == 0) {
         return false;
     }
 
-    auto prev_it = std::prev(it);
-    if (prev_it == _last_offset2batch.begin() && prev_it->first == offset) {
+    if (pos == 1 && _head->last_offset == offset) {
         return false;
     }
 
-    auto base_batch = prev_it->second;
-    base_batch.base_offset = offset;
-    _last_offset2batch.erase(_last_offset2batch.begin(), it);
-    _last_offset2batch.emplace(offset, base_batch);
+    auto base_gap = at(pos - 1);
+    base_gap.base_offset = offset;
+    base_gap.last_offset = offset;
+    erase_until(pos);
+    _head = base_gap;
     return true;
 }
-
 namespace {
 
 struct persisted_batch {
@@ -276,27 +440,25 @@ struct persisted_batches_map
       serde::version<0>,
       serde::compat_version<0>> {
     int64_t start_delta = 0;
-    std::vector<persisted_batch> batches;
+    // same encoding as a vector, without its contiguous allocation
+    fragmented_vector<persisted_batch> batches;
 };
 
 } // namespace
 
 iobuf offset_translator_state::serialize_map() const {
-    vassert(
-      !_last_offset2batch.empty(),
-      "ntp {}: offsets map shouldn't be empty",
-      _ntp);
-
-    std::vector<persisted_batch> batches;
-    batches.reserve(_last_offset2batch.size());
-    for (const auto& [o, b] : _last_offset2batch) {
-        int32_t length = int32_t(o - b.base_offset) + 1;
+    vassert(!empty(), "ntp {}: offsets map shouldn't be empty", _ntp);
+
+    fragmented_vector<persisted_batch> batches;
+    for (size_t i = 0, end = size(); i < end; ++i) {
+        auto g = at(i);
+        int32_t length = int32_t(g.last_offset - g.base_offset) + 1;
         batches.push_back(
-          persisted_batch{.base_offset = b.base_offset, .length = length});
+          persisted_batch{.base_offset = g.base_offset, .length = length});
     }
 
     persisted_batches_map persisted{
-      .start_delta = _last_offset2batch.begin()->second.next_delta,
+      .start_delta = _head->next_delta,
       .batches = std::move(batches),
     };
 
@@ -311,7 +473,8 @@ offset_translator_state::from_serialized_map(model::ntp ntp, iobuf buf) {
           "ntp {}: persisted offset translator map shouldn't be empty", ntp)};
     }
 
-    absl::btree_map<model::offset, batch_info> last_offset2batch;
+    // the batches are sorted, they are appended and frozen in a single pass
+    offset_translator_state state(std::move(ntp));
     int64_t cur_delta = persisted.start_delta;
     model::offset prev_last_offset;
     for (auto it = persisted.batches.begin(); it != persisted.batches.end();
@@ -322,7 +485,7 @@ offset_translator_state::from_serialized_map(model::ntp ntp, iobuf buf) {
                 throw std::runtime_error{fmt::format(
                   "ntp {}: inconsistency in serialized offset translator "
                   "state: offset {} is after {}",
-                  ntp,
+                  state._ntp,
                   b.base_offset,
                   prev_last_offset)};
             }
@@ -330,14 +493,13 @@ offset_translator_state::from_serialized_map(model::ntp ntp, iobuf buf) {
         }
 
         model::offset last_offset = b.base_offset + model::offset{b.length - 1};
-        last_offset2batch.emplace(
-          last_offset,
-          batch_info{.base_offset = b.base_offset, .next_delta = cur_delta});
+        state.push_back(gap{
+          .last_offset = last_offset,
+          .base_offset = b.base_offset,
+          .next_delta = cur_delta});
         prev_last_offset = last_offset;
     }
 
-    offset_translator_state state(std::move(ntp));
-    state._last_offset2batch = std::move(last_offset2batch);
     return state;
 }
 
@@ -345,23 +507,21 @@ offset_translator_state offset_translator_state::from_bootstrap_state(
   model::ntp ntp, const absl::btree_map<model::offset, int64_t>& offset2delta) {
     offset_translator_state state(std::move(ntp));
     for (const auto& [o, d] : offset2delta) {
-        state._last_offset2batch.emplace(
-          o, batch_info{.base_offset = o, .next_delta = d});
+        state.push_back(gap{.last_offset = o, .base_offset = o, .next_delta = d});
     }
     return state;
 }
 
 std::ostream&
 operator<<(std::ostream& os, const offset_translator_state& state) {
-    const auto& map = state._last_offset2batch;
-
-    if (map.empty()) {
+    if (state.empty()) {
         return os << "{empty}";
     }
 
-    return os << "{base offset/delta: " << map.begin()->first << "/"
-              << map.begin()->second.next_delta << ", map size: " << map.size()
-              << ", last delta: " << map.rbegin()->second.next_delta << "}";
+    return os << "{base offset/delta: " << state._head->last_offset << "/"
+              << state._head->next_delta << ", map size: " << state.size()
+              << ", frozen: " << state.frozen_size()
+              << ", last delta: " << state.back().next_delta << "}";
 }
 
 } // namespace storage
@@ -13,9 +13,13 @@
 
 #include "model/fundamental.h"
 #include "serde/serde.h"
+#include "utils/fragmented_vector.h"
 
 #include <absl/container/btree_map.h>
 
+#include <optional>
+#include <vector>
+
 namespace storage {
 
 /// Provides offset translation between raw log offsets and offsets not counting
@@ -25,9 +29,15 @@ namespace storage {
 /// for these batches to occupy offset space (see
 /// https://github.com/redpanda-data/redpanda/issues/1184 for details).
 ///
-/// It works by maintaining an in-memory map of all filtered batch offsets.
-/// This map allows us to quickly find a delta between the raw log offset and
-/// corresponding translated offset.
+/// It works by maintaining an in-memory sorted sequence of all filtered batch
+/// offsets. This sequence allows us to quickly find a delta between the raw log
+/// offset and corresponding translated offset.
+///
+/// Transactional topics accumulate millions of control batches per partition,
+/// so the older part of the sequence is frozen into a packed array, and only the
+/// recently added batches are kept unpacked. The packed offsets are relative to
+/// the base of their run, a new run starts whenever an offset is too far from
+/// the base of the current one. Lookups binary search both parts.
 class offset_translator_state {
 public:
     /// Create an empty translator - the delta between log and kafka offsets is
@@ -40,9 +50,10 @@ public:
     offset_translator_state(
       model::ntp ntp, model::offset base_offset, int64_t base_delta)
       : _ntp(std::move(ntp)) {
-        _last_offset2batch.emplace(
-          base_offset,
-          batch_info{.base_offset = base_offset, .next_delta = base_delta});
+        _head = gap{
+          .last_offset = base_offset,
+          .base_offset = base_offset,
+          .next_delta = base_delta};
     }
 
     offset_translator_state(const offset_translator_state&) = delete;
@@ -52,7 +63,12 @@ public:
 
     const model::ntp& ntp() const { return _ntp; }
 
-    bool empty() const { return _last_offset2batch.empty(); }
+    bool empty() const { return !_head.has_value(); }
+
+    /// Number of filtered batches tracked, including the base one
+    size_t size() const {
+        return (_head ? 1 : 0) + frozen_size() + _tail.size();
+    }
 
     /// Difference between the log offset and the kafka offset.
     int64_t delta(model::offset) const;
@@ -98,22 +114,65 @@ public:
     operator<<(std::ostream&, const offset_translator_state&);
 
 private:
-    struct batch_info {
+    /// Batches beyond this many unpacked ones are frozen
+    static constexpr size_t max_tail_size = 256;
+
+    // A non-data batch. next_delta is active in the log offset interval
+    // (last offset; next last offset] (left end exclusive, right end
+    // inclusive). As prefix truncations happen, we maintain an invariant that
+    // the first gap has the last offset prev_offset(start of the log) - this
+    // way we can calculate delta for any offset in the log.
+    struct gap {
+        model::offset last_offset;
         model::offset base_offset;
         int64_t next_delta;
     };
 
-    // Map from the last offset of non-data batches to the corresponding batch
-    // info. next_delta in the batch info is active in the log offset interval
-    // (last offset; next last offset] (left end exclusive, right end
-    // inclusive). As prefix truncations happen, we maintain an invariant that
-    // there is always an element of the map with the key prev_offset(start of
-    // the log) - this way we can calculate delta for any offset in the log.
-    using batches_map_t = absl::btree_map<model::offset, batch_info>;
+    // A gap of the frozen part, the last offset is relative to the base of
+    // its run.
+    struct frozen_gap {
+        uint32_t last_offset;
+        uint32_t length;
+        int64_t next_delta;
+    };
+
+    // The gaps of _frozen from `begin` up to the next run are relative to
+    // `base`.
+    struct frozen_run {
+        size_t begin;
+        model::offset base;
+    };
+
+    // Gaps are addressed by their position in the sequence of the head, the
+    // frozen gaps and the tail gaps.
+    size_t frozen_size() const { return _frozen.size() - _frozen_begin; }
+    /// index of the run of the frozen gap at the index of _frozen
+    size_t frozen_run_of(size_t) const;
+    gap at(size_t) const;
+    gap back() const { return at(size() - 1); }
+    /// first position of a gap with a last offset >= (or > when `upper`) the
+    /// offset
+    size_t find(model::offset, bool upper) const;
+    size_t lower_bound(model::offset o) const { return find(o, false); }
+    size_t upper_bound(model::offset o) const { return find(o, true); }
+
+    void push_back(gap);
+    /// removes the gaps at and after the position
+    void erase_from(size_t);
+    /// removes the gaps before the position
+    void erase_until(size_t);
+    bool try_freeze(const gap&);
+    void maybe_freeze();
+    void maybe_compact_frozen();
 
-private:
     model::ntp _ntp;
-    batches_map_t _last_offset2batch;
+    std::optional<gap> _head;
+    fragmented_vector<frozen_gap> _frozen;
+    // gaps of _frozen before this position were prefix truncated
+    size_t _frozen_begin{0};
+    std::vector<frozen_run> _frozen_runs;
+    // recently added gaps, sorted by last offset
+    std::vector<gap> _tail;
 };
 
 } // namespace storage
@@ -79,12 +79,16 @@ static model::record_batch_header header_from_iobuf(iobuf b) {
     return hdr;
 }
 
+/// Reads slice the segment read buffers instead of copying them, a batch read
+/// from disk shares the dma buffer it was read into all the way to the socket.
+/// The batch cache copies batches into its own memory so the read buffers
+/// aren't pinned by cached batches.
 static ss::future<result<iobuf>> verify_read_iobuf(
   ss::input_stream<char>& in,
   size_t expected,
   ss::sstring msg,
   bool recover = false) {
-    return read_iobuf_exactly(in, expected)
+    return read_iobuf_exactly_shared(in, expected)
       .then([msg = std::move(msg), expected, recover](iobuf b) {
           if (likely(b.size_bytes() == expected)) {
               return ss::make_ready_future<result<iobuf>>(std::move(b));
@@ -157,7 +161,7 @@ static ss::future<result<model::record_batch_header>> read_header_impl(
   ss::input_stream<char>& input,
   const Consumer& consumer,
   bool recovery = false) {
-    auto b = co_await read_iobuf_exactly(
+    auto b = co_await read_iobuf_exactly_shared(
       input, model::packed_record_batch_header_size);
 
     if (b.empty()) {
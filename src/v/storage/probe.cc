@@ -11,12 +11,15 @@
 
 #include "config/configuration.h"
 #include "prometheus/prometheus_sanitize.h"
+#include "storage/batch_cache.h"
 #include "storage/readers_cache_probe.h"
 #include "storage/segment.h"
+#include "storage/segment_set.h"
 
 #include <seastar/core/metrics.hh>
 
 #include <type_traits>
+#include <utility>
 
 namespace storage {
 
@@ -59,6 +62,214 @@ void node_probe::setup_node_metrics() {
       });
 }
 
+void batch_cache_probe::setup_metrics(const batch_cache& cache) {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+
+    namespace sm = ss::metrics;
+    auto aggregate_labels = config::shard_local_cfg().aggregate_metrics()
+                              ? std::vector<sm::label>{sm::shard_label}
+                              : std::vector<sm::label>{};
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:batch_cache"),
+      {
+        sm::make_counter(
+          "hits",
+          [this] { return _hits; },
+          sm::description("Number of batch cache lookups that were hits"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "misses",
+          [this] { return _misses; },
+          sm::description("Number of batch cache lookups that were misses"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "admissions",
+          [this] { return _admissions; },
+          sm::description("Number of batches admitted to the batch cache"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "historical_admissions",
+          [this] { return _historical_admissions; },
+          sm::description("Number of batches from historical reads admitted "
+                          "at the head of the probationary segment"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "promotions",
+          [this] { return _promotions; },
+          sm::description(
+            "Number of ranges promoted to the protected segment"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "demotions",
+          [this] { return _demotions; },
+          sm::description(
+            "Number of ranges demoted to the probationary segment"))
+          .aggregate(aggregate_labels),
+        sm::make_total_bytes(
+          "reclaimed_bytes",
+          [this] { return _reclaimed_bytes; },
+          sm::description("Number of bytes reclaimed from the batch cache"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "size_bytes",
+          [&cache] { return cache.size_bytes(); },
+          sm::description("Estimated size of the batch cache"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "protected_size_bytes",
+          [&cache] { return cache.protected_size_bytes(); },
+          sm::description(
+            "Estimated size of the batch cache protected segment"))
+          .aggregate(aggregate_labels),
+      });
+}
+
+void log_recovery_probe::log_recovered(
+  recovery_priority priority,
+  duration wait,
+  duration total,
+  const segment_recovery_stats& stats) {
+    ++_logs_recovered;
+    if (priority == recovery_priority::high) {
+        ++_high_priority_logs_recovered;
+    }
+    _segments_opened += stats.segments_opened;
+    _segments_replayed += stats.segments_replayed;
+    _segments_skipped_clean += stats.segments_skipped_clean;
+    _wait_time += wait;
+    _total_time += total;
+    _open_time += stats.open_time;
+    _index_time += stats.index_time;
+    _replay_time += stats.replay_time;
+}
+
+void log_recovery_probe::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+
+    namespace sm = ss::metrics;
+    auto aggregate_labels = config::shard_local_cfg().aggregate_metrics()
+                              ? std::vector<sm::label>{sm::shard_label}
+                              : std::vector<sm::label>{};
+    auto to_ms = [](duration d) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d)
+          .count();
+    };
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:log_recovery"),
+      {
+        sm::make_counter(
+          "logs",
+          [this] { return _logs_recovered; },
+          sm::description("Number of logs recovered"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "high_priority_logs",
+          [this] { return _high_priority_logs_recovered; },
+          sm::description("Number of logs recovered with high priority"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "segments_opened",
+          [this] { return _segments_opened; },
+          sm::description("Number of segments opened by log recovery"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "segments_replayed",
+          [this] { return _segments_replayed; },
+          sm::description("Number of segments replayed to rebuild their "
+                          "index or find their end"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "segments_skipped_clean",
+          [this] { return _segments_skipped_clean; },
+          sm::description(
+            "Number of segments not replayed as they were closed cleanly"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "wait_time_ms",
+          [this, to_ms] { return to_ms(_wait_time); },
+          sm::description(
+            "Total time logs waited to be admitted for recovery"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "recovery_time_ms",
+          [this, to_ms] { return to_ms(_total_time); },
+          sm::description("Total time spent recovering logs"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "open_time_ms",
+          [this, to_ms] { return to_ms(_open_time); },
+          sm::description("Total time spent opening segments of logs"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "index_time_ms",
+          [this, to_ms] { return to_ms(_index_time); },
+          sm::description("Total time spent loading indexes of segments"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "replay_time_ms",
+          [this, to_ms] { return to_ms(_replay_time); },
+          sm::description("Total time spent replaying segments"))
+          .aggregate(aggregate_labels),
+      });
+}
+
+void housekeeping_probe::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+
+    namespace sm = ss::metrics;
+    auto aggregate_labels = config::shard_local_cfg().aggregate_metrics()
+                              ? std::vector<sm::label>{sm::shard_label}
+                              : std::vector<sm::label>{};
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:housekeeping"),
+      {
+        sm::make_counter(
+          "rounds",
+          [this] { return _rounds; },
+          sm::description("Number of housekeeping rounds"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "compactions",
+          [this] { return _compactions; },
+          sm::description("Number of logs compacted by housekeeping"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "compaction_errors",
+          [this] { return _compaction_errors; },
+          sm::description("Number of log compactions which failed"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "queue_depth",
+          [this] { return _queue_depth; },
+          sm::description(
+            "Number of logs waiting to be compacted in the current round"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "running_compactions",
+          [this] { return _running; },
+          sm::description("Number of logs being compacted"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "max_score",
+          [this] { return _max_score; },
+          sm::description(
+            "Highest housekeeping priority of a log in the last round"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "mean_score",
+          [this] { return _mean_score; },
+          sm::description(
+            "Mean housekeeping priority of the logs in the last round"))
+          .aggregate(aggregate_labels),
+      });
+}
+
 void probe::setup_metrics(const model::ntp& ntp) {
     if (config::shard_local_cfg().disable_metrics()) {
         return;
@@ -116,6 +327,20 @@ void probe::setup_metrics(const model::ntp& ntp) {
          sm::description("Total number of cached batches read"),
          labels)
          .aggregate(aggregate_labels),
+       sm::make_counter(
+         "tail_stream_reads",
+         [this] { return _tail_stream_reads; },
+         sm::description(
+           "Number of reads served by the batches shared from the tail of "
+           "the log"),
+         labels)
+         .aggregate(aggregate_labels),
+       sm::make_counter(
+         "tail_stream_batches_read",
+         [this] { return _tail_stream_batches_read; },
+         sm::description("Number of batches shared from the tail of the log"),
+         labels)
+         .aggregate(aggregate_labels),
        sm::make_counter(
          "log_segments_created",
          [this] { return _log_segments_created; },
@@ -161,7 +386,7 @@ void probe::setup_metrics(const model::ntp& ntp) {
          .aggregate(aggregate_labels),
        sm::make_gauge(
          "partition_size",
-         [this] { return _partition_bytes; },
+         [this] { return _disk_usage.data; },
          sm::description("Current size of partition in bytes"),
          labels)
          .aggregate(aggregate_labels),
@@ -174,10 +399,57 @@ void probe::setup_metrics(const model::ntp& ntp) {
 }
 
 void probe::add_initial_segment(const segment& s) {
-    _partition_bytes += s.file_size();
+    add_disk_usage({.data = s.file_size()});
 }
 void probe::delete_segment(const segment& s) {
-    _partition_bytes -= s.file_size();
+    remove_disk_usage({.data = s.file_size()});
+}
+
+void probe::set_segment_artifacts(
+  segment& s, uint64_t index, uint64_t compaction) {
+    remove_disk_usage(s.accounted_artifacts());
+    s.accounted_artifacts() = {.index = index, .compaction = compaction};
+    add_disk_usage(s.accounted_artifacts());
+}
+
+void probe::remove_segment_artifacts(segment& s) {
+    remove_disk_usage(std::exchange(s.accounted_artifacts(), {}));
+}
+
+void probe::set_disk_usage_tracker(
+  disk_usage_tracker* tracker, model::topic_namespace tn) {
+    clear_disk_usage_tracker();
+    _disk_usage_tracker = tracker;
+    _tn = std::move(tn);
+    if (_disk_usage_tracker) {
+        _disk_usage_tracker->add(*_tn, _disk_usage);
+    }
+}
+
+void probe::clear_disk_usage_tracker() {
+    if (_disk_usage_tracker) {
+        _disk_usage_tracker->subtract(*_tn, _disk_usage);
+    }
+    _disk_usage_tracker = nullptr;
+}
+
+void probe::add_disk_usage(const disk_usage& u) {
+    _disk_usage += u;
+    if (_disk_usage_tracker) {
+        _disk_usage_tracker->add(*_tn, u);
+    }
+}
+
+void probe::remove_disk_usage(const disk_usage& u) {
+    // never take out more than was accounted
+    disk_usage removed{
+      .data = std::min(_disk_usage.data, u.data),
+      .index = std::min(_disk_usage.index, u.index),
+      .compaction = std::min(_disk_usage.compaction, u.compaction)};
+    _disk_usage -= removed;
+    if (_disk_usage_tracker) {
+        _disk_usage_tracker->subtract(*_tn, removed);
+    }
 }
 
 void readers_cache_probe::setup_metrics(const model::ntp& ntp) {
@@ -12,13 +12,16 @@
 #pragma once
 #include "model/fundamental.h"
 #include "ssx/metrics.h"
+#include "storage/disk_usage.h"
 #include "storage/fwd.h"
 #include "storage/logger.h"
+#include "storage/recovery_admission.h"
 #include "storage/types.h"
 
 #include <seastar/core/metrics_registration.hh>
 #include <seastar/core/shared_ptr.hh>
 
+#include <chrono>
 #include <cstdint>
 
 namespace storage {
@@ -43,11 +46,105 @@ private:
       ssx::metrics::public_metrics_handle};
 };
 
+// Per-shard batch cache probe.
+class batch_cache_probe {
+public:
+    void hit() { ++_hits; }
+    void miss() { ++_misses; }
+    void admission() { ++_admissions; }
+    void historical_admission() {
+        ++_admissions;
+        ++_historical_admissions;
+    }
+    void promotion() { ++_promotions; }
+    void demotion() { ++_demotions; }
+    void add_reclaimed_bytes(uint64_t bytes) { _reclaimed_bytes += bytes; }
+
+    void setup_metrics(const batch_cache&);
+
+private:
+    uint64_t _hits = 0;
+    uint64_t _misses = 0;
+    uint64_t _admissions = 0;
+    uint64_t _historical_admissions = 0;
+    uint64_t _promotions = 0;
+    uint64_t _demotions = 0;
+    uint64_t _reclaimed_bytes = 0;
+    ss::metrics::metric_groups _metrics;
+};
+
+struct segment_recovery_stats;
+
+// Per-shard probe of the recovery of logs on startup.
+class log_recovery_probe {
+public:
+    using duration = std::chrono::steady_clock::duration;
+
+    /// \brief accounts for a recovered log, `wait` is the time it waited to
+    /// be admitted and `total` the time spent recovering it after that
+    void log_recovered(
+      recovery_priority,
+      duration wait,
+      duration total,
+      const segment_recovery_stats&);
+
+    void setup_metrics();
+
+private:
+    uint64_t _logs_recovered = 0;
+    uint64_t _high_priority_logs_recovered = 0;
+    uint64_t _segments_opened = 0;
+    uint64_t _segments_replayed = 0;
+    uint64_t _segments_skipped_clean = 0;
+    duration _wait_time{0};
+    duration _total_time{0};
+    duration _open_time{0};
+    duration _index_time{0};
+    duration _replay_time{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+// Per-shard probe of the housekeeping scheduler of the log_manager
+class housekeeping_probe {
+public:
+    /// \brief a housekeeping round scored `logs` logs
+    void round_started(size_t logs, double max_score, double total_score) {
+        ++_rounds;
+        _queue_depth = logs;
+        _max_score = max_score;
+        _mean_score = logs == 0 ? 0 : total_score / static_cast<double>(logs);
+    }
+    void compaction_started() {
+        --_queue_depth;
+        ++_running;
+    }
+    void round_finished() { _queue_depth = 0; }
+    void compaction_finished(bool failed) {
+        --_running;
+        ++_compactions;
+        if (failed) {
+            ++_compaction_errors;
+        }
+    }
+
+    void setup_metrics();
+
+private:
+    uint64_t _rounds = 0;
+    uint64_t _compactions = 0;
+    uint64_t _compaction_errors = 0;
+    size_t _queue_depth = 0;
+    size_t _running = 0;
+    double _max_score = 0;
+    double _mean_score = 0;
+    ss::metrics::metric_groups _metrics;
+};
+
 // Per-NTP probe.
 class probe {
 public:
     void add_bytes_written(uint64_t written) {
-        _partition_bytes += written;
+        add_disk_usage({.data = written});
         _bytes_written += written;
     }
 
@@ -82,19 +179,46 @@ public:
         _cached_batches_read += batches;
     }
 
+    void tail_stream_read(size_t batches) {
+        ++_tail_stream_reads;
+        _tail_stream_batches_read += batches;
+    }
+
     void batch_parse_error() { ++_batch_parse_errors; }
 
     void setup_metrics(const model::ntp&);
 
     void delete_segment(const segment&);
 
-    size_t partition_size() const { return _partition_bytes; }
+    size_t partition_size() const { return _disk_usage.data; }
+    uint64_t tail_stream_reads() const { return _tail_stream_reads; }
     void add_initial_segment(const segment&);
-    void remove_partition_bytes(size_t remove) { _partition_bytes -= remove; }
+    void remove_partition_bytes(size_t remove) {
+        remove_disk_usage({.data = remove});
+    }
+
+    /// \brief the index and compaction index files of the segment now take
+    /// `index` and `compaction` bytes
+    void
+    set_segment_artifacts(segment&, uint64_t index, uint64_t compaction);
+    /// \brief the index files of the segment were removed with it
+    void remove_segment_artifacts(segment&);
+
+    /// \brief accounts the disk usage of the log in the shard and topic
+    /// totals of `tracker` from now on
+    void set_disk_usage_tracker(disk_usage_tracker*, model::topic_namespace);
+    /// \brief the log is closed, its usage no longer counts for the shard
+    void clear_disk_usage_tracker();
+    const disk_usage& get_disk_usage() const { return _disk_usage; }
     void set_compaction_ratio(double r) { _compaction_ratio = r; }
 
 private:
-    uint64_t _partition_bytes = 0;
+    void add_disk_usage(const disk_usage&);
+    void remove_disk_usage(const disk_usage&);
+
+    disk_usage _disk_usage;
+    disk_usage_tracker* _disk_usage_tracker{nullptr};
+    std::optional<model::topic_namespace> _tn;
     uint64_t _bytes_written = 0;
     uint64_t _bytes_read = 0;
     uint64_t _cached_bytes_read = 0;
@@ -102,6 +226,8 @@ private:
     uint64_t _batches_written = 0;
     uint64_t _batches_read = 0;
     uint64_t _cached_batches_read = 0;
+    uint64_t _tail_stream_reads = 0;
+    uint64_t _tail_stream_batches_read = 0;
 
     uint32_t _segment_compacted = 0;
     uint32_t _corrupted_compaction_index = 0;
@@ -0,0 +1,183 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/reader_handle_cache.h"
+
+#include "config/configuration.h"
+#include "prometheus/prometheus_sanitize.h"
+#include "ssx/future-util.h"
+#include "storage/logger.h"
+#include "vassert.h"
+#include "vlog.h"
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/metrics.hh>
+
+namespace storage {
+
+reader_handle_cache::reader_handle_cache(config::binding<size_t> fd_budget)
+  : _budget(std::move(fd_budget)) {
+    _budget.watch([this] { maybe_evict(); });
+}
+
+reader_handle_cache::~reader_handle_cache() noexcept {
+    // readers outliving the cache must not call back into it, those in use
+    // close their file by themselves once their last handle is gone
+    for (auto* readers : {&_idle, &_in_use}) {
+        for (auto& r : *readers) {
+            r._handle_cache = nullptr;
+        }
+        readers->clear();
+    }
+}
+
+void reader_handle_cache::acquire(segment_reader& r) {
+    if (r._cache_hook.is_linked()) {
+        r._cache_hook.unlink();
+    }
+    _in_use.push_back(r);
+    ++_in_use_count;
+    // make room for a descriptor which was just opened
+    maybe_evict();
+}
+
+void reader_handle_cache::release(segment_reader& r) {
+    vassert(
+      _in_use_count > 0 && r._cache_hook.is_linked(),
+      "released an unused reader {}",
+      r.path());
+    r._cache_hook.unlink();
+    --_in_use_count;
+    park(r);
+}
+
+void reader_handle_cache::prewarmed(segment_reader& r) {
+    ++_prewarms;
+    park(r);
+}
+
+void reader_handle_cache::forget(segment_reader& r) {
+    if (!r._cache_hook.is_linked()) {
+        return;
+    }
+    r._cache_hook.unlink();
+    if (r._data_file_refcount > 0) {
+        --_in_use_count;
+    }
+}
+
+void reader_handle_cache::discard(segment_reader& r) {
+    forget(r);
+    close_in_background(std::exchange(r._data_file, ss::file{}));
+}
+
+void reader_handle_cache::park(segment_reader& r) {
+    if (is_stopped()) {
+        close_in_background(std::exchange(r._data_file, ss::file{}));
+        return;
+    }
+    _idle.push_back(r);
+    maybe_evict();
+}
+
+void reader_handle_cache::maybe_evict() {
+    while (open_fds() > _budget() && !_idle.empty()) {
+        auto& r = _idle.front();
+        _idle.pop_front();
+        vlog(stlog.debug, "Closing idle segment file {}", r.path());
+        ++_evictions;
+        close_in_background(std::exchange(r._data_file, ss::file{}));
+    }
+}
+
+void reader_handle_cache::close_in_background(ss::file f) {
+    if (!f) {
+        return;
+    }
+    if (_gate.is_closed()) {
+        ssx::background = f.close();
+        return;
+    }
+    ssx::spawn_with_gate(_gate, [f]() mutable {
+        return f.close().handle_exception([](const std::exception_ptr& e) {
+            vlog(stlog.warn, "Error closing idle segment file: {}", e);
+        });
+    });
+}
+
+ss::future<> reader_handle_cache::stop() {
+    while (!_idle.empty()) {
+        auto& r = _idle.front();
+        _idle.pop_front();
+        close_in_background(std::exchange(r._data_file, ss::file{}));
+    }
+    co_await _gate.close();
+}
+
+void reader_handle_cache::setup_metrics() {
+    if (config::shard_local_cfg().disable_metrics()) {
+        return;
+    }
+    _metrics.clear();
+
+    namespace sm = ss::metrics;
+    auto aggregate_labels = config::shard_local_cfg().aggregate_metrics()
+                              ? std::vector<sm::label>{sm::shard_label}
+                              : std::vector<sm::label>{};
+    _metrics.add_group(
+      prometheus_sanitize::metrics_name("storage:reader_handles"),
+      {
+        sm::make_counter(
+          "hits",
+          [this] { return _hits; },
+          sm::description(
+            "Number of segment reads which found the file already open"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "misses",
+          [this] { return _misses; },
+          sm::description("Number of segment reads which had to open the file"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "hit_ratio",
+          [this] {
+              auto lookups = _hits + _misses;
+              return lookups == 0 ? 0.0
+                                  : static_cast<double>(_hits)
+                                      / static_cast<double>(lookups);
+          },
+          sm::description("Ratio of segment reads which found the file open"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "evictions",
+          [this] { return _evictions; },
+          sm::description("Number of idle segment files closed to stay within "
+                          "the file descriptor budget"))
+          .aggregate(aggregate_labels),
+        sm::make_counter(
+          "prewarms",
+          [this] { return _prewarms; },
+          sm::description(
+            "Number of segment files opened ahead of sequential reads"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "open_fds",
+          [this] { return open_fds(); },
+          sm::description("Number of segment files open for reading"))
+          .aggregate(aggregate_labels),
+        sm::make_gauge(
+          "idle_fds",
+          [this] { return idle_fds(); },
+          sm::description(
+            "Number of segment files kept open without active readers"))
+          .aggregate(aggregate_labels),
+      });
+}
+
+} // namespace storage
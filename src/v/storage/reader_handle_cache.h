@@ -0,0 +1,107 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/property.h"
+#include "seastarx.h"
+#include "storage/segment_reader.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <seastar/core/file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/metrics_registration.hh>
+
+#include <cstdint>
+
+namespace storage {
+
+/**
+ * Keeps the read file descriptors of the segments on a shard open once their
+ * last reader is gone, so that the next read of the segment does not have to
+ * open the file again.
+ *
+ * Idle descriptors are kept in LRU order. Whenever the number of descriptors
+ * open for reading (in use and idle) exceeds the budget the least recently
+ * used idle descriptors are closed. Descriptors in use are never closed and
+ * reads don't wait for one to be released: a log reader holds the descriptor
+ * of a segment while opening the next one, and compaction holds several, so
+ * waiting could deadlock once the budget is smaller than what a single
+ * operation holds. The budget may therefore be overshot while more segments
+ * than the budget are being read concurrently, only speculative opens ahead
+ * of a read are skipped then.
+ */
+class reader_handle_cache {
+public:
+    explicit reader_handle_cache(config::binding<size_t> fd_budget);
+    reader_handle_cache(const reader_handle_cache&) = delete;
+    reader_handle_cache& operator=(const reader_handle_cache&) = delete;
+    ~reader_handle_cache() noexcept;
+
+    /// \brief records whether a reader found its file already open
+    void record_lookup(bool hit) { hit ? ++_hits : ++_misses; }
+
+    /// \brief the reader got its first handle, its descriptor is in use
+    void acquire(segment_reader&);
+
+    /// \brief the last handle of the reader is gone, keeps its descriptor
+    /// as the most recently used idle one
+    void release(segment_reader&);
+
+    /// \brief whether a descriptor may be opened ahead of a read without
+    /// going over the budget
+    bool can_prewarm() const {
+        return open_fds() < _budget() || !_idle.empty();
+    }
+
+    /// \brief the reader opened its descriptor ahead of a read
+    void prewarmed(segment_reader&);
+
+    /// \brief the reader closes its descriptor by itself
+    void forget(segment_reader&);
+
+    /// \brief closes the idle descriptor of a reader going away
+    void discard(segment_reader&);
+
+    /// \brief closes idle descriptors and waits for pending closes
+    ss::future<> stop();
+
+    bool is_stopped() const { return _gate.is_closed(); }
+
+    void setup_metrics();
+
+    size_t open_fds() const { return _in_use_count + _idle.size(); }
+    size_t idle_fds() const { return _idle.size(); }
+    uint64_t hits() const { return _hits; }
+    uint64_t misses() const { return _misses; }
+    uint64_t evictions() const { return _evictions; }
+
+private:
+    void park(segment_reader&);
+    void maybe_evict();
+    void close_in_background(ss::file);
+
+    config::binding<size_t> _budget;
+    intrusive_list<segment_reader, &segment_reader::_cache_hook> _idle;
+    // readers with handles, their pointer to the cache is cleared when it
+    // goes away before them
+    intrusive_list<segment_reader, &segment_reader::_cache_hook> _in_use;
+    size_t _in_use_count{0};
+    ss::gate _gate;
+
+    uint64_t _hits{0};
+    uint64_t _misses{0};
+    uint64_t _evictions{0};
+    uint64_t _prewarms{0};
+    ss::metrics::metric_groups _metrics;
+};
+
+} // namespace storage
@@ -0,0 +1,78 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/recovery_admission.h"
+
+#include <seastar/core/coroutine.hh>
+
+#include <ostream>
+
+namespace storage {
+
+std::ostream& operator<<(std::ostream& o, recovery_priority p) {
+    switch (p) {
+    case recovery_priority::high:
+        return o << "high";
+    case recovery_priority::normal:
+        return o << "normal";
+    }
+    return o << "unknown";
+}
+
+recovery_admission::~recovery_admission() noexcept {
+    for (auto& q : _waiters) {
+        for (auto& w : q) {
+            w.set_exception(ss::broken_promise());
+        }
+    }
+}
+
+ss::future<recovery_admission::units>
+recovery_admission::get_units(recovery_priority p) {
+    if (_running < _capacity && waiters() == 0) {
+        ++_running;
+        co_return units(this);
+    }
+    auto& q = _waiters[static_cast<size_t>(p)];
+    q.emplace_back();
+    auto f = q.back().get_future();
+    // the unit is accounted for by maybe_admit() when the waiter is woken up
+    co_await std::move(f);
+    co_return units(this);
+}
+
+void recovery_admission::set_capacity(size_t capacity) {
+    _capacity = capacity;
+    maybe_admit();
+}
+
+size_t recovery_admission::waiters() const {
+    size_t n = 0;
+    for (const auto& q : _waiters) {
+        n += q.size();
+    }
+    return n;
+}
+
+void recovery_admission::release() noexcept {
+    --_running;
+    maybe_admit();
+}
+
+void recovery_admission::maybe_admit() noexcept {
+    for (auto& q : _waiters) {
+        while (_running < _capacity && !q.empty()) {
+            ++_running;
+            q.front().set_value();
+            q.pop_front();
+        }
+    }
+}
+
+} // namespace storage
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "seastarx.h"
+
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/core/future.hh>
+
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <utility>
+
+namespace storage {
+
+/// Order in which logs waiting to be recovered are admitted
+enum class recovery_priority : uint8_t {
+    // e.g. logs of partitions this node recently led
+    high = 0,
+    normal = 1,
+};
+
+std::ostream& operator<<(std::ostream&, recovery_priority);
+
+/**
+ * Bounds the number of logs recovered concurrently on a shard. Unlike a plain
+ * semaphore, waiters are admitted in priority order and only in arrival order
+ * within the same priority.
+ */
+class recovery_admission {
+public:
+    class units {
+    public:
+        units() noexcept = default;
+        explicit units(recovery_admission* a) noexcept
+          : _admission(a) {}
+        units(units&& o) noexcept
+          : _admission(std::exchange(o._admission, nullptr)) {}
+        units& operator=(units&& o) noexcept {
+            if (this != &o) {
+                release();
+                _admission = std::exchange(o._admission, nullptr);
+            }
+            return *this;
+        }
+        units(const units&) = delete;
+        units& operator=(const units&) = delete;
+        ~units() noexcept { release(); }
+
+    private:
+        void release() noexcept {
+            if (_admission) {
+                std::exchange(_admission, nullptr)->release();
+            }
+        }
+
+        recovery_admission* _admission{nullptr};
+    };
+
+    explicit recovery_admission(size_t capacity)
+      : _capacity(capacity) {}
+    recovery_admission(const recovery_admission&) = delete;
+    recovery_admission& operator=(const recovery_admission&) = delete;
+    ~recovery_admission() noexcept;
+
+    ss::future<units> get_units(recovery_priority);
+
+    void set_capacity(size_t);
+
+    size_t running() const { return _running; }
+    size_t waiters() const;
+
+private:
+    void release() noexcept;
+    void maybe_admit() noexcept;
+
+    size_t _capacity;
+    size_t _running{0};
+    std::array<ss::circular_buffer<ss::promise<>>, 2> _waiters;
+};
+
+} // namespace storage
@@ -0,0 +1,73 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/resident_index_tracker.h"
+
+#include "storage/logger.h"
+#include "vlog.h"
+
+namespace storage {
+
+resident_index_tracker::resident_index_tracker(config::binding<size_t> budget)
+  : _budget(std::move(budget)) {
+    _budget.watch([this] { maybe_evict(); });
+}
+
+resident_index_tracker::~resident_index_tracker() noexcept {
+    // indexes outliving the tracker must not call back into it
+    for (auto& idx : _lru) {
+        idx._residency_tracker = nullptr;
+    }
+    _lru.clear();
+}
+
+void resident_index_tracker::touch(segment_index& idx) {
+    if (idx._residency_hook.is_linked()) {
+        idx._residency_hook.unlink();
+        _resident_bytes -= idx._tracked_bytes;
+    }
+    idx._tracked_bytes = idx.memory_usage();
+    _resident_bytes += idx._tracked_bytes;
+    _lru.push_back(idx);
+    maybe_evict();
+}
+
+void resident_index_tracker::untrack(segment_index& idx) {
+    if (!idx._residency_hook.is_linked()) {
+        return;
+    }
+    idx._residency_hook.unlink();
+    _resident_bytes -= idx._tracked_bytes;
+    idx._tracked_bytes = 0;
+}
+
+void resident_index_tracker::maybe_evict() {
+    // the most recently used index is never evicted, it is the one which is
+    // being looked up
+    auto it = _lru.begin();
+    while (_resident_bytes > _budget() && it != _lru.end()
+           && &*it != &_lru.back()) {
+        auto& idx = *it;
+        ++it;
+        if (!idx.try_evict()) {
+            continue;
+        }
+        vlog(
+          stlog.trace,
+          "Evicted entries of index {}, {} bytes",
+          idx.path(),
+          idx._tracked_bytes);
+        idx._residency_hook.unlink();
+        _resident_bytes -= idx._tracked_bytes;
+        idx._tracked_bytes = 0;
+        ++_evictions;
+    }
+}
+
+} // namespace storage
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/property.h"
+#include "storage/segment_index.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <cstdint>
+
+namespace storage {
+
+/**
+ * Keeps the entries of the indexes of closed segments on a shard within a
+ * memory budget. Indexes are kept in LRU order of their lookups, once the
+ * budget is exceeded the entries of the least recently used indexes are
+ * dropped. Evicted indexes keep their header fields and page the entries back
+ * in from disk on the next lookup (see segment_index::page_in).
+ */
+class resident_index_tracker {
+public:
+    explicit resident_index_tracker(config::binding<size_t> budget);
+    resident_index_tracker(const resident_index_tracker&) = delete;
+    resident_index_tracker& operator=(const resident_index_tracker&) = delete;
+    ~resident_index_tracker() noexcept;
+
+    /// \brief marks the index as most recently used and accounts for its
+    /// current size, evicting other indexes if over budget
+    void touch(segment_index&);
+
+    /// \brief stops tracking the index, e.g. because it is mutable again
+    void untrack(segment_index&);
+
+    size_t resident_bytes() const { return _resident_bytes; }
+    uint64_t evictions() const { return _evictions; }
+
+private:
+    void maybe_evict();
+
+    config::binding<size_t> _budget;
+    intrusive_list<segment_index, &segment_index::_residency_hook> _lru;
+    size_t _resident_bytes{0};
+    uint64_t _evictions{0};
+};
+
+} // namespace storage
@@ -15,6 +15,7 @@
 #include "storage/compacted_index_writer.h"
 #include "storage/fs_utils.h"
 #include "storage/fwd.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/logger.h"
 #include "storage/parser_utils.h"
 #include "storage/readers_cache.h"
@@ -64,6 +65,8 @@ segment::segment(
     if (_appender) {
         _appender->set_callbacks(&_appender_callbacks);
     }
+    _idx.set_residency_tracker(&_resources.resident_indexes());
+    _reader.set_handle_cache(&_resources.reader_handles());
 }
 
 void segment::check_segment_not_closed(const char* msg) {
@@ -101,11 +104,12 @@ ss::future<> segment::remove_persistent_state() {
     vassert(is_closed(), "Cannot clear state from unclosed segment");
 
     std::vector<std::filesystem::path> rm;
-    rm.reserve(3);
+    rm.reserve(4);
     rm.emplace_back(reader().filename().c_str());
     rm.emplace_back(index().path().string());
     if (is_compacted_segment()) {
         rm.push_back(reader().path().to_compacted_index());
+        rm.push_back(key_filter_path(reader().path().to_compacted_index()));
     }
     vlog(stlog.debug, "removing: {}", rm);
     return ss::do_with(
@@ -160,7 +164,9 @@ ss::future<> segment::do_release_appender(
         segment_appender_ptr& appender,
         std::optional<compacted_index_writer>& compacted_index) {
           return appender->close()
-            .then([this] { return _idx.flush(); })
+            .then([this] {
+                return _idx.flush().then([this] { _idx.freeze(); });
+            })
             .then([&compacted_index] {
                 if (compacted_index) {
                     return compacted_index->close();
@@ -241,6 +247,21 @@ void segment::release_appender_in_background(readers_cache* readers_cache) {
       });
 }
 
+void segment::prewarm_reader() {
+    if (is_closed()) {
+        return;
+    }
+    ssx::spawn_with_gate(_gate, [this] {
+        return read_lock()
+          .then([this](ss::rwlock::holder h) {
+              return _reader.prewarm().finally([h = std::move(h)] {});
+          })
+          .handle_exception([this](const std::exception_ptr& e) {
+              vlog(stlog.debug, "Failed to prewarm segment {}: {}", *this, e);
+          });
+    });
+}
+
 ss::future<> segment::flush() {
     check_segment_not_closed("flush()");
     return read_lock().then([this](ss::rwlock::holder h) {
@@ -264,8 +285,7 @@ ss::future<> segment::do_flush() {
     });
 }
 
-ss::future<> remove_compacted_index(const segment_full_path& reader_path) {
-    auto path = reader_path.to_compacted_index();
+static ss::future<> remove_index_file(std::filesystem::path path) {
     return ss::remove_file(path.string())
       .handle_exception([path](const std::exception_ptr& e) {
           try {
@@ -280,6 +300,12 @@ ss::future<> remove_compacted_index(const segment_full_path& reader_path) {
       });
 }
 
+ss::future<> remove_compacted_index(const segment_full_path& reader_path) {
+    std::filesystem::path path = reader_path.to_compacted_index();
+    return remove_index_file(path).then(
+      [path] { return remove_index_file(key_filter_path(path)); });
+}
+
 ss::future<>
 segment::truncate(model::offset prev_last_offset, size_t physical) {
     check_segment_not_closed("truncate()");
@@ -355,6 +381,21 @@ ss::future<bool> segment::materialize_index() {
     });
 }
 
+ss::future<bool> segment::materialize_index_header() {
+    vassert(
+      _tracker.base_offset == _tracker.dirty_offset,
+      "Materializing the index must happen before tracking any data. {}",
+      *this);
+    return _idx.materialize_index_header().then([this](bool yn) {
+        if (yn) {
+            _tracker.committed_offset = _idx.max_offset();
+            _tracker.stable_offset = _idx.max_offset();
+            _tracker.dirty_offset = _idx.max_offset();
+        }
+        return yn;
+    });
+}
+
 void segment::cache_truncate(model::offset offset) {
     check_segment_not_closed("cache_truncate()");
     if (likely(bool(_cache))) {
@@ -508,19 +549,43 @@ ss::future<append_result> segment::append(model::record_batch&& b) {
 }
 
 ss::future<segment_reader_handle>
-segment::offset_data_stream(model::offset o, ss::io_priority_class iopc) {
+segment::offset_data_stream(
+  model::offset o,
+  ss::io_priority_class iopc,
+  std::optional<read_window> window) {
     check_segment_not_closed("offset_data_stream()");
+    // the index must stay resident from page in until the lookup
+    segment_index::pin_guard pin(_idx);
+    co_await _idx.page_in();
     auto nearest = _idx.find_nearest(o);
     size_t position = 0;
     if (nearest) {
         position = nearest->filepos;
     }
 
-    // This could be a corruption (bad index) or a runtime defect (bad file
-    // size) (https://github.com/redpanda-data/redpanda/issues/2101)
+    // This could be a corruption (bad index) or a runtime defect (bad
+    // file size) (https://github.com/redpanda-data/redpanda/issues/2101)
     vassert(position < size_bytes(), "Index points beyond file size");
 
-    return _reader.data_stream(position, iopc);
+    co_return co_await _reader.data_stream(position, iopc, window);
+}
+
+ss::future<ss::lw_shared_ptr<const key_bloom_filter>> segment::key_filter(
+  ss::io_priority_class iopc, debug_sanitize_files sanitize) {
+    const auto generation = _generation_id;
+    if (_key_filter && _key_filter->generation == generation) {
+        co_return _key_filter->filter;
+    }
+    ss::lw_shared_ptr<const key_bloom_filter> filter;
+    auto loaded = co_await internal::load_key_filter(*this, iopc, sanitize);
+    if (loaded) {
+        filter = ss::make_lw_shared<key_bloom_filter>(std::move(*loaded));
+    }
+    if (generation == _generation_id) {
+        _key_filter = cached_key_filter{
+          .generation = generation, .filter = filter};
+    }
+    co_return filter;
 }
 
 void segment::advance_stable_offset(size_t offset) {
@@ -13,8 +13,10 @@
 
 #include "storage/batch_cache.h"
 #include "storage/compacted_index_writer.h"
+#include "storage/disk_usage.h"
 #include "storage/fs_utils.h"
 #include "storage/fwd.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/segment_appender.h"
 #include "storage/segment_index.h"
 #include "storage/segment_reader.h"
@@ -99,10 +101,15 @@ public:
     ss::future<append_result> append(const model::record_batch&);
     ss::future<append_result> do_append(const model::record_batch&);
     ss::future<bool> materialize_index();
+    /// \brief as materialize_index() but the entries of the index are only
+    /// paged in on first use
+    ss::future<bool> materialize_index_header();
 
     /// main read interface
-    ss::future<segment_reader_handle>
-      offset_data_stream(model::offset, ss::io_priority_class);
+    ss::future<segment_reader_handle> offset_data_stream(
+      model::offset,
+      ss::io_priority_class,
+      std::optional<read_window> = std::nullopt);
 
     const offset_tracker& offsets() const { return _tracker; }
     bool empty() const;
@@ -119,6 +126,10 @@ public:
     bool finished_self_compaction() const;
     /// \brief used for compaction, to reset the tracker from index
     void force_set_commit_offset_from_index();
+    storage_resources& resources() { return _resources; }
+    /// \brief opens the data file in the background, ahead of a sequential
+    /// read reaching this segment
+    void prewarm_reader();
     // low level api's are discouraged and might be deprecated
     // please use higher level API's when possible
     segment_reader& reader();
@@ -133,6 +144,9 @@ public:
     bool has_appender() const;
     compacted_index_writer& compaction_index();
     const compacted_index_writer& compaction_index() const;
+    /// \brief bytes of the index files of the segment accounted in the probe
+    /// of its log, see probe::set_segment_artifacts
+    disk_usage& accounted_artifacts() { return _accounted_artifacts; }
     // We currently use `max_collectible_offset` to control both
     // deletion/eviction, and compaction.
     bool has_compactible_offsets(const compaction_config& cfg) const;
@@ -150,7 +164,9 @@ public:
       std::optional<model::timestamp> first_ts,
       size_t max_bytes,
       bool skip_lru_promote);
-    void cache_put(const model::record_batch& batch);
+    void cache_put(
+      const model::record_batch& batch,
+      batch_cache::is_historical historical = batch_cache::is_historical::no);
 
     ss::future<ss::rwlock::holder> read_lock(
       ss::semaphore::time_point timeout = ss::semaphore::time_point::max());
@@ -163,6 +179,14 @@ public:
     generation_id get_generation_id() const { return _generation_id; }
     void advance_generation() { _generation_id++; }
 
+    /// \brief key filter of the compacted index, see load_key_filter. Loaded
+    /// once per generation of the segment: rewrites of the compacted index
+    /// only drop keys, so a filter loaded before one still contains every
+    /// key. nullptr if the segment has no valid filter. The caller must hold
+    /// a lock on the segment.
+    ss::future<ss::lw_shared_ptr<const key_bloom_filter>>
+    key_filter(ss::io_priority_class, debug_sanitize_files);
+
     /**
      * Timestamp of the first data batch written to this segment.
      * Note that this isn't the first timestamp of a data batch in the log,
@@ -228,6 +252,12 @@ private:
     segment_appender_ptr _appender;
     std::optional<compacted_index_writer> _compaction_index;
     std::optional<batch_cache_index> _cache;
+    disk_usage _accounted_artifacts;
+    struct cached_key_filter {
+        generation_id generation;
+        ss::lw_shared_ptr<const key_bloom_filter> filter;
+    };
+    std::optional<cached_key_filter> _key_filter;
     ss::rwlock _destructive_ops;
     ss::gate _gate;
 
@@ -377,9 +407,10 @@ inline batch_cache_index::read_result segment::cache_get(
       .next_batch = offset,
     };
 }
-inline void segment::cache_put(const model::record_batch& batch) {
+inline void segment::cache_put(
+  const model::record_batch& batch, batch_cache::is_historical historical) {
     if (likely(bool(_cache))) {
-        _cache->put(batch);
+        _cache->put(batch, historical);
     }
 }
 inline ss::future<ss::rwlock::holder>
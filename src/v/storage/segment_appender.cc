@@ -24,6 +24,8 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <chrono>
 #include <ostream>
 
 namespace storage {
@@ -52,12 +54,17 @@ size_missmatch_error(const char* ctx, size_t expected, size_t got) {
 
 static constexpr auto head_sem_name = "s/appender-head";
 
+// appends further apart than this are not told apart by the moving average
+static constexpr auto max_append_interval = std::chrono::seconds(1);
+
 segment_appender::segment_appender(ss::file f, options opts)
   : _out(std::move(f))
   , _opts(opts)
   , _concurrent_flushes(ss::semaphore::max_counter(), "s/append-flush")
   , _prev_head_write(ss::make_lw_shared<ssx::semaphore>(1, head_sem_name))
   , _inactive_timer([this] { handle_inactive_timer(); })
+  , _coalesce_timer([this] { handle_coalesce_timer(); })
+  , _append_interval(max_append_interval)
   , _chunk_size(config::shard_local_cfg().append_chunk_size()) {
     const auto alignment = _out.disk_write_dma_alignment();
     vassert(
@@ -104,6 +111,10 @@ segment_appender::segment_appender(segment_appender&& o) noexcept
   , _inflight(std::move(o._inflight))
   , _callbacks(std::exchange(o._callbacks, nullptr))
   , _inactive_timer([this] { handle_inactive_timer(); })
+  , _coalesce_timer([this] { handle_coalesce_timer(); })
+  , _coalesce_deadline(std::exchange(o._coalesce_deadline, std::nullopt))
+  , _last_append(o._last_append)
+  , _append_interval(o._append_interval)
   , _chunk_size(o._chunk_size) {
     o._closed = true;
 }
@@ -114,25 +125,93 @@ ss::future<> segment_appender::append(bytes_view s) {
 }
 
 ss::future<> segment_appender::append(const iobuf& io) {
+    record_append();
     return ss::do_for_each(
       io.begin(), io.end(), [this](const iobuf::fragment& f) {
-          return append(f.get(), f.size());
+          return append_buffer(f.get(), f.size());
       });
 }
 
 ss::future<> segment_appender::append(const char* buf, const size_t n) {
-    // seastar is optimized for timers that never fire. here the timer is
-    // cancelled because it firing may dispatch a background write, which as
+    record_append();
+    return append_buffer(buf, n);
+}
+
+ss::future<> segment_appender::append_buffer(const char* buf, const size_t n) {
+    // seastar is optimized for timers that never fire. here the timers are
+    // cancelled because them firing may dispatch a background write, which as
     // currently formulated, is not safe to interlave with append.
     _inactive_timer.cancel();
+    _coalesce_timer.cancel();
     return do_append(buf, n).then([this] {
         if (_head && _head->bytes_pending()) {
             _inactive_timer.arm(
               config::shard_local_cfg().segment_appender_flush_timeout_ms());
         }
+        maybe_dispatch_coalesced_write();
     });
 }
 
+void segment_appender::record_append() {
+    const auto now = coalesce_clock::now();
+    const auto interval = std::min<coalesce_clock::duration>(
+      now - _last_append, max_append_interval);
+    _last_append = now;
+    // weight the latest interval by 1/8
+    _append_interval += (interval - _append_interval) / 8;
+}
+
+bool segment_appender::should_coalesce_write() const {
+    const auto window
+      = config::shard_local_cfg().segment_appender_write_coalesce_ms();
+    /*
+     * only wait when the next append is expected within the window. a writer
+     * that waits for each flush before appending again sees the window in the
+     * time between its appends, so coalescing turns itself off for it.
+     */
+    if (window <= std::chrono::milliseconds(0) || _append_interval >= window) {
+        return false;
+    }
+    // once the pending bytes complete the page being written there is no
+    // rewrite to save
+    const auto align = _head->alignment();
+    return ss::align_down<size_t>(_head->size(), align)
+           == ss::align_down<size_t>(_head->flushed_pos(), align);
+}
+
+bool segment_appender::head_has_flush_waiters() const {
+    return std::any_of(
+      _flush_ops.begin(), _flush_ops.end(), [this](const flush_op& op) {
+          return op.offset > _committed_offset;
+      });
+}
+
+void segment_appender::maybe_dispatch_coalesced_write() {
+    if (!_coalesce_deadline) {
+        return;
+    }
+    if (!_head || !_head->bytes_pending() || !head_has_flush_waiters()) {
+        // the pending flushes were covered by a write of a full chunk
+        _coalesce_deadline.reset();
+        return;
+    }
+    if (
+      coalesce_clock::now() >= *_coalesce_deadline
+      || !should_coalesce_write()) {
+        _coalesce_deadline.reset();
+        dispatch_background_head_write();
+        return;
+    }
+    _coalesce_timer.arm(*_coalesce_deadline);
+}
+
+void segment_appender::handle_coalesce_timer() {
+    _coalesce_deadline.reset();
+    if (_head && _head->bytes_pending()) {
+        dispatch_background_head_write();
+    }
+}
+
 ss::future<> segment_appender::do_append(const char* buf, const size_t n) {
     vassert(!_closed, "append() on closed segment: {}", *this);
 
@@ -412,16 +491,19 @@ ss::future<> segment_appender::process_flush_ops(size_t committed) {
 
     _flush_ops.erase(flushable, _flush_ops.end());
 
-    return _out.flush().then([this, committed, ops = std::move(ops)]() mutable {
-        _flushed_offset = committed;
-        /*
-         * TODO: as an optimization, add a little house keeping to determine if
-         * eligible flush operations showed up while flush() was completing.
-         */
-        for (auto& op : ops) {
-            op.p.set_value();
-        }
-    });
+    return _opts.resources.flushes()
+      .flush(this, _out)
+      .then([this, committed, ops = std::move(ops)]() mutable {
+          _flushed_offset = committed;
+          /*
+           * TODO: as an optimization, add a little house keeping to determine
+           * if eligible flush operations showed up while flush() was
+           * completing.
+           */
+          for (auto& op : ops) {
+              op.p.set_value();
+          }
+      });
 }
 
 void segment_appender::dispatch_background_head_write() {
@@ -523,8 +605,20 @@ ss::future<> segment_appender::flush() {
     // dispatched write will drive flush completion
     if (_head && _head->bytes_pending()) {
         auto& w = _flush_ops.emplace_back(file_byte_offset());
+        auto f = w.p.get_future();
+        if (should_coalesce_write()) {
+            if (!_coalesce_deadline) {
+                _coalesce_deadline = coalesce_clock::now()
+                                     + config::shard_local_cfg()
+                                         .segment_appender_write_coalesce_ms();
+                _coalesce_timer.arm(*_coalesce_deadline);
+            }
+            return f;
+        }
+        _coalesce_timer.cancel();
+        _coalesce_deadline.reset();
         dispatch_background_head_write();
-        return w.p.get_future();
+        return f;
     }
 
     if (file_byte_offset() <= _flushed_offset) {
@@ -547,13 +641,17 @@ ss::future<> segment_appender::flush() {
       _stable_offset,
       *this);
 
-    return _out.flush().handle_exception([this](std::exception_ptr e) {
-        vassert(false, "Could not flush: {} - {}", e, *this);
-    });
+    return _opts.resources.flushes()
+      .flush(this, _out)
+      .handle_exception([this](std::exception_ptr e) {
+          vassert(false, "Could not flush: {} - {}", e, *this);
+      });
 }
 
 ss::future<> segment_appender::hard_flush() {
     _inactive_timer.cancel();
+    _coalesce_timer.cancel();
+    _coalesce_deadline.reset();
     if (_head && _head->bytes_pending()) {
         dispatch_background_head_write();
     }
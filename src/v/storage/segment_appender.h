@@ -23,8 +23,10 @@
 #include <seastar/core/fstream.hh>
 #include <seastar/core/iostream.hh>
 #include <seastar/core/sstring.hh>
+#include <seastar/core/timer.hh>
 
 #include <iosfwd>
+#include <optional>
 
 namespace storage {
 
@@ -105,6 +107,9 @@ public:
     }
 
 private:
+    using coalesce_clock = ss::timer<>::clock;
+
+    ss::future<> append_buffer(const char* buf, const size_t n);
     void dispatch_background_head_write();
     ss::future<> do_next_adaptive_fallocation();
     ss::future<> hydrate_last_half_page();
@@ -168,6 +173,25 @@ private:
     ss::timer<ss::lowres_clock> _inactive_timer;
     void handle_inactive_timer();
 
+    /*
+     * write coalescing: a flush of a few bytes that don't complete the page
+     * being written is held back for up to segment_appender_write_coalesce_ms
+     * if appends arrive more often than that, so that the flushes of the next
+     * appends share the write instead of each rewriting the same page.
+     */
+    void record_append();
+    bool should_coalesce_write() const;
+    bool head_has_flush_waiters() const;
+    void maybe_dispatch_coalesced_write();
+    void handle_coalesce_timer();
+
+    ss::timer<> _coalesce_timer;
+    // set while flushes are waiting for a coalesced write
+    std::optional<coalesce_clock::time_point> _coalesce_deadline;
+    coalesce_clock::time_point _last_append;
+    // moving average of the time between appends
+    coalesce_clock::duration _append_interval;
+
     size_t _chunk_size{0};
 
     friend std::ostream& operator<<(std::ostream&, const segment_appender&);
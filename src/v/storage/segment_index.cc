@@ -9,10 +9,14 @@
 
 #include "storage/segment_index.h"
 
+#include "bytes/iobuf_parser.h"
 #include "model/timestamp.h"
 #include "serde/serde.h"
 #include "storage/index_state.h"
+#include "storage/log_replayer.h"
 #include "storage/logger.h"
+#include "storage/resident_index_tracker.h"
+#include "storage/segment_reader.h"
 #include "storage/segment_utils.h"
 #include "vassert.h"
 
@@ -25,6 +29,7 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <limits>
 
 namespace storage {
 
@@ -57,6 +62,8 @@ segment_index::segment_index(
     _state.base_offset = base;
 }
 
+segment_index::~segment_index() noexcept { untrack(); }
+
 ss::future<ss::file> segment_index::open() {
     if (_mock_file) {
         // Unit testing hook
@@ -69,19 +76,27 @@ ss::future<ss::file> segment_index::open() {
 
 void segment_index::reset() {
     auto base = _state.base_offset;
+    untrack();
     _state = {};
     _state.base_offset = base;
+    _frozen.reset();
+    _resident = true;
     _acc = 0;
 }
 
 void segment_index::swap_index_state(index_state&& o) {
+    untrack();
     _needs_persistence = true;
     _acc = 0;
+    _frozen.reset();
+    _resident = true;
     std::swap(_state, o);
 }
 
 void segment_index::maybe_track(
   const model::record_batch_header& hdr, size_t filepos) {
+    vassert(_resident, "cannot append to a paged out index: {}", _path);
+    thaw();
     _acc += hdr.size_bytes;
     if (_state.maybe_index(
           _acc,
@@ -103,10 +118,20 @@ segment_index::find_nearest(model::timestamp t) {
     if (t < _state.base_timestamp) {
         return std::nullopt;
     }
-    if (_state.empty()) {
+    if (empty()) {
         return std::nullopt;
     }
     const uint32_t i = t() - _state.base_timestamp();
+    if (_frozen) {
+        if (_residency_tracker) {
+            _residency_tracker->touch(*this);
+        }
+        auto e = _frozen->find_nearest_time(i);
+        if (!e) {
+            return std::nullopt;
+        }
+        return translate_index_entry(_state, *e);
+    }
     auto it = std::lower_bound(
       std::begin(_state.relative_time_index),
       std::end(_state.relative_time_index),
@@ -119,12 +144,52 @@ segment_index::find_nearest(model::timestamp t) {
     return translate_index_entry(_state, _state.get_entry(dist));
 }
 
+std::optional<segment_index::entry>
+segment_index::find_timequery_start(model::timestamp t) {
+    if (t <= _state.base_timestamp || empty()) {
+        return std::nullopt;
+    }
+    const auto& times = _state.max_time_index;
+    const auto entries = _frozen ? _frozen->size()
+                                 : _state.relative_offset_index.size();
+    if (times.size() != entries) {
+        // written before the max time index existed
+        return std::nullopt;
+    }
+    const auto needle = static_cast<uint32_t>(std::min<int64_t>(
+      t() - _state.base_timestamp(), std::numeric_limits<uint32_t>::max()));
+    // first range holding a batch at or after the needle. When no batch of
+    // the segment is, start at the last entry so only its range is scanned.
+    auto it = std::lower_bound(times.begin(), times.end(), needle);
+    if (it == times.end()) {
+        it = std::prev(it);
+    }
+    const auto i = static_cast<size_t>(std::distance(times.begin(), it));
+    if (_frozen) {
+        if (_residency_tracker) {
+            _residency_tracker->touch(*this);
+        }
+        return translate_index_entry(_state, _frozen->get_entry(i));
+    }
+    return translate_index_entry(_state, _state.get_entry(i));
+}
+
 std::optional<segment_index::entry>
 segment_index::find_nearest(model::offset o) {
-    if (o < _state.base_offset || _state.empty()) {
+    if (o < _state.base_offset || empty()) {
         return std::nullopt;
     }
     const uint32_t needle = o() - _state.base_offset();
+    if (_frozen) {
+        if (_residency_tracker) {
+            _residency_tracker->touch(*this);
+        }
+        auto e = _frozen->find_nearest_offset(needle);
+        if (!e) {
+            return std::nullopt;
+        }
+        return translate_index_entry(_state, *e);
+    }
     auto it = std::lower_bound(
       std::begin(_state.relative_offset_index),
       std::end(_state.relative_offset_index),
@@ -148,6 +213,8 @@ ss::future<> segment_index::truncate(model::offset o) {
     if (o < _state.base_offset) {
         co_return;
     }
+    co_await page_in();
+    thaw();
     const uint32_t i = o() - _state.base_offset();
     auto it = std::lower_bound(
       std::begin(_state.relative_offset_index),
@@ -199,6 +266,9 @@ ss::future<bool> segment_index::materialize_index_from_file(ss::file f) {
     iobuf b;
     b.append(std::move(buf));
     try {
+        untrack();
+        _frozen.reset();
+        _resident = true;
         _state = serde::from_iobuf<index_state>(std::move(b));
         co_return true;
     } catch (const serde::serde_exception& ex) {
@@ -210,6 +280,117 @@ ss::future<bool> segment_index::materialize_index_from_file(ss::file f) {
     }
 }
 
+ss::future<bool> segment_index::materialize_index_header() {
+    return ss::with_file(open(), [this](ss::file f) {
+        return materialize_index_header_from_file(std::move(f));
+    });
+}
+
+ss::future<bool>
+segment_index::materialize_index_header_from_file(ss::file f) {
+    // only the header region is read, the checksum of the whole file is
+    // verified when the entries are paged in
+    auto size = co_await f.size();
+    const auto header_size = index_state::header_region_size();
+    if (size < header_size) {
+        co_return co_await materialize_index_from_file(std::move(f));
+    }
+    auto buf = co_await f.dma_read_bulk<char>(0, header_size);
+    if (buf.size() < header_size) {
+        co_return co_await materialize_index_from_file(std::move(f));
+    }
+    buf.trim(header_size);
+    iobuf b;
+    b.append(std::move(buf));
+    iobuf_parser parser(std::move(b));
+    std::optional<index_state> header;
+    try {
+        header = index_state::decode_header(parser, size);
+    } catch (const serde::serde_exception& ex) {
+        vlog(
+          stlog.debug, "Cannot decode index header {}: {}", _path, ex.what());
+    }
+    if (!header || header->base_offset != _state.base_offset) {
+        co_return co_await materialize_index_from_file(std::move(f));
+    }
+    untrack();
+    _frozen.reset();
+    _state = std::move(*header);
+    _resident = false;
+    _loading.reset();
+    co_return true;
+}
+
+ss::future<> segment_index::page_in() {
+    if (_resident) {
+        return ss::now();
+    }
+    if (!_loading || _loading->failed()) {
+        _loading = ss::shared_future<>(
+          ss::with_file(open(), [this](ss::file f) {
+              return page_in_from_file(std::move(f));
+          }));
+    }
+    return _loading->get_future();
+}
+
+ss::future<> segment_index::page_in_from_file(ss::file f) {
+    auto size = co_await f.size();
+    auto buf = co_await f.dma_read_bulk<char>(0, size);
+    if (_resident) {
+        // reset or replaced while loading
+        co_return;
+    }
+    iobuf b;
+    b.append(std::move(buf));
+    bool rebuild = false;
+    try {
+        auto st = serde::from_iobuf<index_state>(std::move(b));
+        if (
+          st.base_offset != _state.base_offset
+          || st.max_offset != _state.max_offset) {
+            vlog(
+              stlog.warn,
+              "Index {} changed on disk, header: {}, paged in: {}",
+              _path,
+              _state,
+              st);
+        }
+        _state = std::move(st);
+    } catch (const serde::serde_exception& ex) {
+        vlog(
+          stlog.warn,
+          "Rebuilding index {} from its segment after decoding failure: {}",
+          _path,
+          ex.what());
+        rebuild = true;
+    }
+    if (rebuild) {
+        co_return co_await rebuild_from_segment();
+    }
+    _resident = true;
+    freeze();
+}
+
+ss::future<> segment_index::rebuild_from_segment() {
+    auto rdr = segment_reader(
+      _path.to_segment(), default_data_buffer_step, 1, _sanitize);
+    std::exception_ptr ex;
+    try {
+        co_await rdr.load_size();
+        // resets the index and tracks every batch with a valid checksum
+        co_await rebuild_index(*this, rdr, ss::default_priority_class());
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await rdr.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_await flush();
+    freeze();
+}
+
 ss::future<> segment_index::drop_all_data() {
     reset();
     return ss::with_file(open(), [](ss::file f) { return f.truncate(0); });
@@ -229,16 +410,87 @@ ss::future<> segment_index::flush_to_file(ss::file backing_file) {
     co_await backing_file.truncate(0);
     auto out = co_await ss::make_file_output_stream(std::move(backing_file));
 
-    auto b = serde::to_iobuf(_state.copy());
+    auto state = _state.copy();
+    if (_frozen) {
+        _frozen->decompress_into(state);
+    }
+    auto b = serde::to_iobuf(std::move(state));
     for (const auto& f : b) {
         co_await out.write(f.get(), f.size());
     }
     co_await out.flush();
 }
 
+void segment_index::freeze() {
+    if (!_resident) {
+        return;
+    }
+    if (!_frozen && !_state.empty()) {
+        auto compressed = compressed_index_state::compress(_state);
+        if (compressed) {
+            _frozen = std::move(compressed);
+            _state.relative_offset_index = {};
+            _state.relative_time_index = {};
+            _state.position_index = {};
+        } else {
+            vlog(stlog.debug, "Index {} can not be compressed", _path);
+        }
+    }
+    if (_residency_tracker) {
+        _residency_tracker->touch(*this);
+    }
+}
+
+void segment_index::thaw() {
+    untrack();
+    if (!_frozen) {
+        return;
+    }
+    auto frozen = std::exchange(_frozen, std::nullopt);
+    frozen->decompress_into(_state);
+}
+
+void segment_index::untrack() {
+    if (_residency_tracker) {
+        _residency_tracker->untrack(*this);
+    }
+}
+
+bool segment_index::try_evict() {
+    if (
+      !_resident || _needs_persistence || _pinned > 0
+      || (_loading && !_loading->available())) {
+        return false;
+    }
+    _frozen.reset();
+    _state.relative_offset_index = {};
+    _state.relative_time_index = {};
+    _state.position_index = {};
+    _state.max_time_index = {};
+    _resident = false;
+    _loading.reset();
+    return true;
+}
+
+size_t segment_index::memory_usage() const {
+    if (!_resident) {
+        return 0;
+    }
+    const auto max_time_bytes = _state.max_time_index.size()
+                                * sizeof(uint32_t);
+    if (_frozen) {
+        return _frozen->memory_usage() + max_time_bytes;
+    }
+    return _state.relative_offset_index.size()
+             * (sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t))
+           + max_time_bytes;
+}
+
 std::ostream& operator<<(std::ostream& o, const segment_index& i) {
     return o << "{file:" << i.path() << ", offsets:" << i.base_offset()
-             << ", index:" << i._state << ", step:" << i._step
+             << ", index:" << i._state << ", frozen:" << i.is_frozen()
+             << ", resident:" << i.is_resident()
+             << ", step:" << i._step
              << ", needs_persistence:" << i._needs_persistence << "}";
 }
 std::ostream& operator<<(std::ostream& o, const segment_index_ptr& i) {
@@ -13,19 +13,26 @@
 #include "model/fundamental.h"
 #include "model/record.h"
 #include "model/timestamp.h"
+#include "storage/compressed_index_state.h"
 #include "storage/fs_utils.h"
 #include "storage/index_state.h"
 #include "storage/types.h"
+#include "utils/intrusive_list_helpers.h"
+#include "vassert.h"
 
 #include <seastar/core/file.hh>
+#include <seastar/core/shared_future.hh>
 #include <seastar/core/unaligned.hh>
 
 #include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 namespace storage {
 
+class resident_index_tracker;
+
 /**
  * file file format is: [ header ] [ payload ]
  * header  == segment_index::header
@@ -56,15 +63,23 @@ public:
       size_t step,
       debug_sanitize_files);
 
-    ~segment_index() noexcept = default;
+    ~segment_index() noexcept;
     segment_index(segment_index&&) noexcept = default;
     segment_index& operator=(segment_index&&) noexcept = default;
     segment_index(const segment_index&) = delete;
     segment_index& operator=(const segment_index&) = delete;
 
     void maybe_track(const model::record_batch_header&, size_t filepos);
+    /// Lookups return std::nullopt while the entries are not resident, i.e.
+    /// the caller falls back to the beginning of the segment. Use page_in()
+    /// before the lookup to make sure the entries are available.
     std::optional<entry> find_nearest(model::offset);
     std::optional<entry> find_nearest(model::timestamp);
+    /// \brief entry to start reading from to find the first batch with a
+    /// timestamp at or after the given one, using the max time index which
+    /// tolerates out of order timestamps. std::nullopt when the segment has to
+    /// be read from its beginning or the index has no max time index.
+    std::optional<entry> find_timequery_start(model::timestamp);
 
     model::offset base_offset() const { return _state.base_offset; }
     model::offset max_offset() const { return _state.max_offset; }
@@ -72,6 +87,43 @@ public:
     model::timestamp base_timestamp() const { return _state.base_timestamp; }
 
     ss::future<bool> materialize_index();
+    /// \brief loads only the header fields (offsets and timestamps) leaving
+    /// the entries on disk until page_in(). Falls back to materialize_index()
+    /// for formats whose header can't be read on its own.
+    ss::future<bool> materialize_index_header();
+    /// \brief loads the entries of the index if they are not resident
+    ss::future<> page_in();
+    bool is_resident() const { return _resident; }
+    /// \brief pinned indexes are never evicted by the residency tracker
+    void pin() { ++_pinned; }
+    void unpin() {
+        vassert(_pinned > 0, "unbalanced unpin of index {}", _path);
+        --_pinned;
+    }
+
+    /// \brief keeps the index pinned for its lifetime. Taken before page_in()
+    /// so the entries can't be evicted before the lookup that follows it.
+    class pin_guard {
+    public:
+        explicit pin_guard(segment_index& idx) noexcept
+          : _idx(&idx) {
+            _idx->pin();
+        }
+        pin_guard(pin_guard&& o) noexcept
+          : _idx(std::exchange(o._idx, nullptr)) {}
+        pin_guard& operator=(pin_guard&&) = delete;
+        pin_guard(const pin_guard&) = delete;
+        pin_guard& operator=(const pin_guard&) = delete;
+        ~pin_guard() noexcept {
+            if (_idx) {
+                _idx->unpin();
+            }
+        }
+
+    private:
+        segment_index* _idx;
+    };
+
     ss::future<> flush();
     ss::future<> truncate(model::offset);
 
@@ -89,10 +141,42 @@ public:
     void reset();
     void swap_index_state(index_state&&);
     bool needs_persistence() const { return _needs_persistence; }
-    index_state release_index_state() && { return std::move(_state); }
+    index_state release_index_state() && {
+        vassert(_resident, "index entries must be paged in: {}", _path);
+        thaw();
+        return std::move(_state);
+    }
+
+    /// \brief switches the index to the compressed, read-only representation.
+    /// Called once the segment will not be appended to anymore. Any mutation
+    /// of the index transparently decompresses it first.
+    void freeze();
+    bool is_frozen() const { return _frozen.has_value(); }
+
+    /// \brief approximate memory held by the index entries
+    size_t memory_usage() const;
+
+    /// \brief frozen indexes are registered with the tracker, which may
+    /// evict their entries to stay within the shard's memory budget
+    void set_residency_tracker(resident_index_tracker* t) {
+        _residency_tracker = t;
+    }
 
 private:
+    void thaw();
+    void untrack();
+    bool try_evict();
+    bool empty() const {
+        if (!_resident) {
+            return true;
+        }
+        return _frozen ? _frozen->empty() : _state.empty();
+    }
+
     ss::future<bool> materialize_index_from_file(ss::file);
+    ss::future<bool> materialize_index_header_from_file(ss::file);
+    ss::future<> page_in_from_file(ss::file);
+    ss::future<> rebuild_from_segment();
     ss::future<> flush_to_file(ss::file);
 
     segment_full_path _path;
@@ -100,8 +184,19 @@ private:
     size_t _acc{0};
     bool _needs_persistence{false};
     index_state _state;
+    // entries of _state when the index is frozen, _state then only holds the
+    // header fields
+    std::optional<compressed_index_state> _frozen;
+    // false when only the header fields of _state are loaded
+    bool _resident{true};
+    std::optional<ss::shared_future<>> _loading;
+    size_t _pinned{0};
     debug_sanitize_files _sanitize;
 
+    resident_index_tracker* _residency_tracker{nullptr};
+    intrusive_list_hook _residency_hook;
+    size_t _tracked_bytes{0};
+
     /** Constructor with mock file content for unit testing */
     segment_index(
       segment_full_path path,
@@ -115,6 +210,7 @@ private:
 
     friend class offset_index_utils_fixture;
     friend class log_replayer_fixture;
+    friend class resident_index_tracker;
 
     friend std::ostream& operator<<(std::ostream&, const segment_index&);
 };
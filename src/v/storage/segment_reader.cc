@@ -11,6 +11,7 @@
 
 #include "ssx/future-util.h"
 #include "storage/logger.h"
+#include "storage/reader_handle_cache.h"
 #include "storage/segment_utils.h"
 #include "vassert.h"
 #include "vlog.h"
@@ -21,6 +22,8 @@
 #include <seastar/core/reactor.hh>
 #include <seastar/core/sstring.hh>
 
+#include <fmt/ostream.h>
+
 namespace storage {
 
 segment_reader::segment_reader(
@@ -39,7 +42,11 @@ segment_reader::~segment_reader() noexcept {
           stlog.warn,
           "Dropping segment_reader while handles exist on file {}",
           _path);
+        if (_handle_cache && _data_file && _data_file_refcount > 0) {
+            _handle_cache->forget(*this);
+        }
     }
+    drop_idle_file();
 
     for (auto& i : _streams) {
         i._parent = nullptr;
@@ -53,16 +60,19 @@ segment_reader::segment_reader(segment_reader&& rhs) noexcept
   , _data_file(std::move(rhs._data_file))
   , _data_file_refcount(rhs._data_file_refcount)
   , _streams(std::move(rhs._streams))
+  , _handle_cache(rhs._handle_cache)
   , _file_size(rhs._file_size)
   , _buffer_size(rhs._buffer_size)
   , _read_ahead(rhs._read_ahead)
   , _sanitize(rhs._sanitize) {
+    _cache_hook.swap_nodes(rhs._cache_hook);
     for (auto& i : _streams) {
         i._parent = this;
     }
 }
 
 segment_reader& segment_reader::operator=(segment_reader&& rhs) noexcept {
+    drop_idle_file();
     _path = std::move(rhs._path);
     _data_file = std::move(rhs._data_file);
     _data_file_refcount = rhs._data_file_refcount;
@@ -71,19 +81,38 @@ segment_reader& segment_reader::operator=(segment_reader&& rhs) noexcept {
     _read_ahead = rhs._read_ahead;
     _sanitize = rhs._sanitize;
     _streams = std::move(rhs._streams);
+    _handle_cache = rhs._handle_cache;
+    _cache_hook.swap_nodes(rhs._cache_hook);
     for (auto& i : _streams) {
         i._parent = this;
     }
     return *this;
 }
 
+void segment_reader::drop_idle_file() {
+    if (_handle_cache && _cache_hook.is_linked() && _data_file_refcount == 0) {
+        _handle_cache->discard(*this);
+    }
+}
+
+void segment_reader::set_handle_cache(reader_handle_cache* cache) {
+    vassert(
+      cache == _handle_cache
+        || (_data_file_refcount == 0 && !_cache_hook.is_linked()),
+      "cannot change the handle cache of a reader in use: {}",
+      _path);
+    _handle_cache = cache;
+}
+
 ss::future<> segment_reader::load_size() {
     auto s = co_await stat();
     set_file_size(s.st_size);
 };
 
-ss::future<segment_reader_handle>
-segment_reader::data_stream(size_t pos, const ss::io_priority_class pc) {
+ss::future<segment_reader_handle> segment_reader::data_stream(
+  size_t pos,
+  const ss::io_priority_class pc,
+  std::optional<read_window> window) {
     vassert(
       pos <= _file_size,
       "cannot read negative bytes. Asked to read at position: '{}' - {}",
@@ -102,9 +131,9 @@ segment_reader::data_stream(size_t pos, const ss::io_priority_class pc) {
     // truncating the appender, is optimized.
 
     ss::file_input_stream_options options;
-    options.buffer_size = _buffer_size;
+    options.buffer_size = window ? window->buffer_size : _buffer_size;
     options.io_priority_class = pc;
-    options.read_ahead = _read_ahead;
+    options.read_ahead = window ? window->read_ahead : _read_ahead;
 
     auto handle = co_await get();
     handle.set_stream(make_file_input_stream(
@@ -120,11 +149,18 @@ ss::future<segment_reader_handle> segment_reader::get() {
       _data_file_refcount);
     // Lock to prevent double-opens
     auto units = co_await _open_lock.get_units();
+    const bool was_open = static_cast<bool>(_data_file);
     if (!_data_file) {
         vlog(stlog.debug, "Opening segment file {}", _path);
         _data_file = co_await internal::make_reader_handle(
           std::filesystem::path(_path), _sanitize);
     }
+    if (_handle_cache) {
+        _handle_cache->record_lookup(was_open);
+        if (_data_file_refcount == 0 || !was_open) {
+            _handle_cache->acquire(*this);
+        }
+    }
 
     _data_file_refcount++;
     auto handle = segment_reader_handle(this);
@@ -148,6 +184,11 @@ ss::future<> segment_reader::put() {
     vassert(_data_file_refcount > 0, "bad put() on {}", _path);
     _data_file_refcount--;
     if (_data_file && _data_file_refcount == 0) {
+        if (_handle_cache) {
+            // the cache keeps the file open for the next reader
+            _handle_cache->release(*this);
+            co_return;
+        }
         vlog(stlog.debug, "Closing segment file {}", _path);
         // Note: a get() can now come in and open a fresh file handle: this
         // means we strictly-speaking can consume >1 file descriptors from one
@@ -157,6 +198,24 @@ ss::future<> segment_reader::put() {
     }
 }
 
+ss::future<> segment_reader::prewarm() {
+    if (!_handle_cache || _handle_cache->is_stopped()) {
+        co_return;
+    }
+    auto units = co_await _open_lock.get_units();
+    if (_data_file || !_handle_cache || !_handle_cache->can_prewarm()) {
+        co_return;
+    }
+    vlog(stlog.debug, "Prewarming segment file {}", _path);
+    _data_file = co_await internal::make_reader_handle(
+      std::filesystem::path(_path), _sanitize);
+    if (_data_file_refcount > 0) {
+        _handle_cache->acquire(*this);
+    } else {
+        _handle_cache->prewarmed(*this);
+    }
+}
+
 ss::future<struct stat> segment_reader::stat() {
     auto handle = co_await get();
     auto r = co_await _data_file.stat();
@@ -200,11 +259,20 @@ ss::future<> segment_reader::truncate(size_t n) {
 }
 
 ss::future<> segment_reader::close() {
-    if (_data_file) {
-        return _data_file.close();
-    } else {
+    if (!_data_file) {
         return ss::now();
     }
+    if (_handle_cache) {
+        _handle_cache->forget(*this);
+    }
+    auto f = std::exchange(_data_file, ss::file{});
+    return f.close();
+}
+
+std::ostream& operator<<(std::ostream& os, const read_window& w) {
+    fmt::print(
+      os, "{{buffer_size: {}, read_ahead: {}}}", w.buffer_size, w.read_ahead);
+    return os;
 }
 
 std::ostream& operator<<(std::ostream& os, const segment_reader& seg) {
@@ -327,6 +395,9 @@ ss::future<> concat_segment_data_source_impl::next_stream() {
     _current_stream = _current_handle->take_stream();
 
     _current_pos++;
+    if (_current_pos != _segments.end()) {
+        (*_current_pos)->prewarm_reader();
+    }
 
     vlog(stlog.trace, "opened segment {}", _name);
     co_return;
@@ -31,6 +31,19 @@
 namespace storage {
 
 class segment_reader;
+class reader_handle_cache;
+
+/// Sizes of the reads issued by a data stream over a segment file
+struct read_window {
+    size_t buffer_size{0};
+    unsigned read_ahead{0};
+
+    /// bytes of buffers a stream may hold with this window
+    size_t memory() const { return buffer_size * (read_ahead + 1); }
+
+    friend bool operator==(const read_window&, const read_window&) = default;
+    friend std::ostream& operator<<(std::ostream&, const read_window&);
+};
 
 struct stream_provider {
     virtual ss::input_stream<char> take_stream() = 0;
@@ -140,12 +153,25 @@ public:
     ss::future<> truncate(size_t sz);
 
     /// create an input stream _sharing_ the underlying file handle
-    /// starting at position @pos
-    ss::future<segment_reader_handle>
-    data_stream(size_t pos, const ss::io_priority_class);
+    /// starting at position @pos. The stream reads with the given window,
+    /// or with the window the reader was created with.
+    ss::future<segment_reader_handle> data_stream(
+      size_t pos,
+      const ss::io_priority_class,
+      std::optional<read_window> = std::nullopt);
     ss::future<segment_reader_handle>
     data_stream(size_t pos_begin, size_t pos_end, const ss::io_priority_class);
 
+    /// open the file ahead of a read, if it is not open yet. Only does
+    /// something when the reader is registered with a handle cache, which
+    /// keeps the descriptor open until it's used.
+    ss::future<> prewarm();
+
+    /// \brief shares the descriptors of idle readers of the shard, instead
+    /// of closing the file as soon as the last handle is gone
+    void set_handle_cache(reader_handle_cache*);
+    reader_handle_cache* handle_cache() const { return _handle_cache; }
+
 private:
     segment_full_path _path;
 
@@ -161,11 +187,19 @@ private:
     intrusive_list<segment_reader_handle, &segment_reader_handle::_hook>
       _streams;
 
+    reader_handle_cache* _handle_cache{nullptr};
+    // Linked into the cache while the file is open, in its idle list when
+    // the reader has no handles
+    intrusive_list_hook _cache_hook;
+
     size_t _file_size{0};
     size_t _buffer_size{0};
     unsigned _read_ahead{0};
     debug_sanitize_files _sanitize;
 
+    // Closes the file if it is only kept open by the handle cache
+    void drop_idle_file();
+
     // Acquire a handle to use the underlying file handle
     ss::future<segment_reader_handle> get();
 
@@ -173,6 +207,7 @@ private:
     ss::future<> put();
 
     friend class segment_reader_handle;
+    friend class reader_handle_cache;
     friend std::ostream& operator<<(std::ostream&, const segment_reader&);
 };
 
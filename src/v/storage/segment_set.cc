@@ -20,13 +20,21 @@
 #include <seastar/core/loop.hh>
 #include <seastar/core/seastar.hh>
 #include <seastar/core/thread.hh>
+#include <seastar/util/defer.hh>
 
 #include <absl/container/btree_set.h>
+#include <boost/range/irange.hpp>
 #include <fmt/format.h>
 
 #include <exception>
+#include <vector>
 
 namespace storage {
+
+// bounds the number of segments of a single log opened or having their index
+// loaded at the same time during recovery
+static constexpr size_t max_concurrent_segment_recovery = 16;
+
 struct segment_ordering {
     using type = ss::lw_shared_ptr<segment>;
     bool operator()(const type& seg1, const type& seg2) const {
@@ -174,14 +182,44 @@ std::ostream& operator<<(std::ostream& o, const segment_set& s) {
 static ss::future<segment_set> unsafe_do_recover(
   segment_set&& segments,
   std::optional<ss::sstring> last_clean_segment,
-  ss::abort_source& as) {
+  ss::abort_source& as,
+  segment_recovery_stats& stats) {
     return ss::async([segments = std::move(segments),
                       last_clean_segment = std::move(last_clean_segment),
-                      &as]() mutable {
+                      &as,
+                      &stats]() mutable {
         if (segments.empty() || as.abort_requested()) {
             return std::move(segments);
         }
         segment_set::underlying_t good = std::move(segments).release();
+
+        // use the segment materialize instead of going through the index
+        // directly to hydrate the max_offset state. reads are mostly served
+        // by the tail of the log, for all other segments only the header is
+        // read and the entries are paged in on demand.
+        auto index_start = segment_recovery_stats::clock_type::now();
+        std::vector<bool> materialized(good.size(), false);
+        std::vector<std::exception_ptr> errors(good.size());
+        ss::max_concurrent_for_each(
+          boost::irange<size_t>(0, good.size()),
+          max_concurrent_segment_recovery,
+          [&](size_t i) {
+              auto& s = *good[i];
+              const bool is_tail = i + 1 == good.size();
+              auto f = is_tail ? s.materialize_index()
+                               : s.materialize_index_header();
+              return f.then_wrapped([&, i](ss::future<bool> f) {
+                  try {
+                      materialized[i] = f.get0();
+                  } catch (...) {
+                      errors[i] = std::current_exception();
+                  }
+              });
+          })
+          .get();
+        stats.index_time += segment_recovery_stats::clock_type::now()
+                            - index_start;
+
         absl::btree_set<segment*> to_recover_set;
         for (size_t i = 0; i < good.size(); ++i) {
             auto& s = *good[i];
@@ -202,14 +240,17 @@ static ss::future<segment_set> unsafe_do_recover(
             }
 
             try {
-                // use the segment materialize instead of going through
-                // the index directly to hydrate the max_offset state
-                if (s.materialize_index().get()) {
+                if (errors[i]) {
+                    std::rethrow_exception(errors[i]);
+                }
+                if (materialized[i]) {
                     vassert(
                       s.offsets().dirty_offset == s.index().max_offset(),
                       "dirty_offset and index max_offset must be equal for "
                       "segment {}",
                       s);
+                    // segments are never reopened for appends
+                    s.index().freeze();
                 } else {
                     to_recover_set.insert(&s);
                 }
@@ -287,11 +328,17 @@ static ss::future<segment_set> unsafe_do_recover(
                   stlog.debug,
                   "Skipping recovery of {}, it is marked clean",
                   s);
+                ++stats.segments_skipped_clean;
                 good.emplace_back(std::move(s));
                 continue;
             }
 
-            // Check if the segment was marked clean on shutdown
+            auto replay_start = segment_recovery_stats::clock_type::now();
+            auto replay_time = ss::defer([&stats, replay_start] {
+                stats.replay_time += segment_recovery_stats::clock_type::now()
+                                     - replay_start;
+            });
+            ++stats.segments_replayed;
             auto replayer = log_replayer(*s);
             auto recovered = replayer.recover_in_thread(
               ss::default_priority_class());
@@ -310,6 +357,7 @@ static ss::future<segment_set> unsafe_do_recover(
               .get();
             // persist index
             s->index().flush().get();
+            s->index().freeze();
             vlog(stlog.info, "Recovered: {}", s);
             good.emplace_back(std::move(s));
         }
@@ -320,7 +368,8 @@ static ss::future<segment_set> unsafe_do_recover(
 static ss::future<segment_set> do_recover(
   segment_set&& segments,
   std::optional<ss::sstring> last_clean_segment,
-  ss::abort_source& as) {
+  ss::abort_source& as,
+  segment_recovery_stats& stats) {
     // light-weight copy used for clean-up if recovery fails
     segment_set::underlying_t copy;
     copy.reserve(segments.size());
@@ -332,7 +381,8 @@ static ss::future<segment_set> do_recover(
     // are any pending io operations on a file associated with the segment
     // at the time of destruction seastar will complain about the file handle
     // being destroyed with pending ops.
-    return unsafe_do_recover(std::move(segments), last_clean_segment, as)
+    return unsafe_do_recover(
+             std::move(segments), last_clean_segment, as, stats)
       .handle_exception(
         [copy = std::move(copy)](const std::exception_ptr& ex) mutable {
             return ss::do_with(
@@ -366,64 +416,52 @@ static ss::future<segment_set::underlying_t> open_segments(
   size_t buf_size,
   unsigned read_ahead,
   storage_resources& resources) {
-    using segs_type = segment_set::underlying_t;
-    return ss::do_with(
-      segs_type{},
-      [&as,
-       ppath,
-       cache_factory,
-       sanitize_fileops,
-       buf_size,
-       read_ahead,
-       &resources](segs_type& segs) {
-          auto f = directory_walker::walk(
-            ss::sstring(ppath),
-            [&as,
-             ppath,
-             cache_factory,
-             sanitize_fileops,
-             &segs,
-             buf_size,
-             read_ahead,
-             &resources](ss::directory_entry seg) {
-                // abort if requested
-                if (as.abort_requested()) {
-                    return ss::now();
-                }
-                /*
-                 * Skip non-regular files (including links)
-                 */
-                if (
-                  !seg.type || *seg.type != ss::directory_entry_type::regular) {
-                    return ss::make_ready_future<>();
-                }
-
-                auto path = segment_full_path::parse(ppath, seg.name);
-                if (!path) {
-                    // This is normal, we skip non-log files like indices
-                    return ss::make_ready_future<>();
-                }
-
-                return open_segment(
-                         *path,
-                         sanitize_fileops,
-                         cache_factory(),
-                         buf_size,
-                         read_ahead,
-                         resources)
-                  .then([&segs](ss::lw_shared_ptr<segment> p) {
-                      segs.push_back(std::move(p));
-                  });
-            });
+    std::vector<segment_full_path> paths;
+    co_await directory_walker::walk(
+      ss::sstring(ppath), [&as, ppath, &paths](ss::directory_entry seg) {
+          // abort if requested
+          if (as.abort_requested()) {
+              return ss::now();
+          }
           /*
-           * if the directory walker returns an exceptional future then all
-           * the segment readers that were created are cleaned up by
-           * ss::do_with.
+           * Skip non-regular files (including links)
            */
-          return f.then([&segs]() mutable {
-              return ss::make_ready_future<segs_type>(std::move(segs));
-          });
+          if (!seg.type || *seg.type != ss::directory_entry_type::regular) {
+              return ss::now();
+          }
+          auto path = segment_full_path::parse(ppath, seg.name);
+          // This is normal, we skip non-log files like indices
+          if (path) {
+              paths.push_back(std::move(*path));
+          }
+          return ss::now();
+      });
+
+    /*
+     * if opening any segment fails then all the segment readers that were
+     * created are cleaned up with the vector.
+     */
+    segment_set::underlying_t segs;
+    segs.reserve(paths.size());
+    co_await ss::max_concurrent_for_each(
+      paths,
+      max_concurrent_segment_recovery,
+      [&](const segment_full_path& path) {
+          if (as.abort_requested()) {
+              return ss::now();
+          }
+          return open_segment(
+                   path,
+                   sanitize_fileops,
+                   cache_factory(),
+                   buf_size,
+                   read_ahead,
+                   resources)
+            .then([&segs](ss::lw_shared_ptr<segment> p) {
+                segs.push_back(std::move(p));
+            });
       });
+    co_return segs;
 }
 
 ss::future<segment_set> recover_segments(
@@ -435,7 +473,9 @@ ss::future<segment_set> recover_segments(
   size_t read_buf_size,
   unsigned read_readahead_count,
   std::optional<ss::sstring> last_clean_segment,
-  storage_resources& resources) {
+  storage_resources& resources,
+  segment_recovery_stats& stats) {
+    auto open_start = segment_recovery_stats::clock_type::now();
     return ss::recursive_touch_directory(ss::sstring(path))
       .then([&as,
              path,
@@ -455,8 +495,12 @@ ss::future<segment_set> recover_segments(
       })
       .then([&as,
              is_compaction_enabled,
-             last_clean_segment = std::move(last_clean_segment)](
-              segment_set::underlying_t segs) {
+             last_clean_segment = std::move(last_clean_segment),
+             &stats,
+             open_start](segment_set::underlying_t segs) {
+          stats.open_time += segment_recovery_stats::clock_type::now()
+                             - open_start;
+          stats.segments_opened += segs.size();
           auto segments = segment_set(std::move(segs));
           // we have to mark compacted segments before recovery to allow reading
           // gaps introduced by compaction
@@ -465,7 +509,8 @@ ss::future<segment_set> recover_segments(
                   s->mark_as_compacted_segment();
               }
           }
-          return do_recover(std::move(segments), last_clean_segment, as);
+          return do_recover(
+            std::move(segments), last_clean_segment, as, stats);
       });
 }
 
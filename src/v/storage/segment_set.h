@@ -16,6 +16,7 @@
 
 #include <seastar/core/circular_buffer.hh>
 
+#include <chrono>
 #include <deque>
 
 namespace storage {
@@ -90,6 +91,22 @@ private:
     friend std::ostream& operator<<(std::ostream&, const segment_set&);
 };
 
+/// Time spent and work done recovering the segments of logs
+struct segment_recovery_stats {
+    using clock_type = std::chrono::steady_clock;
+
+    // listing and opening segment files
+    clock_type::duration open_time{0};
+    // loading indexes of segments
+    clock_type::duration index_time{0};
+    // replaying segments without a usable index
+    clock_type::duration replay_time{0};
+    size_t segments_opened{0};
+    size_t segments_replayed{0};
+    // segments not replayed because they were closed cleanly
+    size_t segments_skipped_clean{0};
+};
+
 ss::future<segment_set> recover_segments(
   partition_path path,
   debug_sanitize_files sanitize_fileops,
@@ -99,6 +116,7 @@ ss::future<segment_set> recover_segments(
   size_t read_buf_size,
   unsigned read_readahead_count,
   std::optional<ss::sstring> last_clean_segment,
-  storage_resources&);
+  storage_resources&,
+  segment_recovery_stats&);
 
 } // namespace storage
@@ -17,6 +17,7 @@
 #include "model/timeout_clock.h"
 #include "random/generators.h"
 #include "reflection/adl.h"
+#include "serde/serde.h"
 #include "ssx/future-util.h"
 #include "storage/compacted_index.h"
 #include "storage/compacted_index_writer.h"
@@ -174,6 +175,81 @@ ss::future<segment_appender_ptr> make_segment_appender(
       });
 }
 
+static ss::future<iobuf> read_file(
+  std::filesystem::path path,
+  ss::io_priority_class iopc,
+  debug_sanitize_files sanitize) {
+    auto f = co_await make_reader_handle(path, sanitize);
+    std::exception_ptr ex;
+    iobuf buf;
+    try {
+        const auto size = co_await f.size();
+        buf.append(co_await f.dma_read_bulk<char>(0, size, iopc));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await f.close();
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+    co_return buf;
+}
+
+ss::future<std::optional<key_bloom_filter>> load_key_filter(
+  const segment& s,
+  ss::io_priority_class iopc,
+  debug_sanitize_files sanitize) {
+    const auto idx_path = s.reader().path().to_compacted_index();
+    const auto filter_path = key_filter_path(idx_path);
+    // readers create missing files
+    if (
+      !co_await ss::file_exists(filter_path.string())
+      || !co_await ss::file_exists(idx_path.string())) {
+        co_return std::nullopt;
+    }
+
+    std::optional<key_filter_file> filter;
+    std::optional<compacted_index::footer> footer;
+    auto reader = make_file_backed_compacted_reader(
+      idx_path,
+      co_await make_reader_handle(idx_path, sanitize),
+      iopc,
+      64_KiB);
+    try {
+        filter = serde::from_iobuf<key_filter_file>(
+          co_await read_file(filter_path, iopc, sanitize));
+        footer = co_await reader.load_footer();
+    } catch (...) {
+        vlog(
+          gclog.debug,
+          "ignoring key filter {}: {}",
+          filter_path,
+          std::current_exception());
+    }
+    co_await reader.close().then_wrapped([](ss::future<>) {});
+
+    if (
+      !filter || !footer || filter->index_size != footer->size
+      || filter->index_keys != footer->keys || filter->index_crc != footer->crc
+      || !filter->filter.is_valid()) {
+        co_return std::nullopt;
+    }
+    co_return std::move(filter->filter);
+}
+
+ss::future<>
+rename_compacted_index(std::filesystem::path from, std::filesystem::path to) {
+    co_await ss::rename_file(from.string(), to.string());
+    const auto from_filter = key_filter_path(from);
+    const auto to_filter = key_filter_path(to);
+    if (co_await ss::file_exists(from_filter.string())) {
+        co_await ss::rename_file(from_filter.string(), to_filter.string());
+    } else if (co_await ss::file_exists(to_filter.string())) {
+        // the filter of the replaced index
+        co_await ss::remove_file(to_filter.string());
+    }
+}
+
 size_t number_of_chunks_from_config(const ntp_config& ntpc) {
     auto def = segment_appender::write_behind_memory
                / config::shard_local_cfg().append_chunk_size();
@@ -248,11 +324,11 @@ static ss::future<> do_write_clean_compacted_index(
         })
       .then(
         [old_name = tmpname,
-         new_name = ss::sstring(reader.path())]() -> ss::future<> {
+         new_name = std::filesystem::path(reader.path())]() -> ss::future<> {
             // from glibc: If oldname is not a directory, then any
             // existing file named newname is removed during the
             // renaming operation
-            return ss::rename_file(std::string(old_name), new_name);
+            return rename_compacted_index(old_name, new_name);
         });
 };
 
@@ -335,6 +411,48 @@ ss::future<> do_compact_segment_index(
           return write_clean_compacted_index(reader, cfg, resources);
       });
 }
+
+/// copies the records of the segment listed in `list` into its staging file
+static ss::future<storage::index_state> copy_segment_data(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  ss::rwlock::holder h,
+  storage_resources& resources,
+  compacted_offset_list list) {
+    const auto tmpname = s->reader().path().to_staging();
+    return make_segment_appender(
+             tmpname,
+             cfg.sanitize,
+             segment_appender::write_behind_memory
+               / config::shard_local_cfg().append_chunk_size(),
+             std::nullopt,
+             cfg.iopc,
+             resources)
+      .then([l = std::move(list), &pb, h = std::move(h), cfg, s, tmpname](
+              segment_appender_ptr w) mutable {
+          auto raw = w.get();
+          auto red = copy_data_segment_reducer(
+            std::move(l), raw, s->path().is_internal_topic());
+          auto r = create_segment_full_reader(s, cfg, pb, std::move(h));
+          vlog(
+            gclog.trace,
+            "copying compacted segment data from {} to {}",
+            s->reader().filename(),
+            tmpname);
+          return std::move(r)
+            .consume(std::move(red), model::no_timeout)
+            .finally([raw, w = std::move(w)]() mutable {
+                return raw->close()
+                  .handle_exception([](std::exception_ptr e) {
+                      vlog(
+                        gclog.error, "Error copying index to new segment:{}", e);
+                  })
+                  .finally([w = std::move(w)] {});
+            });
+      });
+}
+
 ss::future<storage::index_state> do_copy_segment_data(
   ss::lw_shared_ptr<segment> s,
   compaction_config cfg,
@@ -353,39 +471,8 @@ ss::future<storage::index_state> do_copy_segment_data(
       })
       .then([cfg, s, &pb, h = std::move(h), &resources](
               compacted_offset_list list) mutable {
-          const auto tmpname = s->reader().path().to_staging();
-          return make_segment_appender(
-                   tmpname,
-                   cfg.sanitize,
-                   segment_appender::write_behind_memory
-                     / config::shard_local_cfg().append_chunk_size(),
-                   std::nullopt,
-                   cfg.iopc,
-                   resources)
-            .then([l = std::move(list), &pb, h = std::move(h), cfg, s, tmpname](
-                    segment_appender_ptr w) mutable {
-                auto raw = w.get();
-                auto red = copy_data_segment_reducer(
-                  std::move(l), raw, s->path().is_internal_topic());
-                auto r = create_segment_full_reader(s, cfg, pb, std::move(h));
-                vlog(
-                  gclog.trace,
-                  "copying compacted segment data from {} to {}",
-                  s->reader().filename(),
-                  tmpname);
-                return std::move(r)
-                  .consume(std::move(red), model::no_timeout)
-                  .finally([raw, w = std::move(w)]() mutable {
-                      return raw->close()
-                        .handle_exception([](std::exception_ptr e) {
-                            vlog(
-                              gclog.error,
-                              "Error copying index to new segment:{}",
-                              e);
-                        })
-                        .finally([w = std::move(w)] {});
-                  });
-            });
+          return copy_segment_data(
+            s, cfg, pb, std::move(h), resources, std::move(list));
       });
 }
 
@@ -428,6 +515,8 @@ ss::future<> do_swap_data_file_handles(
       config::shard_local_cfg().storage_read_buffer_size(),
       config::shard_local_cfg().storage_read_readahead_count(),
       cfg.sanitize);
+    // the swap below moves the cache registration along with the reader
+    r.set_handle_cache(s->reader().handle_cache());
     co_await r.load_size();
 
     // update partition size probe
@@ -437,29 +526,17 @@ ss::future<> do_swap_data_file_handles(
 }
 
 /**
- * Executes segment compaction, returns size of compacted segment or an empty
- * optional if segment wasn't compacted
+ * Replaces the data of the segment with its staging file written by
+ * copy_segment_data. Returns the size of the compacted segment, or an empty
+ * optional if the segment changed since the copy started.
  */
-ss::future<std::optional<size_t>> do_self_compact_segment(
+static ss::future<std::optional<size_t>> swap_compacted_segment_data(
   ss::lw_shared_ptr<segment> s,
+  segment::generation_id segment_generation,
+  storage::index_state idx,
   compaction_config cfg,
   storage::probe& pb,
-  storage::readers_cache& readers_cache,
-  storage_resources& resources) {
-    vlog(gclog.trace, "self compacting segment {}", s->reader().path());
-    auto read_holder = co_await s->read_lock();
-    auto segment_generation = s->get_generation_id();
-
-    if (s->is_closed()) {
-        throw segment_closed_exception();
-    }
-
-    co_await do_compact_segment_index(s, cfg, resources);
-    // copy the bytes after segment is good - note that we
-    // need to do it with the READ-lock, not the write lock
-    auto idx = co_await do_copy_segment_data(
-      s, cfg, pb, std::move(read_holder), resources);
-
+  storage::readers_cache& readers_cache) {
     auto rdr_holder = co_await readers_cache.evict_segment_readers(s);
 
     auto write_lock_holder = co_await s->write_lock();
@@ -490,10 +567,39 @@ ss::future<std::optional<size_t>> do_self_compact_segment(
     s->force_set_commit_offset_from_index();
     s->release_batch_cache_index();
     co_await s->index().flush();
+    s->index().freeze();
     s->advance_generation();
     co_return s->size_bytes();
 }
 
+/**
+ * Executes segment compaction, returns size of compacted segment or an empty
+ * optional if segment wasn't compacted
+ */
+ss::future<std::optional<size_t>> do_self_compact_segment(
+  ss::lw_shared_ptr<segment> s,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache,
+  storage_resources& resources) {
+    vlog(gclog.trace, "self compacting segment {}", s->reader().path());
+    auto read_holder = co_await s->read_lock();
+    auto segment_generation = s->get_generation_id();
+
+    if (s->is_closed()) {
+        throw segment_closed_exception();
+    }
+
+    co_await do_compact_segment_index(s, cfg, resources);
+    // copy the bytes after segment is good - note that we
+    // need to do it with the READ-lock, not the write lock
+    auto idx = co_await do_copy_segment_data(
+      s, cfg, pb, std::move(read_holder), resources);
+
+    co_return co_await swap_compacted_segment_data(
+      s, segment_generation, std::move(idx), cfg, pb, readers_cache);
+}
+
 ss::future<> rebuild_compaction_index(
   model::record_batch_reader rdr,
   ss::lw_shared_ptr<storage::stm_manager> stm_manager,
@@ -610,6 +716,199 @@ ss::future<compaction_result> self_compact_segment(
     __builtin_unreachable();
 }
 
+/// feeds the compacted index of the segment to the reducer
+template<typename Reducer>
+static auto consume_compacted_index(
+  const segment& s, compaction_config cfg, Reducer reducer) {
+    auto idx_path = s.reader().path().to_compacted_index();
+    return make_reader_handle(idx_path, cfg.sanitize)
+      .then([cfg, idx_path, reducer = std::move(reducer)](ss::file f) mutable {
+          auto reader = make_file_backed_compacted_reader(
+            idx_path, std::move(f), cfg.iopc, 64_KiB);
+          return reader.consume(std::move(reducer), model::no_timeout)
+            .finally([reader]() mutable {
+                return reader.close().then_wrapped([](ss::future<>) {});
+            });
+      });
+}
+
+/// rewrites the compacted index of the segment keeping the given entries
+static ss::future<> rewrite_compacted_index(
+  const segment& s,
+  roaring::Roaring to_keep,
+  compaction_config cfg,
+  storage_resources& resources) {
+    auto idx_path = s.reader().path().to_compacted_index();
+    auto f = co_await make_reader_handle(idx_path, cfg.sanitize);
+    auto reader = make_file_backed_compacted_reader(
+      idx_path, std::move(f), cfg.iopc, 64_KiB);
+    const auto tmpname = std::filesystem::path(
+      fmt::format("{}.staging", reader.path()));
+    std::exception_ptr ex;
+    try {
+        co_await copy_filtered_entries(
+          reader,
+          std::move(to_keep),
+          make_file_backed_compacted_index(
+            tmpname.string(), cfg.iopc, cfg.sanitize, true, resources));
+        co_await rename_compacted_index(
+          tmpname, std::filesystem::path(reader.path()));
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    co_await reader.close().then_wrapped([](ss::future<>) {});
+    if (ex) {
+        std::rethrow_exception(ex);
+    }
+}
+
+/// whether the segment may contain keys of the map according to its key
+/// filter, the caller holds a lock on the segment
+static ss::future<bool> may_contain_keys_of(
+  segment& s, const key_offset_map& map, compaction_config cfg) {
+    if (map.size() == 0) {
+        co_return false;
+    }
+    auto filter = co_await s.key_filter(cfg.iopc, cfg.sanitize);
+    if (!filter) {
+        co_return true;
+    }
+    co_return co_await map.may_intersect(*filter);
+}
+
+/**
+ * Removes the records of the segment superseded by a later record of the same
+ * key according to the map. Returns the size of the compacted segment, or an
+ * empty optional if nothing was removed or the segment changed meanwhile.
+ */
+static ss::future<std::optional<size_t>> do_compact_segment_with_key_map(
+  ss::lw_shared_ptr<segment> s,
+  const key_offset_map& map,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache,
+  storage_resources& resources) {
+    auto read_holder = co_await s->read_lock();
+    auto segment_generation = s->get_generation_id();
+
+    if (s->is_closed()) {
+        throw segment_closed_exception();
+    }
+
+    auto filtered = co_await consume_compacted_index(
+      *s, cfg, key_offset_map_filter_reducer(map, s->offsets().base_offset));
+    if (filtered.removed == 0) {
+        co_return std::nullopt;
+    }
+    vlog(
+      gclog.debug,
+      "sliding window compaction removes {} records from segment {}",
+      filtered.removed,
+      s->reader().filename());
+
+    co_await rewrite_compacted_index(
+      *s, std::move(filtered.to_keep), cfg, resources);
+    auto idx = co_await copy_segment_data(
+      s, cfg, pb, std::move(read_holder), resources, std::move(filtered.list));
+
+    co_return co_await swap_compacted_segment_data(
+      s, segment_generation, std::move(idx), cfg, pb, readers_cache);
+}
+
+ss::future<compaction_result> sliding_window_compact(
+  std::vector<ss::lw_shared_ptr<segment>> segments,
+  compaction_config cfg,
+  storage::probe& pb,
+  storage::readers_cache& readers_cache,
+  storage_resources& resources,
+  mutex& segment_rewrite_lock) {
+    size_t size_before = 0;
+    for (const auto& s : segments) {
+        size_before += s->size_bytes();
+    }
+    const auto window_end = segments.back()->offsets().dirty_offset;
+
+    // newer records win, so the map is built from the newest segment
+    // backwards until it is full. Self compacted segments only contain
+    // superseded records of keys of newer segments: a segment whose key filter
+    // contains none of the keys mapped before its own is skipped.
+    auto map_units = co_await resources.compaction_key_map_get_bytes();
+    key_offset_map map(map_units.count());
+    auto rewrite_units = co_await segment_rewrite_lock.get_units();
+    std::vector<bool> candidates(segments.size(), true);
+    size_t indexed = 0;
+    for (auto i = segments.size(); i-- > 0;) {
+        auto& s = segments[i];
+        auto read_holder = co_await s->read_lock();
+        if (s->is_closed()) {
+            throw segment_closed_exception();
+        }
+        candidates[i] = co_await may_contain_keys_of(*s, map, cfg);
+        const bool complete = co_await consume_compacted_index(
+          *s, cfg, key_offset_map_reducer(map));
+        ++indexed;
+        if (!complete) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < segments.size() - indexed; ++i) {
+        auto& s = segments[i];
+        auto read_holder = co_await s->read_lock();
+        if (s->is_closed()) {
+            throw segment_closed_exception();
+        }
+        candidates[i] = co_await may_contain_keys_of(*s, map, cfg);
+    }
+    vlog(
+      gclog.debug,
+      "sliding window compaction key map: {} keys, {} bytes, indexed {} of {} "
+      "segments, {} segments may contain superseded keys",
+      map.size(),
+      map.mem_usage(),
+      indexed,
+      segments.size(),
+      std::count(candidates.begin(), candidates.end(), true));
+    rewrite_units.return_all();
+
+    // a single pass over the segments which may contain superseded records
+    bool compacted = false;
+    size_t size_after = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        auto& s = segments[i];
+        if (!candidates[i]) {
+            size_after += s->size_bytes();
+            continue;
+        }
+        // the map is only valid as long as no records it points to were
+        // truncated away, truncation is excluded while a segment is rewritten
+        rewrite_units = co_await segment_rewrite_lock.get_units();
+        const auto& last = segments.back();
+        if (last->is_closed() || last->offsets().dirty_offset < window_end) {
+            vlog(
+              gclog.debug,
+              "sliding window compaction stops, range truncated below {}",
+              window_end);
+            for (size_t j = i; j < segments.size(); ++j) {
+                size_after += segments[j]->size_bytes();
+            }
+            break;
+        }
+        auto sz = co_await do_compact_segment_with_key_map(
+          s, map, cfg, pb, readers_cache, resources);
+        rewrite_units.return_all();
+        if (sz) {
+            compacted = true;
+            pb.segment_compacted();
+        }
+        size_after += s->size_bytes();
+    }
+
+    if (!compacted) {
+        co_return compaction_result(size_before);
+    }
+    co_return compaction_result(size_before, size_after);
+}
+
 ss::future<
   std::tuple<ss::lw_shared_ptr<segment>, std::vector<segment::generation_id>>>
 make_concatenated_segment(
@@ -821,6 +1120,9 @@ ss::future<std::vector<ss::rwlock::holder>> transfer_segment(
   compaction_config cfg,
   probe& probe,
   std::vector<ss::rwlock::holder> locks) {
+    // the entries must stay resident until they are moved to `to`
+    segment_index::pin_guard pin(from->index());
+    co_await from->index().page_in();
     co_await from->close();
 
     co_await to->index().drop_all_data();
@@ -834,11 +1136,12 @@ ss::future<std::vector<ss::rwlock::holder>> transfer_segment(
       std::move(from->index()).release_index_state());
     to->force_set_commit_offset_from_index();
     co_await to->index().flush();
+    to->index().freeze();
 
     // compaction index
     from_path = from_path.to_compacted_index();
     auto to_path = to->reader().path().to_compacted_index();
-    co_await ss::rename_file(from_path.string(), to_path.string());
+    co_await rename_compacted_index(from_path, to_path);
 
     // clean up replacement segment
     co_await from->remove_persistent_state();
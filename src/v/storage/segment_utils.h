@@ -15,10 +15,12 @@
 #include "storage/compacted_index_reader.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/compacted_offset_list.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/probe.h"
 #include "storage/readers_cache.h"
 #include "storage/segment.h"
 #include "storage/segment_appender.h"
+#include "utils/mutex.h"
 #include "utils/named_type.h"
 
 #include <seastar/core/circular_buffer.hh>
@@ -39,6 +41,25 @@ ss::future<compaction_result> self_compact_segment(
   storage::readers_cache&,
   storage::storage_resources&);
 
+/*
+ * Sliding window compaction over a range of self compacted segments (oldest
+ * first). A map of the latest offset of every key is built over the compacted
+ * indices of the range, newest segment first and within the key map memory
+ * of the shard. All segments of the range are then rewritten in a single pass
+ * without the records superseded by a later record of the same key.
+ *
+ * The segment rewrite lock of the log is held while the map is built and
+ * while each segment is rewritten, but released in between. The pass stops
+ * when the range was truncated meanwhile.
+ */
+ss::future<compaction_result> sliding_window_compact(
+  std::vector<ss::lw_shared_ptr<segment>>,
+  storage::compaction_config,
+  storage::probe&,
+  storage::readers_cache&,
+  storage::storage_resources&,
+  mutex& segment_rewrite_lock);
+
 /*
  * Concatentate segments into a minimal new segment.
  *
@@ -109,6 +130,16 @@ ss::future<compacted_index_writer> make_compacted_index_writer(
   ss::io_priority_class iopc,
   storage_resources& resources);
 
+/// \brief key filter of the compacted index of the segment, std::nullopt if
+/// there is none or it was written for a previous version of the index. The
+/// caller must hold a lock on the segment.
+ss::future<std::optional<key_bloom_filter>> load_key_filter(
+  const segment&, ss::io_priority_class, debug_sanitize_files);
+
+/// \brief renames a compacted index along with its key filter
+ss::future<>
+rename_compacted_index(std::filesystem::path from, std::filesystem::path to);
+
 ss::future<segment_appender_ptr> make_segment_appender(
   const segment_full_path& path,
   storage::debug_sanitize_files debug,
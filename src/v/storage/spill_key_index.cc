@@ -10,10 +10,13 @@
 #include "storage/spill_key_index.h"
 
 #include "bytes/bytes.h"
+#include "bytes/iostream.h"
 #include "random/generators.h"
 #include "reflection/adl.h"
+#include "serde/serde.h"
 #include "storage/compacted_index.h"
 #include "storage/compacted_index_writer.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/logger.h"
 #include "storage/segment_utils.h"
 #include "utils/vint.h"
@@ -22,6 +25,7 @@
 
 #include <seastar/core/coroutine.hh>
 #include <seastar/core/file.hh>
+#include <seastar/core/fstream.hh>
 #include <seastar/core/future-util.hh>
 
 #include <fmt/ostream.h>
@@ -43,7 +47,8 @@ spill_key_index::spill_key_index(
   , _debug(debug)
   , _resources(resources)
   , _pc(p)
-  , _truncate(truncate) {}
+  , _truncate(truncate)
+  , _write_key_filter(true) {}
 
 /**
  * This constructor is only for unit tests, which pre-construct a ss::file
@@ -213,6 +218,10 @@ ss::future<> spill_key_index::spill(
         size_t key_size = std::min(max_key_size, b.size());
 
         payload.append(b.data(), key_size);
+        if (type == compacted_index::entry_type::key) {
+            // readers of the index see the truncated key
+            _key_filter.add(key_bloom_filter::hash(b.substr(0, key_size)));
+        }
     }
     const size_t size = payload.size_bytes() - size_reservation;
     const size_t size_le = ss::cpu_to_le(size); // downcast
@@ -341,6 +350,35 @@ ss::future<> spill_key_index::close() {
 
         throw ex;
     }
+
+    if (_write_key_filter) {
+        co_await write_key_filter();
+    }
+}
+
+ss::future<> spill_key_index::write_key_filter() {
+    auto path = key_filter_path(std::filesystem::path(filename()));
+    auto buf = serde::to_iobuf(key_filter_file{
+      .index_size = _footer.size,
+      .index_keys = _footer.keys,
+      .index_crc = _footer.crc,
+      .filter = std::exchange(_key_filter, {})});
+    std::optional<ss::output_stream<char>> out;
+    try {
+        auto f = co_await make_writer_handle(path, _debug, true);
+        out = co_await ss::make_file_output_stream(std::move(f));
+        co_await write_iobuf_to_output_stream(std::move(buf), *out);
+    } catch (...) {
+        // the filter is optional, readers ignore a partially written one
+        vlog(
+          stlog.warn,
+          "error writing key filter {}: {}",
+          path,
+          std::current_exception());
+    }
+    if (out) {
+        co_await out->close().handle_exception([](std::exception_ptr) {});
+    }
 }
 
 void spill_key_index::print(std::ostream& o) const { o << *this; }
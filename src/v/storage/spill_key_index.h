@@ -18,6 +18,7 @@
 #include "ssx/semaphore.h"
 #include "storage/compacted_index.h"
 #include "storage/compacted_index_writer.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/segment_appender.h"
 #include "storage/storage_resources.h"
 #include "storage/types.h"
@@ -112,6 +113,7 @@ private:
     ss::future<> drain_all_keys();
     ss::future<> add_key(compaction_key, value_type);
     ss::future<> spill(compacted_index::entry_type, bytes_view, value_type);
+    ss::future<> write_key_filter();
 
     storage::debug_sanitize_files _debug;
     storage_resources& _resources;
@@ -131,6 +133,9 @@ private:
     size_t _keys_mem_usage{0};
     compacted_index::footer _footer;
     crc::crc32c _crc;
+    // filter of the keys written to the index, stored next to it on close
+    key_bloom_filter _key_filter;
+    bool _write_key_filter{false};
     ss::gate _gate;
 
     friend std::ostream& operator<<(std::ostream&, const spill_key_index&);
@@ -31,10 +31,24 @@ storage_resources::storage_resources(
   , _configuration_manager_dirty_bytes(_target_replay_bytes() / ss::smp::count)
   , _stm_dirty_bytes(_target_replay_bytes() / ss::smp::count)
   , _compaction_index_bytes(_compaction_index_mem_limit())
+  , _compaction_key_map_mem_limit(
+      config::shard_local_cfg().storage_compaction_key_map_memory.bind())
+  , _compaction_max_concurrency(
+      config::shard_local_cfg().log_compaction_max_concurrency.bind())
+  , _compaction_key_map_bytes(
+      _compaction_key_map_mem_limit(), "s/compaction-key-map")
   , _inflight_recovery(
       std::max(_max_concurrent_replay() / ss::smp::count, uint64_t{1}))
   , _inflight_close_flush(
-      std::max(_max_concurrent_replay() / ss::smp::count, uint64_t{1})) {
+      std::max(_max_concurrent_replay() / ss::smp::count, uint64_t{1}))
+  , _resident_indexes(
+      config::shard_local_cfg().storage_segment_index_memory.bind())
+  , _tail_streams(config::shard_local_cfg().storage_tail_stream_bytes.bind())
+  , _flushes(config::shard_local_cfg().storage_flush_coalesce_window_ms.bind())
+  , _reader_handles(config::shard_local_cfg().storage_reader_fd_budget.bind())
+  , _read_ahead_mem_limit(
+      config::shard_local_cfg().storage_read_ahead_memory.bind())
+  , _read_ahead_bytes(_read_ahead_mem_limit()) {
     // Register notifications on configuration changes
     _target_replay_bytes.watch([this]() {
         auto v = _target_replay_bytes() / ss::smp::count;
@@ -59,6 +73,14 @@ storage_resources::storage_resources(
     _compaction_index_mem_limit.watch([this] {
         _compaction_index_bytes.set_capacity(_compaction_index_mem_limit());
     });
+
+    _compaction_key_map_mem_limit.watch([this] {
+        _compaction_key_map_bytes.set_capacity(_compaction_key_map_mem_limit());
+    });
+
+    _read_ahead_mem_limit.watch([this] {
+        _read_ahead_bytes.set_capacity(_read_ahead_mem_limit());
+    });
 }
 
 // Unit test convenience for tests that want to control the falloc step
@@ -240,4 +262,21 @@ storage_resources::compaction_index_take_bytes(size_t bytes) {
     return _compaction_index_bytes.take(bytes);
 }
 
+ss::future<ssx::semaphore_units>
+storage_resources::compaction_key_map_get_bytes() {
+    // the share is taken from the current values, passes started before a
+    // change keep their share until they finish
+    const size_t share = _compaction_key_map_mem_limit()
+                         / std::max<uint16_t>(_compaction_max_concurrency(), 1);
+    return _compaction_key_map_bytes.get_units(std::max<size_t>(share, 1));
+}
+
+std::optional<ssx::semaphore_units>
+storage_resources::read_ahead_try_take_bytes(size_t bytes) {
+    if (_read_ahead_bytes.available_units() < static_cast<ssize_t>(bytes)) {
+        return std::nullopt;
+    }
+    return _read_ahead_bytes.take(bytes).units;
+}
+
 } // namespace storage
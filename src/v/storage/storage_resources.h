@@ -12,6 +12,11 @@
 #pragma once
 
 #include "config/property.h"
+#include "storage/flush_coordinator.h"
+#include "storage/reader_handle_cache.h"
+#include "storage/recovery_admission.h"
+#include "storage/resident_index_tracker.h"
+#include "storage/tail_stream.h"
 #include "ssx/semaphore.h"
 #include "units.h"
 #include "utils/adjustable_semaphore.h"
@@ -71,14 +76,41 @@ public:
         return _compaction_index_bytes.current() > 0;
     }
 
-    ss::future<ssx::semaphore_units> get_recovery_units() {
-        return _inflight_recovery.get_units(1);
+    /**
+     * Blocks until the key map of a sliding window compaction pass may use
+     * its share of the shard's key map memory. Every pass gets the same
+     * share so that as many passes as logs compacted concurrently fit.
+     */
+    ss::future<ssx::semaphore_units> compaction_key_map_get_bytes();
+
+    ss::future<recovery_admission::units>
+    get_recovery_units(recovery_priority p = recovery_priority::normal) {
+        return _inflight_recovery.get_units(p);
     }
 
     ss::future<ssx::semaphore_units> get_close_flush_units() {
         return _inflight_close_flush.get_units(1);
     }
 
+    ss::future<ssx::semaphore_units> get_artifact_refresh_units() {
+        return ss::get_units(_inflight_artifact_refresh, 1);
+    }
+
+    resident_index_tracker& resident_indexes() { return _resident_indexes; }
+
+    tail_stream_tracker& tail_streams() { return _tail_streams; }
+
+    flush_coordinator& flushes() { return _flushes; }
+
+    reader_handle_cache& reader_handles() { return _reader_handles; }
+
+    /**
+     * Non-blocking: takes bytes for the read buffers of a sequential reader
+     * if the shard's budget has them available, otherwise returns nothing and
+     * the reader keeps its current buffers.
+     */
+    std::optional<ssx::semaphore_units> read_ahead_try_take_bytes(size_t);
+
     /**
      * An adjustable_semaphore will set checkpoint_hint whenever its units
      * are exhausted, but this can happen with pathological frequency if
@@ -140,13 +172,41 @@ private:
     // use for their spill_key_index objects
     adjustable_semaphore _compaction_index_bytes{0};
 
+    // How much memory may the key maps of sliding window compaction use?
+    config::binding<size_t> _compaction_key_map_mem_limit;
+    config::binding<uint16_t> _compaction_max_concurrency;
+    adjustable_semaphore _compaction_key_map_bytes;
+
     // How many logs may be recovered (via log_manager::manage)
-    // concurrently?
-    adjustable_semaphore _inflight_recovery{0};
+    // concurrently? Logs are admitted in priority order.
+    recovery_admission _inflight_recovery{0};
 
     // How many logs may be flushed during segment close concurrently?
     // (e.g. when we shut down and ask everyone to flush)
     adjustable_semaphore _inflight_close_flush{0};
+
+    // How many segments may have the sizes of their index files looked up
+    // concurrently? (e.g. for all segments of all logs during startup)
+    static constexpr size_t max_concurrent_artifact_refresh = 16;
+    ssx::semaphore _inflight_artifact_refresh{
+      max_concurrent_artifact_refresh, "s/artifact-refresh"};
+
+    // How much memory may the indexes of closed segments use?
+    resident_index_tracker _resident_indexes;
+
+    // How much memory may the tail streams of the logs on this shard use?
+    tail_stream_tracker _tail_streams;
+
+    // Coalesces the flushes of all segment appenders on this shard
+    flush_coordinator _flushes;
+
+    // How many segment files may be kept open for reading?
+    reader_handle_cache _reader_handles;
+
+    // How much memory may the grown read buffers of sequential log readers
+    // use?
+    config::binding<size_t> _read_ahead_mem_limit;
+    adjustable_semaphore _read_ahead_bytes;
 };
 
 } // namespace storage
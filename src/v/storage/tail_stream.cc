@@ -0,0 +1,181 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "storage/tail_stream.h"
+
+#include "storage/logger.h"
+#include "vlog.h"
+
+#include <algorithm>
+
+namespace storage {
+
+tail_stream::~tail_stream() noexcept { clear(); }
+
+void tail_stream::append(model::record_batch& batch) {
+    if (
+      !_tracker || _tracker->budget() == 0
+      || ++_appends_since_shared_read > idle_appends) {
+        _shared = false;
+    }
+    if (!_shared) {
+        clear();
+        return;
+    }
+    // the buffers are shared with the appended batch, not copied
+    auto shared = batch.share();
+    const auto bytes = shared.memory_usage();
+    _bytes += bytes;
+    _batches.push_back(std::move(shared));
+    _tracker->charge(*this, bytes);
+}
+
+void tail_stream::pop_front() {
+    const auto bytes = _batches.front().memory_usage();
+    _bytes -= bytes;
+    _batches.pop_front();
+    if (_tracker) {
+        _tracker->release(*this, bytes);
+    }
+}
+
+void tail_stream::pop_back() {
+    const auto bytes = _batches.back().memory_usage();
+    _bytes -= bytes;
+    _batches.pop_back();
+    if (_tracker) {
+        _tracker->release(*this, bytes);
+    }
+}
+
+void tail_stream::truncate(model::offset offset) {
+    while (!_batches.empty() && _batches.back().last_offset() >= offset) {
+        pop_back();
+    }
+    // offsets past the truncation point will be appended and read again
+    if (_max_read_start && *_max_read_start >= offset) {
+        _max_read_start = std::nullopt;
+    }
+}
+
+void tail_stream::prefix_truncate(model::offset offset) {
+    while (!_batches.empty() && _batches.front().last_offset() < offset) {
+        pop_front();
+    }
+}
+
+void tail_stream::clear() {
+    while (!_batches.empty()) {
+        pop_back();
+    }
+}
+
+std::optional<model::record_batch_reader> tail_stream::read(
+  const log_reader_config& cfg,
+  model::offset tail_start,
+  model::offset dirty_offset,
+  probe& pb) {
+    // a second reader of the same batches of the active segment. Readers
+    // advance past the batches they got, so a read that can return batches
+    // starting at or before an earlier one comes from another reader. Reads
+    // of offsets that aren't visible yet return nothing, a reader polling for
+    // them reads the same offset over and over.
+    const auto readable_end = std::min(cfg.max_offset, dirty_offset);
+    if (cfg.start_offset >= tail_start && cfg.start_offset <= readable_end) {
+        if (_max_read_start && cfg.start_offset <= *_max_read_start) {
+            _shared = true;
+            _appends_since_shared_read = 0;
+        }
+        _max_read_start = std::max(
+          _max_read_start.value_or(cfg.start_offset), cfg.start_offset);
+    }
+    if (
+      _batches.empty() || _batches.back().last_offset() != dirty_offset
+      || cfg.start_offset < _batches.front().base_offset()) {
+        return std::nullopt;
+    }
+
+    model::record_batch_reader::data_t ret;
+    auto it = std::lower_bound(
+      _batches.begin(),
+      _batches.end(),
+      cfg.start_offset,
+      [](const model::record_batch& b, model::offset o) {
+          return b.last_offset() < o;
+      });
+    // same accounting as the log reader: the first batch is returned even if
+    // it is larger than max_bytes unless the limit is strict
+    size_t bytes_consumed = 0;
+    for (; it != _batches.end(); ++it) {
+        if (it->base_offset() > cfg.max_offset) {
+            break;
+        }
+        const auto& header = it->header();
+        if (cfg.type_filter && header.type != *cfg.type_filter) {
+            continue;
+        }
+        if (
+          cfg.first_timestamp
+          && header.max_timestamp < *cfg.first_timestamp) {
+            continue;
+        }
+        const auto size = static_cast<size_t>(it->size_bytes());
+        if (
+          (cfg.strict_max_bytes || bytes_consumed > 0)
+          && bytes_consumed + size > cfg.max_bytes) {
+            break;
+        }
+        bytes_consumed += size;
+        ret.push_back(it->share());
+        if (bytes_consumed >= cfg.max_bytes) {
+            break;
+        }
+    }
+    pb.tail_stream_read(ret.size());
+    return model::make_memory_record_batch_reader(std::move(ret));
+}
+
+tail_stream_tracker::tail_stream_tracker(config::binding<size_t> budget)
+  : _budget(std::move(budget)) {
+    _budget.watch([this] { maybe_evict(); });
+}
+
+tail_stream_tracker::~tail_stream_tracker() noexcept {
+    // streams outliving the tracker must not call back into it
+    for (auto& s : _lru) {
+        s._tracker = nullptr;
+    }
+    _lru.clear();
+}
+
+void tail_stream_tracker::charge(tail_stream& s, size_t bytes) {
+    if (s._hook.is_linked()) {
+        s._hook.unlink();
+    }
+    _lru.push_back(s);
+    _bytes += bytes;
+    maybe_evict();
+}
+
+void tail_stream_tracker::release(tail_stream& s, size_t bytes) {
+    _bytes -= bytes;
+    if (s._batches.empty() && s._hook.is_linked()) {
+        s._hook.unlink();
+    }
+}
+
+void tail_stream_tracker::maybe_evict() {
+    while (_bytes > _budget() && !_lru.empty()) {
+        // unlinks the stream once it is empty
+        _lru.front().pop_front();
+        ++_evictions;
+    }
+}
+
+} // namespace storage
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "config/property.h"
+#include "model/fundamental.h"
+#include "model/record.h"
+#include "model/record_batch_reader.h"
+#include "storage/probe.h"
+#include "storage/types.h"
+#include "utils/intrusive_list_helpers.h"
+
+#include <deque>
+#include <optional>
+
+namespace storage {
+
+class tail_stream_tracker;
+
+/**
+ * The most recently appended batches of a log.
+ *
+ * When many consumers tail the same partition every fetch would otherwise
+ * create or reuse its own log reader, look the batches up in the batch cache
+ * and copy them out of it. Once a batch of the active segment is read by a
+ * second reader, i.e. several readers follow the tail, the stream starts to
+ * keep the appended batches, sharing their buffers with the appender rather
+ * than copying them, and hands out shared batches to every reader starting
+ * within it. The stream stops holding batches again when no batch was read by
+ * a second reader over `idle_appends` appends.
+ *
+ * The stream always holds a suffix of the active segment and is cut whenever
+ * the log is truncated. The memory of the streams of a shard is bounded by
+ * the tail_stream_tracker, which drops the oldest batches of the least
+ * recently appended streams first. Readers starting before the first batch of
+ * a stream are served by log readers as usual.
+ */
+class tail_stream {
+public:
+    static constexpr size_t idle_appends = 1024;
+
+    tail_stream() = default;
+    tail_stream(const tail_stream&) = delete;
+    tail_stream& operator=(const tail_stream&) = delete;
+    ~tail_stream() noexcept;
+
+    void set_tracker(tail_stream_tracker* t) { _tracker = t; }
+
+    /// \brief a batch was appended to the log
+    void append(model::record_batch&);
+
+    /// \brief the batches at and after `offset` were truncated from the log
+    void truncate(model::offset offset);
+
+    /// \brief the batches before `offset` are no longer readable
+    void prefix_truncate(model::offset offset);
+
+    void clear();
+
+    /// \brief reader of the batches matching `cfg`, std::nullopt when the
+    /// stream doesn't hold `cfg.start_offset`. `tail_start` is the base offset
+    /// of the active segment and `dirty_offset` the last offset of the log,
+    /// the stream is only read when it ends at it.
+    std::optional<model::record_batch_reader> read(
+      const log_reader_config& cfg,
+      model::offset tail_start,
+      model::offset dirty_offset,
+      probe&);
+
+    bool empty() const { return _batches.empty(); }
+    bool is_shared() const { return _shared; }
+    size_t size_bytes() const { return _bytes; }
+    size_t batches() const { return _batches.size(); }
+
+private:
+    void pop_front();
+    void pop_back();
+
+    std::deque<model::record_batch> _batches;
+    size_t _bytes{0};
+
+    // a batch of the active segment was read by more than one reader
+    // recently
+    bool _shared{false};
+    size_t _appends_since_shared_read{0};
+    // highest start offset of the reads that could return batches of the
+    // active segment
+    std::optional<model::offset> _max_read_start;
+
+    tail_stream_tracker* _tracker{nullptr};
+    intrusive_list_hook _hook;
+
+    friend class tail_stream_tracker;
+};
+
+/**
+ * Keeps the batches held by the tail streams of a shard within a memory
+ * budget. Streams are kept in the order of their appends, once the budget is
+ * exceeded the oldest batches of the least recently appended streams are
+ * dropped.
+ */
+class tail_stream_tracker {
+public:
+    explicit tail_stream_tracker(config::binding<size_t> budget);
+    tail_stream_tracker(const tail_stream_tracker&) = delete;
+    tail_stream_tracker& operator=(const tail_stream_tracker&) = delete;
+    ~tail_stream_tracker() noexcept;
+
+    size_t budget() const { return _budget(); }
+    size_t bytes() const { return _bytes; }
+    uint64_t evictions() const { return _evictions; }
+
+private:
+    /// \brief the stream appended a batch of `bytes`
+    void charge(tail_stream&, size_t bytes);
+    /// \brief the stream dropped a batch of `bytes`
+    void release(tail_stream&, size_t bytes);
+    void maybe_evict();
+
+    config::binding<size_t> _budget;
+    intrusive_list<tail_stream, &tail_stream::_hook> _lru;
+    size_t _bytes{0};
+    uint64_t _evictions{0};
+
+    friend class tail_stream;
+};
+
+} // namespace storage
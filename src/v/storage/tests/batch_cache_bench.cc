@@ -0,0 +1,102 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/fundamental.h"
+#include "model/tests/random_batch.h"
+#include "storage/batch_cache.h"
+#include "units.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <vector>
+
+/**
+ * Replays a mixed workload against the batch cache: a set of partitions is
+ * appended to and tailed by real-time consumers which re-read a small window of
+ * recent batches, while a catch-up consumer scans a large backlog of another
+ * partition. The cache is kept within a fixed memory budget by explicit
+ * reclaims. Every put and tail read counts as an operation, so perf_tests
+ * reports the time per cache operation.
+ */
+struct mixed_workload {
+    static constexpr size_t tail_partitions = 16;
+    static constexpr size_t steps = 256;
+    static constexpr size_t backfill_per_step = 16;
+    static constexpr size_t tail_window = 8;
+    static constexpr size_t memory_budget = 4_MiB;
+
+    mixed_workload()
+      : cache(storage::batch_cache::reclaim_options{
+        .growth_window = std::chrono::milliseconds(0),
+        .stable_window = std::chrono::milliseconds(0),
+        .min_size = 32_KiB,
+        .max_size = 256_KiB,
+        .min_free_memory = 0}) {
+        for (size_t p = 0; p < tail_partitions; ++p) {
+            auto& batches = tail_batches.emplace_back();
+            for (size_t o = 0; o < steps; ++o) {
+                batches.push_back(model::test::make_random_batch(
+                  model::offset(o), 4, false));
+            }
+        }
+        for (size_t o = 0; o < steps * backfill_per_step; ++o) {
+            backlog.push_back(
+              model::test::make_random_batch(model::offset(o), 4, false));
+        }
+    }
+
+    ~mixed_workload() { cache.stop().get(); }
+
+    size_t replay(storage::batch_cache::is_historical historical) {
+        std::vector<std::unique_ptr<storage::batch_cache_index>> tail;
+        for (size_t p = 0; p < tail_partitions; ++p) {
+            tail.push_back(std::make_unique<storage::batch_cache_index>(cache));
+        }
+        auto cold = std::make_unique<storage::batch_cache_index>(cache);
+
+        size_t ops = 0;
+        perf_tests::start_measuring_time();
+        for (size_t step = 0; step < steps; ++step) {
+            for (size_t p = 0; p < tail_partitions; ++p) {
+                tail[p]->put(tail_batches[p][step]);
+                ++ops;
+                // consumers lagging at most a few batches behind the tail
+                auto from = step >= tail_window ? step - tail_window : 0;
+                for (size_t o = from; o <= step; ++o) {
+                    perf_tests::do_not_optimize(tail[p]->get(model::offset(o)));
+                    ++ops;
+                }
+            }
+            for (size_t i = 0; i < backfill_per_step; ++i) {
+                cold->put(backlog[step * backfill_per_step + i], historical);
+                ++ops;
+            }
+            if (cache.size_bytes() > memory_budget) {
+                cache.reclaim(cache.size_bytes() - memory_budget);
+            }
+        }
+        perf_tests::stop_measuring_time();
+
+        cold.reset();
+        tail.clear();
+        return ops;
+    }
+
+    storage::batch_cache cache;
+    std::vector<std::vector<model::record_batch>> tail_batches;
+    std::vector<model::record_batch> backlog;
+};
+
+PERF_TEST_F(mixed_workload, backlog_normal) {
+    return replay(storage::batch_cache::is_historical::no);
+}
+
+PERF_TEST_F(mixed_workload, backlog_historical) {
+    return replay(storage::batch_cache::is_historical::yes);
+}
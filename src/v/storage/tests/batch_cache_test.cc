@@ -45,7 +45,8 @@ public:
     batch_cache_test_fixture()
       : cache(opts) {}
 
-    auto& get_lru() { return cache._lru; };
+    auto& get_probation_lru() { return cache._probation_lru; };
+    auto& get_protected_lru() { return cache._protected_lru; };
     ~batch_cache_test_fixture() { cache.stop().get(); }
 
     storage::batch_cache cache;
@@ -291,19 +292,75 @@ FIXTURE_TEST(test_random_batch_sizes, batch_cache_test_fixture) {
         batches.push_back(std::move(batch));
     }
 
+    double max_waste = ((double)storage::batch_cache::range::max_waste_bytes
+                        / storage::batch_cache::range::range_size)
+                       * 100.0;
+
+    // assert waste before reads reorder the ranges, we have to skip last range
+    for (auto& r : boost::make_iterator_range(
+           get_probation_lru().begin(),
+           std::prev(get_probation_lru().end()))) {
+        BOOST_REQUIRE_LE(r.waste(), max_waste);
+    }
+
     for (auto& b : batches) {
         auto from_cache = index.get(b.base_offset());
         BOOST_REQUIRE(from_cache.has_value());
         BOOST_REQUIRE_EQUAL(from_cache->header(), b.header());
         BOOST_REQUIRE_EQUAL(from_cache->data(), b.data());
     }
-    double max_waste = ((double)storage::batch_cache::range::max_waste_bytes
-                        / storage::batch_cache::range::range_size)
-                       * 100.0;
+}
 
-    // assert waste, we have to skip last range
-    for (auto& r : boost::make_iterator_range(
-           get_lru().begin(), std::prev(get_lru().end()))) {
-        BOOST_REQUIRE_LE(r.waste(), max_waste);
+FIXTURE_TEST(scan_does_not_evict_protected, batch_cache_test_fixture) {
+    storage::batch_cache_index hot(cache);
+    storage::batch_cache_index cold(cache);
+
+    auto scan = [&cold](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            cold.put(make_random_batch(40_KiB, model::offset(i)));
+        }
+    };
+
+    // hot tail batch, hit after being admitted so that it is promoted
+    hot.put(make_random_batch(40_KiB, model::offset(0)));
+    scan(0, 20);
+    BOOST_REQUIRE(hot.get(model::offset(0)));
+    BOOST_REQUIRE(!get_protected_lru().empty());
+
+    // scan of a backlog that is read only once
+    scan(20, 40);
+    BOOST_REQUIRE_LE(
+      cache.protected_size_bytes(),
+      cache.size_bytes() * storage::batch_cache::protected_ratio);
+
+    // reclaiming the size of the scan leaves the hot batch in place
+    cache.reclaim(cache.size_bytes() - cache.protected_size_bytes());
+    BOOST_REQUIRE(hot.get(model::offset(0)));
+    for (int i = 0; i < 40; ++i) {
+        BOOST_REQUIRE(!cold.get(model::offset(i)));
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(historical_admitted_at_head) {
+    static storage::batch_cache::reclaim_options opts = {
+      .growth_window = std::chrono::milliseconds(3000),
+      .stable_window = std::chrono::milliseconds(10000),
+      .min_size = 1,
+      .max_size = 1,
+    };
+    std::unique_ptr<storage::batch_cache_index> index;
+    storage::batch_cache cache(opts);
+    index = std::make_unique<storage::batch_cache_index>(cache);
+
+    auto tail = cache.put(*index, make_random_batch(40_KiB, model::offset(0)));
+    auto historical = cache.put(
+      *index,
+      make_random_batch(40_KiB, model::offset(1)),
+      storage::batch_cache::is_historical::yes);
+
+    // the historical range is the first one to be reclaimed
+    cache.reclaim(1);
+    BOOST_REQUIRE(tail.range());
+    BOOST_REQUIRE(!historical.range());
+    cache.stop().get();
+}
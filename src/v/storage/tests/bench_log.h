@@ -0,0 +1,81 @@
+/*
+ * Copyright 2022 Redpanda Data, Inc.
+ *
+ * Use of this software is governed by the Business Source License
+ * included in the file licenses/BSL.md
+ *
+ * As of the Change Date specified in that file, in accordance with
+ * the Business Source License, use of this software will be governed
+ * by the Apache License, Version 2.0
+ */
+
+#pragma once
+
+#include "model/fundamental.h"
+#include "model/record.h"
+#include "model/tests/random_batch.h"
+#include "storage/tests/utils/disk_log_builder.h"
+#include "units.h"
+
+#include <vector>
+
+namespace storage {
+
+/// Shape of the log a storage benchmark reads from: `segments` segments of
+/// `batches_per_segment` uncompressed batches of `records_per_batch` records
+/// of `record_size` bytes each.
+struct bench_log_spec {
+    size_t segments{1};
+    size_t batches_per_segment{0};
+    int records_per_batch{1};
+    size_t record_size{0};
+};
+
+/// Log config of the benchmark logs: segments are rolled explicitly by
+/// build_bench_log, so they are sized not to roll on their own.
+inline log_config bench_log_config() {
+    return log_config(
+      log_config::storage_type::disk,
+      random_dir(),
+      1_GiB,
+      debug_sanitize_files::no);
+}
+
+/// Writes the log described by `spec` from offset 0 into a started `builder`
+/// and flushes it. Every batch is passed to `adjust` before it is appended,
+/// e.g. to rewrite its timestamps. Returns the offset following the last
+/// batch.
+template<typename Adjust>
+model::offset build_bench_log(
+  disk_log_builder& builder, const bench_log_spec& spec, Adjust adjust) {
+    model::offset o{0};
+    for (size_t s = 0; s < spec.segments; ++s) {
+        builder | add_segment(o);
+        for (size_t b = 0; b < spec.batches_per_segment; ++b) {
+            auto batch = model::test::make_random_batch(
+              model::test::record_batch_spec{
+                .offset = o,
+                .allow_compression = false,
+                .count = spec.records_per_batch,
+                .record_sizes = std::vector<size_t>(
+                  spec.records_per_batch, spec.record_size)});
+            adjust(batch);
+            builder
+              .add_batch(
+                std::move(batch),
+                append_config(),
+                disk_log_builder::should_flush_after::no)
+              .get();
+            o += model::offset(spec.records_per_batch);
+        }
+    }
+    builder.get_log().flush().get();
+    return o;
+}
+
+inline model::offset
+build_bench_log(disk_log_builder& builder, const bench_log_spec& spec) {
+    return build_bench_log(builder, spec, [](model::record_batch&) {});
+}
+
+} // namespace storage
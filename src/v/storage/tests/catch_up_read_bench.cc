@@ -0,0 +1,65 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "model/record_batch_reader.h"
+#include "storage/tests/bench_log.h"
+#include "units.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+/**
+ * Reads a 64MiB backlog spread over 8 segments from its start, as a catch-up
+ * consumer or a recovering follower does. The backlog is read once with the
+ * configured read buffers and read ahead for every read and once with
+ * adaptive read ahead. Every run counts the bytes read, so the time perf_tests
+ * reports is the time per byte.
+ */
+struct catch_up_read_bench {
+    catch_up_read_bench()
+      : builder(storage::bench_log_config()) {
+        builder | storage::start();
+        storage::build_bench_log(
+          builder,
+          {.segments = 8,
+           .batches_per_segment = 128,
+           .records_per_batch = 16,
+           .record_size = 4_KiB});
+    }
+
+    ~catch_up_read_bench() {
+        config::shard_local_cfg().storage_adaptive_read_ahead.reset();
+        builder | storage::stop();
+    }
+
+    size_t read_backlog(bool adaptive) {
+        config::shard_local_cfg().storage_adaptive_read_ahead.set_value(
+          adaptive);
+        auto cfg = storage::reader_config();
+        // read from disk, the batches just written are still in the cache
+        cfg.skip_batch_cache = true;
+
+        perf_tests::start_measuring_time();
+        auto batches = builder.consume(cfg).get0();
+        perf_tests::stop_measuring_time();
+        size_t bytes = 0;
+        for (const auto& b : batches) {
+            bytes += b.size_bytes();
+        }
+        return bytes;
+    }
+
+    storage::disk_log_builder builder;
+};
+
+PERF_TEST_F(catch_up_read_bench, catch_up_fixed) { return read_backlog(false); }
+
+PERF_TEST_F(catch_up_read_bench, catch_up_adaptive) {
+    return read_backlog(true);
+}
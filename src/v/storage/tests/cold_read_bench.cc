@@ -0,0 +1,47 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/record_batch_reader.h"
+#include "storage/tests/bench_log.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+/**
+ * Reads a segment of small batches from disk, bypassing the batch cache. The
+ * batches are sliced out of the read buffers of the segment, so the
+ * allocations per batch read, which perf_tests reports for every batch
+ * returned, should not depend on the size of the batches.
+ */
+struct cold_read_bench {
+    cold_read_bench()
+      : builder(storage::bench_log_config()) {
+        builder | storage::start();
+        storage::build_bench_log(
+          builder,
+          {.batches_per_segment = 4096,
+           .records_per_batch = 4,
+           .record_size = 64});
+    }
+
+    ~cold_read_bench() { builder | storage::stop(); }
+
+    size_t read_all() {
+        auto cfg = storage::reader_config();
+        cfg.skip_batch_cache = true;
+
+        perf_tests::start_measuring_time();
+        auto read = builder.consume(cfg).get0();
+        perf_tests::stop_measuring_time();
+        return read.size();
+    }
+
+    storage::disk_log_builder builder;
+};
+
+PERF_TEST_F(cold_read_bench, cold_read) { return read_all(); }
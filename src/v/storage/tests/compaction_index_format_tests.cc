@@ -9,20 +9,26 @@
 
 #include "bytes/bytes.h"
 #include "bytes/iobuf_parser.h"
+#include "config/configuration.h"
 #include "random/generators.h"
 #include "reflection/adl.h"
+#include "serde/serde.h"
 #include "storage/compacted_index.h"
 #include "storage/compacted_index_reader.h"
 #include "storage/compacted_index_writer.h"
 #include "storage/compaction_reducers.h"
 #include "storage/fs_utils.h"
+#include "storage/key_bloom_filter.h"
 #include "storage/segment_utils.h"
 #include "storage/spill_key_index.h"
+#include "storage/storage_resources.h"
 #include "test_utils/fixture.h"
 #include "units.h"
 #include "utils/tmpbuf_file.h"
 #include "utils/vint.h"
 
+#include <seastar/util/defer.hh>
+
 #include <boost/test/unit_test_suite.hpp>
 
 storage::compacted_index_writer make_dummy_compacted_index(
@@ -300,6 +306,135 @@ FIXTURE_TEST(key_reducer_max_mem, compacted_topic_fixture) {
     BOOST_REQUIRE(exact_mem_bitmap.contains(98));
     BOOST_REQUIRE(exact_mem_bitmap.contains(99));
 }
+FIXTURE_TEST(key_offset_map_sliding_window, compacted_topic_fixture) {
+    // two segments, the older one alternates between two keys and the newer
+    // one only updates the first key
+    tmpbuf_file::store_t older_data;
+    tmpbuf_file::store_t newer_data;
+    auto older = make_dummy_compacted_index(older_data, 1_KiB, resources);
+    auto newer = make_dummy_compacted_index(newer_data, 1_KiB, resources);
+
+    const auto key1 = random_generators::get_bytes(64);
+    const auto key2 = random_generators::get_bytes(64);
+    const auto bt = model::record_batch_type::raft_data;
+    for (auto i = 0; i < 10; ++i) {
+        older.index(bt, bytes(i % 2 ? key1 : key2), model::offset(i), 0).get();
+        newer.index(bt, bytes(key1), model::offset(10 + i), 0).get();
+    }
+    older.close().get();
+    newer.close().get();
+
+    auto make_reader = [](tmpbuf_file::store_t& data) {
+        return storage::make_file_backed_compacted_reader(
+          storage::segment_full_path::mock("dummy name"),
+          ss::file(ss::make_shared(tmpbuf_file(data))),
+          ss::default_priority_class(),
+          32_KiB);
+    };
+
+    storage::internal::key_offset_map map;
+    for (auto* data : {&newer_data, &older_data}) {
+        auto complete = make_reader(*data)
+                          .consume(
+                            storage::internal::key_offset_map_reducer(map),
+                            model::no_timeout)
+                          .get0();
+        BOOST_REQUIRE(complete);
+    }
+    BOOST_REQUIRE_EQUAL(map.size(), 2);
+    BOOST_REQUIRE_EQUAL(map.get(key1), model::offset(19));
+    BOOST_REQUIRE_EQUAL(map.get(key2), model::offset(8));
+
+    auto filtered = make_reader(older_data)
+                      .consume(
+                        storage::internal::key_offset_map_filter_reducer(
+                          map, model::offset(0)),
+                        model::no_timeout)
+                      .get0();
+    BOOST_REQUIRE_EQUAL(filtered.removed, 9);
+    BOOST_REQUIRE_EQUAL(filtered.to_keep.cardinality(), 1);
+    BOOST_REQUIRE(filtered.to_keep.contains(8));
+    BOOST_REQUIRE(filtered.list.contains(model::offset(8)));
+    BOOST_REQUIRE(!filtered.list.contains(model::offset(9)));
+
+    // a map too small for both keys only knows about the newest one, the
+    // records of the other key must be kept
+    storage::internal::key_offset_map newest_only;
+    auto complete = make_reader(newer_data)
+                      .consume(
+                        storage::internal::key_offset_map_reducer(newest_only),
+                        model::no_timeout)
+                      .get0();
+    BOOST_REQUIRE(complete);
+    storage::internal::key_offset_map small_map(
+      newest_only.mem_usage() + key2.size());
+    complete = make_reader(newer_data)
+                 .consume(
+                   storage::internal::key_offset_map_reducer(small_map),
+                   model::no_timeout)
+                 .get0();
+    BOOST_REQUIRE(complete);
+    complete = make_reader(older_data)
+                 .consume(
+                   storage::internal::key_offset_map_reducer(small_map),
+                   model::no_timeout)
+                 .get0();
+    BOOST_REQUIRE(!complete);
+    BOOST_REQUIRE(small_map.full());
+    BOOST_REQUIRE(!small_map.get(key2));
+
+    filtered = make_reader(older_data)
+                 .consume(
+                   storage::internal::key_offset_map_filter_reducer(
+                     small_map, model::offset(0)),
+                   model::no_timeout)
+                 .get0();
+    BOOST_REQUIRE_EQUAL(filtered.removed, 5);
+    BOOST_REQUIRE_EQUAL(filtered.to_keep.cardinality(), 5);
+}
+
+FIXTURE_TEST(key_offset_map_memory_share, compacted_topic_fixture) {
+    auto reset_cfg = ss::defer([] {
+        config::shard_local_cfg().storage_compaction_key_map_memory.reset();
+        config::shard_local_cfg().log_compaction_max_concurrency.reset();
+    });
+    config::shard_local_cfg().storage_compaction_key_map_memory.set_value(
+      size_t(64_MiB));
+    config::shard_local_cfg().log_compaction_max_concurrency.set_value(
+      uint16_t(2));
+    storage::storage_resources resources;
+
+    // every concurrent pass gets its share
+    auto first = resources.compaction_key_map_get_bytes().get0();
+    auto second = resources.compaction_key_map_get_bytes().get0();
+    BOOST_REQUIRE_EQUAL(first.count(), 32_MiB);
+    BOOST_REQUIRE_EQUAL(second.count(), 32_MiB);
+    auto third = resources.compaction_key_map_get_bytes();
+    BOOST_REQUIRE(!third.available());
+    first.return_all();
+    BOOST_REQUIRE_EQUAL(third.get0().count(), 32_MiB);
+
+    // the memory follows the property
+    config::shard_local_cfg().storage_compaction_key_map_memory.set_value(
+      size_t(128_MiB));
+    auto fourth = resources.compaction_key_map_get_bytes();
+    BOOST_REQUIRE(fourth.available());
+    BOOST_REQUIRE_EQUAL(fourth.get0().count(), 64_MiB);
+}
+
+BOOST_AUTO_TEST_CASE(compacted_offset_list_count) {
+    storage::internal::compacted_offset_list list(
+      model::offset(100), roaring::Roaring{});
+    for (auto o : {100, 101, 105, 106, 107, 120}) {
+        list.add(model::offset(o));
+    }
+    BOOST_REQUIRE_EQUAL(list.count(model::offset(100), model::offset(101)), 2);
+    BOOST_REQUIRE_EQUAL(list.count(model::offset(102), model::offset(104)), 0);
+    BOOST_REQUIRE_EQUAL(list.count(model::offset(105), model::offset(107)), 3);
+    BOOST_REQUIRE_EQUAL(list.count(model::offset(101), model::offset(120)), 5);
+    BOOST_REQUIRE_EQUAL(list.count(model::offset(121), model::offset(200)), 0);
+}
+
 FIXTURE_TEST(index_filtered_copy_tests, compacted_topic_fixture) {
     tmpbuf_file::store_t index_data;
 
@@ -488,3 +623,44 @@ FIXTURE_TEST(v1_footers_rejected, compacted_topic_fixture) {
           storage::compacted_index::needs_rebuild_error);
     }
 }
+
+FIXTURE_TEST(key_bloom_filter_lookups, compacted_topic_fixture) {
+    static constexpr size_t keys = 10000;
+    storage::key_bloom_filter filter;
+    std::vector<bytes> added;
+    for (size_t i = 0; i < keys; ++i) {
+        added.push_back(random_generators::get_bytes(16));
+        filter.add(storage::key_bloom_filter::hash(added.back()));
+        // duplicates don't count
+        filter.add(storage::key_bloom_filter::hash(added.back()));
+    }
+    BOOST_REQUIRE(filter.is_valid());
+    BOOST_REQUIRE_LE(filter.keys(), keys);
+    BOOST_REQUIRE_GT(filter.keys(), keys * 95 / 100);
+
+    auto false_positives = [&filter] {
+        size_t n = 0;
+        for (size_t i = 0; i < keys; ++i) {
+            // longer than the added keys, so never one of them
+            if (filter.may_contain(random_generators::get_bytes(17))) {
+                ++n;
+            }
+        }
+        return n;
+    };
+    for (const auto& k : added) {
+        BOOST_REQUIRE(filter.may_contain(k));
+    }
+    BOOST_REQUIRE_LT(false_positives(), keys * 3 / 100);
+
+    filter = serde::from_iobuf<storage::key_bloom_filter>(
+      serde::to_iobuf(std::move(filter)));
+    BOOST_REQUIRE(filter.is_valid());
+    for (const auto& k : added) {
+        BOOST_REQUIRE(filter.may_contain(k));
+    }
+    BOOST_REQUIRE_LT(false_positives(), keys * 3 / 100);
+
+    // an empty filter contains nothing
+    BOOST_REQUIRE(!storage::key_bloom_filter{}.may_contain(added.front()));
+}
@@ -2,11 +2,15 @@
 #include "bytes/bytes.h"
 #include "random/generators.h"
 #include "serde/serde.h"
+#include "storage/compressed_index_state.h"
 #include "storage/index_state.h"
 #include "storage/index_state_serde_compat.h"
+#include "units.h"
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 static storage::index_state make_random_index_state() {
     storage::index_state st;
     st.bitflags = random_generators::get_int<uint32_t>();
@@ -26,6 +30,21 @@ static storage::index_state make_random_index_state() {
     return st;
 }
 
+// entries as tracked for a real segment: offsets and positions are increasing
+static storage::index_state make_monotonic_index_state(size_t n) {
+    storage::index_state st;
+    uint32_t offset = 0;
+    uint32_t time = 0;
+    uint64_t pos = 0;
+    for (size_t i = 0; i < n; ++i) {
+        st.add_entry(offset, time, pos);
+        offset += random_generators::get_int<uint32_t>(1, 1000);
+        time += random_generators::get_int<uint32_t>(0, 1000);
+        pos += random_generators::get_int<uint64_t>(32_KiB, 1_MiB);
+    }
+    return st;
+}
+
 static void set_version(iobuf& buf, int8_t version) {
     auto tmp = iobuf_to_bytes(buf);
     buf.clear();
@@ -159,3 +178,105 @@ BOOST_AUTO_TEST_CASE(serde_deprecated_crc) {
           return is_crc || is_out_of_bounds;
       });
 }
+
+BOOST_AUTO_TEST_CASE(compressed_round_trip) {
+    for (auto n : {1, 15, 16, 17, 64, 65, 1000, 10000}) {
+        auto input = make_monotonic_index_state(n);
+        auto compressed = storage::compressed_index_state::compress(input);
+        BOOST_REQUIRE(compressed);
+        BOOST_REQUIRE_EQUAL(compressed->size(), n);
+
+        storage::index_state output;
+        compressed->decompress_into(output);
+        BOOST_REQUIRE_EQUAL(output, input);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compressed_rejects_non_monotonic) {
+    storage::index_state st;
+    st.add_entry(10, 0, 0);
+    st.add_entry(5, 0, 100);
+    BOOST_REQUIRE(!storage::compressed_index_state::compress(st));
+}
+
+BOOST_AUTO_TEST_CASE(compressed_find_nearest) {
+    auto input = make_monotonic_index_state(1000);
+    auto compressed = storage::compressed_index_state::compress(input);
+    BOOST_REQUIRE(compressed);
+
+    const auto& offsets = input.relative_offset_index;
+    const auto& times = input.relative_time_index;
+    const auto max_offset = offsets[offsets.size() - 1];
+    const auto max_time = times[times.size() - 1];
+    for (int i = 0; i < 10000; ++i) {
+        // last entry with offset <= needle
+        auto needle = random_generators::get_int<uint32_t>(0, max_offset + 10);
+        auto it = std::upper_bound(offsets.begin(), offsets.end(), needle);
+        auto expected = input.get_entry(std::distance(offsets.begin(), it) - 1);
+        BOOST_REQUIRE(compressed->find_nearest_offset(needle) == expected);
+
+        // first entry with time >= needle
+        needle = random_generators::get_int<uint32_t>(0, max_time + 10);
+        it = std::lower_bound(times.begin(), times.end(), needle);
+        auto result = compressed->find_nearest_time(needle);
+        if (it == times.end()) {
+            BOOST_REQUIRE(!result);
+        } else {
+            BOOST_REQUIRE(
+              result == input.get_entry(std::distance(times.begin(), it)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(max_time_index_out_of_order) {
+    storage::index_state st;
+    int64_t max_time = 0;
+    model::timestamp base;
+    uint64_t pos = 0;
+    size_t acc = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const auto ts = model::timestamp(
+          1'000'000 + i * 10 + random_generators::get_int(-500, 500));
+        if (i == 0) {
+            base = ts;
+            max_time = ts();
+        }
+        max_time = std::max(max_time, ts());
+        const auto entries = st.relative_offset_index.size();
+        // batches of 32KiB, every 4th one is indexed
+        acc += 32_KiB;
+        if (st.maybe_index(
+              acc,
+              128_KiB,
+              pos,
+              model::offset(i),
+              model::offset(i),
+              ts,
+              ts,
+              true)) {
+            acc = 0;
+        }
+        pos += 32_KiB;
+        // the last entry covers every batch so far
+        BOOST_REQUIRE(st.has_max_time_index());
+        BOOST_REQUIRE_EQUAL(
+          static_cast<int64_t>(st.max_time_index[st.max_time_index.size() - 1]),
+          max_time - base());
+        if (st.relative_offset_index.size() > entries) {
+            BOOST_REQUIRE_EQUAL(
+              st.relative_offset_index[entries], static_cast<uint32_t>(i));
+        }
+    }
+    const auto& times = st.max_time_index;
+    BOOST_REQUIRE(std::is_sorted(times.begin(), times.end()));
+
+    // survives a round trip and truncation
+    auto copy = st.copy();
+    auto output = serde::from_iobuf<storage::index_state>(
+      serde::to_iobuf(std::move(copy)));
+    BOOST_REQUIRE_EQUAL(output, st);
+    while (!output.empty()) {
+        output.pop_back();
+        BOOST_REQUIRE(output.has_max_time_index());
+    }
+}
@@ -0,0 +1,78 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/bytes.h"
+#include "config/configuration.h"
+#include "random/generators.h"
+#include "reflection/adl.h"
+#include "storage/kvstore.h"
+#include "storage/storage_resources.h"
+#include "units.h"
+
+#include <seastar/core/loop.hh>
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/util/file.hh>
+
+#include <boost/range/irange.hpp>
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+/**
+ * Put latency of 10k raft groups updating their kvstore keys concurrently, as
+ * they do when all of them vote or move their offset translator state at
+ * once. Each group writes a small value to its own key in the consensus and
+ * offset_translator key spaces. perf_tests reports the time per put.
+ */
+struct kvstore_put_bench {
+    static constexpr int groups = 10'000;
+
+    kvstore_put_bench()
+      : dir("kvstore_put_bench." + random_generators::gen_alphanum_string(8))
+      , kvs(
+          storage::kvstore_config(
+            1_MiB,
+            config::mock_binding(10ms),
+            dir,
+            storage::debug_sanitize_files::no),
+          resources) {
+        config::shard_local_cfg().get("disable_metrics").set_value(true);
+        kvs.start().get();
+    }
+
+    ~kvstore_put_bench() {
+        kvs.stop().get();
+        ss::recursive_remove_directory(std::filesystem::path(dir)).get();
+    }
+
+    ss::future<> put(storage::kvstore::key_space ks, int group) {
+        return kvs.put(
+          ks,
+          iobuf_to_bytes(reflection::to_iobuf(group)),
+          reflection::to_iobuf(random_generators::get_int<int64_t>()));
+    }
+
+    size_t put_all_groups() {
+        perf_tests::start_measuring_time();
+        ss::parallel_for_each(boost::irange(0, groups), [this](int group) {
+            return ss::when_all_succeed(
+              put(storage::kvstore::key_space::consensus, group),
+              put(storage::kvstore::key_space::offset_translator, group));
+        }).get();
+        perf_tests::stop_measuring_time();
+        return 2 * groups;
+    }
+
+    ss::sstring dir;
+    storage::storage_resources resources;
+    storage::kvstore kvs;
+};
+
+PERF_TEST_F(kvstore_put_bench, put_10k_groups) { return put_all_groups(); }
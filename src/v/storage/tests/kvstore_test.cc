@@ -16,6 +16,11 @@
 #include <seastar/testing/thread_test_case.hh>
 #include <seastar/util/file.hh>
 
+#include <array>
+#include <filesystem>
+#include <map>
+#include <vector>
+
 template<typename T>
 static void set_configuration(ss::sstring p_name, T v) {
     ss::smp::invoke_on_all([p_name, v = std::move(v)] {
@@ -233,3 +238,111 @@ SEASTAR_THREAD_TEST_CASE(kvstore) {
 
     cleanup_store(dir).get();
 }
+
+SEASTAR_THREAD_TEST_CASE(kvstore_concurrent_key_spaces) {
+    set_configuration("disable_metrics", true);
+
+    auto dir = ssx::sformat(
+      "kvstore_test_{}", random_generators::get_int(4000));
+
+    auto conf = prepare_store(dir).get();
+
+    using ks_t = storage::kvstore::key_space;
+    const std::array<ks_t, 3> spaces = {
+      ks_t::consensus, ks_t::storage, ks_t::offset_translator};
+    std::map<std::pair<ks_t, bytes>, iobuf> truth;
+
+    storage::storage_resources resources;
+    auto kvs = std::make_unique<storage::kvstore>(conf, resources);
+    kvs->start().get();
+
+    // the same keys in every key space, written concurrently over enough
+    // rounds to roll segments while snapshots are written in the background
+    for (int round = 0; round < 20; round++) {
+        std::vector<ss::future<>> batch;
+        for (int i = 0; i < 50; i++) {
+            auto key = random_generators::get_bytes(2);
+            for (auto ks : spaces) {
+                auto value = bytes_to_iobuf(random_generators::get_bytes(20));
+                truth[{ks, key}] = value.copy();
+                batch.push_back(kvs->put(ks, key, std::move(value)));
+            }
+        }
+        ss::when_all_succeed(batch.begin(), batch.end()).get();
+    }
+
+    auto check = [&] {
+        for (auto& [k, v] : truth) {
+            BOOST_REQUIRE(kvs->get(k.first, k.second).value() == v);
+        }
+        BOOST_REQUIRE(
+          !kvs->get(ks_t::testing, truth.begin()->first.second).has_value());
+    };
+    check();
+    kvs->stop().get();
+
+    kvs = std::make_unique<storage::kvstore>(conf, resources);
+    kvs->start().get();
+    check();
+    kvs->stop().get();
+
+    cleanup_store(dir).get();
+}
+
+SEASTAR_THREAD_TEST_CASE(kvstore_one_snapshot_in_flight) {
+    set_configuration("disable_metrics", true);
+
+    auto dir = ssx::sformat(
+      "kvstore_test_{}", random_generators::get_int(4000));
+
+    auto conf = prepare_store(dir).get();
+    std::map<bytes, iobuf> truth;
+
+    storage::storage_resources resources;
+    auto kvs = std::make_unique<storage::kvstore>(conf, resources);
+    kvs->start().get();
+
+    // a closed segment stays on disk until the snapshot replacing it is
+    // written, so with one snapshot in flight there is never more than the
+    // active segment and the one being snapshotted
+    auto segment_count = [&dir] {
+        size_t count = 0;
+        for (auto& e : std::filesystem::recursive_directory_iterator(
+               std::filesystem::path(dir))) {
+            if (e.path().extension() == ".log") {
+                ++count;
+            }
+        }
+        return count;
+    };
+
+    // every round overflows the segment so each flush wants to roll
+    for (int round = 0; round < 50; round++) {
+        std::vector<ss::future<>> batch;
+        for (int i = 0; i < 20; i++) {
+            auto key = random_generators::get_bytes(8);
+            auto value = bytes_to_iobuf(random_generators::get_bytes(512));
+            truth[key] = value.copy();
+            batch.push_back(kvs->put(
+              storage::kvstore::key_space::testing, key, std::move(value)));
+        }
+        ss::when_all_succeed(batch.begin(), batch.end()).get();
+        BOOST_REQUIRE_LE(segment_count(), 2);
+    }
+
+    auto check = [&] {
+        for (auto& [k, v] : truth) {
+            BOOST_REQUIRE(
+              kvs->get(storage::kvstore::key_space::testing, k).value() == v);
+        }
+    };
+    check();
+    kvs->stop().get();
+
+    kvs = std::make_unique<storage::kvstore>(conf, resources);
+    kvs->start().get();
+    check();
+    kvs->stop().get();
+
+    cleanup_store(dir).get();
+}
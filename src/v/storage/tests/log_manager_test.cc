@@ -14,12 +14,15 @@
 #include "storage/api.h"
 #include "storage/directories.h"
 #include "storage/disk_log_appender.h"
+#include "storage/log_housekeeping_meta.h"
 #include "storage/segment_appender.h"
 #include "storage/segment_appender_utils.h"
 #include "storage/segment_reader.h"
+#include "units.h"
 #include "utils/file_sanitizer.h"
 
 #include <seastar/core/thread.hh>
+#include <seastar/core/when_all.hh>
 #include <seastar/testing/thread_test_case.hh>
 #include <seastar/util/defer.hh>
 
@@ -128,3 +131,58 @@ SEASTAR_THREAD_TEST_CASE(test_can_load_logs) {
     BOOST_CHECK(
       file_exists(seg4->reader().filename() + ".cannotrecover").get0());
 }
+
+SEASTAR_THREAD_TEST_CASE(test_recovery_admission_priority) {
+    recovery_admission admission(1);
+    std::vector<int> order;
+
+    auto first = admission.get_units(recovery_priority::normal).get0();
+    auto admit = [&](recovery_priority p, int id) {
+        return admission.get_units(p).then(
+          [&order, id](recovery_admission::units) {
+              // the unit is released on return, admitting the next waiter
+              order.push_back(id);
+          });
+    };
+    auto f1 = admit(recovery_priority::normal, 1);
+    auto f2 = admit(recovery_priority::normal, 2);
+    auto f3 = admit(recovery_priority::high, 3);
+    BOOST_REQUIRE_EQUAL(admission.running(), 1);
+    BOOST_REQUIRE_EQUAL(admission.waiters(), 3);
+
+    // releasing the first unit admits the high priority waiter first
+    first = recovery_admission::units();
+    ss::when_all_succeed(std::move(f1), std::move(f2), std::move(f3)).get();
+    BOOST_REQUIRE(order == std::vector<int>({3, 1, 2}));
+    BOOST_REQUIRE_EQUAL(admission.running(), 0);
+    BOOST_REQUIRE_EQUAL(admission.waiters(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_housekeeping_score_order) {
+    const auto interval = 10s;
+    auto score = [interval](housekeeping_stats stats, auto since) {
+        return housekeeping_score(stats, since, interval);
+    };
+
+    // a log with nothing to do which was just housekept
+    auto idle = score({.size_bytes = 1_GiB}, 0s);
+    // half of the closed bytes of a compacted log are dirty
+    auto dirty = score({.dirty_ratio = 0.5, .size_bytes = 1_GiB}, 0s);
+    // a quarter of the log is over retention
+    auto over_retention = score(
+      {.bytes_over_retention = 256_MiB, .size_bytes = 1_GiB}, 0s);
+    // a log with nothing to do which wasn't housekept for long
+    auto stale = score({.size_bytes = 1_GiB}, 1h);
+
+    BOOST_REQUIRE_EQUAL(idle, 0);
+    BOOST_REQUIRE_GT(dirty, idle);
+    BOOST_REQUIRE_GT(over_retention, dirty);
+    BOOST_REQUIRE_GT(stale, idle);
+    // staleness saturates: a stale log never outranks a dirty one which
+    // waited as long
+    BOOST_REQUIRE_EQUAL(stale, score({.size_bytes = 1_GiB}, 24h));
+    BOOST_REQUIRE_GT(
+      score({.dirty_ratio = 0.5, .size_bytes = 1_GiB}, 1h), stale);
+    // empty logs score by their staleness alone
+    BOOST_REQUIRE_EQUAL(score({}, 1h), stale);
+}
@@ -0,0 +1,78 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/fundamental.h"
+#include "model/record_batch_reader.h"
+#include "random/generators.h"
+#include "storage/tests/bench_log.h"
+#include "units.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+/**
+ * Reads a 4 segment log of 4KiB batches from disk, either from start to end or
+ * one batch at a time at random offsets. The batch cache is bypassed so that
+ * every read goes through the segment readers and the parser.
+ */
+struct log_reader_bench {
+    static constexpr size_t random_reads = 256;
+
+    log_reader_bench()
+      : builder(storage::bench_log_config()) {
+        builder | storage::start();
+        last_offset = storage::build_bench_log(
+                        builder,
+                        {.segments = 4,
+                         .batches_per_segment = 512,
+                         .records_per_batch = 4,
+                         .record_size = 1_KiB})
+                      - model::offset(1);
+    }
+
+    ~log_reader_bench() { builder | storage::stop(); }
+
+    static storage::log_reader_config
+    uncached_config(model::offset start, model::offset end) {
+        auto cfg = storage::reader_config();
+        cfg.start_offset = start;
+        cfg.max_offset = end;
+        cfg.skip_batch_cache = true;
+        return cfg;
+    }
+
+    size_t read_sequential() {
+        perf_tests::start_measuring_time();
+        auto batches
+          = builder.consume(uncached_config(model::offset(0), last_offset))
+              .get0();
+        perf_tests::stop_measuring_time();
+        return batches.size();
+    }
+
+    size_t read_random() {
+        size_t read = 0;
+        for (size_t i = 0; i < random_reads; ++i) {
+            auto o = model::offset(
+              random_generators::get_int<model::offset::type>(
+                0, last_offset()));
+            perf_tests::start_measuring_time();
+            auto batches = builder.consume(uncached_config(o, o)).get0();
+            perf_tests::stop_measuring_time();
+            read += batches.size();
+        }
+        return read;
+    }
+
+    storage::disk_log_builder builder;
+    model::offset last_offset;
+};
+
+PERF_TEST_F(log_reader_bench, read_sequential) { return read_sequential(); }
+
+PERF_TEST_F(log_reader_bench, read_random) { return read_random(); }
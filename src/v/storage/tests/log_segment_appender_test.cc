@@ -15,7 +15,9 @@
 
 #include <seastar/core/reactor.hh>
 #include <seastar/core/thread.hh>
+#include <seastar/core/when_all.hh>
 #include <seastar/testing/thread_test_case.hh>
+#include <seastar/util/defer.hh>
 
 // test gate
 #include <seastar/core/gate.hh>
@@ -285,3 +287,94 @@ SEASTAR_THREAD_TEST_CASE(test_fallocate_size) {
         run_test_fallocate_size(fallocate_size);
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_concurrent_flushes_are_coalesced) {
+    // wide enough for the writes of both appenders to complete in one window
+    config::shard_local_cfg().storage_flush_coalesce_window_ms.set_value(
+      std::chrono::milliseconds(100));
+    auto reset_window = ss::defer([] {
+        config::shard_local_cfg().storage_flush_coalesce_window_ms.reset();
+    });
+    storage::storage_resources resources;
+    auto f1 = open_file("test.segment_appender_coalesce_1.log");
+    auto f2 = open_file("test.segment_appender_coalesce_2.log");
+    auto a1 = make_segment_appender(f1, resources);
+    auto a2 = make_segment_appender(f2, resources);
+    auto& flushes = resources.flushes();
+
+    // requests for the same file within the window share a single sync
+    const auto requests = flushes.requests();
+    const auto syncs = flushes.syncs();
+    ss::when_all_succeed(
+      flushes.flush(&a1, f1), flushes.flush(&a1, f1), flushes.flush(&a1, f1))
+      .get();
+    BOOST_REQUIRE_EQUAL(flushes.requests() - requests, 3);
+    BOOST_REQUIRE_EQUAL(flushes.syncs() - syncs, 1);
+
+    // concurrent flushes of an appender are served by one sync and the
+    // syncs of different appenders are dispatched in one batch
+    const auto data = make_random_data(1_KiB);
+    a1.append(data).get();
+    a2.append(data).get();
+    const auto batches = flushes.batches();
+    ss::when_all_succeed(a1.flush(), a1.flush(), a1.flush(), a2.flush()).get();
+    BOOST_REQUIRE_EQUAL(flushes.syncs() - syncs, 3);
+    BOOST_REQUIRE_EQUAL(flushes.batches() - batches, 1);
+
+    // every appender still gets its own data synced
+    for (auto& f : {f1, f2}) {
+        auto in = make_file_input_stream(f, 0);
+        BOOST_REQUIRE_EQUAL(
+          read_iobuf_exactly(in, data.size_bytes()).get0(), data);
+        in.close().get();
+    }
+
+    a1.close().get();
+    a2.close().get();
+    flushes.stop().get();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_small_flushes_are_coalesced) {
+    struct write_counter final : segment_appender::callbacks {
+        void committed_physical_offset(size_t) final { ++writes; }
+        size_t writes{0};
+    };
+    auto reset_cfg = ss::defer([] {
+        config::shard_local_cfg().segment_appender_write_coalesce_ms.reset();
+    });
+    config::shard_local_cfg().segment_appender_write_coalesce_ms.set_value(
+      std::chrono::milliseconds(100));
+    storage::storage_resources resources;
+    auto f = open_file("test.segment_appender_write_coalesce.log");
+    auto appender = make_segment_appender(f, resources);
+    write_counter counter;
+    appender.set_callbacks(&counter);
+
+    // small appends in quick succession, each followed by a flush that isn't
+    // waited for, like a leader appending and flushing for acks=all
+    static constexpr size_t appends = 200;
+    iobuf expected;
+    std::vector<ss::future<>> flushes;
+    for (size_t i = 0; i < appends; ++i) {
+        auto data = make_random_data(10);
+        expected.append(data.copy());
+        appender.append(data).get();
+        flushes.push_back(appender.flush());
+    }
+    ss::when_all_succeed(flushes.begin(), flushes.end()).get();
+
+    // the first flushes are written one by one until appends are known to be
+    // frequent, after that flushes wait for the next appends
+    BOOST_REQUIRE_LT(counter.writes, appends / 2);
+    auto in = make_file_input_stream(f, 0);
+    BOOST_REQUIRE_EQUAL(
+      read_iobuf_exactly(in, expected.size_bytes()).get0(), expected);
+    in.close().get();
+
+    // a flush that doesn't complete is written once the window passes
+    appender.append(make_random_data(10)).get();
+    appender.flush().get();
+    BOOST_REQUIRE_EQUAL(appender.file_byte_offset(), expected.size_bytes() + 10);
+
+    appender.close().get();
+}
@@ -7,21 +7,27 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 
+#include "config/configuration.h"
 #include "model/record.h"
 #include "model/record_batch_reader.h"
 #include "model/record_utils.h"
 #include "model/tests/random_batch.h"
 #include "model/timeout_clock.h"
 #include "random/generators.h"
+#include "storage/adaptive_read_ahead.h"
 #include "storage/disk_log_appender.h"
 #include "storage/log_reader.h"
+#include "storage/reader_handle_cache.h"
 #include "storage/segment.h"
 #include "storage/segment_appender.h"
 #include "storage/segment_appender_utils.h"
 #include "storage/segment_reader.h"
+#include "storage/storage_resources.h"
+#include "units.h"
 #include "utils/disk_log_builder.h"
 #include "utils/file_sanitizer.h"
 
+#include <seastar/core/seastar.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/testing/thread_test_case.hh>
 
@@ -291,3 +297,132 @@ SEASTAR_THREAD_TEST_CASE(test_does_not_read_past_max_offset) {
     b | stop();
     check_batches(res, batches);
 }
+
+SEASTAR_THREAD_TEST_CASE(test_reader_handle_cache_fd_budget) {
+    reader_handle_cache cache(config::mock_binding<size_t>(2));
+    std::vector<std::unique_ptr<segment_reader>> readers;
+    for (int i = 0; i < 3; ++i) {
+        auto name = fmt::format("reader_handle_cache_{}.log", i);
+        ss::open_file_dma(name, ss::open_flags::create | ss::open_flags::rw)
+          .then([](ss::file f) { return f.close().finally([f] {}); })
+          .get();
+        readers.push_back(std::make_unique<segment_reader>(
+          segment_full_path::mock(name), 128_KiB, 10, debug_sanitize_files::no));
+        readers.back()->set_handle_cache(&cache);
+    }
+    auto open_stream = [&readers](int i) {
+        return readers[i]->data_stream(0, ss::default_priority_class()).get0();
+    };
+
+    // files stay open once their readers are gone
+    readers[0]->load_size().get();
+    readers[1]->load_size().get();
+    BOOST_REQUIRE_EQUAL(cache.misses(), 2);
+    BOOST_REQUIRE_EQUAL(cache.idle_fds(), 2);
+    readers[0]->load_size().get();
+    BOOST_REQUIRE_EQUAL(cache.hits(), 1);
+    BOOST_REQUIRE_EQUAL(cache.misses(), 2);
+
+    // a third file closes the least recently used one, reader 1
+    readers[2]->load_size().get();
+    BOOST_REQUIRE_EQUAL(cache.evictions(), 1);
+    BOOST_REQUIRE_EQUAL(cache.open_fds(), 2);
+    readers[0]->load_size().get();
+    BOOST_REQUIRE_EQUAL(cache.hits(), 2);
+    readers[1]->load_size().get();
+    BOOST_REQUIRE_EQUAL(cache.misses(), 4);
+
+    // files in use are never closed, even over the budget
+    auto h0 = open_stream(0);
+    auto h1 = open_stream(1);
+    auto h2 = open_stream(2);
+    BOOST_REQUIRE_EQUAL(cache.open_fds(), 3);
+    BOOST_REQUIRE_EQUAL(cache.idle_fds(), 0);
+    h0.close().get();
+    h1.close().get();
+    h2.close().get();
+    BOOST_REQUIRE_EQUAL(cache.open_fds(), 2);
+    BOOST_REQUIRE_EQUAL(cache.idle_fds(), 2);
+
+    // prewarming keeps the file open for the next read
+    readers[0]->prewarm().get();
+    BOOST_REQUIRE_EQUAL(cache.idle_fds(), 2);
+    auto hits = cache.hits();
+    readers[0]->load_size().get();
+    BOOST_REQUIRE_EQUAL(cache.hits(), hits + 1);
+
+    for (auto& r : readers) {
+        r->close().get();
+    }
+    BOOST_REQUIRE_EQUAL(cache.open_fds(), 0);
+    cache.stop().get();
+    for (int i = 0; i < 3; ++i) {
+        ss::remove_file(fmt::format("reader_handle_cache_{}.log", i)).get();
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_reader_handle_cache_outlived_by_readers) {
+    auto cache = std::make_unique<reader_handle_cache>(
+      config::mock_binding<size_t>(1));
+    std::vector<std::unique_ptr<segment_reader>> readers;
+    for (int i = 0; i < 2; ++i) {
+        auto name = fmt::format("reader_handle_cache_outlived_{}.log", i);
+        ss::open_file_dma(name, ss::open_flags::create | ss::open_flags::rw)
+          .then([](ss::file f) { return f.close().finally([f] {}); })
+          .get();
+        readers.push_back(std::make_unique<segment_reader>(
+          segment_full_path::mock(name), 128_KiB, 10, debug_sanitize_files::no));
+        readers.back()->set_handle_cache(cache.get());
+    }
+
+    // no descriptor is opened ahead of a read while the budget is used up by
+    // readers in use
+    auto h0 = readers[0]->data_stream(0, ss::default_priority_class()).get0();
+    readers[1]->prewarm().get();
+    BOOST_REQUIRE_EQUAL(cache->open_fds(), 1);
+    BOOST_REQUIRE_EQUAL(cache->idle_fds(), 0);
+
+    // readers in use when the cache goes away close their file by themselves
+    cache->stop().get();
+    cache.reset();
+    BOOST_REQUIRE(readers[0]->handle_cache() == nullptr);
+    h0.close().get();
+    for (auto& r : readers) {
+        r->close().get();
+    }
+    for (int i = 0; i < 2; ++i) {
+        ss::remove_file(fmt::format("reader_handle_cache_outlived_{}.log", i))
+          .get();
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_adaptive_read_ahead_window) {
+    storage_resources resources;
+    adaptive_read_ahead read_ahead;
+    const auto initial = read_ahead.window().value();
+    BOOST_REQUIRE_EQUAL(initial.read_ahead, 1u);
+
+    // the window grows once twice its memory was read sequentially
+    BOOST_REQUIRE(
+      !read_ahead.record_sequential_read(initial.memory(), resources));
+    BOOST_REQUIRE(
+      read_ahead.record_sequential_read(initial.memory(), resources));
+    BOOST_REQUIRE_EQUAL(read_ahead.window()->read_ahead, 2u);
+    BOOST_REQUIRE_EQUAL(read_ahead.window()->buffer_size, initial.buffer_size);
+
+    // read ahead grows up to the configured count, then the buffers grow
+    for (int i = 0; i < 16; ++i) {
+        read_ahead.record_sequential_read(
+          2 * read_ahead.window()->memory(), resources);
+    }
+    BOOST_REQUIRE_EQUAL(
+      read_ahead.window()->read_ahead,
+      static_cast<unsigned>(
+        config::shard_local_cfg().storage_read_readahead_count()));
+    BOOST_REQUIRE_EQUAL(
+      read_ahead.window()->buffer_size, adaptive_read_ahead::max_buffer_size);
+
+    // a seek goes back to the initial window
+    read_ahead.reset();
+    BOOST_REQUIRE_EQUAL(read_ahead.window().value(), initial);
+}
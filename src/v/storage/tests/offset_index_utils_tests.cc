@@ -7,7 +7,9 @@
 // the Business Source License, use of this software will be governed
 // by the Apache License, Version 2.0
 #include "random/generators.h"
+#include "config/property.h"
 #include "serde/serde.h"
+#include "storage/resident_index_tracker.h"
 #include "storage/segment_index.h"
 #include "test_utils/fixture.h"
 #include "utils/file_io.h"
@@ -40,6 +42,25 @@ public:
         _base_hdr.size_bytes = batch_size;
         return _base_hdr;
     }
+    /// another index backed by the same file
+    segment_index_ptr make_index_over_data() {
+        return std::unique_ptr<segment_index>(new segment_index(
+          segment_full_path::mock("In memory iobuf"),
+          ss::file(ss::make_shared(tmpbuf_file(_data))),
+          _base_offset,
+          storage::segment_index::default_data_buffer_step));
+    }
+
+    void track_entries(segment_index& idx, uint32_t n) {
+        for (uint32_t i = 0; i < n; ++i) {
+            idx.maybe_track(
+              modify_get(
+                _base_offset + model::offset(i),
+                storage::segment_index::default_data_buffer_step),
+              i * storage::segment_index::default_data_buffer_step);
+        }
+    }
+
     void index_entry_expect(uint32_t offset, size_t filepos) {
         auto o = model::offset(offset);
         auto p = _idx->find_nearest(o);
@@ -132,3 +153,121 @@ FIXTURE_TEST(bucket_truncate, offset_index_utils_fixture) {
         BOOST_REQUIRE_EQUAL(p->filepos, 458048);
     }
 }
+
+FIXTURE_TEST(index_frozen_lookups, offset_index_utils_fixture) {
+    track_entries(*_idx, 1024);
+    std::vector<std::optional<segment_index::entry>> expected;
+    for (uint32_t i = 0; i < 1100; ++i) {
+        expected.push_back(_idx->find_nearest(model::offset(i)));
+    }
+    const auto raw_bytes = _idx->memory_usage();
+    _idx->freeze();
+    BOOST_REQUIRE(_idx->is_frozen());
+    BOOST_REQUIRE_LT(_idx->memory_usage(), raw_bytes);
+    for (uint32_t i = 0; i < 1100; ++i) {
+        auto e = _idx->find_nearest(model::offset(i));
+        BOOST_REQUIRE_EQUAL(e.has_value(), expected[i].has_value());
+        if (e) {
+            BOOST_REQUIRE_EQUAL(e->offset, expected[i]->offset);
+            BOOST_REQUIRE_EQUAL(e->filepos, expected[i]->filepos);
+        }
+    }
+    // mutations decompress the index
+    _idx->truncate(model::offset(512)).get();
+    BOOST_REQUIRE(!_idx->is_frozen());
+    index_entry_expect(511, 511 * segment_index::default_data_buffer_step);
+}
+
+FIXTURE_TEST(index_lazy_page_in, offset_index_utils_fixture) {
+    track_entries(*_idx, 1024);
+    _idx->flush().get();
+
+    auto lazy = make_index_over_data();
+    BOOST_REQUIRE(lazy->materialize_index_header().get());
+    BOOST_REQUIRE(!lazy->is_resident());
+    BOOST_REQUIRE_EQUAL(lazy->max_offset(), _idx->max_offset());
+    BOOST_REQUIRE_EQUAL(lazy->base_timestamp(), _idx->base_timestamp());
+    BOOST_REQUIRE_EQUAL(lazy->max_timestamp(), _idx->max_timestamp());
+    BOOST_REQUIRE(!lazy->find_nearest(model::offset(100)));
+
+    lazy->page_in().get();
+    BOOST_REQUIRE(lazy->is_resident());
+    auto e = lazy->find_nearest(model::offset(100));
+    BOOST_REQUIRE(e);
+    BOOST_REQUIRE_EQUAL(e->offset, model::offset(100));
+    BOOST_REQUIRE_EQUAL(
+      e->filepos, 100 * segment_index::default_data_buffer_step);
+}
+
+FIXTURE_TEST(index_header_reads_only_header, offset_index_utils_fixture) {
+    track_entries(*_idx, 1024);
+    _idx->flush().get();
+
+    // corrupt an entry, the header fields are left intact
+    const size_t pos = _data.size - 64;
+    auto it = std::prev(_data.data.upper_bound(pos));
+    it->second.get_write()[pos - it->first] ^= 0xff;
+
+    // the entries are not read so the header loads
+    auto lazy = make_index_over_data();
+    BOOST_REQUIRE(lazy->materialize_index_header().get());
+    BOOST_REQUIRE(!lazy->is_resident());
+    BOOST_REQUIRE_EQUAL(lazy->max_offset(), _idx->max_offset());
+    BOOST_REQUIRE_EQUAL(lazy->max_timestamp(), _idx->max_timestamp());
+
+    // paging in verifies the checksum and rebuilds from the segment, which
+    // doesn't exist here
+    BOOST_REQUIRE_THROW(lazy->page_in().get(), std::exception);
+    BOOST_REQUIRE(!lazy->is_resident());
+}
+
+FIXTURE_TEST(index_pinned_not_evicted, offset_index_utils_fixture) {
+    track_entries(*_idx, 1024);
+    _idx->flush().get();
+
+    resident_index_tracker tracker(config::mock_binding<size_t>(1));
+    auto first = make_index_over_data();
+    auto second = make_index_over_data();
+    {
+        segment_index::pin_guard pin(*first);
+        for (auto* idx : {first.get(), second.get()}) {
+            idx->set_residency_tracker(&tracker);
+            BOOST_REQUIRE(idx->materialize_index().get());
+            idx->freeze();
+        }
+        BOOST_REQUIRE(first->is_resident());
+        BOOST_REQUIRE(second->is_resident());
+        BOOST_REQUIRE_EQUAL(tracker.evictions(), 0);
+    }
+    // once unpinned the next index paged in evicts it
+    auto third = make_index_over_data();
+    third->set_residency_tracker(&tracker);
+    BOOST_REQUIRE(third->materialize_index().get());
+    third->freeze();
+    BOOST_REQUIRE(!first->is_resident());
+    BOOST_REQUIRE(third->is_resident());
+}
+
+FIXTURE_TEST(index_residency_budget, offset_index_utils_fixture) {
+    track_entries(*_idx, 1024);
+    _idx->flush().get();
+
+    resident_index_tracker tracker(config::mock_binding<size_t>(1));
+    auto first = make_index_over_data();
+    auto second = make_index_over_data();
+    for (auto* idx : {first.get(), second.get()}) {
+        idx->set_residency_tracker(&tracker);
+        BOOST_REQUIRE(idx->materialize_index().get());
+        idx->freeze();
+    }
+    // only the most recently used index stays resident
+    BOOST_REQUIRE(!first->is_resident());
+    BOOST_REQUIRE(second->is_resident());
+    BOOST_REQUIRE_EQUAL(tracker.evictions(), 1);
+    BOOST_REQUIRE_EQUAL(tracker.resident_bytes(), second->memory_usage());
+
+    first->page_in().get();
+    BOOST_REQUIRE(first->is_resident());
+    BOOST_REQUIRE(!second->is_resident());
+    BOOST_REQUIRE(first->find_nearest(model::offset(100)));
+}
@@ -0,0 +1,98 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "bytes/iostream.h"
+#include "model/tests/random_batch.h"
+#include "storage/parser.h"
+#include "storage/segment_appender_utils.h"
+#include "storage/segment_reader.h"
+#include "units.h"
+#include "vassert.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <vector>
+
+namespace {
+class counting_consumer final : public storage::batch_consumer {
+public:
+    explicit counting_consumer(size_t& batches)
+      : _batches(batches) {}
+
+    consume_result
+    accept_batch_start(const model::record_batch_header&) const override {
+        return consume_result::accept_batch;
+    }
+    void consume_batch_start(
+      model::record_batch_header, size_t, size_t) override {}
+    void skip_batch_start(model::record_batch_header, size_t, size_t) override {
+    }
+    void consume_records(iobuf&& records) override {
+        perf_tests::do_not_optimize(records);
+    }
+    stop_parser consume_batch_end() override {
+        ++_batches;
+        return stop_parser::no;
+    }
+    void print(std::ostream& os) const override {
+        os << "storage::counting_consumer";
+    }
+
+private:
+    size_t& _batches;
+};
+} // namespace
+
+/**
+ * Parses 16MiB of serialized batches of a given size from memory, measuring
+ * the parser without any disk io.
+ */
+struct parser_bench {
+    static constexpr size_t bytes_per_run = 16_MiB;
+
+    static iobuf make_segment(size_t record_size) {
+        iobuf segment;
+        model::offset o{0};
+        while (segment.size_bytes() < bytes_per_run) {
+            auto batch = model::test::make_random_batch(
+              model::test::record_batch_spec{
+                .offset = o,
+                .allow_compression = false,
+                .count = 1,
+                .record_sizes = std::vector<size_t>{record_size}});
+            o = batch.last_offset() + model::offset(1);
+            segment.append(storage::disk_header_to_iobuf(batch.header()));
+            segment.append(std::move(batch).release_data());
+        }
+        return segment;
+    }
+
+    size_t parse(size_t record_size) {
+        auto segment = make_segment(record_size);
+        size_t batches = 0;
+        storage::continuous_batch_parser parser(
+          std::make_unique<counting_consumer>(batches),
+          storage::segment_reader_handle(
+            make_iobuf_input_stream(std::move(segment))));
+
+        perf_tests::start_measuring_time();
+        auto r = parser.consume().get0();
+        perf_tests::stop_measuring_time();
+        parser.close().get();
+        vassert(r.has_value(), "Parser failed: {}", r.error().message());
+        return batches;
+    }
+};
+
+PERF_TEST_F(parser_bench, parse_256b) { return parse(256); }
+
+PERF_TEST_F(parser_bench, parse_4k) { return parse(4_KiB); }
+
+PERF_TEST_F(parser_bench, parse_64k) { return parse(64_KiB); }
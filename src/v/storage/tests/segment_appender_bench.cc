@@ -0,0 +1,74 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "bytes/iobuf.h"
+#include "config/property.h"
+#include "random/generators.h"
+#include "storage/segment_appender.h"
+#include "storage/storage_resources.h"
+#include "units.h"
+
+#include <seastar/core/seastar.hh>
+#include <seastar/testing/perf_tests.hh>
+
+/**
+ * Appends 4MiB to a segment appender in batches of a given size and flushes
+ * it. The file is truncated between runs so that the benchmark doesn't
+ * measure the growth of the file system.
+ */
+struct segment_appender_bench {
+    static constexpr size_t bytes_per_run = 4_MiB;
+
+    segment_appender_bench()
+      : resources(config::mock_binding<size_t>(32_MiB))
+      , appender(
+          ss::open_file_dma(
+            "segment_appender_bench.log",
+            ss::open_flags::create | ss::open_flags::rw
+              | ss::open_flags::truncate)
+            .get0(),
+          storage::segment_appender::options(
+            ss::default_priority_class(), 8, std::nullopt, resources)) {}
+
+    ~segment_appender_bench() { appender.close().get(); }
+
+    size_t append_and_flush(size_t batch_size) {
+        auto batch = bytes_to_iobuf(random_generators::get_bytes(batch_size));
+        const size_t batches = bytes_per_run / batch_size;
+
+        perf_tests::start_measuring_time();
+        for (size_t i = 0; i < batches; ++i) {
+            appender.append(batch).get();
+        }
+        appender.flush().get();
+        perf_tests::stop_measuring_time();
+
+        appender.truncate(0).get();
+        return batches;
+    }
+
+    storage::storage_resources resources;
+    storage::segment_appender appender;
+};
+
+PERF_TEST_F(segment_appender_bench, append_flush_512b) {
+    return append_and_flush(512);
+}
+
+PERF_TEST_F(segment_appender_bench, append_flush_4k) {
+    return append_and_flush(4_KiB);
+}
+
+PERF_TEST_F(segment_appender_bench, append_flush_32k) {
+    return append_and_flush(32_KiB);
+}
+
+PERF_TEST_F(segment_appender_bench, append_flush_256k) {
+    return append_and_flush(256_KiB);
+}
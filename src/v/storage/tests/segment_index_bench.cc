@@ -0,0 +1,106 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "model/fundamental.h"
+#include "model/record.h"
+#include "random/generators.h"
+#include "storage/segment_index.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <vector>
+
+/**
+ * Compares lookups in the index of a 1GiB segment (default 32KiB indexing
+ * step) in its regular representation and once frozen. perf_tests reports the
+ * time per lookup, the memory saved by freezing is checked by
+ * offset_index_utils_tests.
+ */
+struct segment_index_bench {
+    static constexpr size_t entries = 32768;
+    static constexpr size_t records_per_batch = 100;
+    static constexpr size_t lookups = 1024;
+    static constexpr int64_t base_ts = 1'600'000'000'000;
+
+    segment_index_bench()
+      : raw(make_index())
+      , frozen(make_index()) {
+        frozen.freeze();
+
+        const auto max_offset = entries * records_per_batch;
+        for (size_t i = 0; i < lookups; ++i) {
+            offsets.emplace_back(
+              random_generators::get_int<int64_t>(0, max_offset));
+            timestamps.emplace_back(
+              base_ts + random_generators::get_int<int64_t>(0, max_offset));
+        }
+    }
+
+    static storage::segment_index make_index() {
+        storage::segment_index idx(
+          storage::segment_full_path::mock("bench"),
+          model::offset(0),
+          storage::segment_index::default_data_buffer_step,
+          storage::debug_sanitize_files::no);
+        model::record_batch_header hdr;
+        hdr.type = model::record_batch_type::raft_data;
+        hdr.size_bytes = storage::segment_index::default_data_buffer_step;
+        hdr.last_offset_delta = records_per_batch - 1;
+        size_t pos = 0;
+        for (size_t i = 0; i < entries; ++i) {
+            hdr.base_offset = model::offset(i * records_per_batch);
+            hdr.first_timestamp = model::timestamp(
+              base_ts + i * records_per_batch);
+            hdr.max_timestamp = model::timestamp(
+              hdr.first_timestamp() + hdr.last_offset_delta);
+            idx.maybe_track(hdr, pos);
+            pos += hdr.size_bytes;
+        }
+        return idx;
+    }
+
+    size_t find_offsets(storage::segment_index& idx) {
+        perf_tests::start_measuring_time();
+        for (auto o : offsets) {
+            perf_tests::do_not_optimize(idx.find_nearest(o));
+        }
+        perf_tests::stop_measuring_time();
+        return offsets.size();
+    }
+
+    size_t find_timestamps(storage::segment_index& idx) {
+        perf_tests::start_measuring_time();
+        for (auto t : timestamps) {
+            perf_tests::do_not_optimize(idx.find_nearest(t));
+        }
+        perf_tests::stop_measuring_time();
+        return timestamps.size();
+    }
+
+    storage::segment_index raw;
+    storage::segment_index frozen;
+    std::vector<model::offset> offsets;
+    std::vector<model::timestamp> timestamps;
+};
+
+PERF_TEST_F(segment_index_bench, find_nearest_offset_raw) {
+    return find_offsets(raw);
+}
+
+PERF_TEST_F(segment_index_bench, find_nearest_offset_frozen) {
+    return find_offsets(frozen);
+}
+
+PERF_TEST_F(segment_index_bench, find_nearest_timestamp_raw) {
+    return find_timestamps(raw);
+}
+
+PERF_TEST_F(segment_index_bench, find_nearest_timestamp_frozen) {
+    return find_timestamps(frozen);
+}
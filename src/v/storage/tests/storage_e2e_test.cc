@@ -1147,6 +1147,82 @@ FIXTURE_TEST(compacted_log_truncation, storage_test_fixture) {
     }
 }
 
+FIXTURE_TEST(compacted_log_key_lookup, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::ntp_config::default_overrides overrides;
+    overrides.cleanup_policy_bitflags
+      = model::cleanup_policy_bitflags::compaction;
+    ss::abort_source as;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log = mgr
+                 .manage(storage::ntp_config(
+                   ntp,
+                   mgr.config().base_dir,
+                   std::make_unique<storage::ntp_config::default_overrides>(
+                     overrides)))
+                 .get0();
+    // "key" only lives in the first segment, every segment rolls on a new term
+    append_single_record_batch(log, 1, model::term_id(1));
+    append_single_record_batch(log, 10, model::term_id(1), 0, true);
+    for (int t = 2; t <= 5; ++t) {
+        append_single_record_batch(log, 10, model::term_id(t), 0, true);
+    }
+    // active segment is never compacted
+    append_single_record_batch(log, 1, model::term_id(6), 0, true);
+    log.flush().get0();
+
+    storage::compaction_config c_cfg(
+      model::timestamp::min(),
+      std::nullopt,
+      model::offset::max(),
+      ss::default_priority_class(),
+      as);
+    log.compact(c_cfg).get0();
+
+    auto found = log.lookup_key(bytes("key")).get0();
+    info("lookup of existing key: {}", found);
+    BOOST_REQUIRE(found.offset.has_value());
+    BOOST_REQUIRE_EQUAL(*found.offset, model::offset(0));
+    // the filters of the newer compacted segments don't have the key
+    BOOST_REQUIRE_GE(found.segments_skipped, 1);
+    BOOST_REQUIRE_LE(
+      found.segments_read + found.segments_skipped, log.segment_count());
+
+    auto missing = log.lookup_key(bytes("missing")).get0();
+    info("lookup of missing key: {}", missing);
+    BOOST_REQUIRE(!missing.offset.has_value());
+
+    // the key filters are loaded once per generation of the segment
+    size_t filters = 0;
+    for (auto& s : get_disk_log(log)->segments()) {
+        auto lock = s->read_lock().get0();
+        auto first = s->key_filter(
+                        ss::default_priority_class(),
+                        storage::debug_sanitize_files::no)
+                       .get0();
+        auto second = s->key_filter(
+                         ss::default_priority_class(),
+                         storage::debug_sanitize_files::no)
+                        .get0();
+        BOOST_REQUIRE_EQUAL(first.get(), second.get());
+        filters += first ? 1 : 0;
+    }
+    BOOST_REQUIRE_GE(filters, 1);
+
+    // a lookup racing with the log being closed stops without reading the
+    // closed segments
+    auto racing = log.lookup_key(bytes("key"));
+    mgr.shutdown(ntp).get();
+    try {
+        auto result = racing.get0();
+        BOOST_REQUIRE_EQUAL(*result.offset, model::offset(0));
+    } catch (const storage::segment_closed_exception&) {
+    }
+}
+
 FIXTURE_TEST(
   check_segment_roll_after_compacted_log_truncate, storage_test_fixture) {
     auto cfg = default_log_config(test_dir);
@@ -3294,3 +3370,153 @@ FIXTURE_TEST(test_bytes_eviction_overrides, storage_test_fixture) {
           disk_log->size_bytes(), tc.expected_bytes_left - segment_size);
     }
 }
+
+FIXTURE_TEST(tail_stream_shared_reads, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+    auto ntp = model::ntp("default", "test", 0);
+    auto log
+      = mgr.manage(storage::ntp_config(ntp, mgr.config().base_dir)).get0();
+    auto disk_log = get_disk_log(log);
+
+    append_single_record_batch(log, 10, model::term_id(1));
+    log.flush().get0();
+
+    auto read = [&log](model::offset start, bool from_disk) {
+        storage::log_reader_config reader_cfg(
+          start, log.offsets().dirty_offset, ss::default_priority_class());
+        reader_cfg.skip_batch_cache = from_disk;
+        auto reader = log.make_reader(reader_cfg).get0();
+        return model::consume_reader_to_memory(
+                 std::move(reader), model::no_timeout)
+          .get0();
+    };
+
+    // a single reader at the tail doesn't make the stream keep batches
+    read(model::offset(0), false);
+    append_single_record_batch(log, 5, model::term_id(1));
+    BOOST_REQUIRE(!disk_log->tail_stream_shared());
+
+    // neither does a single reader polling for appended offsets which aren't
+    // visible yet, e.g. not committed
+    for (int i = 0; i < 3; ++i) {
+        storage::log_reader_config poll_cfg(
+          model::offset(10), model::offset(9), ss::default_priority_class());
+        auto reader = log.make_reader(poll_cfg).get0();
+        auto polled = model::consume_reader_to_memory(
+                        std::move(reader), model::no_timeout)
+                        .get0();
+        BOOST_REQUIRE(polled.empty());
+    }
+    BOOST_REQUIRE(!disk_log->tail_stream_shared());
+
+    // a second reader of the same batches does
+    read(model::offset(0), false);
+    BOOST_REQUIRE(disk_log->tail_stream_shared());
+    append_single_record_batch(log, 5, model::term_id(1));
+    log.flush().get0();
+
+    // every tailing reader shares the same batches, equal to those on disk
+    auto expected = read(model::offset(15), true);
+    BOOST_REQUIRE_EQUAL(expected.size(), 5);
+    auto reads_before = disk_log->get_probe().tail_stream_reads();
+    for (int i = 0; i < 10; ++i) {
+        auto batches = read(model::offset(15), false);
+        BOOST_REQUIRE_EQUAL(batches.size(), expected.size());
+        for (size_t b = 0; b < batches.size(); ++b) {
+            BOOST_REQUIRE_EQUAL(batches[b], expected[b]);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(
+      disk_log->get_probe().tail_stream_reads(), reads_before + 10);
+
+    // the stream doesn't hold batches truncated from the log
+    log
+      .truncate(storage::truncate_config(
+        model::offset(17), ss::default_priority_class()))
+      .get0();
+    auto truncated = read(model::offset(15), false);
+    BOOST_REQUIRE_EQUAL(truncated.size(), 2);
+    BOOST_REQUIRE_EQUAL(truncated.back().last_offset(), model::offset(16));
+
+    // after a roll the previous segment is read from the log again
+    append_single_record_batch(log, 1, model::term_id(2));
+    log.flush().get0();
+    reads_before = disk_log->get_probe().tail_stream_reads();
+    auto all = read(model::offset(0), false);
+    BOOST_REQUIRE_EQUAL(all.size(), 18);
+    BOOST_REQUIRE_EQUAL(
+      disk_log->get_probe().tail_stream_reads(), reads_before);
+    // a second reader of the new segment fills the stream again
+    read(model::offset(17), false);
+    read(model::offset(17), false);
+    append_single_record_batch(log, 1, model::term_id(2));
+    log.flush().get0();
+    auto tail = read(model::offset(18), false);
+    BOOST_REQUIRE_EQUAL(tail.size(), 1);
+    BOOST_REQUIRE_EQUAL(
+      disk_log->get_probe().tail_stream_reads(), reads_before + 1);
+}
+
+FIXTURE_TEST(disk_usage_accounting, storage_test_fixture) {
+    auto cfg = default_log_config(test_dir);
+    cfg.stype = storage::log_config::storage_type::disk;
+    storage::log_manager mgr = make_log_manager(cfg);
+    auto deferred = ss::defer([&mgr]() mutable { mgr.stop().get0(); });
+
+    auto ntp_a0 = model::ntp("default", "topic_a", 0);
+    auto ntp_a1 = model::ntp("default", "topic_a", 1);
+    auto ntp_b0 = model::ntp("default", "topic_b", 0);
+    auto log_a0
+      = mgr.manage(storage::ntp_config(ntp_a0, mgr.config().base_dir)).get0();
+    auto log_a1
+      = mgr.manage(storage::ntp_config(ntp_a1, mgr.config().base_dir)).get0();
+    auto log_b0
+      = mgr.manage(storage::ntp_config(ntp_b0, mgr.config().base_dir)).get0();
+
+    for (auto log : {log_a0, log_a1, log_b0}) {
+        append_single_record_batch(log, 10, model::term_id(1));
+        // roll so that the index of the first segment is written
+        append_single_record_batch(log, 10, model::term_id(2));
+        log.flush().get0();
+    }
+
+    const auto& tracker = mgr.usage_tracker();
+    auto topic_a = model::topic_namespace(ntp_a0.ns, ntp_a0.tp.topic);
+    auto topic_b = model::topic_namespace(ntp_b0.ns, ntp_b0.tp.topic);
+    // index sizes are accounted in the background once segments roll
+    tests::cooperative_spin_wait_with_timeout(10s, [&] {
+        return log_a0.get_disk_usage().index > 0
+               && log_a1.get_disk_usage().index > 0
+               && log_b0.get_disk_usage().index > 0;
+    }).get();
+
+    auto usage_a = log_a0.get_disk_usage();
+    usage_a += log_a1.get_disk_usage();
+    auto usage_b = log_b0.get_disk_usage();
+    BOOST_REQUIRE_EQUAL(
+      usage_a.data, log_a0.size_bytes() + log_a1.size_bytes());
+    BOOST_REQUIRE_EQUAL(tracker.topic_usage(topic_a), usage_a);
+    BOOST_REQUIRE_EQUAL(tracker.topic_usage(topic_b), usage_b);
+    auto shard = usage_a;
+    shard += usage_b;
+    BOOST_REQUIRE_EQUAL(tracker.shard_usage(), shard);
+
+    // the usage of a removed log no longer counts
+    mgr.remove(ntp_b0).get();
+    BOOST_REQUIRE_EQUAL(tracker.topic_usage(topic_b), storage::disk_usage{});
+    BOOST_REQUIRE_EQUAL(tracker.shard_usage(), usage_a);
+    BOOST_REQUIRE_EQUAL(tracker.topics(), 1);
+
+    // truncation gives back the truncated bytes right away
+    log_a0
+      .truncate(storage::truncate_config(
+        model::offset(15), ss::default_priority_class()))
+      .get0();
+    BOOST_REQUIRE_LT(tracker.topic_usage(topic_a).data, usage_a.data);
+    BOOST_REQUIRE_EQUAL(
+      tracker.topic_usage(topic_a).data,
+      log_a0.size_bytes() + log_a1.size_bytes());
+}
@@ -0,0 +1,86 @@
+// Copyright 2022 Redpanda Data, Inc.
+//
+// Use of this software is governed by the Business Source License
+// included in the file licenses/BSL.md
+//
+// As of the Change Date specified in that file, in accordance with
+// the Business Source License, use of this software will be governed
+// by the Apache License, Version 2.0
+
+#include "config/configuration.h"
+#include "model/fundamental.h"
+#include "random/generators.h"
+#include "storage/tests/bench_log.h"
+#include "units.h"
+
+#include <seastar/testing/perf_tests.hh>
+
+#include <vector>
+
+/**
+ * Timequeries over segments with skewed producer timestamps: timestamps
+ * mostly increase, but one batch in ten carries a timestamp up to a minute
+ * late as a producer with a lagging clock or retried sends would. Queries for
+ * random times are answered once by reading the matching segment from its
+ * beginning and once seeking with the max time index. perf_tests reports the
+ * time per query.
+ */
+struct timequery_bench {
+    static constexpr int64_t first_ts = 1'000'000'000;
+    static constexpr size_t queries_per_run = 100;
+
+    timequery_bench()
+      : builder(storage::bench_log_config()) {
+        builder | storage::start();
+        storage::build_bench_log(
+          builder,
+          {.segments = 4,
+           .batches_per_segment = 2048,
+           .records_per_batch = 4,
+           .record_size = 1_KiB},
+          [this](model::record_batch& batch) {
+              last_ts += 10;
+              auto ts = last_ts;
+              if (random_generators::get_int(9) == 0) {
+                  ts -= random_generators::get_int(60'000);
+              }
+              batch.header().first_timestamp = model::timestamp(ts);
+              batch.header().max_timestamp = model::timestamp(ts);
+          });
+    }
+
+    ~timequery_bench() {
+        config::shard_local_cfg().storage_timequery_index.reset();
+        builder | storage::stop();
+    }
+
+    size_t run_queries(bool use_index) {
+        config::shard_local_cfg().storage_timequery_index.set_value(use_index);
+        auto log = builder.get_log();
+        std::vector<model::timestamp> times;
+        times.reserve(queries_per_run);
+        for (size_t i = 0; i < queries_per_run; ++i) {
+            times.emplace_back(random_generators::get_int(first_ts, last_ts));
+        }
+
+        perf_tests::start_measuring_time();
+        for (auto t : times) {
+            storage::timequery_config cfg(
+              t,
+              log.offsets().dirty_offset,
+              ss::default_priority_class(),
+              model::record_batch_type::raft_data);
+            auto res = log.timequery(cfg).get0();
+            perf_tests::do_not_optimize(res);
+        }
+        perf_tests::stop_measuring_time();
+        return times.size();
+    }
+
+    storage::disk_log_builder builder;
+    int64_t last_ts{first_ts};
+};
+
+PERF_TEST_F(timequery_bench, timequery_scan) { return run_queries(false); }
+
+PERF_TEST_F(timequery_bench, timequery_index) { return run_queries(true); }
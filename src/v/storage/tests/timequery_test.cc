@@ -9,11 +9,16 @@
 
 #include "config/configuration.h"
 #include "model/tests/random_batch.h"
+#include "random/generators.h"
 #include "storage/tests/disk_log_builder_fixture.h"
 #include "test_utils/fixture.h"
+#include "units.h"
 
 #include <seastar/core/file.hh>
 
+#include <algorithm>
+#include <vector>
+
 FIXTURE_TEST(timequery, log_builder_fixture) {
     using namespace storage; // NOLINT
 
@@ -120,3 +125,61 @@ FIXTURE_TEST(timequery_single_value, log_builder_fixture) {
     BOOST_TEST(res->offset == model::offset(0));
     b | stop();
 }
+
+FIXTURE_TEST(timequery_out_of_order_timestamps, log_builder_fixture) {
+    using namespace storage; // NOLINT
+
+    b | start();
+
+    // 2000 single record batches of 1KiB, enough for tens of index entries,
+    // with timestamps increasing by 10 on average but off by up to +-500
+    b | add_segment(0);
+    std::vector<model::timestamp> timestamps;
+    for (auto offset = 0; offset < 2000; ++offset) {
+        auto ts = model::timestamp(
+          10'000 + offset * 10 + random_generators::get_int(-500, 500));
+        timestamps.push_back(ts);
+        auto batch = model::test::make_random_batch(
+          model::test::record_batch_spec{
+            .offset = model::offset(offset),
+            .allow_compression = false,
+            .count = 1,
+            .record_sizes = std::vector<size_t>{1_KiB}});
+        batch.header().first_timestamp = ts;
+        batch.header().max_timestamp = ts;
+        b | add_batch(std::move(batch));
+    }
+
+    auto log = b.get_log();
+    auto query = [&log](model::timestamp t) {
+        storage::timequery_config config(
+          t,
+          log.offsets().dirty_offset,
+          ss::default_priority_class(),
+          std::nullopt);
+        return log.timequery(config).get0();
+    };
+
+    for (bool use_index : {true, false}) {
+        config::shard_local_cfg().storage_timequery_index.set_value(use_index);
+        for (auto t = 9'000; t < 31'000; t += 97) {
+            // the first batch at or after t, regardless of the batches
+            // following it
+            auto it = std::find_if(
+              timestamps.begin(), timestamps.end(), [t](model::timestamp ts) {
+                  return ts >= model::timestamp(t);
+              });
+            auto res = query(model::timestamp(t));
+            if (it == timestamps.end()) {
+                BOOST_TEST(!res);
+                continue;
+            }
+            BOOST_REQUIRE(res);
+            auto offset = std::distance(timestamps.begin(), it);
+            BOOST_TEST(res->offset == model::offset(offset));
+            BOOST_TEST(res->time == *it);
+        }
+    }
+    config::shard_local_cfg().storage_timequery_index.reset();
+    b | stop();
+}
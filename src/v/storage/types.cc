@@ -59,7 +59,7 @@ std::ostream& operator<<(std::ostream& o, const log_reader_config& cfg) {
     } else {
         o << "nullopt";
     }
-    return o << "}";
+    return o << ", historical_read:" << cfg.historical_read << "}";
 }
 
 std::ostream& operator<<(std::ostream& o, const append_result& a) {
@@ -74,6 +74,15 @@ std::ostream& operator<<(std::ostream& o, const append_result& a) {
 std::ostream& operator<<(std::ostream& o, const timequery_result& a) {
     return o << "{offset:" << a.offset << ", time:" << a.time << "}";
 }
+std::ostream& operator<<(std::ostream& o, const key_lookup_result& r) {
+    fmt::print(
+      o,
+      "{{offset:{}, segments_read:{}, segments_skipped:{}}}",
+      r.offset,
+      r.segments_read,
+      r.segments_skipped);
+    return o;
+}
 std::ostream& operator<<(std::ostream& o, const timequery_config& a) {
     o << "{max_offset:" << a.max_offset << ", time:" << a.time
       << ", type_filter:";
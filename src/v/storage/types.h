@@ -235,6 +235,17 @@ struct timequery_result {
     friend std::ostream& operator<<(std::ostream& o, const timequery_result&);
 };
 
+/// Latest record of a key in a log
+struct key_lookup_result {
+    // log offset of the latest record of the key
+    std::optional<model::offset> offset;
+    // segments read, and skipped as their key filter doesn't contain the key
+    size_t segments_read{0};
+    size_t segments_skipped{0};
+
+    friend std::ostream& operator<<(std::ostream& o, const key_lookup_result&);
+};
+
 struct truncate_config {
     truncate_config(model::offset o, ss::io_priority_class p)
       : base_offset(o)
@@ -309,6 +320,11 @@ struct log_reader_config {
     // historical read-once workloads like compaction).
     bool skip_batch_cache{false};
 
+    // the read is catching up on historical data. batches read from disk are
+    // admitted at the head of the batch cache probationary segment and cache
+    // hits do not promote, so a backlog scan can not evict the hot tail.
+    bool historical_read{false};
+
     log_reader_config(
       model::offset start_offset,
       model::offset max_offset,
@@ -404,4 +420,15 @@ struct compaction_result {
     friend std::ostream& operator<<(std::ostream&, const compaction_result&);
 };
 
+/// Inputs of the housekeeping priority of a log, see log_manager
+struct housekeeping_stats {
+    // fraction of the closed bytes of a compacted log which weren't compacted
+    // yet
+    double dirty_ratio{0};
+    // bytes the log holds over its retention.bytes
+    size_t bytes_over_retention{0};
+    // size of the log
+    size_t size_bytes{0};
+};
+
 } // namespace storage
@@ -65,6 +65,10 @@ public:
 
     size_t depth() const { return _curr_depth; }
 
+    /// units not taken, negative while more units are taken than the depth
+    ssize_t available_units() const { return _queue.available_units(); }
+    size_t waiters() const { return _queue.waiters(); }
+
     ss::future<ssx::semaphore_units> get_unit() {
         return ss::get_units(_queue, 1);
     }